@@ -26,6 +26,10 @@
 // File: voglbench.cpp
 #include "vogl_common.h"
 #include "vogl_gl_replayer.h"
+#include "vogl_null_gl.h"
+#include "vogl_threaded_replayer.h"
+#include "vogl_program_binary_cache.h"
+#include "vogl_bench_report.h"
 #include "vogl_colorized_console.h"
 #include "vogl_command_line_params.h"
 #include "vogl_cfile_stream.h"
@@ -72,6 +76,17 @@ static command_line_param_desc g_command_line_param_descs[] =
     { "loop_frame", 1, false, "Replay: loop mode's start frame" },
     { "loop_len", 1, false, "Replay: loop mode's loop length" },
     { "loop_count", 1, false, "Replay: loop mode's loop count" },
+    { "loop_predecode", 0, false, "Replay: loop mode decodes the looped frames once and replays them from memory" },
+    { "threaded_replay", 0, false, "Replay: Replay the trace serially, then again with one replay thread per traced GL thread, and report the speedup. Implies -lock_window_dimensions" },
+    { "null_driver", 0, false, "Replay: Replay through the null GL driver (no window, context or GPU) to measure the replayer's own CPU cost, implies -profile" },
+    { "profile", 0, false, "Replay: Profile every replayed call (decode, replayer and driver time vs. traced GL time) and print a per-entrypoint report at exit" },
+    { "profile_file", 1, false, "Replay: Write the per-frame and per-call profile timeline to this file (.json, otherwise CSV), implies -profile" },
+    { "bench_loops", 1, false, "Replay: Benchmark mode: replay the loop_frame/loop_len frames this many measured times, fencing each frame with glFinish() and reporting CPU and GPU frame time statistics. Requires -loop_frame" },
+    { "bench_warmup", 1, false, "Replay: Benchmark mode: number of unmeasured warm-up loops before the measured loops (default is 1)" },
+    { "bench_file", 1, false, "Replay: Benchmark mode: write the per-frame times and summary to this file (.json, otherwise CSV)" },
+    { "bench_baseline", 1, false, "Replay: Benchmark mode: compare against a .json report written earlier by -bench_file, and fail if any metric regressed significantly" },
+    { "bench_threshold", 1, false, "Replay: Benchmark mode: minimum slowdown of the mean, in percent, for a significant difference to count as a regression (default is 2)" },
+    { "profile_trace_tick_rate", 1, false, "Replay: Rate of the trace's rdtsc timestamps in ticks/sec (default is to estimate this machine's TSC rate)" },
     { "logfile", 1, false, "Create logfile" },
     { "help", 0, false, "Display this help" },
     { "?", 0, false, "Display this help" },
@@ -82,6 +97,9 @@ static command_line_param_desc g_command_line_param_descs[] =
     { "fs_preprocessor", 1, false, "Replay: Run all FS through specified pre-processor prior to glCreateShader() call and substitute the shader output by the pre-processor into the glCreateShader() call." },
     { "fs_preprocessor_options", 1, false, "Replay: Options to pass to the FS pre-processor.  Must also specify --fs_preprocessor" },
     { "fs_preprocessor_prefix", 1, false, "Replay: Dir/prefix to append to FS input to PP and output from PP.  Must also specify --fs_preprocessor" },
+    { "fs_preprocessor_cache", 1, false, "Replay: Directory to cache FS pre-processor output in, so each distinct FS is only pre-processed once across runs.  Must also specify --fs_preprocessor" },
+    { "fs_preprocessor_worker", 0, false, "Replay: Start the FS pre-processor once and stream all FS through it over stdin/stdout (see vogl_fs_preprocessor.cpp for the protocol).  Must also specify --fs_preprocessor" },
+    { "program_binary_cache", 1, false, "Replay: Directory used to cache linked program binaries across runs (requires GL 4.1 or GL_ARB_get_program_binary)" },
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -186,6 +204,26 @@ static void vogl_direct_gl_func_epilog(gl_entrypoint_id_t entrypoint_id, void *p
     vogl_printf("* GLEPILOG %s\n", g_vogl_entrypoint_descs[entrypoint_id].m_pName);
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+// is_profiling_enabled
+//----------------------------------------------------------------------------------------------------------------------
+static bool is_profiling_enabled()
+{
+    return g_command_line_params().get_value_as_bool("profile") ||
+           g_command_line_params().get_value_as_bool("null_driver") ||
+           g_command_line_params().has_key("profile_file");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// needs_wrapped_gl_calls
+// The profiler measures driver time with the GL func prolog/epilog callbacks, which need the wrapped entrypoints.
+// Threaded replay uses them to let other replay threads in while a GL call is in the driver.
+//----------------------------------------------------------------------------------------------------------------------
+static bool needs_wrapped_gl_calls()
+{
+    return is_profiling_enabled() || g_command_line_params().get_value_as_bool("threaded_replay");
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 // voglbench_init
 //----------------------------------------------------------------------------------------------------------------------
@@ -225,6 +263,15 @@ static bool voglbench_init(int argc, char *argv[])
         vogl_set_direct_gl_func_epilog(vogl_direct_gl_func_epilog, NULL);
     }
 
+    bool wrap_all_gl_calls = needs_wrapped_gl_calls();
+
+    if (g_command_line_params().get_value_as_bool("null_driver"))
+    {
+        vogl_message_printf("Using the null GL driver\n");
+        vogl_init_actual_gl_entrypoints(vogl_null_gl_get_proc_address, wrap_all_gl_calls);
+        return true;
+    }
+
     #if VOGL_PLATFORM_HAS_SDL
         if (SDL_Init(SDL_INIT_VIDEO) < 0) 
             return false;
@@ -233,7 +280,6 @@ static bool voglbench_init(int argc, char *argv[])
     if (!load_gl())
         return false;
 
-    bool wrap_all_gl_calls = false;
     vogl_init_actual_gl_entrypoints(vogl_get_proc_address_helper, wrap_all_gl_calls);
     return true;
 }
@@ -274,9 +320,82 @@ static uint get_replayer_flags_from_command_line_params()
             replayer_flags |= s_replayer_command_line_params[i].m_flag;
     }
 
+    // Replay threads can't wait for the window to be resized.
+    if (g_command_line_params().get_value_as_bool("threaded_replay"))
+        replayer_flags |= cGLReplayerLockWindowDimensions;
+
     return replayer_flags;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+// tool_threaded_replay
+// Pre-decodes the rest of the trace, replays it serially, resets the replayer, then replays it again with one replay thread
+// per traced GL thread.
+//----------------------------------------------------------------------------------------------------------------------
+static bool tool_threaded_replay(vogl_gl_replayer &replayer, vogl_trace_file_reader &trace_reader)
+{
+    VOGL_FUNC_TRACER
+
+    vogl_predecoded_frames frames;
+    if (!frames.record(trace_reader, &replayer.get_trace_gl_ctypes(), cUINT32_MAX))
+    {
+        vogl_error_printf("Failed pre-decoding trace\n");
+        return false;
+    }
+
+    vogl_printf("Pre-decoded %u frame(s), %u packets\n", frames.get_num_frames(), frames.size());
+
+    vogl_threaded_replayer threaded_replayer;
+    if (!threaded_replayer.init(&replayer, &frames))
+        return false;
+
+    vogl_printf("Trace has %u GL thread(s), %u sync points\n", threaded_replayer.get_num_threads(), threaded_replayer.get_num_sync_points());
+
+    uint32_t start_context_switches = replayer.get_total_forced_context_switches();
+
+    timer tm;
+    tm.start();
+
+    vogl_gl_replayer::status_t status;
+    do
+    {
+        status = replayer.process_pending_packets();
+        if (status == vogl_gl_replayer::cStatusOK)
+            status = replayer.process_next_packet(frames);
+    } while ((status >= 0) && (status != vogl_gl_replayer::cStatusAtEOF));
+
+    double serial_time = tm.get_elapsed_secs();
+    uint32_t serial_context_switches = replayer.get_total_forced_context_switches() - start_context_switches;
+    uint32_t total_swaps = replayer.get_total_swaps();
+
+    if (status != vogl_gl_replayer::cStatusAtEOF)
+    {
+        vogl_error_printf("Serial replay failed\n");
+        return false;
+    }
+
+    vogl_printf("Serial replay:   %u total swaps, %.3f secs, %u forced context switches\n", total_swaps, serial_time, serial_context_switches);
+
+    replayer.reset_state();
+
+    start_context_switches = replayer.get_total_forced_context_switches();
+
+    status = threaded_replayer.replay();
+    if (status != vogl_gl_replayer::cStatusAtEOF)
+    {
+        vogl_error_printf("Threaded replay failed\n");
+        return false;
+    }
+
+    double threaded_time = threaded_replayer.get_replay_time();
+
+    vogl_printf("Threaded replay: %u total swaps, %.3f secs, %u forced context switches\n",
+                replayer.get_total_swaps() - total_swaps, threaded_time, replayer.get_total_forced_context_switches() - start_context_switches);
+    vogl_printf("Speedup over serial replay: %.3fx\n", threaded_time ? (serial_time / threaded_time) : 0.0f);
+
+    return true;
+}
+
 #if (VOGL_PLATFORM_HAS_SDL)
     //----------------------------------------------------------------------------------------------------------------------
     // tool_replay_mode
@@ -314,11 +433,14 @@ static uint get_replayer_flags_from_command_line_params()
 
         #if defined(PLATFORM_WINDOWS)
             // We need to get proc addresses for windows late.
-            replayer.set_proc_address_helper(vogl_get_proc_address_helper, false);
+            replayer.set_proc_address_helper(vogl_get_proc_address_helper, needs_wrapped_gl_calls());
         #endif
 
         uint replayer_flags = get_replayer_flags_from_command_line_params();
 
+        bool null_driver = g_command_line_params().get_value_as_bool("null_driver");
+        window.set_null_mode(null_driver);
+
         // TODO: This will create a window with default attributes, which seems fine for the majority of traces.
         // Unfortunately, some GL call streams *don't* want an alpha channel, or depth, or stencil etc. in the default framebuffer so this may become a problem.
         // Also, this design only supports a single window, which is going to be a problem with multiple window traces.
@@ -334,6 +456,43 @@ static uint get_replayer_flags_from_command_line_params()
             return false;
         }
 
+        replayer.set_fs_preprocessor(g_command_line_params().get_value_as_string("fs_preprocessor", 0, ""));
+        replayer.set_fs_preprocessor_options(g_command_line_params().get_value_as_string("fs_preprocessor_options", 0, ""));
+        replayer.set_fs_preprocessor_prefix(g_command_line_params().get_value_as_string("fs_preprocessor_prefix", 0, ""));
+        replayer.set_fs_preprocessor_cache_dir(g_command_line_params().get_value_as_string("fs_preprocessor_cache", 0, ""));
+        replayer.set_fs_preprocessor_use_worker(g_command_line_params().get_value_as_bool("fs_preprocessor_worker"));
+
+        if (g_command_line_params().has_key("program_binary_cache"))
+        {
+            if (!vogl_program_binary_cache::get_instance()->init(g_command_line_params().get_value_as_string_or_empty("program_binary_cache")))
+                vogl_warning_printf("Failed initializing program binary cache, continuing without it\n");
+        }
+
+        if ((g_command_line_params().has_key("bench_loops")) && (g_command_line_params().get_value_as_int("loop_frame", 0, -1) == -1))
+        {
+            vogl_error_printf("-bench_loops requires -loop_frame\n");
+            return false;
+        }
+
+        // The profiler's per-call state isn't thread safe.
+        if ((g_command_line_params().get_value_as_bool("threaded_replay")) && (is_profiling_enabled()))
+        {
+            vogl_error_printf("-threaded_replay can't be combined with profiling\n");
+            return false;
+        }
+
+        vogl_replay_profiler profiler;
+        dynamic_string profile_filename(g_command_line_params().get_value_as_string_or_empty("profile_file"));
+        if (is_profiling_enabled())
+        {
+            if (g_command_line_params().has_key("profile_trace_tick_rate"))
+                profiler.set_trace_ticks_per_sec(g_command_line_params().get_value_as_float("profile_trace_tick_rate"));
+
+            profiler.init(!profile_filename.is_empty());
+            profiler.install_gl_callbacks(true);
+            replayer.set_profiler(&profiler);
+        }
+
         // Disable all glGetError() calls in vogl_utils.cpp.
         vogl_disable_gl_get_error();
 
@@ -350,9 +509,33 @@ static uint get_replayer_flags_from_command_line_params()
         int loop_count = math::maximum<int>(g_command_line_params().get_value_as_int("loop_count", 0, cINT32_MAX), 1);
         bool endless_mode = g_command_line_params().get_value_as_bool("endless");
 
+        // In benchmark mode the looped frames are replayed once per warm-up and measured loop, then replay stops.
+        vogl_bench_report bench;
+        if (g_command_line_params().has_key("bench_loops"))
+        {
+            bench.init(g_command_line_params().get_value_as_uint("bench_warmup", 0, 1, 0, cINT32_MAX),
+                       g_command_line_params().get_value_as_uint("bench_loops", 0, 1, 1, cINT32_MAX));
+
+            // The first loop plays right after the snapshot is taken, every other loop starts by restoring it.
+            loop_count = static_cast<int>(bench.get_total_loops() - 1);
+            endless_mode = false;
+        }
+
+        // When enabled, the looped frames are read and deserialized once, then replayed from memory on every iteration.
+        bool loop_predecode = g_command_line_params().get_value_as_bool("loop_predecode");
+        bool loop_frames_active = false;
+        vogl_predecoded_frames loop_frames;
+
         timer tm;
         tm.start();
 
+        if (g_command_line_params().get_value_as_bool("threaded_replay"))
+        {
+            if (!tool_threaded_replay(replayer, *pTrace_reader))
+                goto error_exit;
+            goto normal_exit;
+        }
+
         for (;;)
         {
             tmZone(TELEMETRY_LEVEL0, TMZF_NONE, "Main Loop");
@@ -414,10 +597,30 @@ static uint get_replayer_flags_from_command_line_params()
                     {
                         vogl_printf("Snapshot succeeded\n");
 
+                        if (bench.is_enabled())
+                        {
+                            GL_ENTRYPOINT(glFinish)();
+                            bench.begin_loop();
+                        }
+
                         snapshot_loop_start_frame = pTrace_reader->get_cur_frame();
                         snapshot_loop_end_frame = pTrace_reader->get_cur_frame() + loop_len;
 
                         vogl_debug_printf("Loop start: %" PRIi64 " Loop end: %" PRIi64 "\n", snapshot_loop_start_frame, snapshot_loop_end_frame);
+
+                        if (loop_predecode)
+                        {
+                            if (!loop_frames.record(*pTrace_reader, &replayer.get_trace_gl_ctypes(), loop_len))
+                            {
+                                vogl_error_printf("Failed pre-decoding loop frames\n");
+                                goto error_exit;
+                            }
+
+                            vogl_printf("Pre-decoded %u frame(s), %u packets\n", loop_frames.get_num_frames(), loop_frames.size());
+
+                            loop_frames.rewind();
+                            loop_frames_active = true;
+                        }
                     }
                     else
                     {
@@ -432,11 +635,23 @@ static uint get_replayer_flags_from_command_line_params()
             {
                 for (;;)
                 {
+                    // A restored snapshot starts the next benchmark loop, once the GPU is done with the restore.
+                    bool applying_snapshot = bench.is_enabled() && (replayer.get_pending_apply_snapshot() != NULL);
+
                     status = replayer.process_pending_packets();
 
+                    if ((applying_snapshot) && (!replayer.get_pending_apply_snapshot()) && (status == vogl_gl_replayer::cStatusOK))
+                    {
+                        GL_ENTRYPOINT(glFinish)();
+                        bench.begin_loop();
+                    }
+
                     if (status == vogl_gl_replayer::cStatusOK)
                     {
-                        status = replayer.process_next_packet(*pTrace_reader);
+                        if (loop_frames_active)
+                            status = replayer.process_next_packet(loop_frames);
+                        else
+                            status = replayer.process_next_packet(*pTrace_reader);
                     }
 
                     if ((status == vogl_gl_replayer::cStatusNextFrame) ||
@@ -452,27 +667,51 @@ static uint get_replayer_flags_from_command_line_params()
             if (status == vogl_gl_replayer::cStatusHardFailure)
                 break;
 
+            if ((status == vogl_gl_replayer::cStatusNextFrame) && (bench.get_cur_loop() >= 0))
+            {
+                timer_ticks cpu_end_ticks = timer::get_ticks();
+                GL_ENTRYPOINT(glFinish)();
+                bench.end_frame(cpu_end_ticks, timer::get_ticks());
+            }
+
             if (status == vogl_gl_replayer::cStatusAtEOF)
             {
                 vogl_message_printf("At trace EOF, frame index %u\n", replayer.get_frame_index());
             }
 
-            if (replayer.get_at_frame_boundary() &&
-                pSnapshot && 
-                (loop_count > 0) &&
-                ((pTrace_reader->get_cur_frame() == snapshot_loop_end_frame) || (status == vogl_gl_replayer::cStatusAtEOF)))
+            // While the loop is replayed from pre-decoded frames the trace reader sits at the end of the loop, so take the frame from their cursor.
+            int64_t cur_trace_frame = loop_frames_active ? (snapshot_loop_start_frame + loop_frames.get_cur_frame()) : pTrace_reader->get_cur_frame();
+
+            bool at_loop_end = replayer.get_at_frame_boundary() &&
+                pSnapshot &&
+                ((cur_trace_frame == snapshot_loop_end_frame) || (status == vogl_gl_replayer::cStatusAtEOF));
+
+            if ((at_loop_end) && (loop_count > 0))
             {
                 status = replayer.begin_applying_snapshot(pSnapshot, false);
                 if ((status != vogl_gl_replayer::cStatusOK) && (status != vogl_gl_replayer::cStatusResizeWindow))
                     goto error_exit;
 
-                pTrace_reader->seek_to_frame(static_cast<uint>(snapshot_loop_start_frame));
+                if (loop_frames_active)
+                    loop_frames.rewind();
+                else
+                    pTrace_reader->seek_to_frame(static_cast<uint>(snapshot_loop_start_frame));
 
                 vogl_debug_printf("Applying snapshot and seeking back to frame %" PRIi64 "\n", snapshot_loop_start_frame);
                 loop_count--;
             }
             else
             {
+                if ((at_loop_end) && (bench.is_enabled()))
+                    goto normal_exit;
+
+                // Done looping, continue from the trace reader which is already positioned right after the looped frames.
+                if ((loop_frames_active) && (loop_frames.get_cur_packet_index() == loop_frames.size()))
+                {
+                    loop_frames_active = false;
+                    loop_frames.clear();
+                }
+
                 bool print_progress = (status == vogl_gl_replayer::cStatusAtEOF) ||
                     ((replayer.get_at_frame_boundary()) && ((replayer.get_frame_index() % 100) == 0));
                 if (print_progress)
@@ -499,6 +738,7 @@ static uint get_replayer_flags_from_command_line_params()
                             double fs_pp_time = replayer.get_fs_pp_time();
                             vogl_printf("Ran with FS Preprocessor (FSPP) enabled:\n");
                             vogl_printf("FSPP Time: %.3f secs\n", fs_pp_time);
+                            vogl_printf("FSPP Cache: %u hits, %u misses\n", replayer.get_fs_preprocessor()->get_num_cache_hits(), replayer.get_fs_preprocessor()->get_num_cache_misses());
                             vogl_printf("Overall Stats:             %u total swaps, %.3f secs, %3.3f avg fps\n", replayer.get_total_swaps(), time_since_start, replayer.get_frame_index() / time_since_start);
                             vogl_printf("Stats Excluding FSPP time: %u total swaps, %.3f secs, %3.3f avg fps\n", replayer.get_total_swaps(), time_since_start-fs_pp_time, replayer.get_frame_index() / (time_since_start-fs_pp_time));
                             break;
@@ -525,9 +765,47 @@ static uint get_replayer_flags_from_command_line_params()
         }
 
     normal_exit:
+        if (vogl_program_binary_cache::get_instance()->is_enabled())
+            vogl_program_binary_cache::get_instance()->print_stats();
+
+        if (bench.is_enabled())
+        {
+            bench.print_summary();
+
+            dynamic_string bench_filename(g_command_line_params().get_value_as_string_or_empty("bench_file"));
+            if ((!bench_filename.is_empty()) && (!bench.write(bench_filename.get_ptr())))
+                goto error_exit;
+
+            dynamic_string baseline_filename(g_command_line_params().get_value_as_string_or_empty("bench_baseline"));
+            if (!baseline_filename.is_empty())
+            {
+                bool any_regressions = false;
+                if (!bench.compare_to_baseline(baseline_filename.get_ptr(), g_command_line_params().get_value_as_float("bench_threshold", 0, 2.0f), any_regressions))
+                    goto error_exit;
+
+                if (any_regressions)
+                {
+                    vogl_error_printf("Benchmark regressed against baseline \"%s\"\n", baseline_filename.get_ptr());
+                    goto error_exit;
+                }
+            }
+        }
+
+        if (replayer.get_profiler())
+        {
+            profiler.install_gl_callbacks(false);
+            replayer.set_profiler(NULL);
+
+            profiler.print_report();
+
+            if ((!profile_filename.is_empty()) && (!profiler.write_timeline(profile_filename.get_ptr())))
+                return false;
+        }
+
         return true;
 
     error_exit:
+        profiler.install_gl_callbacks(false);
         return false;
     }
 #else
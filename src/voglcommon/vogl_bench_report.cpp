@@ -0,0 +1,331 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * Copyright 2010-2014 Rich Geldreich and Tenacious Software LLC
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_bench_report.cpp
+#include "vogl_bench_report.h"
+#include "vogl_cfile_stream.h"
+#include "vogl_json.h"
+#include "vogl_file_utils.h"
+
+#define VOGL_BENCH_REPORT_VERSION 1
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::vogl_bench_report
+//----------------------------------------------------------------------------------------------------------------------
+vogl_bench_report::vogl_bench_report()
+    : m_num_warmup_loops(0),
+      m_num_measured_loops(0)
+{
+    VOGL_FUNC_TRACER
+
+    clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::init
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_bench_report::init(uint32_t num_warmup_loops, uint32_t num_measured_loops)
+{
+    VOGL_FUNC_TRACER
+
+    clear();
+
+    m_num_warmup_loops = num_warmup_loops;
+    m_num_measured_loops = num_measured_loops;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::clear
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_bench_report::clear()
+{
+    VOGL_FUNC_TRACER
+
+    m_cur_loop = -1;
+    m_cur_loop_frame = 0;
+    m_frame_start_ticks = 0;
+
+    m_frames.clear();
+
+    for (uint32_t i = 0; i < cTotalMetrics; i++)
+        m_stats[i].clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::begin_loop
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_bench_report::begin_loop()
+{
+    VOGL_FUNC_TRACER
+
+    m_cur_loop++;
+    m_cur_loop_frame = 0;
+    m_frame_start_ticks = timer::get_ticks();
+
+    if (static_cast<uint32_t>(m_cur_loop) < m_num_warmup_loops)
+        vogl_printf("Benchmark warm-up loop %u of %u\n", m_cur_loop + 1, m_num_warmup_loops);
+    else
+        vogl_printf("Benchmark loop %u of %u\n", m_cur_loop - m_num_warmup_loops + 1, m_num_measured_loops);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::end_frame
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_bench_report::end_frame(timer_ticks cpu_end_ticks, timer_ticks gpu_end_ticks)
+{
+    VOGL_FUNC_TRACER
+
+    if (m_cur_loop < 0)
+        return;
+
+    if (static_cast<uint32_t>(m_cur_loop) >= m_num_warmup_loops)
+    {
+        frame_sample sample;
+        sample.m_loop = m_cur_loop - m_num_warmup_loops;
+        sample.m_frame = m_cur_loop_frame;
+        sample.m_times_ms[cMetricCPU] = timer::ticks_to_ms(cpu_end_ticks - m_frame_start_ticks);
+        sample.m_times_ms[cMetricGPU] = timer::ticks_to_ms(gpu_end_ticks - m_frame_start_ticks);
+        m_frames.push_back(sample);
+
+        for (uint32_t i = 0; i < cTotalMetrics; i++)
+            m_stats[i].add_sample(sample.m_times_ms[i]);
+    }
+
+    m_cur_loop_frame++;
+    m_frame_start_ticks = gpu_end_ticks;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::get_metric_name
+//----------------------------------------------------------------------------------------------------------------------
+const char *vogl_bench_report::get_metric_name(metric_t metric)
+{
+    switch (metric)
+    {
+        case cMetricCPU:
+            return "cpu_ms";
+        case cMetricGPU:
+            return "gpu_ms";
+        default:
+            break;
+    }
+
+    VOGL_ASSERT_ALWAYS;
+    return "";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::print_summary
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_bench_report::print_summary() const
+{
+    VOGL_FUNC_TRACER
+
+    vogl_printf("Benchmark: %u warm-up loop(s), %u measured loop(s), %u measured frames\n", m_num_warmup_loops, m_num_measured_loops, m_frames.size());
+
+    vogl_printf("%-8s %10s %10s %10s %10s %10s %10s %10s\n", "Metric", "Min", "Median", "P95", "P99", "Max", "Mean", "Variance");
+
+    for (uint32_t i = 0; i < cTotalMetrics; i++)
+    {
+        const vogl::sample_stats &stats = m_stats[i];
+
+        vogl_printf("%-8s %10.3f %10.3f %10.3f %10.3f %10.3f %10.3f %10.4f\n", get_metric_name(static_cast<metric_t>(i)),
+                    stats.get_min(), stats.get_median(), stats.get_percentile(95.0), stats.get_percentile(99.0), stats.get_max(),
+                    stats.get_mean(), stats.get_variance());
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::write
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_bench_report::write(const char *pFilename) const
+{
+    VOGL_FUNC_TRACER
+
+    cfile_stream stream;
+    if (!stream.open(pFilename, cDataStreamWritable))
+    {
+        vogl_error_printf("Failed opening benchmark report file \"%s\"\n", pFilename);
+        return false;
+    }
+
+    dynamic_string ext(pFilename);
+    file_utils::get_extension(ext);
+
+    bool success = ext.compare("json", false) ? write_csv(stream) : write_json(stream);
+
+    if ((!stream.close()) || (!success))
+    {
+        vogl_error_printf("Failed writing benchmark report file \"%s\"\n", pFilename);
+        return false;
+    }
+
+    vogl_printf("Wrote benchmark report to \"%s\"\n", pFilename);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::write_csv
+// One row per measured frame, the summary is only written to the JSON report.
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_bench_report::write_csv(data_stream &stream) const
+{
+    VOGL_FUNC_TRACER
+
+    bool success = stream.puts("loop,frame,cpu_ms,gpu_ms\n");
+
+    for (uint32_t i = 0; (i < m_frames.size()) && (success); i++)
+    {
+        const frame_sample &frame = m_frames[i];
+        success = stream.printf("%u,%u,%f,%f\n", frame.m_loop, frame.m_frame, frame.m_times_ms[cMetricCPU], frame.m_times_ms[cMetricGPU]);
+    }
+
+    return success;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::write_json
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_bench_report::write_json(data_stream &stream) const
+{
+    VOGL_FUNC_TRACER
+
+    json_stream_writer writer;
+    if (!writer.open(stream))
+        return false;
+
+    writer.begin_object();
+
+    writer.add_value("version", VOGL_BENCH_REPORT_VERSION);
+    writer.add_value("warmup_loops", m_num_warmup_loops);
+    writer.add_value("measured_loops", m_num_measured_loops);
+
+    writer.begin_object("summary");
+    for (uint32_t i = 0; i < cTotalMetrics; i++)
+    {
+        const vogl::sample_stats &stats = m_stats[i];
+
+        writer.begin_object(get_metric_name(static_cast<metric_t>(i)));
+        writer.add_value("count", stats.size());
+        writer.add_value("min", stats.get_min());
+        writer.add_value("median", stats.get_median());
+        writer.add_value("p95", stats.get_percentile(95.0));
+        writer.add_value("p99", stats.get_percentile(99.0));
+        writer.add_value("max", stats.get_max());
+        writer.add_value("mean", stats.get_mean());
+        writer.add_value("variance", stats.get_variance());
+        writer.end();
+    }
+    writer.end();
+
+    writer.begin_array("frames");
+    for (uint32_t i = 0; i < m_frames.size(); i++)
+    {
+        const frame_sample &frame = m_frames[i];
+
+        writer.begin_object();
+        writer.add_value("loop", frame.m_loop);
+        writer.add_value("frame", frame.m_frame);
+        for (uint32_t j = 0; j < cTotalMetrics; j++)
+            writer.add_value(get_metric_name(static_cast<metric_t>(j)), frame.m_times_ms[j]);
+        writer.end();
+    }
+    writer.end();
+
+    writer.end();
+
+    return writer.close();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_bench_report::compare_to_baseline
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_bench_report::compare_to_baseline(const char *pFilename, double threshold_percent, bool &any_regressions) const
+{
+    VOGL_FUNC_TRACER
+
+    any_regressions = false;
+
+    json_document doc;
+    if (!doc.deserialize_file(pFilename))
+    {
+        vogl_error_printf("Failed reading benchmark baseline file \"%s\"\n", pFilename);
+        return false;
+    }
+
+    const json_node *pFrames_node = doc.get_root()->find_child_array("frames");
+    if (!pFrames_node)
+    {
+        vogl_error_printf("Benchmark baseline file \"%s\" has no frames array\n", pFilename);
+        return false;
+    }
+
+    vogl::sample_stats baseline_stats[cTotalMetrics];
+    for (uint32_t i = 0; i < pFrames_node->size(); i++)
+    {
+        const json_node *pFrame_node = pFrames_node->get_value_as_object(i);
+        if (!pFrame_node)
+            return false;
+
+        for (uint32_t j = 0; j < cTotalMetrics; j++)
+            baseline_stats[j].add_sample(pFrame_node->value_as_double(get_metric_name(static_cast<metric_t>(j))));
+    }
+
+    vogl_printf("Comparing against baseline \"%s\" (%u frames), regression threshold %.2f%%\n", pFilename, pFrames_node->size(), threshold_percent);
+    vogl_printf("%-8s %12s %12s %9s %9s %9s  %s\n", "Metric", "Base mean", "Mean", "Change", "t", "t crit", "Result");
+
+    for (uint32_t i = 0; i < cTotalMetrics; i++)
+    {
+        const vogl::sample_stats &base = baseline_stats[i];
+        const vogl::sample_stats &cur = m_stats[i];
+
+        double t, dof;
+        bool have_test = vogl::sample_stats_welch_t_test(base, cur, t, dof);
+        double t_crit = vogl::student_t_critical_value_95(dof);
+
+        double change_percent = (base.get_mean() > 0) ? ((cur.get_mean() - base.get_mean()) * 100.0 / base.get_mean()) : 0;
+
+        const char *pResult = "insufficient samples";
+        if (have_test)
+        {
+            bool significant = fabs(t) > t_crit;
+            if ((significant) && (t > 0) && (change_percent >= threshold_percent))
+            {
+                pResult = "REGRESSION";
+                any_regressions = true;
+            }
+            else if ((significant) && (t < 0) && (-change_percent >= threshold_percent))
+                pResult = "improvement";
+            else
+                pResult = "no significant change";
+        }
+
+        vogl_printf("%-8s %12.3f %12.3f %8.2f%% %9.3f %9.3f  %s\n", get_metric_name(static_cast<metric_t>(i)),
+                    base.get_mean(), cur.get_mean(), change_percent, t, t_crit, pResult);
+    }
+
+    return true;
+}
@@ -0,0 +1,131 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * Copyright 2010-2014 Rich Geldreich and Tenacious Software LLC
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_bench_report.h
+#ifndef VOGL_BENCH_REPORT_H
+#define VOGL_BENCH_REPORT_H
+
+#include "vogl_common.h"
+#include "vogl_timer.h"
+#include "vogl_sample_stats.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+// class vogl_bench_report
+// Collects per-frame times over repeated loops of the same frames (voglbench's -loop_frame/-loop_len), skipping the
+// first num_warmup_loops loops. Each frame records:
+//  cpu - wall time from the start of the frame until its swap returned
+//  gpu - wall time from the start of the frame until a glFinish() issued after its swap returned
+// The next frame starts once the glFinish() returns, so frames don't overlap.
+// Reports can be written as JSON or CSV, and compared against an earlier JSON report.
+//----------------------------------------------------------------------------------------------------------------------
+class vogl_bench_report
+{
+    VOGL_NO_COPY_OR_ASSIGNMENT_OP(vogl_bench_report);
+
+public:
+    enum metric_t
+    {
+        cMetricCPU,
+        cMetricGPU,
+        cTotalMetrics
+    };
+
+    vogl_bench_report();
+
+    void init(uint32_t num_warmup_loops, uint32_t num_measured_loops);
+    void clear();
+
+    bool is_enabled() const
+    {
+        return m_num_measured_loops != 0;
+    }
+
+    uint32_t get_num_warmup_loops() const
+    {
+        return m_num_warmup_loops;
+    }
+    uint32_t get_num_measured_loops() const
+    {
+        return m_num_measured_loops;
+    }
+
+    // Total number of loops (warm-up and measured) to replay.
+    uint32_t get_total_loops() const
+    {
+        return m_num_warmup_loops + m_num_measured_loops;
+    }
+
+    // Call when the looped frames start playing (after the loop's state has been restored and the GPU is idle).
+    void begin_loop();
+
+    // Call at each frame boundary inside a loop. cpu_end_ticks is when the swap returned, gpu_end_ticks is when the following glFinish() returned.
+    void end_frame(timer_ticks cpu_end_ticks, timer_ticks gpu_end_ticks);
+
+    // Index of the current loop, or -1 before the first loop started.
+    int get_cur_loop() const
+    {
+        return m_cur_loop;
+    }
+
+    const vogl::sample_stats &get_stats(metric_t metric) const
+    {
+        return m_stats[metric];
+    }
+
+    void print_summary() const;
+
+    // Writes JSON if the filename's extension is .json, otherwise CSV.
+    bool write(const char *pFilename) const;
+
+    // Compares against a report written earlier by write() as JSON. A metric regressed if its mean is at least threshold_percent slower
+    // and the difference is significant according to Welch's t-test (95%). Returns false if the baseline couldn't be read.
+    bool compare_to_baseline(const char *pFilename, double threshold_percent, bool &any_regressions) const;
+
+    static const char *get_metric_name(metric_t metric);
+
+private:
+    struct frame_sample
+    {
+        uint32_t m_loop;
+        uint32_t m_frame;
+        double m_times_ms[cTotalMetrics];
+    };
+
+    uint32_t m_num_warmup_loops;
+    uint32_t m_num_measured_loops;
+
+    int m_cur_loop;
+    uint32_t m_cur_loop_frame;
+    timer_ticks m_frame_start_ticks;
+
+    vogl::vector<frame_sample> m_frames;
+    vogl::sample_stats m_stats[cTotalMetrics];
+
+    bool write_csv(vogl::data_stream &stream) const;
+    bool write_json(vogl::data_stream &stream) const;
+};
+
+#endif // VOGL_BENCH_REPORT_H
@@ -1046,19 +1046,64 @@ vogl::data_stream *vogl_archive_blob_manager::open(const vogl::dynamic_string &i
 
     // TODO: Add some sort of streaming decompression support to miniz and this class.
 
-    mz_zip_clear_last_error(&m_zip);
+    // Only fetch the raw (possibly deflated) bytes while holding the archive lock, so multiple threads can inflate blobs concurrently.
+    mz_zip_archive_file_stat file_stat;
+    size_t comp_size;
+    void *pComp_buf;
+    {
+        scoped_mutex lock(m_zip_mutex);
 
-    size_t size;
-    void *pBuf = mz_zip_extract_to_heap(&m_zip, it->second.m_file_index, &size, 0);
-    if (!pBuf)
+        mz_zip_clear_last_error(&m_zip);
+
+        if (!mz_zip_file_stat(&m_zip, it->second.m_file_index, &file_stat))
+            pComp_buf = NULL;
+        else
+            pComp_buf = mz_zip_extract_to_heap(&m_zip, it->second.m_file_index, &comp_size, MZ_ZIP_FLAG_COMPRESSED_DATA);
+
+        if (!pComp_buf)
+        {
+            mz_zip_error mz_err = mz_zip_get_last_error(&m_zip);
+            vogl_error_printf("mz_zip_extract_to_heap() failed opening blob \"%s\", error 0x%X (%s)\n", id.get_ptr(), mz_err, mz_zip_get_error_string(mz_err));
+
+            return NULL;
+        }
+    }
+
+    VOGL_VERIFY(file_stat.m_uncomp_size == it->second.m_size);
+
+    if (!file_stat.m_method)
     {
-        mz_zip_error mz_err = mz_zip_get_last_error(&m_zip);
-        vogl_error_printf("mz_zip_extract_to_heap() failed opening blob \"%s\", error 0x%X (%s)\n", id.get_ptr(), mz_err, mz_zip_get_error_string(mz_err));
+        VOGL_VERIFY(comp_size == it->second.m_size);
+        return vogl_new(vogl::buffer_stream, pComp_buf, comp_size);
+    }
 
+    if ((file_stat.m_method != MZ_DEFLATED) || (file_stat.m_uncomp_size > static_cast<uint64_t>(cINT32_MAX)))
+    {
+        vogl_error_printf("Unsupported compression method %u or size for blob \"%s\"\n", file_stat.m_method, id.get_ptr());
+        mz_free(pComp_buf);
         return NULL;
     }
 
-    VOGL_VERIFY(size == it->second.m_size);
+    size_t size = static_cast<size_t>(file_stat.m_uncomp_size);
+
+    // mz_free() is used in close(), so allocate the decompressed block from the same heap miniz uses.
+    void *pBuf = vogl_malloc(math::maximum<size_t>(size, 1));
+    if (!pBuf)
+    {
+        mz_free(pComp_buf);
+        return NULL;
+    }
+
+    size_t actual_size = tinfl_decompress_mem_to_mem(pBuf, size, pComp_buf, comp_size, 0);
+
+    mz_free(pComp_buf);
+
+    if ((actual_size != size) || (mz_crc32(MZ_CRC32_INIT, static_cast<const uint8_t *>(pBuf), size) != file_stat.m_crc32))
+    {
+        vogl_error_printf("Failed decompressing blob \"%s\"\n", id.get_ptr());
+        vogl_free(pBuf);
+        return NULL;
+    }
 
     return vogl_new(vogl::buffer_stream, pBuf, size);
 }
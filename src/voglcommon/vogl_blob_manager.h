@@ -30,6 +30,7 @@
 #include "vogl_map.h"
 #include "vogl_data_stream.h"
 #include "vogl_miniz_zip.h"
+#include "vogl_threading.h"
 
 enum vogl_blob_manager_type_t
 {
@@ -338,6 +339,9 @@ private:
     mutable mz_zip_archive m_zip;
     dynamic_string m_archive_filename;
 
+    // Guards m_zip, so open() may be called from multiple threads. Only the compressed bytes are read under the lock, inflation happens outside of it.
+    mutable mutex m_zip_mutex;
+
     struct blob
     {
         vogl::dynamic_string m_id;
@@ -351,3 +351,23 @@ void vogl_set_direct_gl_func_epilog(vogl_gl_func_prolog_epilog_func_t pFunc, voi
     g_gl_func_epilog_func_ptr = pFunc;
     g_gl_func_epilog_func_user_data = pUser_data;
 }
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_get_direct_gl_func_prolog
+//----------------------------------------------------------------------------------------------------------------------
+vogl_gl_func_prolog_epilog_func_t vogl_get_direct_gl_func_prolog(void **ppUser_data)
+{
+    if (ppUser_data)
+        *ppUser_data = g_gl_func_prolog_func_user_data;
+    return g_gl_func_prolog_func_ptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_get_direct_gl_func_epilog
+//----------------------------------------------------------------------------------------------------------------------
+vogl_gl_func_prolog_epilog_func_t vogl_get_direct_gl_func_epilog(void **ppUser_data)
+{
+    if (ppUser_data)
+        *ppUser_data = g_gl_func_epilog_func_user_data;
+    return g_gl_func_epilog_func_ptr;
+}
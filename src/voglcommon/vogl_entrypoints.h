@@ -195,6 +195,8 @@ void vogl_init_actual_gl_entrypoints(vogl_gl_get_proc_address_helper_func_ptr_t
 typedef void (*vogl_gl_func_prolog_epilog_func_t)(gl_entrypoint_id_t entrypoint_id, void *pUser_data, void **pStack_data);
 void vogl_set_direct_gl_func_prolog(vogl_gl_func_prolog_epilog_func_t pFunc, void *pUser_data);
 void vogl_set_direct_gl_func_epilog(vogl_gl_func_prolog_epilog_func_t pFunc, void *pUser_data);
+vogl_gl_func_prolog_epilog_func_t vogl_get_direct_gl_func_prolog(void **ppUser_data);
+vogl_gl_func_prolog_epilog_func_t vogl_get_direct_gl_func_epilog(void **ppUser_data);
 
 void vogl_init_gl_entrypoint_descs();
 
@@ -26,6 +26,15 @@
 // File: vogl_fs_preprocessor.cpp
 #include "vogl_fs_preprocessor.h"
 #include "vogl_file_utils.h"
+#include "vogl_port.h"
+
+#if defined(PLATFORM_POSIX)
+    #include <unistd.h>
+    #include <signal.h>
+    #include <pthread.h>
+    #include <errno.h>
+    #include <sys/wait.h>
+#endif
 
 vogl_fs_preprocessor* vogl_fs_preprocessor::m_instance = 0;
 
@@ -43,7 +52,13 @@ vogl_fs_preprocessor::vogl_fs_preprocessor()
       m_null(false),
       m_tm(0),
       m_time_to_run_pp(0),
-      m_enabled(false)
+      m_enabled(false),
+      m_num_cache_hits(0),
+      m_num_cache_misses(0),
+      m_use_worker(false),
+      m_worker_pid(0),
+      m_worker_write_fd(-1),
+      m_worker_read_fd(-1)
 {
     VOGL_FUNC_TRACER
     m_null_color[0] = 0.6275;
@@ -63,6 +78,8 @@ void vogl_fs_preprocessor::cleanup()
 vogl_fs_preprocessor::~vogl_fs_preprocessor()
 {
     VOGL_FUNC_TRACER
+
+    _stop_worker();
 }
 
 void vogl_fs_preprocessor::reset()
@@ -86,6 +103,30 @@ void vogl_fs_preprocessor::reset()
     m_tm.start();
     m_time_to_run_pp = 0;
     m_enabled = false;
+
+    // The output cache is content addressed, so it stays valid across resets.
+    m_cache_dir.clear();
+    m_num_cache_hits = 0;
+    m_num_cache_misses = 0;
+
+    _stop_worker();
+    m_use_worker = false;
+}
+
+void vogl_fs_preprocessor::set_pp_cache_dir(const dynamic_string &cache_dir)
+{
+    m_cache_dir.clear();
+
+    if (cache_dir.is_empty())
+        return;
+
+    if ((!file_utils::does_dir_exist(cache_dir.get_ptr())) && (!file_utils::create_directories(cache_dir, false)))
+    {
+        vogl_warning_printf("Failed creating FS pre-processor cache directory \"%s\", only caching in memory\n", cache_dir.get_ptr());
+        return;
+    }
+
+    m_cache_dir = cache_dir;
 }
 
 // Internal class function wrapped by public run() call so that we can easily time how long pp takes
@@ -104,6 +145,43 @@ bool vogl_fs_preprocessor::_run()
         }
         m_in_shader = _set_null_output_color(m_in_shader);
     }
+
+    hash128_t key = _get_cache_key();
+    if (_find_cached_output(key))
+    {
+        m_num_cache_hits++;
+        _write_pp_prefix_files();
+        return true;
+    }
+
+    m_num_cache_misses++;
+
+    bool success = false;
+    if (m_use_worker)
+    {
+        success = _run_worker();
+        if (success)
+            _write_pp_prefix_files();
+        else
+        {
+            vogl_warning_printf("FS pre-processor worker failed, running the pre-processor once per shader from now on\n");
+            _stop_worker();
+            m_use_worker = false;
+        }
+    }
+
+    if (!success)
+        success = _run_pp_process();
+
+    if (success)
+        _add_cached_output(key);
+
+    return success;
+}
+
+// Runs the pp once for the current shader, passing it through temp files
+bool vogl_fs_preprocessor::_run_pp_process()
+{
     // Write input shader to a file to feed into pp
     //dynamic_string in_fs_filename("tmp_shader_in.frag");
     dynamic_string in_fs_filename("tmp_shader_in.frag");
@@ -154,6 +232,288 @@ bool vogl_fs_preprocessor::_run()
     return true;
 }
 
+// _run_pp_process() leaves its input and output shaders in the prefixed files, this writes the same files when the
+// output came from the cache or the worker instead.
+void vogl_fs_preprocessor::_write_pp_prefix_files()
+{
+    if (m_pp_prefix.is_empty())
+        return;
+
+    dynamic_string in_fs_filename(cVarArg, "%sshader_in_%i.frag", m_pp_prefix.get_ptr(), m_shader_id);
+    dynamic_string out_shader_filename(cVarArg, "%sshader_out_%i.frag", m_pp_prefix.get_ptr(), m_shader_id);
+
+    if ((!file_utils::write_string_to_file(in_fs_filename.get_ptr(), m_in_shader)) ||
+        (!file_utils::write_string_to_file(out_shader_filename.get_ptr(), m_output_shader)))
+    {
+        vogl_warning_printf("Failed writing FS pre-processor files with prefix \"%s\"\n", m_pp_prefix.get_ptr());
+    }
+}
+
+hash128_t vogl_fs_preprocessor::_get_cache_key() const
+{
+    dynamic_string key_str(cVarArg, "%s\n%s\n", m_pp_cmd.get_ptr(), m_pp_opts.get_ptr());
+    key_str.append(m_in_shader);
+
+    return calc_hash128(key_str.get_ptr(), key_str.get_len());
+}
+
+bool vogl_fs_preprocessor::_find_cached_output(const hash128_t &key)
+{
+    output_cache_map::const_iterator it = m_output_cache.find(key);
+    if (it != m_output_cache.end())
+    {
+        m_output_shader = it->second;
+    }
+    else
+    {
+        if (m_cache_dir.is_empty())
+            return false;
+
+        dynamic_string filename;
+        file_utils::combine_path(filename, m_cache_dir.get_ptr(), dynamic_string(cVarArg, "%016" PRIX64 "%016" PRIX64 ".frag", key.m_hi, key.m_lo).get_ptr());
+
+        uint8_vec data;
+        if ((!file_utils::does_file_exist(filename.get_ptr())) || (!file_utils::read_file_to_vec(filename.get_ptr(), data)) || (data.is_empty()))
+            return false;
+
+        m_output_shader.set_from_buf(data.get_ptr(), data.size());
+        m_output_cache.insert(key, m_output_shader);
+    }
+
+    m_count = 1;
+    m_length = m_output_shader.get_len();
+    return true;
+}
+
+void vogl_fs_preprocessor::_add_cached_output(const hash128_t &key)
+{
+    m_output_cache.insert(key, m_output_shader);
+
+    if (m_cache_dir.is_empty())
+        return;
+
+    dynamic_string filename;
+    file_utils::combine_path(filename, m_cache_dir.get_ptr(), dynamic_string(cVarArg, "%016" PRIX64 "%016" PRIX64 ".frag", key.m_hi, key.m_lo).get_ptr());
+
+    // Write to a temp file and rename it, so concurrent replayers sharing the cache dir never read a partial file.
+    dynamic_string temp_filename(cVarArg, "%s.%u.tmp", filename.get_ptr(), static_cast<uint32_t>(plat_getpid()));
+    if (!file_utils::write_string_to_file(temp_filename.get_ptr(), m_output_shader))
+    {
+        vogl_warning_printf("Failed writing FS pre-processor cache file \"%s\"\n", temp_filename.get_ptr());
+        remove(temp_filename.get_ptr());
+        return;
+    }
+
+    if (rename(temp_filename.get_ptr(), filename.get_ptr()) != 0)
+        remove(temp_filename.get_ptr());
+}
+
+#if defined(PLATFORM_POSIX)
+// If the worker has died, write() fails with EPIPE and we fall back to running the pp per shader. SIGPIPE is blocked on
+// this thread only while writing, and any SIGPIPE the write raised is consumed before the old mask is restored, so the
+// process-wide disposition the app or replayer set up is left alone.
+static bool fspp_write_all(int fd, const void *pBuf, size_t size)
+{
+    sigset_t sigpipe_mask, old_mask, pending;
+    sigemptyset(&sigpipe_mask);
+    sigaddset(&sigpipe_mask, SIGPIPE);
+
+    sigpending(&pending);
+    const bool sigpipe_was_pending = sigismember(&pending, SIGPIPE) == 1;
+
+    pthread_sigmask(SIG_BLOCK, &sigpipe_mask, &old_mask);
+
+    bool success = true;
+    const char *pSrc = static_cast<const char *>(pBuf);
+    while (size)
+    {
+        ssize_t n = write(fd, pSrc, size);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            if ((errno == EPIPE) && (!sigpipe_was_pending))
+            {
+                sigpending(&pending);
+                if (sigismember(&pending, SIGPIPE) == 1)
+                {
+                    int sig;
+                    sigwait(&sigpipe_mask, &sig);
+                }
+            }
+
+            success = false;
+            break;
+        }
+        pSrc += n;
+        size -= n;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+    return success;
+}
+
+static bool fspp_read_all(int fd, void *pBuf, size_t size)
+{
+    char *pDst = static_cast<char *>(pBuf);
+    while (size)
+    {
+        ssize_t n = read(fd, pDst, size);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (!n)
+            return false;
+        pDst += n;
+        size -= n;
+    }
+    return true;
+}
+#endif
+
+bool vogl_fs_preprocessor::_start_worker()
+{
+#if defined(PLATFORM_POSIX)
+    int to_worker[2], from_worker[2];
+    if (pipe(to_worker) != 0)
+        return false;
+
+    if (pipe(from_worker) != 0)
+    {
+        close(to_worker[0]);
+        close(to_worker[1]);
+        return false;
+    }
+
+    dynamic_string worker_cmd(cVarArg, "%s %s", m_pp_cmd.get_ptr(), m_pp_opts.get_ptr());
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(to_worker[0]);
+        close(to_worker[1]);
+        close(from_worker[0]);
+        close(from_worker[1]);
+        return false;
+    }
+
+    if (!pid)
+    {
+        dup2(to_worker[0], STDIN_FILENO);
+        dup2(from_worker[1], STDOUT_FILENO);
+        close(to_worker[0]);
+        close(to_worker[1]);
+        close(from_worker[0]);
+        close(from_worker[1]);
+
+        execl("/bin/sh", "sh", "-c", worker_cmd.get_ptr(), (char *)NULL);
+        _exit(127);
+    }
+
+    close(to_worker[0]);
+    close(from_worker[1]);
+
+    m_worker_pid = pid;
+    m_worker_write_fd = to_worker[1];
+    m_worker_read_fd = from_worker[0];
+
+    vogl_message_printf("Started FS pre-processor worker: %s\n", worker_cmd.get_ptr());
+    return true;
+#else
+    vogl_warning_printf("The FS pre-processor worker isn't supported on this platform\n");
+    return false;
+#endif
+}
+
+void vogl_fs_preprocessor::_stop_worker()
+{
+#if defined(PLATFORM_POSIX)
+    if (m_worker_pid <= 0)
+        return;
+
+    // Closing its stdin tells the worker to exit.
+    close(m_worker_write_fd);
+    close(m_worker_read_fd);
+
+    int status;
+    waitpid(m_worker_pid, &status, 0);
+#endif
+
+    m_worker_pid = 0;
+    m_worker_write_fd = -1;
+    m_worker_read_fd = -1;
+}
+
+// Worker protocol: the pp is started once as "<pp cmd> <pp opts>" and reads requests from stdin until EOF. Each request is
+// a text header "<shader id> <byte count>\n" followed by exactly that many bytes of shader source. The pp replies on stdout
+// with "<status> <byte count>\n" and that many bytes, which are the preprocessed shader if status is 0, or an error
+// message otherwise.
+bool vogl_fs_preprocessor::_run_worker()
+{
+#if defined(PLATFORM_POSIX)
+    if ((m_worker_pid <= 0) && (!_start_worker()))
+        return false;
+
+    dynamic_string header(cVarArg, "%u %u\n", m_shader_id, m_in_shader.get_len());
+    if ((!fspp_write_all(m_worker_write_fd, header.get_ptr(), header.get_len())) ||
+        (!fspp_write_all(m_worker_write_fd, m_in_shader.get_ptr(), m_in_shader.get_len())))
+    {
+        vogl_error_printf("Failed sending FS %u to the FS pre-processor worker\n", m_shader_id);
+        return false;
+    }
+
+    char reply_header[64];
+    uint32_t reply_header_len = 0;
+    for (;;)
+    {
+        if ((reply_header_len == sizeof(reply_header) - 1) || (!fspp_read_all(m_worker_read_fd, &reply_header[reply_header_len], 1)))
+        {
+            vogl_error_printf("Failed reading reply for FS %u from the FS pre-processor worker\n", m_shader_id);
+            return false;
+        }
+        if (reply_header[reply_header_len] == '\n')
+            break;
+        reply_header_len++;
+    }
+    reply_header[reply_header_len] = '\0';
+
+    int status = 0;
+    uint32_t reply_size = 0;
+    if ((sscanf(reply_header, "%d %u", &status, &reply_size) != 2) || (reply_size > 256U * 1024U * 1024U))
+    {
+        vogl_error_printf("Invalid reply header \"%s\" from the FS pre-processor worker\n", reply_header);
+        return false;
+    }
+
+    vogl::vector<char> reply(reply_size);
+    if ((reply_size) && (!fspp_read_all(m_worker_read_fd, reply.get_ptr(), reply_size)))
+    {
+        vogl_error_printf("Failed reading reply for FS %u from the FS pre-processor worker\n", m_shader_id);
+        return false;
+    }
+
+    dynamic_string reply_str;
+    reply_str.set_from_buf(reply.get_ptr(), reply_size);
+
+    if (status != 0)
+    {
+        vogl_error_printf("FS pre-processor worker failed on FS %u (status %i):\n%s\n", m_shader_id, status, reply_str.get_ptr());
+        return false;
+    }
+
+    m_output_shader.swap(reply_str);
+    m_count = 1;
+    m_length = m_output_shader.get_len();
+    return true;
+#else
+    return false;
+#endif
+}
+
 bool vogl_fs_preprocessor::run()
 {
     double pp_start = m_tm.get_elapsed_secs();
@@ -33,6 +33,8 @@
 
 #include "vogl_common.h"
 #include "vogl_dynamic_string.h"
+#include "vogl_hash.h"
+#include "vogl_hash_map.h"
 
 #include "vogl_common.h"
 
@@ -75,6 +77,15 @@ public:
     {
         m_pp_prefix = pp_prefix;
     }
+    // Outputs are always cached in memory, keyed by a hash of the pp command, options and input shader. With a cache dir
+    // they're also kept on disk, so later runs never launch the pp for a shader it has already seen.
+    void set_pp_cache_dir(const dynamic_string &cache_dir);
+    // Start the pp once and stream every shader through it, instead of launching it per shader. The pp must implement
+    // the worker protocol documented above _run_worker() in vogl_fs_preprocessor.cpp.
+    void set_use_worker(bool use_worker)
+    {
+        m_use_worker = use_worker;
+    }
     GLsizei get_count() const
     {
         return m_count;        
@@ -95,6 +106,14 @@ public:
     {
         return m_time_to_run_pp;
     }
+    uint32_t get_num_cache_hits() const
+    {
+        return m_num_cache_hits;
+    }
+    uint32_t get_num_cache_misses() const
+    {
+        return m_num_cache_misses;
+    }
     void set_null(bool null_value)
     {
         m_null = null_value;
@@ -125,6 +144,14 @@ private:
     vogl_fs_preprocessor(const vogl_fs_preprocessor&);
     vogl_fs_preprocessor& operator=(const vogl_fs_preprocessor&);
     bool _run();
+    bool _run_pp_process();
+    bool _run_worker();
+    bool _start_worker();
+    void _stop_worker();
+    hash128_t _get_cache_key() const;
+    bool _find_cached_output(const hash128_t &key);
+    void _add_cached_output(const hash128_t &key);
+    void _write_pp_prefix_files();
     dynamic_string _check_opts(const dynamic_string &in_opts); // set internal state
     dynamic_string _set_null_output_color(dynamic_string in_shader);
 
@@ -145,6 +172,17 @@ private:
     timer m_tm;
     double m_time_to_run_pp;
     bool m_enabled; // is pp enabled?
+
+    typedef vogl::hash_map<hash128_t, dynamic_string, bit_hasher<hash128_t> > output_cache_map;
+    output_cache_map m_output_cache;
+    dynamic_string m_cache_dir;
+    uint32_t m_num_cache_hits;
+    uint32_t m_num_cache_misses;
+
+    bool m_use_worker;
+    int m_worker_pid;
+    int m_worker_write_fd; // worker's stdin
+    int m_worker_read_fd;  // worker's stdout
 };
 
 #endif // VOGL_FS_PREPROCESSOR_H
@@ -27,6 +27,8 @@
 #include "vogl_gl_replayer.h"
 #include "vogl_general_context_state.h"
 #include "vogl_sync_object.h"
+#include "vogl_program_binary_cache.h"
+#include "vogl_shader_utils.h"
 #include "vogl_trace_file_writer.h"
 #include "vogl_texture_format.h"
 #include "gl_glx_cgl_wgl_replay_helper_macros.inc"
@@ -230,11 +232,13 @@ vogl_gl_replayer::vogl_gl_replayer()
       m_pending_window_resize_attempt_counter(false),
       m_frame_index(0),
       m_total_swaps(0),
+      m_total_forced_context_switches(0),
       m_last_parsed_call_counter(-1),
       m_last_processed_call_counter(-1),
       m_cur_trace_context(0),
       m_cur_replay_context(NULL),
       m_pCur_context_state(NULL),
+      m_cur_packet_uses_client_side_arrays(false),
       m_frame_draw_counter(0),
       m_frame_draw_counter_kill_threshold(cUINT64_MAX),
       m_is_valid(false),
@@ -243,6 +247,7 @@ vogl_gl_replayer::vogl_gl_replayer()
       m_delete_pending_snapshot_after_applying(false),
       m_proc_address_helper_func(NULL),
       m_wrap_all_gl_calls(false),
+      m_pProfiler(NULL),
       m_replay_to_trace_remapper(*this)
 
 {
@@ -250,6 +255,8 @@ vogl_gl_replayer::vogl_gl_replayer()
 
     m_trace_gl_ctypes.init();
     m_fs_pp = vogl_fs_preprocessor::get_instance();
+
+    utils::zero_object(m_restore_object_type_times);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -307,9 +314,11 @@ bool vogl_gl_replayer::init(uint32_t flags, vogl_replay_window *pWindow, const v
     }
 
     m_pCur_gl_packet = NULL;
+    m_cur_packet_uses_client_side_arrays = false;
 
     m_frame_index = 0;
     m_total_swaps = 0;
+    m_total_forced_context_switches = 0;
     m_last_parsed_call_counter = 0;
     m_last_processed_call_counter = 0;
 
@@ -352,9 +361,11 @@ void vogl_gl_replayer::deinit()
     m_ctypes_packet.reset();
 
     m_pCur_gl_packet = NULL;
+    m_cur_packet_uses_client_side_arrays = false;
 
     m_frame_index = 0;
     m_total_swaps = 0;
+    m_total_forced_context_switches = 0;
     m_last_parsed_call_counter = 0;
     m_last_processed_call_counter = 0;
 
@@ -446,7 +457,18 @@ vogl_gl_replayer::status_t vogl_gl_replayer::process_pending_packets()
 vogl_gl_replayer::status_t vogl_gl_replayer::process_next_packet(const vogl_trace_packet &gl_packet)
 {
     // TODO: Fix const correctness
-    return process_gl_entrypoint_packet((vogl_trace_packet &)gl_packet);
+    if (!m_pProfiler)
+        return process_gl_entrypoint_packet((vogl_trace_packet &)gl_packet);
+
+    uint32_t frame_index = m_frame_index;
+
+    m_pProfiler->begin_call();
+
+    status_t status = process_gl_entrypoint_packet((vogl_trace_packet &)gl_packet);
+
+    m_pProfiler->end_call(gl_packet, frame_index);
+
+    return status;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -456,6 +478,8 @@ vogl_gl_replayer::status_t vogl_gl_replayer::process_next_packet(vogl_trace_file
 {
     VOGL_FUNC_TRACER
 
+    timer_ticks decode_start_ticks = m_pProfiler ? timer::get_ticks() : 0;
+
     vogl_trace_file_reader::trace_file_reader_status_t read_status = trace_reader.read_next_packet();
     if (read_status == vogl_trace_file_reader::cEOF)
     {
@@ -486,6 +510,9 @@ vogl_gl_replayer::status_t vogl_gl_replayer::process_next_packet(vogl_trace_file
                 break;
             }
 
+            if (m_pProfiler)
+                m_pProfiler->add_decode_ticks(timer::get_ticks() - decode_start_ticks);
+
             status = process_pending_packets();
 
             if (status == cStatusOK)
@@ -518,6 +545,32 @@ vogl_gl_replayer::status_t vogl_gl_replayer::process_next_packet(vogl_trace_file
     return status;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_gl_replayer::process_next_packet
+// Replays the next packet of pre-decoded frames. Returns cStatusAtEOF once their cursor reaches the end.
+//----------------------------------------------------------------------------------------------------------------------
+vogl_gl_replayer::status_t vogl_gl_replayer::process_next_packet(vogl_predecoded_frames &frames)
+{
+    VOGL_FUNC_TRACER
+
+    const vogl_trace_packet *pPacket = frames.get_next_packet();
+    if (!pPacket)
+        return cStatusAtEOF;
+
+    status_t status = process_pending_packets();
+
+    if (status == cStatusOK)
+        status = process_next_packet(*pPacket);
+
+    if (status < 0)
+    {
+        vogl_error_printf("%s failure processing GL entrypoint packet\n",
+                          (status == cStatusHardFailure) ? "Hard" : "Soft");
+    }
+
+    return status;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 // vogl_gl_replayer::process_pending_window_resize
 //----------------------------------------------------------------------------------------------------------------------
@@ -1125,6 +1178,7 @@ bool vogl_gl_replayer::set_client_side_array_data(const key_value_map &map, GLui
 
             VOGL_ASSERT((first_vertex_ofs + bytes_to_copy) <= array_data.size());
 
+            m_cur_packet_uses_client_side_arrays = true;
             memcpy(array_data.get_ptr() + first_vertex_ofs, pVertex_blob->get_ptr(), bytes_to_copy);
         }
     }
@@ -1232,6 +1286,7 @@ bool vogl_gl_replayer::set_client_side_vertex_attrib_array_data(const key_value_
 
         VOGL_ASSERT((first_vertex_ofs + bytes_to_copy) <= m_client_side_vertex_attrib_data[vertex_attrib_index].size());
 
+        m_cur_packet_uses_client_side_arrays = true;
         memcpy(m_client_side_vertex_attrib_data[vertex_attrib_index].get_ptr() + first_vertex_ofs, pVertex_blob->get_ptr(), bytes_to_copy);
     }
 
@@ -1553,9 +1608,47 @@ vogl_gl_replayer::status_t vogl_gl_replayer::switch_contexts(vogl_trace_context_
     m_cur_replay_context = replay_context;
     m_pCur_context_state = pContext_state;
 
+    m_total_forced_context_switches++;
+
     return cStatusOK;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_gl_replayer::get_thread_context_binding
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_gl_replayer::get_thread_context_binding(thread_context_binding &binding) const
+{
+    binding.m_trace_context = m_cur_trace_context;
+    binding.m_replay_context = m_cur_replay_context;
+    binding.m_pCur_gl_packet = m_pCur_gl_packet;
+    binding.m_last_parsed_call_counter = m_last_parsed_call_counter;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_gl_replayer::set_thread_context_binding
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_gl_replayer::set_thread_context_binding(const thread_context_binding &binding)
+{
+    m_pCur_gl_packet = binding.m_pCur_gl_packet;
+    if (binding.m_pCur_gl_packet)
+        m_last_parsed_call_counter = binding.m_last_parsed_call_counter;
+
+    // Look the context up again, another thread may have destroyed it since the binding was saved.
+    context_state *pContext_state = binding.m_trace_context ? get_trace_context_state(binding.m_trace_context) : NULL;
+
+    if ((!pContext_state) || (pContext_state->m_replay_context != binding.m_replay_context))
+    {
+        m_cur_trace_context = 0;
+        m_cur_replay_context = 0;
+        m_pCur_context_state = NULL;
+        return;
+    }
+
+    m_cur_trace_context = binding.m_trace_context;
+    m_cur_replay_context = binding.m_replay_context;
+    m_pCur_context_state = pContext_state;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 // vogl_gl_replayer::debug_callback_arb
 //----------------------------------------------------------------------------------------------------------------------
@@ -2862,6 +2955,11 @@ void vogl_gl_replayer::handle_link_program(gl_entrypoint_id_t entrypoint_id)
         process_entrypoint_warning("Handle is not a program, trace program 0x%X replay program 0x%X\n", trace_handle, replay_handle);
     }
 
+    // Programs linked from sources can be served from the on-disk program binary cache, keyed by everything that goes into the link.
+    vogl_program_binary_cache *pBinary_cache = vogl_program_binary_cache::get_instance();
+    bool use_binary_cache = (entrypoint_id != VOGL_ENTRYPOINT_glProgramBinary) && (pBinary_cache->is_usable(m_pCur_context_state->m_context_info));
+    vogl_program_binary_cache::key_builder cache_key_builder(m_pCur_context_state->m_context_info);
+
     const json_document *pDoc = m_pCur_gl_packet->get_key_value_map().get_json_document("metadata");
 
     if (!pDoc)
@@ -2878,6 +2976,8 @@ void vogl_gl_replayer::handle_link_program(gl_entrypoint_id_t entrypoint_id)
     {
         const json_node &doc_root = *pDoc->get_root();
 
+        cache_key_builder.add_link_metadata(doc_root);
+
         const json_node *pAttrib_node = doc_root.find_child_array("active_attribs");
         if (pAttrib_node)
         {
@@ -2975,32 +3075,72 @@ void vogl_gl_replayer::handle_link_program(gl_entrypoint_id_t entrypoint_id)
         }
     }
 
-    switch (entrypoint_id)
+    bool linked_from_binary_cache = false;
+    hash128_t binary_cache_key;
+
+    if (use_binary_cache)
     {
-        case VOGL_ENTRYPOINT_glLinkProgram:
-        {
-            GL_ENTRYPOINT(glLinkProgram)(replay_handle);
-            break;
-        }
-        case VOGL_ENTRYPOINT_glLinkProgramARB:
+        cache_key_builder.add_attached_shaders(replay_handle);
+
+        if ((m_pCur_context_state->m_context_info.get_version() >= VOGL_GL_VERSION_4_1) || (m_pCur_context_state->m_context_info.supports_extension("GL_ARB_separate_shader_objects")))
         {
-            GL_ENTRYPOINT(glLinkProgramARB)(replay_handle);
-            break;
+            GLint separable = GL_FALSE;
+            GL_ENTRYPOINT(glGetProgramiv)(replay_handle, GL_PROGRAM_SEPARABLE, &separable);
+            check_gl_error();
+            cache_key_builder.set_separable(separable != GL_FALSE);
         }
-        case VOGL_ENTRYPOINT_glProgramBinary:
+
+        use_binary_cache = cache_key_builder.get_num_shaders() > 0;
+    }
+
+    if (use_binary_cache)
+    {
+        binary_cache_key = cache_key_builder.get_key();
+
+        linked_from_binary_cache = pBinary_cache->load(replay_handle, binary_cache_key);
+        if (!linked_from_binary_cache)
+            pBinary_cache->prepare_for_link(replay_handle);
+    }
+
+    if (!linked_from_binary_cache)
+    {
+        switch (entrypoint_id)
         {
-            GL_ENTRYPOINT(glProgramBinary)(replay_handle, m_pCur_gl_packet->get_param_value<GLenum>(1), m_pCur_gl_packet->get_param_client_memory<GLvoid>(2), m_pCur_gl_packet->get_param_value<GLsizei>(3));
-            break;
+            case VOGL_ENTRYPOINT_glLinkProgram:
+            {
+                GL_ENTRYPOINT(glLinkProgram)(replay_handle);
+                break;
+            }
+            case VOGL_ENTRYPOINT_glLinkProgramARB:
+            {
+                GL_ENTRYPOINT(glLinkProgramARB)(replay_handle);
+                break;
+            }
+            case VOGL_ENTRYPOINT_glProgramBinary:
+            {
+                GL_ENTRYPOINT(glProgramBinary)(replay_handle, m_pCur_gl_packet->get_param_value<GLenum>(1), m_pCur_gl_packet->get_param_client_memory<GLvoid>(2), m_pCur_gl_packet->get_param_value<GLsizei>(3));
+                break;
+            }
+            default:
+            {
+                VOGL_ASSERT_ALWAYS;
+                return;
+            }
         }
-        default:
+
+        check_gl_error();
+
+        if (use_binary_cache)
         {
-            VOGL_ASSERT_ALWAYS;
-            return;
+            GLint link_status = GL_FALSE;
+            GL_ENTRYPOINT(glGetProgramiv)(replay_handle, GL_LINK_STATUS, &link_status);
+            check_gl_error();
+
+            if (link_status)
+                pBinary_cache->store(replay_handle, binary_cache_key);
         }
     }
 
-    check_gl_error();
-
     handle_post_link_program(entrypoint_id, trace_handle, replay_handle, GL_NONE, 0, NULL);
 }
 
@@ -3757,6 +3897,7 @@ vogl_gl_replayer::status_t vogl_gl_replayer::process_pending_gl_entrypoint_packe
 vogl_gl_replayer::status_t vogl_gl_replayer::process_gl_entrypoint_packet(vogl_trace_packet& trace_packet)
 {
     m_pCur_gl_packet = &trace_packet;
+    m_cur_packet_uses_client_side_arrays = false;
 
     status_t status = cStatusOK;
 
@@ -11437,10 +11578,23 @@ vogl_gl_replayer::status_t vogl_gl_replayer::restore_objects(
     vogl_verbose_printf("Restoring %s objects\n", get_gl_object_state_type_str(state_type));
 
     vogl::timer tm;
-    if (m_flags & cGLReplayerVerboseMode)
-        tm.start();
+    tm.start();
 
     const vogl_gl_object_state_ptr_vec &object_ptrs = context_state.get_objects();
+    const vogl_context_info &context_info = m_pCur_context_state->m_context_info;
+
+    // Shaders and programs are restored in two passes: all the compiles and links are submitted first, and their statuses
+    // are only read back once everything is queued. Checking each status right away would serialize the driver's compiler.
+    const bool two_pass = (state_type == cGLSTShader) || (state_type == cGLSTProgram);
+    if (two_pass)
+    {
+        if (vogl_enable_parallel_shader_compile(context_info, m_proc_address_helper_func ? m_proc_address_helper_func : vogl_get_proc_address_helper))
+            vogl_verbose_printf("Parallel shader compilation enabled\n");
+    }
+
+    uint_vec pending_object_indices;
+    vogl::vector<GLuint64> pending_handles;
+    vogl::vector<vogl_program_restore_pending> pending_programs;
 
     uint32_t n = 0;
 
@@ -11452,106 +11606,164 @@ vogl_gl_replayer::status_t vogl_gl_replayer::restore_objects(
             continue;
 
         GLuint64 restore_handle = 0;
-        if (!pState_obj->restore(m_pCur_context_state->m_context_info, trace_to_replay_remapper, restore_handle))
+        bool restored;
+
+        if (state_type == cGLSTShader)
+            restored = static_cast<const vogl_shader_state *>(pState_obj)->restore_begin(context_info, trace_to_replay_remapper, restore_handle);
+        else if (state_type == cGLSTProgram)
+        {
+            pending_programs.enlarge(1);
+            restored = static_cast<const vogl_program_state *>(pState_obj)->restore_begin(context_info, trace_to_replay_remapper, pending_programs.back());
+            restore_handle = pending_programs.back().m_handle;
+        }
+        else
+            restored = pState_obj->restore(context_info, trace_to_replay_remapper, restore_handle);
+
+        if (!restored)
         {
             vogl_error_printf("Failed restoring object type %s object index %u trace handle 0x%" PRIX64 " restore handle 0x%" PRIX64 "\n", get_gl_object_state_type_str(state_type), i, (uint64_t)pState_obj->get_snapshot_handle(), (uint64_t)restore_handle);
             return cStatusHardFailure;
         }
-        n++;
 
-        if (pState_obj->get_marked_for_deletion())
+        if (two_pass)
         {
-            objects_to_delete.push_back(pState_obj);
+            pending_object_indices.push_back(i);
+            pending_handles.push_back(restore_handle);
+            continue;
         }
 
-        VOGL_ASSERT(trace_to_replay_remapper.remap_handle(pState_obj->get_handle_namespace(), pState_obj->get_snapshot_handle()) == restore_handle);
+        n++;
 
-        switch (pState_obj->get_type())
+        finish_restoring_object(trace_to_replay_remapper, pState_obj, i, restore_handle, objects_to_delete);
+    }
+
+    for (uint32_t j = 0; j < pending_object_indices.size(); j++)
+    {
+        uint32_t i = pending_object_indices[j];
+        const vogl_gl_object_state *pState_obj = object_ptrs[i];
+        GLuint64 restore_handle = pending_handles[j];
+
+        if (state_type == cGLSTShader)
         {
-            case cGLSTQuery:
+            static_cast<const vogl_shader_state *>(pState_obj)->restore_end(restore_handle);
+        }
+        else
+        {
+            if (!static_cast<const vogl_program_state *>(pState_obj)->restore_end(context_info, trace_to_replay_remapper, pending_programs[j]))
             {
-                const vogl_query_state *pQuery = static_cast<const vogl_query_state *>(pState_obj);
+                vogl_error_printf("Failed restoring object type %s object index %u trace handle 0x%" PRIX64 " restore handle 0x%" PRIX64 "\n", get_gl_object_state_type_str(state_type), i, (uint64_t)pState_obj->get_snapshot_handle(), (uint64_t)restore_handle);
+                return cStatusHardFailure;
+            }
+        }
 
-                VOGL_ASSERT(restore_handle <= cUINT32_MAX);
-                get_shared_state()->m_query_targets[static_cast<GLuint>(restore_handle)] = pQuery->get_target();
+        n++;
 
-                break;
-            }
-            case cGLSTProgram:
-            {
-                const vogl_program_state *pProg = static_cast<const vogl_program_state *>(pState_obj);
+        finish_restoring_object(trace_to_replay_remapper, pState_obj, i, restore_handle, objects_to_delete);
+
+        if ((state_type == cGLSTProgram) && ((n & 255) == 255))
+            vogl_verbose_printf("Restored %u programs\n", n);
+    }
+
+    tm.stop();
+    m_restore_object_type_times[state_type] += tm.get_elapsed_secs();
+
+    if (m_flags & cGLReplayerVerboseMode)
+    {
+        vogl_verbose_printf("Restore took %f secs\n", tm.get_elapsed_secs());
+        vogl_verbose_printf("Finished restoring %u %s objects\n", n, get_gl_object_state_type_str(state_type));
+    }
+
+    return cStatusOK;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_gl_replayer::finish_restoring_object
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_gl_replayer::finish_restoring_object(vogl_handle_remapper &trace_to_replay_remapper, const vogl_gl_object_state *pState_obj, uint32_t i, GLuint64 restore_handle, vogl_const_gl_object_state_ptr_vec &objects_to_delete)
+{
+    VOGL_FUNC_TRACER
+
+    if (pState_obj->get_marked_for_deletion())
+    {
+        objects_to_delete.push_back(pState_obj);
+    }
+
+    VOGL_ASSERT(trace_to_replay_remapper.remap_handle(pState_obj->get_handle_namespace(), pState_obj->get_snapshot_handle()) == restore_handle);
+
+    switch (pState_obj->get_type())
+    {
+        case cGLSTQuery:
+        {
+            const vogl_query_state *pQuery = static_cast<const vogl_query_state *>(pState_obj);
+
+            VOGL_ASSERT(restore_handle <= cUINT32_MAX);
+            get_shared_state()->m_query_targets[static_cast<GLuint>(restore_handle)] = pQuery->get_target();
 
-                if (pProg->has_link_time_snapshot())
+            break;
+        }
+        case cGLSTProgram:
+        {
+            const vogl_program_state *pProg = static_cast<const vogl_program_state *>(pState_obj);
+
+            if (pProg->has_link_time_snapshot())
+            {
+                vogl_program_state link_snapshot(*pProg->get_link_time_snapshot());
+                if (!link_snapshot.remap_handles(trace_to_replay_remapper))
                 {
-                    vogl_program_state link_snapshot(*pProg->get_link_time_snapshot());
-                    if (!link_snapshot.remap_handles(trace_to_replay_remapper))
-                    {
-                        vogl_error_printf("Failed remapping handles in program link time snapshot, object index %u trace handle 0x%" PRIX64 " restore handle 0x%" PRIX64 "\n", i, (uint64_t)pState_obj->get_snapshot_handle(), (uint64_t)restore_handle);
-                    }
-                    else
-                    {
-                        get_shared_state()->m_shadow_state.m_linked_programs.add_snapshot(static_cast<uint32_t>(restore_handle), link_snapshot);
-                    }
+                    vogl_error_printf("Failed remapping handles in program link time snapshot, object index %u trace handle 0x%" PRIX64 " restore handle 0x%" PRIX64 "\n", i, (uint64_t)pState_obj->get_snapshot_handle(), (uint64_t)restore_handle);
+                }
+                else
+                {
+                    get_shared_state()->m_shadow_state.m_linked_programs.add_snapshot(static_cast<uint32_t>(restore_handle), link_snapshot);
                 }
-
-                if ((n & 255) == 255)
-                    vogl_verbose_printf("Restored %u programs\n", n);
-                break;
             }
-            case cGLSTBuffer:
-            {
-                const vogl_buffer_state *pBuf = static_cast<const vogl_buffer_state *>(pState_obj);
 
-                // Check if the buffer was mapped during the snapshot, if so remap it and record the ptr in the replayer's context shadow.
-                if (pBuf->get_is_mapped())
-                {
-                    vogl_mapped_buffer_desc map_desc;
-                    map_desc.m_buffer = static_cast<GLuint>(restore_handle);
-                    map_desc.m_target = pBuf->get_target();
-                    map_desc.m_offset = pBuf->get_map_ofs();
-                    map_desc.m_length = pBuf->get_map_size();
-                    map_desc.m_access = pBuf->get_map_access();
-                    map_desc.m_range = pBuf->get_is_map_range();
+            break;
+        }
+        case cGLSTBuffer:
+        {
+            const vogl_buffer_state *pBuf = static_cast<const vogl_buffer_state *>(pState_obj);
 
-                    GLuint prev_handle = vogl_get_bound_gl_buffer(map_desc.m_target);
+            // Check if the buffer was mapped during the snapshot, if so remap it and record the ptr in the replayer's context shadow.
+            if (pBuf->get_is_mapped())
+            {
+                vogl_mapped_buffer_desc map_desc;
+                map_desc.m_buffer = static_cast<GLuint>(restore_handle);
+                map_desc.m_target = pBuf->get_target();
+                map_desc.m_offset = pBuf->get_map_ofs();
+                map_desc.m_length = pBuf->get_map_size();
+                map_desc.m_access = pBuf->get_map_access();
+                map_desc.m_range = pBuf->get_is_map_range();
 
-                    GL_ENTRYPOINT(glBindBuffer)(map_desc.m_target, map_desc.m_buffer);
-                    VOGL_CHECK_GL_ERROR;
+                GLuint prev_handle = vogl_get_bound_gl_buffer(map_desc.m_target);
 
-                    uint32_t access = map_desc.m_access & ~(GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
-                    if (map_desc.m_range)
-                    {
-                        map_desc.m_pPtr = GL_ENTRYPOINT(glMapBufferRange)(map_desc.m_target, static_cast<GLintptr>(map_desc.m_offset), static_cast<GLintptr>(map_desc.m_length), access);
-                        VOGL_CHECK_GL_ERROR;
-                    }
-                    else
-                    {
-                        map_desc.m_pPtr = GL_ENTRYPOINT(glMapBuffer)(map_desc.m_target, access);
-                        VOGL_CHECK_GL_ERROR;
-                    }
+                GL_ENTRYPOINT(glBindBuffer)(map_desc.m_target, map_desc.m_buffer);
+                VOGL_CHECK_GL_ERROR;
 
-                    GL_ENTRYPOINT(glBindBuffer)(map_desc.m_target, prev_handle);
+                uint32_t access = map_desc.m_access & ~(GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+                if (map_desc.m_range)
+                {
+                    map_desc.m_pPtr = GL_ENTRYPOINT(glMapBufferRange)(map_desc.m_target, static_cast<GLintptr>(map_desc.m_offset), static_cast<GLintptr>(map_desc.m_length), access);
+                    VOGL_CHECK_GL_ERROR;
+                }
+                else
+                {
+                    map_desc.m_pPtr = GL_ENTRYPOINT(glMapBuffer)(map_desc.m_target, access);
                     VOGL_CHECK_GL_ERROR;
-
-                    vogl_mapped_buffer_desc_vec &mapped_bufs = get_shared_state()->m_shadow_state.m_mapped_buffers;
-                    mapped_bufs.push_back(map_desc);
                 }
 
-                break;
+                GL_ENTRYPOINT(glBindBuffer)(map_desc.m_target, prev_handle);
+                VOGL_CHECK_GL_ERROR;
+
+                vogl_mapped_buffer_desc_vec &mapped_bufs = get_shared_state()->m_shadow_state.m_mapped_buffers;
+                mapped_bufs.push_back(map_desc);
             }
-            default:
-                break;
-        }
-    }
 
-    if (m_flags & cGLReplayerVerboseMode)
-    {
-        tm.stop();
-        vogl_verbose_printf("Restore took %f secs\n", tm.get_elapsed_secs());
-        vogl_verbose_printf("Finished restoring %u %s objects\n", n, get_gl_object_state_type_str(state_type));
+            break;
+        }
+        default:
+            break;
     }
-
-    return cStatusOK;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -12153,6 +12365,8 @@ vogl_gl_replayer::status_t vogl_gl_replayer::process_applying_pending_snapshot()
 
     trace_to_replay_handle_remapper trace_to_replay_remapper(*this);
 
+    utils::zero_object(m_restore_object_type_times);
+
     m_frame_index = snapshot.get_frame_index();
     m_last_parsed_call_counter = snapshot.get_gl_call_counter();
     m_last_processed_call_counter = snapshot.get_gl_call_counter();
@@ -12306,6 +12520,16 @@ vogl_gl_replayer::status_t vogl_gl_replayer::process_applying_pending_snapshot()
         handle_marked_for_deleted_objects(objects_to_delete, trace_to_replay_remapper);
     }
 
+    if (m_flags & cGLReplayerVerboseMode)
+    {
+        vogl_verbose_printf("Snapshot object restore times:\n");
+        for (uint32_t i = 0; i < cGLSTTotalTypes; i++)
+        {
+            if (m_restore_object_type_times[i] > 0.0f)
+                vogl_verbose_printf("  %s: %.3f secs\n", get_gl_object_state_type_str(static_cast<vogl_gl_object_state_type>(i)), m_restore_object_type_times[i]);
+        }
+    }
+
     destroy_pending_snapshot();
 
     return cStatusOK;
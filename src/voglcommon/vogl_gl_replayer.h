@@ -33,9 +33,12 @@
 #include "vogl_trace_stream_types.h"
 #include "vogl_trace_packet.h"
 #include "vogl_trace_file_reader.h"
+#include "vogl_predecoded_frames.h"
+#include "vogl_replay_profiler.h"
 #include "vogl_context_info.h"
 
 #include "vogl_replay_window.h"
+#include "vogl_dense_hash_map.h"
 #include "vogl_gl_state_snapshot.h"
 #include "vogl_blob_manager.h"
 #include "vogl_fs_preprocessor.h"
@@ -182,6 +185,18 @@ public:
     {
         m_fs_pp->set_pp_prefix(str);
     }
+    void set_fs_preprocessor_cache_dir(const dynamic_string &str)
+    {
+        m_fs_pp->set_pp_cache_dir(str);
+    }
+    void set_fs_preprocessor_use_worker(bool use_worker)
+    {
+        m_fs_pp->set_use_worker(use_worker);
+    }
+    const vogl_fs_preprocessor *get_fs_preprocessor() const
+    {
+        return m_fs_pp;
+    }
     double get_fs_pp_time() const
     {
         return m_fs_pp->get_pp_time();
@@ -192,6 +207,60 @@ public:
         m_allow_snapshot_restoring = bAllowed;
     }
 
+    // Optional per-call profiler, not owned by the replayer. NULL disables profiling.
+    // With the null GL driver (vogl_null_gl.h) the profile is purely the replayer's own CPU overhead.
+    void set_profiler(vogl_replay_profiler *pProfiler)
+    {
+        m_pProfiler = pProfiler;
+    }
+    vogl_replay_profiler *get_profiler() const
+    {
+        return m_pProfiler;
+    }
+
+    // The current context of one replay thread, and the packet it's in the middle of replaying (if any). Lets several
+    // threads share one replayer (see vogl_threaded_replayer.h), each keeping its own contexts current on its own OS
+    // thread, instead of switching contexts on every call. The caller must serialize all access to the replayer, but
+    // can let another thread in while a packet's GL call is in the driver, as long as it restores the binding after.
+    struct thread_context_binding
+    {
+        vogl_trace_context_ptr_value m_trace_context;
+        GLReplayContextType m_replay_context;
+
+        const vogl_trace_packet *m_pCur_gl_packet;
+        int64_t m_last_parsed_call_counter;
+
+        thread_context_binding()
+            : m_trace_context(0), m_replay_context(0), m_pCur_gl_packet(NULL), m_last_parsed_call_counter(-1)
+        {
+        }
+    };
+
+    void get_thread_context_binding(thread_context_binding &binding) const;
+    // Doesn't call MakeCurrent, the binding must already be current on the calling thread. Bindings to contexts which
+    // have since been destroyed are treated as no context.
+    void set_thread_context_binding(const thread_context_binding &binding);
+
+    // True if the packet being replayed copied client side vertex data into the replayer's shared client side arrays,
+    // so its draw call reads memory other contexts' draws write to.
+    bool get_cur_packet_uses_client_side_arrays() const
+    {
+        return m_cur_packet_uses_client_side_arrays;
+    }
+
+    // Number of MakeCurrents done by the replayer that aren't in the trace, because consecutive packets came from different contexts.
+    uint32_t get_total_forced_context_switches() const
+    {
+        return m_total_forced_context_switches;
+    }
+
+    // Seconds spent restoring each object type by the last applied snapshot, summed over all contexts.
+    double get_restore_object_type_time(vogl_gl_object_state_type state_type) const
+    {
+        VOGL_ASSERT(state_type < cGLSTTotalTypes);
+        return m_restore_object_type_times[state_type];
+    }
+
     bool is_valid() const
     {
         return m_is_valid;
@@ -227,6 +296,8 @@ public:
     status_t process_pending_packets();
     status_t process_next_packet(const vogl_trace_packet &gl_packet);
     status_t process_next_packet(vogl_trace_file_reader &trace_reader);
+    // Processes the next packet of pre-decoded frames (see vogl_predecoded_frames), returns cStatusAtEOF after the last packet.
+    status_t process_next_packet(vogl_predecoded_frames &frames);
 
     // process_frame() calls process_next_packet() in a loop until the window must be resized, or until the next frame, or until the EOF or an error occurs.
     status_t process_frame(vogl_trace_file_reader &trace_reader);
@@ -375,15 +446,18 @@ private:
 
     uint32_t m_frame_index;
     uint32_t m_total_swaps;
+    uint32_t m_total_forced_context_switches;
+    double m_restore_object_type_times[cGLSTTotalTypes];
     int64_t m_last_parsed_call_counter;
     int64_t m_last_processed_call_counter;
 
     bool m_at_frame_boundary;
 
-    typedef vogl::hash_map<GLuint, GLuint> gl_handle_hash_map;
+    // Trace->replay name maps are hit on nearly every call, and GL names are small dense integers.
+    typedef vogl::dense_hash_map<GLuint, GLuint> gl_handle_hash_map;
     typedef vogl::hash_map<vogl_sync_ptr_value, GLsync, bit_hasher<vogl_sync_ptr_value> > gl_sync_hash_map;
 
-    typedef vogl::hash_map<GLint, GLint> uniform_location_hash_map;
+    typedef vogl::dense_hash_map<GLint, GLint> uniform_location_hash_map;
     struct glsl_program_state
     {
         // maps trace program locations to replay program locations
@@ -511,6 +585,7 @@ private:
     uint8_vec m_client_side_vertex_attrib_data[VOGL_MAX_SUPPORTED_GL_VERTEX_ATTRIBUTES];
     uint8_vec m_client_side_array_data[VOGL_NUM_CLIENT_SIDE_ARRAY_DESCS];
     uint8_vec m_client_side_texcoord_data[VOGL_MAX_SUPPORTED_GL_TEXCOORD_ARRAYS];
+    bool m_cur_packet_uses_client_side_arrays;
 
     uint8_vec m_screenshot_buffer;
     uint8_vec m_screenshot_buffer2;
@@ -530,6 +605,8 @@ private:
     vogl_gl_get_proc_address_helper_func_ptr_t m_proc_address_helper_func;
     bool m_wrap_all_gl_calls;
 
+    vogl_replay_profiler *m_pProfiler;
+
     // TODO: Make a 1st class snapshot cache class
     struct snapshot_cache_entry
     {
@@ -1360,6 +1437,7 @@ private:
 
     status_t restore_context(vogl_handle_remapper &trace_to_replay_remapper, const vogl_gl_state_snapshot &snapshot, const vogl_context_snapshot &context_snapshot);
     status_t restore_objects(vogl_handle_remapper &trace_to_replay_remapper, const vogl_gl_state_snapshot &snapshot, const vogl_context_snapshot &context_state, vogl_gl_object_state_type state_type, vogl_const_gl_object_state_ptr_vec &objects_to_delete);
+    void finish_restoring_object(vogl_handle_remapper &trace_to_replay_remapper, const vogl_gl_object_state *pState_obj, uint32_t i, GLuint64 restore_handle, vogl_const_gl_object_state_ptr_vec &objects_to_delete);
     vogl_gl_replayer::status_t restore_display_lists(vogl_handle_remapper &trace_to_replay_remapper, const vogl_gl_state_snapshot &snapshot, const vogl_context_snapshot &context_snapshot);
     status_t restore_general_state(vogl_handle_remapper &trace_to_replay_remapper, const vogl_gl_state_snapshot &snapshot, const vogl_context_snapshot &context_snapshot);
     status_t update_context_shadows(vogl_handle_remapper &trace_to_replay_remapper, const vogl_gl_state_snapshot &snapshot, const vogl_context_snapshot &context_snapshot);
@@ -502,6 +502,51 @@ bool vogl_context_snapshot::serialize(json_node &node, vogl_blob_manager &blob_m
     return true;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+// Parallel object deserialization
+// Objects backed by blobs (textures, buffers, renderbuffers) spend nearly all of their deserialization time fetching,
+// inflating and parsing blob data, which doesn't touch GL. These are deserialized on helper threads while the main thread
+// handles everything else.
+//----------------------------------------------------------------------------------------------------------------------
+struct vogl_object_deserialize_job
+{
+    vogl_gl_object_state *m_pState_obj;
+    const json_node *m_pNode;
+    bool m_succeeded;
+};
+
+typedef vogl::vector<vogl_object_deserialize_job> vogl_object_deserialize_job_vec;
+
+struct vogl_object_deserialize_context
+{
+    const vogl_blob_manager *m_pBlob_manager;
+    vogl_object_deserialize_job_vec *m_pJobs;
+    atomic32_t m_next_job;
+};
+
+static inline bool vogl_is_blob_backed_object_state_type(vogl_gl_object_state_type state_type)
+{
+    return (state_type == cGLSTTexture) || (state_type == cGLSTBuffer) || (state_type == cGLSTRenderbuffer);
+}
+
+static void vogl_object_deserialize_task(uint64_t data, void *pData_ptr)
+{
+    VOGL_NOTE_UNUSED(data);
+
+    vogl_object_deserialize_context *pContext = static_cast<vogl_object_deserialize_context *>(pData_ptr);
+    vogl_object_deserialize_job_vec &jobs = *pContext->m_pJobs;
+
+    for (;;)
+    {
+        uint32_t job_index = atomic_increment32(&pContext->m_next_job) - 1;
+        if (job_index >= jobs.size())
+            break;
+
+        vogl_object_deserialize_job &job = jobs[job_index];
+        job.m_succeeded = job.m_pState_obj->deserialize(*job.m_pNode, *pContext->m_pBlob_manager);
+    }
+}
+
 bool vogl_context_snapshot::deserialize(const json_node &node, const vogl_blob_manager &blob_manager, const vogl_ctypes *pCtypes)
 {
     VOGL_FUNC_TRACER
@@ -572,6 +617,10 @@ bool vogl_context_snapshot::deserialize(const json_node &node, const vogl_blob_m
     const json_node *pObjects_node = node.find_child_object("state_objects");
     if (pObjects_node)
     {
+        // Create all the objects in snapshot order first, then deserialize them (the blob backed ones in parallel).
+        vogl_object_deserialize_job_vec blob_jobs;
+        vogl_object_deserialize_job_vec other_jobs;
+
         for (uint32_t obj_iter = 0; obj_iter < pObjects_node->size(); obj_iter++)
         {
             const dynamic_string &obj_type_str = pObjects_node->get_key(obj_iter);
@@ -608,15 +657,61 @@ bool vogl_context_snapshot::deserialize(const json_node &node, const vogl_blob_m
                     return false;
                 }
 
-                if (!pState_obj->deserialize(*pObj_node, blob_manager))
-                {
-                    vogl_delete(pState_obj);
+                m_object_ptrs.push_back(pState_obj);
 
-                    clear();
-                    return false;
-                }
+                vogl_object_deserialize_job job;
+                job.m_pState_obj = pState_obj;
+                job.m_pNode = pObj_node;
+                job.m_succeeded = false;
 
-                m_object_ptrs.push_back(pState_obj);
+                if (vogl_is_blob_backed_object_state_type(state_type))
+                    blob_jobs.push_back(job);
+                else
+                    other_jobs.push_back(job);
+            }
+        }
+
+        // Make sure the GL enum tables are initialized before any helper threads start looking up enums.
+        get_gl_enums();
+
+        vogl_object_deserialize_context context;
+        context.m_pBlob_manager = &blob_manager;
+        context.m_pJobs = &blob_jobs;
+        context.m_next_job = 0;
+
+        uint32_t num_helper_threads = math::minimum<uint32_t>(vogl_get_max_helper_threads(), blob_jobs.size() / 2);
+
+        task_pool pool;
+        if ((num_helper_threads) && (pool.init(num_helper_threads)))
+        {
+            for (uint32_t i = 0; i < num_helper_threads; i++)
+                pool.queue_task(vogl_object_deserialize_task, 0, &context);
+        }
+
+        for (uint32_t i = 0; i < other_jobs.size(); i++)
+            other_jobs[i].m_succeeded = other_jobs[i].m_pState_obj->deserialize(*other_jobs[i].m_pNode, blob_manager);
+
+        // Help with whatever blob backed objects remain, then wait for the helpers to finish.
+        vogl_object_deserialize_task(0, &context);
+
+        pool.join();
+        pool.deinit();
+
+        for (uint32_t i = 0; i < other_jobs.size(); i++)
+        {
+            if (!other_jobs[i].m_succeeded)
+            {
+                clear();
+                return false;
+            }
+        }
+
+        for (uint32_t i = 0; i < blob_jobs.size(); i++)
+        {
+            if (!blob_jobs[i].m_succeeded)
+            {
+                clear();
+                return false;
             }
         }
     }
@@ -761,13 +856,10 @@ bool vogl_gl_state_snapshot::end_capture()
     return m_is_valid;
 }
 
-bool vogl_gl_state_snapshot::serialize(json_node &node, vogl_blob_manager &blob_manager, const vogl_ctypes *pCtypes) const
+bool vogl_gl_state_snapshot::serialize_header(json_node &node, vogl_blob_manager &blob_manager) const
 {
     VOGL_FUNC_TRACER
 
-    if (!m_is_valid)
-        return false;
-
     m_uuid.json_serialize(node.add("uuid"));
     node.add_key_value("window_width", m_window_width);
     node.add_key_value("window_height", m_window_height);
@@ -784,6 +876,19 @@ bool vogl_gl_state_snapshot::serialize(json_node &node, vogl_blob_manager &blob_
     if (!vogl_json_serialize_vec(node, blob_manager, "client_side_texcoord_ptrs", m_client_side_texcoord_ptrs))
         return false;
 
+    return true;
+}
+
+bool vogl_gl_state_snapshot::serialize(json_node &node, vogl_blob_manager &blob_manager, const vogl_ctypes *pCtypes) const
+{
+    VOGL_FUNC_TRACER
+
+    if (!m_is_valid)
+        return false;
+
+    if (!serialize_header(node, blob_manager))
+        return false;
+
     if (!vogl_json_serialize_ptr_vec(node, blob_manager, "context_snapshots", m_context_ptrs, pCtypes))
         return false;
 
@@ -796,6 +901,55 @@ bool vogl_gl_state_snapshot::serialize(json_node &node, vogl_blob_manager &blob_
     return true;
 }
 
+bool vogl_gl_state_snapshot::serialize(json_stream_writer &writer, vogl_blob_manager &blob_manager, const vogl_ctypes *pCtypes) const
+{
+    VOGL_FUNC_TRACER
+
+    if (!m_is_valid)
+        return false;
+
+    json_node header_node(NULL, true);
+    if (!serialize_header(header_node, blob_manager))
+        return false;
+
+    if (!writer.begin_object())
+        return false;
+
+    for (uint32_t i = 0; i < header_node.size(); i++)
+    {
+        if (!writer.add_value(header_node.get_key(i).get_ptr(), header_node.get_value(i)))
+            return false;
+    }
+
+    if (!writer.begin_array("context_snapshots"))
+        return false;
+
+    for (uint32_t i = 0; i < m_context_ptrs.size(); i++)
+    {
+        json_node context_node(NULL, true);
+        if ((m_context_ptrs[i]) && (!m_context_ptrs[i]->serialize(context_node, blob_manager, pCtypes)))
+            return false;
+
+        if (!writer.add_node(NULL, context_node))
+            return false;
+    }
+
+    if (!writer.end())
+        return false;
+
+    if (m_default_framebuffer.is_valid())
+    {
+        json_node framebuffer_node(NULL, true);
+        if (!m_default_framebuffer.serialize(framebuffer_node, blob_manager))
+            return false;
+
+        if (!writer.add_node("default_framebuffer", framebuffer_node))
+            return false;
+    }
+
+    return writer.end();
+}
+
 bool vogl_gl_state_snapshot::deserialize(const json_node &node, const vogl_blob_manager &blob_manager, const vogl_ctypes *pCtypes)
 {
     VOGL_FUNC_TRACER
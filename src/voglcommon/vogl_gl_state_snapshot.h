@@ -406,6 +406,9 @@ public:
     bool serialize(json_node &node, vogl_blob_manager &blob_manager, const vogl_ctypes *pCtypes) const;
     bool deserialize(const json_node &node, const vogl_blob_manager &blob_manager, const vogl_ctypes *pCtypes);
 
+    // Writes the same document as serialize(json_node &) as it goes, only one context's state is held in memory at a time.
+    bool serialize(json_stream_writer &writer, vogl_blob_manager &blob_manager, const vogl_ctypes *pCtypes) const;
+
     md5_hash get_uuid() const
     {
         return m_uuid;
@@ -513,6 +516,8 @@ private:
     bool m_captured_default_framebuffer;
     bool m_is_valid;
 
+    bool serialize_header(json_node &node, vogl_blob_manager &blob_manager) const;
+
     void destroy_contexts()
     {
         for (uint32_t i = 0; i < m_context_ptrs.size(); i++)
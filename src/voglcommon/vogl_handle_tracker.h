@@ -31,6 +31,7 @@
 
 #include "vogl_common.h"
 #include "vogl_hash_map.h"
+#include "vogl_dense_hash_map.h"
 #include "vogl_sparse_vector.h"
 #include "vogl_json.h"
 
@@ -113,7 +114,7 @@ public:
     };
 
     typedef vogl::sparse_vector<handle_def, 5> handle_def_vec;
-    typedef vogl::hash_map<handle_t, uint32_t> handle_hash_map_t;
+    typedef vogl::dense_hash_map<handle_t, uint32_t> handle_hash_map_t;
 
     vogl_handle_tracker();
     vogl_handle_tracker(vogl_namespace_t handle_namespace);
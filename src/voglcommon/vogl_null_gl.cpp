@@ -0,0 +1,711 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_null_gl.cpp
+#include "vogl_null_gl.h"
+#include "vogl_hash_map.h"
+
+// The generated stubs ignore their parameters.
+#if defined(__GNUC__)
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+// Null driver state
+//----------------------------------------------------------------------------------------------------------------------
+struct vogl_null_gl_state
+{
+    vogl_null_gl_state()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        m_next_name = 1;
+        m_next_sync = 1;
+        m_bindings.clear();
+        m_buffer_sizes.clear();
+        m_mapped_buffers.clear();
+    }
+
+    GLuint alloc_names(GLsizei n)
+    {
+        GLuint first = m_next_name;
+        m_next_name += math::maximum<GLsizei>(n, 1);
+        return first;
+    }
+
+    GLuint get_binding(GLenum binding) const
+    {
+        vogl::hash_map<GLenum, GLuint>::const_iterator it(m_bindings.find(binding));
+        return (it != m_bindings.end()) ? it->second : 0;
+    }
+
+    GLuint m_next_name;
+    uintptr_t m_next_sync;
+
+    // Keyed by binding enum (GL_ARRAY_BUFFER_BINDING, GL_TEXTURE_BINDING_2D, etc.)
+    vogl::hash_map<GLenum, GLuint> m_bindings;
+
+    vogl::hash_map<GLuint, GLint64> m_buffer_sizes;
+    vogl::hash_map<GLuint, uint8_vec> m_mapped_buffers;
+};
+
+static vogl_null_gl_state &get_null_gl_state()
+{
+    static vogl_null_gl_state s_state;
+    return s_state;
+}
+
+static GLenum get_null_binding_from_target(GLenum target)
+{
+    switch (target)
+    {
+#define DEFINE_BINDING(c, t, b) \
+    case t:                     \
+        return b;
+#include "gl_buffer_bindings.inc"
+#undef DEFINE_BINDING
+        default:
+            break;
+    }
+    return GL_NONE;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Generic stubs, one per entrypoint
+//----------------------------------------------------------------------------------------------------------------------
+template <typename T>
+static inline T null_gl_default_return()
+{
+    return T();
+}
+
+#define DEF_PROTO(exported, category, ret, ret_type, num_params, name, args, params) \
+    static ret GLAPIENTRY VOGL_GLUER(vogl_null_, name) args                          \
+    {                                                                               \
+        return null_gl_default_return<ret>();                                       \
+    }
+#define DEF_PROTO_VOID(exported, category, ret, ret_type, num_params, name, args, params) \
+    static void GLAPIENTRY VOGL_GLUER(vogl_null_, name) args                              \
+    {                                                                                    \
+    }
+#include "gl_glx_cgl_wgl_protos.inc"
+#undef DEF_PROTO
+#undef DEF_PROTO_VOID
+
+//----------------------------------------------------------------------------------------------------------------------
+// Stubs with behavior the replayer depends on
+//----------------------------------------------------------------------------------------------------------------------
+static const GLubyte *GLAPIENTRY null_glGetString(GLenum name)
+{
+    switch (name)
+    {
+        case GL_VERSION:
+            return reinterpret_cast<const GLubyte *>("4.3.0 vogl null driver");
+        case GL_SHADING_LANGUAGE_VERSION:
+            return reinterpret_cast<const GLubyte *>("4.30");
+        case GL_VENDOR:
+            return reinterpret_cast<const GLubyte *>("vogl");
+        case GL_RENDERER:
+            return reinterpret_cast<const GLubyte *>("vogl null driver");
+        default:
+            break;
+    }
+    return reinterpret_cast<const GLubyte *>("");
+}
+
+static const GLubyte *GLAPIENTRY null_glGetStringi(GLenum name, GLuint index)
+{
+    return reinterpret_cast<const GLubyte *>("");
+}
+
+// Implementation limits. These are (mostly) the GL 4.3 compatibility profile minimums, so limit dependent replayer code
+// (context info, state snapshotting) does roughly the same amount of work as it would on a real driver.
+static bool null_get_limit(GLenum pname, GLint64 &value)
+{
+    switch (pname)
+    {
+        // Textures and framebuffers
+        case GL_MAX_TEXTURE_SIZE:
+        case GL_MAX_CUBE_MAP_TEXTURE_SIZE:
+        case GL_MAX_RECTANGLE_TEXTURE_SIZE:
+        case GL_MAX_RENDERBUFFER_SIZE:
+        case GL_MAX_FRAMEBUFFER_WIDTH:
+        case GL_MAX_FRAMEBUFFER_HEIGHT:
+        case GL_MAX_VIEWPORT_DIMS:
+            value = 16384;
+            return true;
+        case GL_MAX_3D_TEXTURE_SIZE:
+        case GL_MAX_ARRAY_TEXTURE_LAYERS:
+        case GL_MAX_FRAMEBUFFER_LAYERS:
+            value = 2048;
+            return true;
+        case GL_MAX_TEXTURE_BUFFER_SIZE:
+            value = 65536;
+            return true;
+        case GL_MAX_TEXTURE_LOD_BIAS:
+            value = 2;
+            return true;
+        case GL_MAX_VIEWPORTS:
+            value = 16;
+            return true;
+        case GL_MAX_DRAW_BUFFERS:
+        case GL_MAX_COLOR_ATTACHMENTS:
+            value = 8;
+            return true;
+        case GL_MAX_DUAL_SOURCE_DRAW_BUFFERS:
+        case GL_MAX_COLOR_TEXTURE_SAMPLES:
+        case GL_MAX_DEPTH_TEXTURE_SAMPLES:
+        case GL_MAX_INTEGER_SAMPLES:
+        case GL_MAX_SAMPLE_MASK_WORDS:
+            value = 1;
+            return true;
+        case GL_MAX_SAMPLES:
+        case GL_MAX_FRAMEBUFFER_SAMPLES:
+            value = 4;
+            return true;
+
+        // Texture units
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_GEOMETRY_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_COMPUTE_TEXTURE_IMAGE_UNITS:
+            value = 16;
+            return true;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+            value = 96;
+            return true;
+        case GL_MAX_TEXTURE_UNITS:
+            value = 4;
+            return true;
+        case GL_MAX_TEXTURE_COORDS:
+            value = 8;
+            return true;
+
+        // Vertex input
+        case GL_MAX_VERTEX_ATTRIBS:
+        case GL_MAX_VERTEX_ATTRIB_BINDINGS:
+            value = 16;
+            return true;
+        case GL_MAX_VERTEX_ATTRIB_RELATIVE_OFFSET:
+            value = 2047;
+            return true;
+        case GL_MAX_ELEMENTS_VERTICES:
+        case GL_MAX_ELEMENTS_INDICES:
+            value = 1048576;
+            return true;
+        case GL_MAX_ELEMENT_INDEX:
+            value = 0xFFFFFF;
+            return true;
+
+        // Shader stages
+        case GL_MAX_VERTEX_UNIFORM_COMPONENTS:
+        case GL_MAX_FRAGMENT_UNIFORM_COMPONENTS:
+        case GL_MAX_GEOMETRY_UNIFORM_COMPONENTS:
+        case GL_MAX_GEOMETRY_TOTAL_OUTPUT_COMPONENTS:
+        case GL_MAX_COMPUTE_UNIFORM_COMPONENTS:
+        case GL_MAX_COMPUTE_LOCAL_INVOCATIONS:
+        case GL_MAX_UNIFORM_LOCATIONS:
+            value = 1024;
+            return true;
+        case GL_MAX_VERTEX_UNIFORM_VECTORS:
+        case GL_MAX_FRAGMENT_UNIFORM_VECTORS:
+        case GL_MAX_GEOMETRY_OUTPUT_VERTICES:
+            value = 256;
+            return true;
+        case GL_MAX_VERTEX_OUTPUT_COMPONENTS:
+        case GL_MAX_GEOMETRY_INPUT_COMPONENTS:
+            value = 64;
+            return true;
+        case GL_MAX_FRAGMENT_INPUT_COMPONENTS:
+        case GL_MAX_GEOMETRY_OUTPUT_COMPONENTS:
+            value = 128;
+            return true;
+        case GL_MAX_VARYING_FLOATS:
+            value = 60;
+            return true;
+        case GL_MAX_VARYING_VECTORS:
+            value = 15;
+            return true;
+        case GL_MAX_PROGRAM_TEXEL_OFFSET:
+            value = 7;
+            return true;
+        case GL_MIN_PROGRAM_TEXEL_OFFSET:
+            value = -8;
+            return true;
+
+        // Uniform blocks
+        case GL_MAX_VERTEX_UNIFORM_BLOCKS:
+        case GL_MAX_FRAGMENT_UNIFORM_BLOCKS:
+        case GL_MAX_GEOMETRY_UNIFORM_BLOCKS:
+        case GL_MAX_COMPUTE_UNIFORM_BLOCKS:
+            value = 14;
+            return true;
+        case GL_MAX_COMBINED_UNIFORM_BLOCKS:
+            value = 70;
+            return true;
+        case GL_MAX_UNIFORM_BUFFER_BINDINGS:
+            value = 72;
+            return true;
+        case GL_MAX_UNIFORM_BLOCK_SIZE:
+            value = 16384;
+            return true;
+        case GL_MAX_COMBINED_VERTEX_UNIFORM_COMPONENTS:
+        case GL_MAX_COMBINED_FRAGMENT_UNIFORM_COMPONENTS:
+        case GL_MAX_COMBINED_GEOMETRY_UNIFORM_COMPONENTS:
+        case GL_MAX_COMBINED_COMPUTE_UNIFORM_COMPONENTS:
+            value = 14 * 16384 / 4 + 1024;
+            return true;
+
+        // Shader storage, atomic counters and images
+        case GL_MAX_FRAGMENT_SHADER_STORAGE_BLOCKS:
+        case GL_MAX_COMPUTE_SHADER_STORAGE_BLOCKS:
+        case GL_MAX_COMBINED_SHADER_STORAGE_BLOCKS:
+        case GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS:
+        case GL_MAX_FRAGMENT_ATOMIC_COUNTERS:
+        case GL_MAX_COMPUTE_ATOMIC_COUNTERS:
+        case GL_MAX_COMBINED_ATOMIC_COUNTERS:
+        case GL_MAX_IMAGE_UNITS:
+            value = 8;
+            return true;
+        case GL_MAX_ATOMIC_COUNTER_BUFFER_BINDINGS:
+        case GL_MAX_COMPUTE_ATOMIC_COUNTER_BUFFERS:
+            value = 1;
+            return true;
+
+        // Transform feedback
+        case GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_ATTRIBS:
+        case GL_MAX_TRANSFORM_FEEDBACK_SEPARATE_COMPONENTS:
+        case GL_MAX_TRANSFORM_FEEDBACK_BUFFERS:
+            value = 4;
+            return true;
+        case GL_MAX_TRANSFORM_FEEDBACK_INTERLEAVED_COMPONENTS:
+            value = 64;
+            return true;
+
+        // Debug output
+        case GL_MAX_LABEL_LENGTH:
+            value = 256;
+            return true;
+        case GL_MAX_DEBUG_GROUP_STACK_DEPTH:
+            value = 64;
+            return true;
+
+        // Fixed function
+        case GL_MAX_LIGHTS:
+        case GL_MAX_CLIP_PLANES:
+        case GL_MAX_EVAL_ORDER:
+        case GL_MAX_PROGRAM_MATRICES_ARB:
+            value = 8;
+            return true;
+        case GL_MAX_MODELVIEW_STACK_DEPTH:
+        case GL_MAX_PIXEL_MAP_TABLE:
+            value = 32;
+            return true;
+        case GL_MAX_PROJECTION_STACK_DEPTH:
+        case GL_MAX_TEXTURE_STACK_DEPTH:
+        case GL_MAX_COLOR_MATRIX_STACK_DEPTH:
+            value = 2;
+            return true;
+        case GL_MAX_NAME_STACK_DEPTH:
+        case GL_MAX_LIST_NESTING:
+            value = 64;
+            return true;
+        case GL_MAX_ATTRIB_STACK_DEPTH:
+        case GL_MAX_CLIENT_ATTRIB_STACK_DEPTH:
+            value = 16;
+            return true;
+
+        default:
+            break;
+    }
+    return false;
+}
+
+static GLint64 null_get_integer(GLenum pname)
+{
+    switch (pname)
+    {
+        case GL_MAJOR_VERSION:
+            return 4;
+        case GL_MINOR_VERSION:
+            return 3;
+        case GL_CONTEXT_PROFILE_MASK:
+            return GL_CONTEXT_COMPATIBILITY_PROFILE_BIT;
+        default:
+            break;
+    }
+
+    GLint64 limit;
+    if (null_get_limit(pname, limit))
+        return limit;
+
+    return get_null_gl_state().get_binding(pname);
+}
+
+// GL_MAX_VIEWPORT_DIMS is the only multi-value pname we answer, everything else writes a single value.
+template <typename T>
+static void null_get_values(GLenum pname, T *pParams)
+{
+    if (!pParams)
+        return;
+
+    pParams[0] = static_cast<T>(null_get_integer(pname));
+    if (pname == GL_MAX_VIEWPORT_DIMS)
+        pParams[1] = pParams[0];
+}
+
+static void GLAPIENTRY null_glGetIntegerv(GLenum pname, GLint *pParams)
+{
+    null_get_values(pname, pParams);
+}
+
+static void GLAPIENTRY null_glGetInteger64v(GLenum pname, GLint64 *pParams)
+{
+    null_get_values(pname, pParams);
+}
+
+static void GLAPIENTRY null_glGetFloatv(GLenum pname, GLfloat *pParams)
+{
+    null_get_values(pname, pParams);
+}
+
+static void GLAPIENTRY null_glGetDoublev(GLenum pname, GLdouble *pParams)
+{
+    null_get_values(pname, pParams);
+}
+
+static void GLAPIENTRY null_glGetBooleanv(GLenum pname, GLboolean *pParams)
+{
+    if (pParams)
+        *pParams = null_get_integer(pname) ? GL_TRUE : GL_FALSE;
+}
+
+// Object names
+static void null_gen_names(GLsizei n, GLuint *pNames)
+{
+    if ((n <= 0) || (!pNames))
+        return;
+
+    GLuint first = get_null_gl_state().alloc_names(n);
+    for (GLsizei i = 0; i < n; i++)
+        pNames[i] = first + i;
+}
+
+#define DEF_NULL_GEN_FUNC(name)                                    \
+    static void GLAPIENTRY null_##name(GLsizei n, GLuint *pNames) \
+    {                                                              \
+        null_gen_names(n, pNames);                                 \
+    }
+DEF_NULL_GEN_FUNC(glGenTextures)
+DEF_NULL_GEN_FUNC(glGenTexturesEXT)
+DEF_NULL_GEN_FUNC(glGenBuffers)
+DEF_NULL_GEN_FUNC(glGenBuffersARB)
+DEF_NULL_GEN_FUNC(glGenFramebuffers)
+DEF_NULL_GEN_FUNC(glGenFramebuffersEXT)
+DEF_NULL_GEN_FUNC(glGenRenderbuffers)
+DEF_NULL_GEN_FUNC(glGenRenderbuffersEXT)
+DEF_NULL_GEN_FUNC(glGenVertexArrays)
+DEF_NULL_GEN_FUNC(glGenVertexArraysAPPLE)
+DEF_NULL_GEN_FUNC(glGenQueries)
+DEF_NULL_GEN_FUNC(glGenQueriesARB)
+DEF_NULL_GEN_FUNC(glGenSamplers)
+DEF_NULL_GEN_FUNC(glGenProgramPipelines)
+DEF_NULL_GEN_FUNC(glGenTransformFeedbacks)
+DEF_NULL_GEN_FUNC(glGenProgramsARB)
+#undef DEF_NULL_GEN_FUNC
+
+static GLuint GLAPIENTRY null_glGenLists(GLsizei range)
+{
+    return get_null_gl_state().alloc_names(range);
+}
+
+static GLuint GLAPIENTRY null_glCreateShader(GLenum type)
+{
+    return get_null_gl_state().alloc_names(1);
+}
+
+static GLuint GLAPIENTRY null_glCreateProgram()
+{
+    return get_null_gl_state().alloc_names(1);
+}
+
+static GLuint GLAPIENTRY null_glCreateShaderProgramv(GLenum type, GLsizei count, const GLchar *const *strings)
+{
+    return get_null_gl_state().alloc_names(1);
+}
+
+static GLhandleARB GLAPIENTRY null_glCreateShaderObjectARB(GLenum shaderType)
+{
+    return get_null_gl_state().alloc_names(1);
+}
+
+static GLhandleARB GLAPIENTRY null_glCreateProgramObjectARB()
+{
+    return get_null_gl_state().alloc_names(1);
+}
+
+static GLsync GLAPIENTRY null_glFenceSync(GLenum condition, GLbitfield flags)
+{
+    return reinterpret_cast<GLsync>(get_null_gl_state().m_next_sync++);
+}
+
+static GLenum GLAPIENTRY null_glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    return GL_ALREADY_SIGNALED;
+}
+
+static GLenum GLAPIENTRY null_glCheckFramebufferStatus(GLenum target)
+{
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+// Shader/program status - everything compiles and links
+static void GLAPIENTRY null_glGetShaderiv(GLuint shader, GLenum pname, GLint *pParams)
+{
+    if (pParams)
+        *pParams = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+static void GLAPIENTRY null_glGetProgramiv(GLuint program, GLenum pname, GLint *pParams)
+{
+    if (pParams)
+        *pParams = ((pname == GL_LINK_STATUS) || (pname == GL_VALIDATE_STATUS)) ? GL_TRUE : 0;
+}
+
+static void GLAPIENTRY null_glGetObjectParameterivARB(GLhandleARB obj, GLenum pname, GLint *pParams)
+{
+    if (pParams)
+        *pParams = ((pname == GL_OBJECT_COMPILE_STATUS_ARB) || (pname == GL_OBJECT_LINK_STATUS_ARB) || (pname == GL_OBJECT_VALIDATE_STATUS_ARB)) ? GL_TRUE : 0;
+}
+
+// Bindings
+static void null_bind(GLenum target, GLuint name)
+{
+    vogl_null_gl_state &state = get_null_gl_state();
+
+    if (target == GL_FRAMEBUFFER)
+    {
+        state.m_bindings[GL_DRAW_FRAMEBUFFER_BINDING] = name;
+        state.m_bindings[GL_READ_FRAMEBUFFER_BINDING] = name;
+        return;
+    }
+
+    GLenum binding = get_null_binding_from_target(target);
+    if (binding != GL_NONE)
+        state.m_bindings[binding] = name;
+}
+
+static void GLAPIENTRY null_glBindBuffer(GLenum target, GLuint buffer)
+{
+    null_bind(target, buffer);
+}
+
+static void GLAPIENTRY null_glBindTexture(GLenum target, GLuint texture)
+{
+    null_bind(target, texture);
+}
+
+static void GLAPIENTRY null_glBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    null_bind(target, framebuffer);
+}
+
+static void GLAPIENTRY null_glBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    null_bind(target, renderbuffer);
+}
+
+static void GLAPIENTRY null_glBindVertexArray(GLuint array)
+{
+    null_bind(GL_VERTEX_ARRAY, array);
+}
+
+static void GLAPIENTRY null_glUseProgram(GLuint program)
+{
+    null_bind(GL_PROGRAM, program);
+}
+
+static void GLAPIENTRY null_glActiveTexture(GLenum texture)
+{
+    null_bind(GL_ACTIVE_TEXTURE, texture);
+}
+
+// Buffer storage and mapping - only sizes are tracked, mapped memory is scratch that's thrown away at unmap time
+static GLuint null_get_bound_buffer(GLenum target)
+{
+    return get_null_gl_state().get_binding(get_null_binding_from_target(target));
+}
+
+static void GLAPIENTRY null_glBufferData(GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage)
+{
+    get_null_gl_state().m_buffer_sizes[null_get_bound_buffer(target)] = size;
+}
+
+static void GLAPIENTRY null_glGetBufferParameteriv(GLenum target, GLenum pname, GLint *pParams)
+{
+    if (!pParams)
+        return;
+
+    *pParams = 0;
+
+    if (pname == GL_BUFFER_SIZE)
+    {
+        vogl_null_gl_state &state = get_null_gl_state();
+        vogl::hash_map<GLuint, GLint64>::const_iterator it(state.m_buffer_sizes.find(null_get_bound_buffer(target)));
+        if (it != state.m_buffer_sizes.end())
+            *pParams = static_cast<GLint>(it->second);
+    }
+}
+
+static GLvoid *null_map_buffer(GLenum target, GLint64 size)
+{
+    uint8_vec &storage = get_null_gl_state().m_mapped_buffers[null_get_bound_buffer(target)];
+    storage.resize(static_cast<uint32_t>(math::maximum<GLint64>(size, 1)));
+    return storage.get_ptr();
+}
+
+static GLvoid *GLAPIENTRY null_glMapBuffer(GLenum target, GLenum access)
+{
+    GLint size = 0;
+    null_glGetBufferParameteriv(target, GL_BUFFER_SIZE, &size);
+    return null_map_buffer(target, size);
+}
+
+static GLvoid *GLAPIENTRY null_glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    return null_map_buffer(target, length);
+}
+
+static GLboolean GLAPIENTRY null_glUnmapBuffer(GLenum target)
+{
+    get_null_gl_state().m_mapped_buffers.erase(null_get_bound_buffer(target));
+    return GL_TRUE;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Entrypoint table
+//----------------------------------------------------------------------------------------------------------------------
+static vogl_void_func_ptr_t g_vogl_null_gl_funcs[VOGL_NUM_ENTRYPOINTS];
+
+static void init_null_gl_funcs()
+{
+#define DEF_PROTO(exported, category, ret, ret_type, num_params, name, args, params) \
+    g_vogl_null_gl_funcs[VOGL_ENTRYPOINT_##name] = reinterpret_cast<vogl_void_func_ptr_t>(VOGL_GLUER(vogl_null_, name));
+#define DEF_PROTO_VOID(exported, category, ret, ret_type, num_params, name, args, params) \
+    g_vogl_null_gl_funcs[VOGL_ENTRYPOINT_##name] = reinterpret_cast<vogl_void_func_ptr_t>(VOGL_GLUER(vogl_null_, name));
+#include "gl_glx_cgl_wgl_protos.inc"
+#undef DEF_PROTO
+#undef DEF_PROTO_VOID
+
+#define SET_NULL_FUNC(name, func) g_vogl_null_gl_funcs[VOGL_ENTRYPOINT_##name] = reinterpret_cast<vogl_void_func_ptr_t>(func);
+    SET_NULL_FUNC(glGetString, null_glGetString)
+    SET_NULL_FUNC(glGetStringi, null_glGetStringi)
+    SET_NULL_FUNC(glGetIntegerv, null_glGetIntegerv)
+    SET_NULL_FUNC(glGetInteger64v, null_glGetInteger64v)
+    SET_NULL_FUNC(glGetFloatv, null_glGetFloatv)
+    SET_NULL_FUNC(glGetDoublev, null_glGetDoublev)
+    SET_NULL_FUNC(glGetBooleanv, null_glGetBooleanv)
+
+    SET_NULL_FUNC(glGenTextures, null_glGenTextures)
+    SET_NULL_FUNC(glGenTexturesEXT, null_glGenTexturesEXT)
+    SET_NULL_FUNC(glGenBuffers, null_glGenBuffers)
+    SET_NULL_FUNC(glGenBuffersARB, null_glGenBuffersARB)
+    SET_NULL_FUNC(glGenFramebuffers, null_glGenFramebuffers)
+    SET_NULL_FUNC(glGenFramebuffersEXT, null_glGenFramebuffersEXT)
+    SET_NULL_FUNC(glGenRenderbuffers, null_glGenRenderbuffers)
+    SET_NULL_FUNC(glGenRenderbuffersEXT, null_glGenRenderbuffersEXT)
+    SET_NULL_FUNC(glGenVertexArrays, null_glGenVertexArrays)
+    SET_NULL_FUNC(glGenVertexArraysAPPLE, null_glGenVertexArraysAPPLE)
+    SET_NULL_FUNC(glGenQueries, null_glGenQueries)
+    SET_NULL_FUNC(glGenQueriesARB, null_glGenQueriesARB)
+    SET_NULL_FUNC(glGenSamplers, null_glGenSamplers)
+    SET_NULL_FUNC(glGenProgramPipelines, null_glGenProgramPipelines)
+    SET_NULL_FUNC(glGenTransformFeedbacks, null_glGenTransformFeedbacks)
+    SET_NULL_FUNC(glGenProgramsARB, null_glGenProgramsARB)
+    SET_NULL_FUNC(glGenLists, null_glGenLists)
+    SET_NULL_FUNC(glCreateShader, null_glCreateShader)
+    SET_NULL_FUNC(glCreateProgram, null_glCreateProgram)
+    SET_NULL_FUNC(glCreateShaderProgramv, null_glCreateShaderProgramv)
+    SET_NULL_FUNC(glCreateShaderObjectARB, null_glCreateShaderObjectARB)
+    SET_NULL_FUNC(glCreateProgramObjectARB, null_glCreateProgramObjectARB)
+    SET_NULL_FUNC(glFenceSync, null_glFenceSync)
+    SET_NULL_FUNC(glClientWaitSync, null_glClientWaitSync)
+    SET_NULL_FUNC(glCheckFramebufferStatus, null_glCheckFramebufferStatus)
+    SET_NULL_FUNC(glCheckFramebufferStatusEXT, null_glCheckFramebufferStatus)
+
+    SET_NULL_FUNC(glGetShaderiv, null_glGetShaderiv)
+    SET_NULL_FUNC(glGetProgramiv, null_glGetProgramiv)
+    SET_NULL_FUNC(glGetObjectParameterivARB, null_glGetObjectParameterivARB)
+
+    SET_NULL_FUNC(glBindBuffer, null_glBindBuffer)
+    SET_NULL_FUNC(glBindBufferARB, null_glBindBuffer)
+    SET_NULL_FUNC(glBindTexture, null_glBindTexture)
+    SET_NULL_FUNC(glBindTextureEXT, null_glBindTexture)
+    SET_NULL_FUNC(glBindFramebuffer, null_glBindFramebuffer)
+    SET_NULL_FUNC(glBindFramebufferEXT, null_glBindFramebuffer)
+    SET_NULL_FUNC(glBindRenderbuffer, null_glBindRenderbuffer)
+    SET_NULL_FUNC(glBindRenderbufferEXT, null_glBindRenderbuffer)
+    SET_NULL_FUNC(glBindVertexArray, null_glBindVertexArray)
+    SET_NULL_FUNC(glUseProgram, null_glUseProgram)
+    SET_NULL_FUNC(glActiveTexture, null_glActiveTexture)
+    SET_NULL_FUNC(glActiveTextureARB, null_glActiveTexture)
+
+    SET_NULL_FUNC(glBufferData, null_glBufferData)
+    SET_NULL_FUNC(glBufferDataARB, null_glBufferData)
+    SET_NULL_FUNC(glGetBufferParameteriv, null_glGetBufferParameteriv)
+    SET_NULL_FUNC(glGetBufferParameterivARB, null_glGetBufferParameteriv)
+    SET_NULL_FUNC(glMapBuffer, null_glMapBuffer)
+    SET_NULL_FUNC(glMapBufferARB, null_glMapBuffer)
+    SET_NULL_FUNC(glMapBufferRange, null_glMapBufferRange)
+    SET_NULL_FUNC(glUnmapBuffer, null_glUnmapBuffer)
+    SET_NULL_FUNC(glUnmapBufferARB, null_glUnmapBuffer)
+#undef SET_NULL_FUNC
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_null_gl_get_proc_address
+//----------------------------------------------------------------------------------------------------------------------
+vogl_void_func_ptr_t vogl_null_gl_get_proc_address(const char *pName)
+{
+    static pthread_once_t s_init_once = PTHREAD_ONCE_INIT;
+    pthread_once(&s_init_once, init_null_gl_funcs);
+
+    gl_entrypoint_id_t id = vogl_find_entrypoint(pName);
+    if (id == VOGL_ENTRYPOINT_INVALID)
+        return NULL;
+
+    return g_vogl_null_gl_funcs[id];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_null_gl_reset
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_null_gl_reset()
+{
+    get_null_gl_state().reset();
+}
@@ -0,0 +1,44 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_null_gl.h
+#ifndef VOGL_NULL_GL_H
+#define VOGL_NULL_GL_H
+
+#include "vogl_common.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+// Null GL driver
+// Stub implementations of every GL/GLX/WGL entrypoint, for replaying traces without a GPU or a real GL context so the
+// replayer's own CPU overhead can be measured. The stubs do nothing beyond handing out object names, sync objects and
+// mapping memory, and answering the handful of glGet's the replayer relies on (bindings, buffer sizes, compile/link status).
+// Pass vogl_null_gl_get_proc_address() to vogl_init_actual_gl_entrypoints() and open the replay window in null mode.
+//----------------------------------------------------------------------------------------------------------------------
+vogl_void_func_ptr_t vogl_null_gl_get_proc_address(const char *pName);
+
+// Resets the null driver's name counters, bindings and mappings.
+void vogl_null_gl_reset();
+
+#endif // VOGL_NULL_GL_H
@@ -0,0 +1,127 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_predecoded_frames.cpp
+#include "vogl_predecoded_frames.h"
+#include "vogl_trace_file_reader.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_predecoded_frames::vogl_predecoded_frames
+//----------------------------------------------------------------------------------------------------------------------
+vogl_predecoded_frames::vogl_predecoded_frames()
+    : m_num_frames(0),
+      m_cur_packet_index(0),
+      m_total_packet_bytes(0),
+      m_ends_at_eof(false)
+{
+    VOGL_FUNC_TRACER
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_predecoded_frames::~vogl_predecoded_frames
+//----------------------------------------------------------------------------------------------------------------------
+vogl_predecoded_frames::~vogl_predecoded_frames()
+{
+    VOGL_FUNC_TRACER
+
+    clear();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_predecoded_frames::clear
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_predecoded_frames::clear()
+{
+    VOGL_FUNC_TRACER
+
+    for (uint32_t i = 0; i < m_packets.size(); i++)
+        vogl_delete(m_packets[i]);
+    m_packets.clear();
+    m_frame_after_packet.clear();
+
+    m_num_frames = 0;
+    m_cur_packet_index = 0;
+    m_total_packet_bytes = 0;
+    m_ends_at_eof = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_predecoded_frames::record
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_predecoded_frames::record(vogl_trace_file_reader &trace_reader, const vogl_ctypes *pCtypes, uint32_t num_frames)
+{
+    VOGL_FUNC_TRACER
+
+    clear();
+
+    const uint32_t start_frame = trace_reader.get_cur_frame();
+
+    while (m_num_frames < num_frames)
+    {
+        vogl_trace_file_reader::trace_file_reader_status_t read_status = trace_reader.read_next_packet();
+        if (read_status == vogl_trace_file_reader::cEOF)
+        {
+            m_ends_at_eof = true;
+            break;
+        }
+        else if (read_status != vogl_trace_file_reader::cOK)
+        {
+            vogl_error_printf("Failed reading from trace file\n");
+            clear();
+            return false;
+        }
+
+        const vogl_trace_stream_packet_types_t packet_type = trace_reader.get_packet_type();
+        if (packet_type == cTSPTEOF)
+        {
+            m_ends_at_eof = true;
+            break;
+        }
+        else if (packet_type != cTSPTGLEntrypoint)
+        {
+            continue;
+        }
+
+        vogl_trace_packet *pPacket = vogl_new(vogl_trace_packet, pCtypes);
+        if (!pPacket->deserialize(trace_reader.get_packet_buf().get_ptr(), trace_reader.get_packet_buf().size(), false))
+        {
+            vogl_error_printf("Failed deserializing GL entrypoint packet\n");
+            vogl_delete(pPacket);
+            clear();
+            return false;
+        }
+
+        m_total_packet_bytes += trace_reader.get_packet_buf().size();
+
+        m_num_frames = trace_reader.get_cur_frame() - start_frame;
+
+        m_packets.push_back(pPacket);
+        m_frame_after_packet.push_back(m_num_frames);
+    }
+
+    vogl_verbose_printf("Recorded %u packets (%" PRIu64 " bytes) spanning %u frame(s) starting at frame %u\n", m_packets.size(), m_total_packet_bytes, m_num_frames, start_frame);
+
+    return true;
+}
@@ -0,0 +1,125 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_predecoded_frames.h
+#ifndef VOGL_PREDECODED_FRAMES_H
+#define VOGL_PREDECODED_FRAMES_H
+
+#include "vogl_common.h"
+#include "vogl_trace_packet.h"
+
+class vogl_trace_file_reader;
+
+//----------------------------------------------------------------------------------------------------------------------
+// class vogl_predecoded_frames
+// A range of frames read and decoded from a trace file once, so they can be replayed over and over (loop/benchmark modes)
+// without going back through the trace reader and packet deserializer on every iteration.
+// Only GL entrypoint packets are kept, with their client memory decoded up front. This only removes the reading and
+// decoding cost: every packet is still replayed by vogl_gl_replayer::process_next_packet(), including its handle lookups,
+// so replay time still includes the replayer's per-call overhead. It is not a compiled command buffer.
+//----------------------------------------------------------------------------------------------------------------------
+class vogl_predecoded_frames
+{
+    VOGL_NO_COPY_OR_ASSIGNMENT_OP(vogl_predecoded_frames);
+
+public:
+    vogl_predecoded_frames();
+    ~vogl_predecoded_frames();
+
+    void clear();
+
+    // Reads packets starting at the reader's current position until num_frames frames have been read, or until EOF.
+    // The reader is left positioned immediately after the last recorded packet. pCtypes must remain valid while the frames are used.
+    bool record(vogl_trace_file_reader &trace_reader, const vogl_ctypes *pCtypes, uint32_t num_frames);
+
+    bool is_empty() const
+    {
+        return m_packets.is_empty();
+    }
+
+    uint32_t size() const
+    {
+        return m_packets.size();
+    }
+
+    const vogl_trace_packet &get_packet(uint32_t index) const
+    {
+        return *m_packets[index];
+    }
+
+    // Total number of frames recorded (the last frame may be partial if the trace ended early).
+    uint32_t get_num_frames() const
+    {
+        return m_num_frames;
+    }
+
+    // True if recording stopped because the end of the trace was reached.
+    bool get_ends_at_eof() const
+    {
+        return m_ends_at_eof;
+    }
+
+    uint64_t get_total_packet_bytes() const
+    {
+        return m_total_packet_bytes;
+    }
+
+    // Playback cursor
+    void rewind()
+    {
+        m_cur_packet_index = 0;
+    }
+
+    // Returns NULL after the last packet.
+    const vogl_trace_packet *get_next_packet()
+    {
+        if (m_cur_packet_index >= m_packets.size())
+            return NULL;
+        return m_packets[m_cur_packet_index++];
+    }
+
+    uint32_t get_cur_packet_index() const
+    {
+        return m_cur_packet_index;
+    }
+
+    // Number of frames (swaps) executed since the last rewind().
+    uint32_t get_cur_frame() const
+    {
+        return m_cur_packet_index ? m_frame_after_packet[m_cur_packet_index - 1] : 0;
+    }
+
+private:
+    vogl::vector<vogl_trace_packet *> m_packets;
+    // Number of frames completed after each packet, relative to the first recorded frame.
+    vogl::vector<uint32_t> m_frame_after_packet;
+
+    uint32_t m_num_frames;
+    uint32_t m_cur_packet_index;
+    uint64_t m_total_packet_bytes;
+    bool m_ends_at_eof;
+};
+
+#endif // VOGL_PREDECODED_FRAMES_H
@@ -0,0 +1,595 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_program_binary_cache.cpp
+#include "vogl_program_binary_cache.h"
+#include "vogl_context_info.h"
+#include "vogl_program_state.h"
+#include "vogl_blob_manager.h"
+#include "vogl_file_utils.h"
+#include "vogl_port.h"
+
+#include <stdio.h>
+
+// Cache file layout: a header followed by the driver's program binary.
+#define VOGL_PROGRAM_BINARY_CACHE_MAGIC 0x43425056 // "VPBC"
+#define VOGL_PROGRAM_BINARY_CACHE_VERSION 1
+
+#pragma pack(push, 1)
+struct vogl_program_binary_cache_header
+{
+    uint32_t m_magic;
+    uint32_t m_version;
+    uint64_t m_key_lo;
+    uint64_t m_key_hi;
+    uint32_t m_binary_format;
+    uint32_t m_binary_size;
+};
+#pragma pack(pop)
+
+vogl_program_binary_cache *vogl_program_binary_cache::m_instance = 0;
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::vogl_program_binary_cache
+//----------------------------------------------------------------------------------------------------------------------
+vogl_program_binary_cache::vogl_program_binary_cache()
+    : m_total_hits(0),
+      m_total_misses(0),
+      m_total_rejected(0),
+      m_total_stored(0)
+{
+    VOGL_FUNC_TRACER
+
+    atexit(&cleanup);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::~vogl_program_binary_cache
+//----------------------------------------------------------------------------------------------------------------------
+vogl_program_binary_cache::~vogl_program_binary_cache()
+{
+    VOGL_FUNC_TRACER
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::cleanup
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::cleanup()
+{
+    delete m_instance;
+    m_instance = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::init
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_program_binary_cache::init(const dynamic_string &cache_dir)
+{
+    VOGL_FUNC_TRACER
+
+    deinit();
+
+    if (cache_dir.is_empty())
+        return false;
+
+    if ((!file_utils::does_dir_exist(cache_dir.get_ptr())) && (!file_utils::create_directories(cache_dir, false)))
+    {
+        vogl_error_printf("Failed creating program binary cache directory \"%s\"\n", cache_dir.get_ptr());
+        return false;
+    }
+
+    m_cache_dir = cache_dir;
+
+    vogl_message_printf("Using program binary cache directory \"%s\"\n", m_cache_dir.get_ptr());
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::deinit
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::deinit()
+{
+    VOGL_FUNC_TRACER
+
+    m_cache_dir.clear();
+
+    m_total_hits = 0;
+    m_total_misses = 0;
+    m_total_rejected = 0;
+    m_total_stored = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::is_usable
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_program_binary_cache::is_usable(const vogl_context_info &context_info) const
+{
+    VOGL_FUNC_TRACER
+
+    if (!is_enabled())
+        return false;
+
+    if ((!GL_ENTRYPOINT(glGetProgramBinary)) || (!GL_ENTRYPOINT(glProgramBinary)) || (!GL_ENTRYPOINT(glProgramParameteri)))
+        return false;
+
+    if ((context_info.get_version() < VOGL_GL_VERSION_4_1) && (!context_info.supports_extension("GL_ARB_get_program_binary")))
+        return false;
+
+    // Drivers may support the extension without supporting any binary formats (Mesa without its shader cache, for example).
+    return vogl_get_gl_integer(GL_NUM_PROGRAM_BINARY_FORMATS) > 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::key_builder::key_builder
+//----------------------------------------------------------------------------------------------------------------------
+vogl_program_binary_cache::key_builder::key_builder(const vogl_context_info &context_info)
+    : m_transform_feedback_mode(GL_NONE),
+      m_separable(false)
+{
+    m_driver.format("%s\n%s\n%s", context_info.get_vendor_str().get_ptr(), context_info.get_renderer_str().get_ptr(), context_info.get_version_str().get_ptr());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::key_builder::add_shader
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::key_builder::add_shader(GLenum type, const char *pSource)
+{
+    dynamic_string shader(cVarArg, "%08X\n", type);
+    if (pSource)
+        shader.append(pSource);
+
+    m_shaders.push_back(shader);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::key_builder::add_attached_shaders
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::key_builder::add_attached_shaders(GLuint program)
+{
+    GLint num_shaders = 0;
+    GL_ENTRYPOINT(glGetProgramiv)(program, GL_ATTACHED_SHADERS, &num_shaders);
+    if ((vogl_check_gl_error()) || (num_shaders <= 0))
+        return;
+
+    vogl::vector<GLuint> shaders(num_shaders);
+    GLsizei actual_num_shaders = 0;
+    GL_ENTRYPOINT(glGetAttachedShaders)(program, num_shaders, &actual_num_shaders, shaders.get_ptr());
+    if (vogl_check_gl_error())
+        return;
+
+    vogl::vector<GLchar> source;
+    for (GLsizei i = 0; i < math::minimum<GLsizei>(actual_num_shaders, num_shaders); i++)
+    {
+        GLint type = 0, source_len = 0;
+        GL_ENTRYPOINT(glGetShaderiv)(shaders[i], GL_SHADER_TYPE, &type);
+        GL_ENTRYPOINT(glGetShaderiv)(shaders[i], GL_SHADER_SOURCE_LENGTH, &source_len);
+
+        source.resize(math::maximum<GLint>(source_len, 0) + 1);
+        source[0] = '\0';
+
+        GLsizei actual_len = 0;
+        GL_ENTRYPOINT(glGetShaderSource)(shaders[i], source.size(), &actual_len, source.get_ptr());
+
+        if (vogl_check_gl_error())
+            continue;
+
+        add_shader(type, source.get_ptr());
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::key_builder::add_attrib_binding
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::key_builder::add_attrib_binding(const char *pName, GLint location)
+{
+    if ((!pName) || (!pName[0]) || (location < 0))
+        return;
+    if ((vogl_strnicmp(pName, "gl_", 3) == 0) || (vogl_strnicmp(pName, "_gl", 3) == 0))
+        return;
+
+    m_bindings.push_back(dynamic_string(cVarArg, "attrib %i %s", location, pName));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::key_builder::add_frag_data_binding
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::key_builder::add_frag_data_binding(const char *pName, GLint location, GLint location_index)
+{
+    if ((!pName) || (!pName[0]) || (vogl_strnicmp(pName, "gl_", 3) == 0))
+        return;
+
+    m_bindings.push_back(dynamic_string(cVarArg, "output %i %i %s", location, location_index, pName));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::key_builder::add_transform_feedback_varying
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::key_builder::add_transform_feedback_varying(const char *pName, GLint index)
+{
+    if (index < 0)
+        return;
+
+    m_bindings.push_back(dynamic_string(cVarArg, "varying %i %s", index, pName ? pName : ""));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::key_builder::set_transform_feedback_mode
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::key_builder::set_transform_feedback_mode(GLenum mode)
+{
+    m_transform_feedback_mode = mode;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::key_builder::set_separable
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::key_builder::set_separable(bool separable)
+{
+    m_separable = separable;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::key_builder::add_link_metadata
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::key_builder::add_link_metadata(const json_node &metadata)
+{
+    const json_node *pAttribs = metadata.find_child_array("active_attribs");
+    if (pAttribs)
+    {
+        for (uint32_t i = 0; i < pAttribs->size(); i++)
+        {
+            const json_node *pAttrib = pAttribs->get_child(i);
+            if (pAttrib)
+                add_attrib_binding(pAttrib->value_as_string_ptr("name"), pAttrib->value_as_int("location", -1));
+        }
+    }
+
+    const json_node *pOutputs = metadata.find_child_array("active_outputs");
+    if (pOutputs)
+    {
+        for (uint32_t i = 0; i < pOutputs->size(); i++)
+        {
+            const json_node *pOutput = pOutputs->get_child(i);
+            if (pOutput)
+                add_frag_data_binding(pOutput->value_as_string_ptr("name"), pOutput->value_as_int("location"), pOutput->value_as_int("location_index"));
+        }
+    }
+
+    if (metadata.value_as_int("transform_feedback_num_varyings"))
+    {
+        const json_node *pVaryings = metadata.find_child_array("transform_feedback_varyings");
+        if (pVaryings)
+        {
+            for (uint32_t i = 0; i < pVaryings->size(); i++)
+            {
+                const json_node *pVarying = pVaryings->get_child(i);
+                if (pVarying)
+                    add_transform_feedback_varying(pVarying->value_as_string_ptr("name"), pVarying->value_as_int("index", -1));
+            }
+
+            set_transform_feedback_mode(vogl_get_json_value_as_enum(metadata, "transform_feedback_mode"));
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::key_builder::get_key
+//----------------------------------------------------------------------------------------------------------------------
+hash128_t vogl_program_binary_cache::key_builder::get_key() const
+{
+    dynamic_string_array shaders(m_shaders);
+    shaders.sort();
+
+    dynamic_string_array bindings(m_bindings);
+    bindings.sort();
+
+    // Each string is preceeded by its length, so different splits of the same text can't collide.
+    uint8_vec data;
+    data.reserve(4096);
+
+    dynamic_string header(cVarArg, "%u %u %08X %u\n", VOGL_PROGRAM_BINARY_CACHE_VERSION, m_separable, m_transform_feedback_mode, shaders.size());
+    data.append(reinterpret_cast<const uint8_t *>(header.get_ptr()), header.get_len());
+
+    const dynamic_string_array *pArrays[2] = { &shaders, &bindings };
+    for (uint32_t a = 0; a < VOGL_ARRAY_SIZE(pArrays); a++)
+    {
+        for (uint32_t i = 0; i < pArrays[a]->size(); i++)
+        {
+            const dynamic_string &str = (*pArrays[a])[i];
+
+            uint32_t len = str.get_len();
+            data.append(reinterpret_cast<const uint8_t *>(&len), sizeof(len));
+            data.append(reinterpret_cast<const uint8_t *>(str.get_ptr()), len);
+        }
+    }
+
+    return calc_hash128(data.get_ptr(), data.size(), calc_crc64(CRC64_INIT, reinterpret_cast<const uint8_t *>(m_driver.get_ptr()), m_driver.get_len()));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::get_filename
+//----------------------------------------------------------------------------------------------------------------------
+dynamic_string vogl_program_binary_cache::get_filename(const hash128_t &key) const
+{
+    dynamic_string filename(cVarArg, "%016" PRIX64 "%016" PRIX64 ".bin", key.m_hi, key.m_lo);
+
+    dynamic_string path;
+    file_utils::combine_path(path, m_cache_dir.get_ptr(), filename.get_ptr());
+    return path;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::prepare_for_link
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::prepare_for_link(GLuint program)
+{
+    VOGL_FUNC_TRACER
+
+    GL_ENTRYPOINT(glProgramParameteri)(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    vogl_check_gl_error();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::load
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_program_binary_cache::load(GLuint program, const hash128_t &key)
+{
+    VOGL_FUNC_TRACER
+
+    GLenum binary_format = GL_NONE;
+    uint8_vec binary;
+    if (!read_entry(key, binary_format, binary))
+    {
+        m_total_misses++;
+        return false;
+    }
+
+    vogl_check_gl_error();
+
+    GL_ENTRYPOINT(glProgramBinary)(program, binary_format, binary.get_ptr(), binary.size());
+
+    bool gl_error = vogl_check_gl_error();
+
+    GLint link_status = GL_FALSE;
+    GL_ENTRYPOINT(glGetProgramiv)(program, GL_LINK_STATUS, &link_status);
+    vogl_check_gl_error();
+
+    if ((gl_error) || (!link_status))
+    {
+        dynamic_string filename(get_filename(key));
+        vogl_debug_printf("Driver rejected cached program binary \"%s\", deleting it\n", filename.get_ptr());
+        file_utils::delete_file(filename.get_ptr());
+        m_total_rejected++;
+        return false;
+    }
+
+    m_total_hits++;
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::store
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_program_binary_cache::store(GLuint program, const hash128_t &key)
+{
+    VOGL_FUNC_TRACER
+
+    vogl_check_gl_error();
+
+    GLint binary_size = 0;
+    GL_ENTRYPOINT(glGetProgramiv)(program, GL_PROGRAM_BINARY_LENGTH, &binary_size);
+    if ((vogl_check_gl_error()) || (binary_size <= 0))
+        return false;
+
+    uint8_vec binary(binary_size);
+
+    GLsizei actual_size = 0;
+    GLenum binary_format = GL_NONE;
+    GL_ENTRYPOINT(glGetProgramBinary)(program, binary_size, &actual_size, &binary_format, binary.get_ptr());
+    if ((vogl_check_gl_error()) || (actual_size <= 0) || (actual_size > binary_size))
+        return false;
+
+    binary.resize(actual_size);
+
+    if (!write_entry(key, binary_format, binary))
+        return false;
+
+    m_total_stored++;
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::read_entry
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_program_binary_cache::read_entry(const hash128_t &key, GLenum &binary_format, uint8_vec &binary)
+{
+    VOGL_FUNC_TRACER
+
+    dynamic_string filename(get_filename(key));
+
+    uint8_vec data;
+    if ((!file_utils::does_file_exist(filename.get_ptr())) || (!file_utils::read_file_to_vec(filename.get_ptr(), data)))
+        return false;
+
+    const vogl_program_binary_cache_header *pHeader = reinterpret_cast<const vogl_program_binary_cache_header *>(data.get_ptr());
+    if ((data.size() < sizeof(vogl_program_binary_cache_header)) ||
+        (pHeader->m_magic != VOGL_PROGRAM_BINARY_CACHE_MAGIC) ||
+        (pHeader->m_version != VOGL_PROGRAM_BINARY_CACHE_VERSION) ||
+        (pHeader->m_key_lo != key.m_lo) || (pHeader->m_key_hi != key.m_hi) ||
+        (pHeader->m_binary_size != data.size() - sizeof(vogl_program_binary_cache_header)))
+    {
+        vogl_warning_printf("Deleting invalid program binary cache file \"%s\"\n", filename.get_ptr());
+        file_utils::delete_file(filename.get_ptr());
+        return false;
+    }
+
+    binary_format = pHeader->m_binary_format;
+    binary.resize(0);
+    binary.append(data.get_ptr() + sizeof(vogl_program_binary_cache_header), pHeader->m_binary_size);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::write_entry
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_program_binary_cache::write_entry(const hash128_t &key, GLenum binary_format, const uint8_vec &binary)
+{
+    VOGL_FUNC_TRACER
+
+    uint8_vec data(sizeof(vogl_program_binary_cache_header));
+
+    vogl_program_binary_cache_header *pHeader = reinterpret_cast<vogl_program_binary_cache_header *>(data.get_ptr());
+    pHeader->m_magic = VOGL_PROGRAM_BINARY_CACHE_MAGIC;
+    pHeader->m_version = VOGL_PROGRAM_BINARY_CACHE_VERSION;
+    pHeader->m_key_lo = key.m_lo;
+    pHeader->m_key_hi = key.m_hi;
+    pHeader->m_binary_format = binary_format;
+    pHeader->m_binary_size = binary.size();
+
+    data.append(binary);
+
+    // Write to a temporary file and rename it, so other replayers sharing the cache never see a partial file.
+    dynamic_string filename(get_filename(key));
+    dynamic_string temp_filename(cVarArg, "%s.%u.tmp", filename.get_ptr(), static_cast<uint32_t>(plat_getpid()));
+
+    if (!file_utils::write_vec_to_file(temp_filename.get_ptr(), data))
+    {
+        vogl_warning_printf("Failed writing program binary cache file \"%s\"\n", temp_filename.get_ptr());
+        return false;
+    }
+
+    if (rename(temp_filename.get_ptr(), filename.get_ptr()) != 0)
+    {
+        file_utils::delete_file(temp_filename.get_ptr());
+        return false;
+    }
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache::print_stats
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_binary_cache::print_stats() const
+{
+    if (!is_enabled())
+        return;
+
+    vogl_printf("Program binary cache: %u hits, %u misses, %u rejected by driver, %u stored\n", m_total_hits, m_total_misses, m_total_rejected, m_total_stored);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_binary_cache_test
+// Stores a binary under the key the replayer builds from a live link's trace metadata, then checks that restoring a
+// snapshot of the same program looks it up under the same key.
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_program_binary_cache_test()
+{
+    static const char *s_pVS_source = "#version 330\nin vec4 pos;\nin vec2 uv;\nout vec2 v_uv;\nvoid main() { v_uv = uv; gl_Position = pos; }\n";
+    static const char *s_pFS_source = "#version 330\nin vec2 v_uv;\nout vec4 color;\nvoid main() { color = vec4(v_uv, 0, 1); }\n";
+
+    // glLinkProgram metadata as vogltrace writes it: built-in and unbound attribs are skipped.
+    static const char *s_pLink_metadata =
+        "{ \"program\" : 1, \"link_status\" : 1, \"total_active_attributes\" : 3,"
+        "  \"active_attribs\" : [ { \"index\" : 1, \"name\" : \"pos\", \"location\" : 0 }, { \"index\" : 2, \"name\" : \"uv\", \"location\" : 1 } ],"
+        "  \"total_active_outputs\" : 1,"
+        "  \"active_outputs\" : [ { \"index\" : 0, \"name\" : \"color\", \"location\" : 0, \"location_index\" : 0, \"type\" : 35666, \"array_size\" : 1, \"is_per_patch\" : 0 } ],"
+        "  \"transform_feedback_mode\" : \"GL_INTERLEAVED_ATTRIBS\", \"transform_feedback_num_varyings\" : 0 }";
+
+    vogl_context_info context_info;
+
+    dynamic_string cache_dir(file_utils::generate_temp_filename("vogl_program_binary_cache_test"));
+    vogl_program_binary_cache &cache = *vogl_program_binary_cache::get_instance();
+    if (!cache.init(cache_dir))
+        return false;
+
+    bool success = false;
+    hash128_t live_key, restore_key;
+
+    for (;;)
+    {
+        json_document link_metadata;
+        if (!link_metadata.deserialize(s_pLink_metadata))
+            break;
+
+        vogl_program_binary_cache::key_builder live_key_builder(context_info);
+        live_key_builder.add_shader(GL_VERTEX_SHADER, s_pVS_source);
+        live_key_builder.add_shader(GL_FRAGMENT_SHADER, s_pFS_source);
+        live_key_builder.add_link_metadata(*link_metadata.get_root());
+        live_key_builder.set_separable(false);
+        live_key = live_key_builder.get_key();
+
+        uint8_vec binary(1024);
+        for (uint32_t i = 0; i < binary.size(); i++)
+            binary[i] = static_cast<uint8_t>(i * 7);
+
+        if (!cache.write_entry(live_key, 0x1234, binary))
+            break;
+
+        // The same program as a snapshot serializes it: gl_VertexID is active but has no location.
+        vogl_memory_blob_manager blob_manager;
+        blob_manager.init(cBMFReadWrite);
+        dynamic_string vs_blob_id(blob_manager.add_buf_compute_unique_id(s_pVS_source, vogl_strlen(s_pVS_source), "vs", "txt"));
+        dynamic_string fs_blob_id(blob_manager.add_buf_compute_unique_id(s_pFS_source, vogl_strlen(s_pFS_source), "fs", "txt"));
+
+        dynamic_string snapshot(cVarArg,
+            "{ \"handle\" : 1, \"link_snapshot\" : true, \"link_status\" : true, \"separable\" : false, \"num_active_attribs\" : 3,"
+            "  \"shader_objects\" : [ { \"handle\" : 2, \"type\" : \"GL_VERTEX_SHADER\", \"source_blob_id\" : \"%s\" },"
+            "                         { \"handle\" : 3, \"type\" : \"GL_FRAGMENT_SHADER\", \"source_blob_id\" : \"%s\" } ],"
+            "  \"active_attribs\" : [ { \"name\" : \"gl_VertexID\", \"type\" : \"GL_INT\", \"size\" : 1, \"location\" : -1 },"
+            "                         { \"name\" : \"uv\", \"type\" : \"GL_FLOAT_VEC2\", \"size\" : 1, \"location\" : 1 },"
+            "                         { \"name\" : \"pos\", \"type\" : \"GL_FLOAT_VEC4\", \"size\" : 1, \"location\" : 0 } ],"
+            "  \"outputs\" : [ { \"index\" : 0, \"name\" : \"color\", \"location\" : 0, \"location_index\" : 0, \"type\" : \"GL_FLOAT_VEC4\", \"array_size\" : 1, \"is_per_patch\" : false } ],"
+            "  \"transform_feedback_mode\" : \"GL_INTERLEAVED_ATTRIBS\", \"transform_feedback_num_varyings\" : 0 }",
+            vs_blob_id.get_ptr(), fs_blob_id.get_ptr());
+
+        json_document snapshot_doc;
+        if (!snapshot_doc.deserialize(snapshot))
+            break;
+
+        vogl_program_state program_state;
+        if (!program_state.deserialize(*snapshot_doc.get_root(), blob_manager))
+            break;
+
+        restore_key = program_state.get_binary_cache_key(context_info);
+        if (restore_key != live_key)
+            break;
+
+        GLenum binary_format = GL_NONE;
+        uint8_vec cached_binary;
+        if ((!cache.read_entry(restore_key, binary_format, cached_binary)) || (binary_format != 0x1234) || (!(cached_binary == binary)))
+            break;
+
+        success = true;
+        break;
+    }
+
+    file_utils::delete_file(cache.get_filename(live_key).get_ptr());
+    cache.deinit();
+    remove(cache_dir.get_ptr());
+
+    return success;
+}
@@ -0,0 +1,160 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_program_binary_cache.h
+#ifndef VOGL_PROGRAM_BINARY_CACHE_H
+#define VOGL_PROGRAM_BINARY_CACHE_H
+
+#include "vogl_common.h"
+#include "vogl_hash.h"
+
+class vogl_context_info;
+
+//----------------------------------------------------------------------------------------------------------------------
+// class vogl_program_binary_cache
+// Persistent on-disk cache of linked GLSL program binaries (GL_ARB_get_program_binary), so replays and snapshot restores
+// of shader heavy traces don't have to recompile and relink every program on every run.
+// Entries are keyed by a 128-bit hash of the driver's vendor/renderer/version strings and everything that affects the
+// link: shader types and sources, attribute, frag data and transform feedback bindings, and the separable flag. Each
+// entry is a separate file in the cache directory. Binaries the driver rejects (e.g. after a driver update) are deleted,
+// and the caller falls back to compiling and linking normally.
+//----------------------------------------------------------------------------------------------------------------------
+class vogl_program_binary_cache
+{
+    VOGL_NO_COPY_OR_ASSIGNMENT_OP(vogl_program_binary_cache);
+
+public:
+    static vogl_program_binary_cache *get_instance()
+    {
+        if (!m_instance)
+            m_instance = new vogl_program_binary_cache;
+
+        return m_instance;
+    }
+
+    // Enables the cache. The directory is created if it doesn't exist.
+    bool init(const dynamic_string &cache_dir);
+    void deinit();
+
+    bool is_enabled() const
+    {
+        return !m_cache_dir.is_empty();
+    }
+
+    // True if the cache is enabled and the current context can get and set program binaries.
+    bool is_usable(const vogl_context_info &context_info) const;
+
+    class key_builder
+    {
+    public:
+        key_builder(const vogl_context_info &context_info);
+
+        void add_shader(GLenum type, const char *pSource);
+        // Adds the type and source of every shader currently attached to the program.
+        void add_attached_shaders(GLuint program);
+        // Bindings to built-in (gl_) names and negative locations are ignored, like they are when the bindings are set.
+        void add_attrib_binding(const char *pName, GLint location);
+        void add_frag_data_binding(const char *pName, GLint location, GLint location_index);
+        void add_transform_feedback_varying(const char *pName, GLint index);
+        void set_transform_feedback_mode(GLenum mode);
+        void set_separable(bool separable);
+
+        // Adds the attrib, frag data and transform feedback bindings from glLinkProgram trace metadata ("active_attribs",
+        // "active_outputs", "transform_feedback_*"). This is the only way bindings are added to keys: the replayer passes the
+        // trace's metadata, and snapshot restore passes vogl_program_state::get_link_metadata(), which records the same
+        // post-link queries in the same layout. So a binary stored by a live link is found again when a snapshot of that
+        // program is restored.
+        void add_link_metadata(const json_node &metadata);
+
+        // Shaders and bindings are sorted, so the order they're added in doesn't matter.
+        hash128_t get_key() const;
+
+        uint32_t get_num_shaders() const
+        {
+            return m_shaders.size();
+        }
+
+    private:
+        dynamic_string m_driver;
+        dynamic_string_array m_shaders;
+        dynamic_string_array m_bindings;
+        GLenum m_transform_feedback_mode;
+        bool m_separable;
+    };
+
+    // Call before linking a program which will be stored.
+    void prepare_for_link(GLuint program);
+
+    // On a hit, sets the program's binary with glProgramBinary. Returns true if the driver accepted it and the program is linked.
+    bool load(GLuint program, const hash128_t &key);
+
+    // Stores the binary of a successfully linked program.
+    bool store(GLuint program, const hash128_t &key);
+
+    // The file side of load() and store(), without GL.
+    bool read_entry(const hash128_t &key, GLenum &binary_format, uint8_vec &binary);
+    bool write_entry(const hash128_t &key, GLenum binary_format, const uint8_vec &binary);
+
+    // The cache file holding key's entry.
+    dynamic_string get_filename(const hash128_t &key) const;
+
+    uint32_t get_total_hits() const
+    {
+        return m_total_hits;
+    }
+    uint32_t get_total_misses() const
+    {
+        return m_total_misses;
+    }
+    uint32_t get_total_rejected() const
+    {
+        return m_total_rejected;
+    }
+    uint32_t get_total_stored() const
+    {
+        return m_total_stored;
+    }
+
+    void print_stats() const;
+
+private:
+    vogl_program_binary_cache();
+    ~vogl_program_binary_cache();
+
+    static void cleanup();
+
+    static vogl_program_binary_cache *m_instance;
+
+    dynamic_string m_cache_dir;
+
+    uint32_t m_total_hits;
+    uint32_t m_total_misses;
+    uint32_t m_total_rejected;
+    uint32_t m_total_stored;
+};
+
+bool vogl_program_binary_cache_test();
+
+#endif // VOGL_PROGRAM_BINARY_CACHE_H
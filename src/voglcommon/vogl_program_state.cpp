@@ -27,6 +27,7 @@
 // TODO: Remap uniform block locations
 
 #include "vogl_program_state.h"
+#include "vogl_program_binary_cache.h"
 
 #define VOGL_PROGRAM_VERSION 0x0101
 
@@ -1276,10 +1277,73 @@ bool vogl_program_state::restore_transform_feedback(uint32_t handle32, const vog
     return true;
 }
 
-bool vogl_program_state::restore_link_snapshot(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, bool &any_restore_warnings, bool &any_gl_errors, bool &link_succeeded) const
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_state::get_link_metadata
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_program_state::get_link_metadata(json_node &node) const
 {
     VOGL_FUNC_TRACER
 
+    json_node &attribs_array = node.add_array("active_attribs");
+    for (uint32_t i = 0; i < math::minimum<uint32_t>(m_num_active_attribs, m_attribs.size()); i++)
+    {
+        json_node &attrib_node = attribs_array.add_object();
+        attrib_node.add_key_value("index", i);
+        attrib_node.add_key_value("name", m_attribs[i].m_name);
+        attrib_node.add_key_value("location", m_attribs[i].m_bound_location);
+    }
+
+    json_node &outputs_array = node.add_array("active_outputs");
+    for (uint32_t i = 0; i < m_outputs.size(); i++)
+    {
+        json_node &output_node = outputs_array.add_object();
+        output_node.add_key_value("index", i);
+        output_node.add_key_value("name", m_outputs[i].m_name);
+        output_node.add_key_value("location", m_outputs[i].m_location);
+        output_node.add_key_value("location_index", m_outputs[i].m_location_index);
+    }
+
+    node.add_key_value("transform_feedback_mode", get_gl_enums().find_gl_name(m_transform_feedback_mode));
+    node.add_key_value("transform_feedback_num_varyings", m_varyings.size());
+
+    json_node &varyings_array = node.add_array("transform_feedback_varyings");
+    for (uint32_t i = 0; i < m_varyings.size(); i++)
+    {
+        json_node &varying_node = varyings_array.add_object();
+        varying_node.add_key_value("index", m_varyings[i].m_index);
+        varying_node.add_key_value("name", m_varyings[i].m_name);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_program_state::get_binary_cache_key
+//----------------------------------------------------------------------------------------------------------------------
+hash128_t vogl_program_state::get_binary_cache_key(const vogl_context_info &context_info) const
+{
+    VOGL_FUNC_TRACER
+
+    vogl_program_binary_cache::key_builder cache_key_builder(context_info);
+
+    for (uint32_t i = 0; i < m_shaders.size(); i++)
+        cache_key_builder.add_shader(m_shaders[i].get_shader_type(), m_shaders[i].get_source().get_ptr());
+
+    json_document link_metadata;
+    get_link_metadata(*link_metadata.get_root());
+    cache_key_builder.add_link_metadata(*link_metadata.get_root());
+
+    cache_key_builder.set_separable(m_separable);
+
+    return cache_key_builder.get_key();
+}
+
+bool vogl_program_state::restore_link_snapshot(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, vogl_program_restore_pending &pending) const
+{
+    VOGL_FUNC_TRACER
+
+    bool &any_restore_warnings = pending.m_any_restore_warnings;
+    bool &any_gl_errors = pending.m_any_gl_errors;
+    bool &link_succeeded = pending.m_link_succeeded;
+
     if (vogl_check_gl_error())
         any_gl_errors = true;
 
@@ -1299,6 +1363,15 @@ bool vogl_program_state::restore_link_snapshot(uint32_t handle32, const vogl_con
 
     uint_vec shader_handles;
 
+    // Built from the same link metadata the replayer keys live links with, so restores can reuse binaries stored during
+    // earlier replays and skip compiling and linking entirely.
+    vogl_program_binary_cache *pBinary_cache = vogl_program_binary_cache::get_instance();
+    bool use_binary_cache = (m_shaders.size() > 0) && (pBinary_cache->is_usable(context_info));
+    hash128_t binary_cache_key;
+
+    if (use_binary_cache)
+        binary_cache_key = get_binary_cache_key(context_info);
+
     if (m_program_binary.size())
     {
         GL_ENTRYPOINT(glProgramBinary)(handle32, m_program_binary_format, m_program_binary.get_ptr(), m_program_binary.size());
@@ -1311,6 +1384,13 @@ bool vogl_program_state::restore_link_snapshot(uint32_t handle32, const vogl_con
             link_succeeded = true;
     }
 
+    if ((!link_succeeded) && (use_binary_cache))
+    {
+        link_succeeded = pBinary_cache->load(handle32, binary_cache_key);
+        if (!link_succeeded)
+            pBinary_cache->prepare_for_link(handle32);
+    }
+
     if ((!link_succeeded) && (m_shaders.size()))
     {
         shader_handles.resize(m_shaders.size());
@@ -1321,15 +1401,10 @@ bool vogl_program_state::restore_link_snapshot(uint32_t handle32, const vogl_con
             if ((vogl_check_gl_error()) || (!shader_handles[i]))
                 goto handle_error;
 
+            // The compile status is checked by finish_link_shaders(), after the link.
             GLuint64 handle = shader_handles[i];
-            if (!m_shaders[i].restore(context_info, remapper, handle))
+            if (!m_shaders[i].restore_begin(context_info, remapper, handle))
                 goto handle_error;
-
-            if (!m_shaders[i].get_restore_compile_status())
-            {
-                vogl_warning_printf("Failed compiling shadowed link-time shader while restoring program, trace program %u GL program %u\n", m_snapshot_handle, handle32);
-                any_restore_warnings = true;
-            }
         }
 
         for (uint32_t i = 0; i < m_shaders.size(); i++)
@@ -1352,21 +1427,16 @@ bool vogl_program_state::restore_link_snapshot(uint32_t handle32, const vogl_con
             vogl_warning_printf("GL error while linking link-time snapshot program on trace program %u GL program %u\n", m_snapshot_handle, handle32);
             any_gl_errors = true;
         }
-        else if (get_program_bool(handle32, GL_LINK_STATUS))
-            link_succeeded = true;
-
-        for (uint32_t i = 0; i < shader_handles.size(); i++)
+        else
         {
-            GL_ENTRYPOINT(glDetachShader)(handle32, shader_handles[i]);
-            if (vogl_check_gl_error())
-                any_gl_errors = true;
-
-            GL_ENTRYPOINT(glDeleteShader)(shader_handles[i]);
-            shader_handles[i] = 0;
-
-            if (vogl_check_gl_error())
-                any_gl_errors = true;
+            // Don't wait for the link here, restore_end() picks up the link status.
+            pending.m_link_submitted = true;
+            pending.m_store_in_binary_cache = use_binary_cache;
+            pending.m_binary_cache_key = binary_cache_key;
         }
+
+        pending.m_pLink_shader_owner = this;
+        pending.m_link_shader_handles.swap(shader_handles);
     }
 
     return true;
@@ -1382,20 +1452,53 @@ handle_error:
     return false;
 }
 
-bool vogl_program_state::link_program(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, bool &any_restore_warnings, bool &any_gl_errors, bool &link_succeeded) const
+void vogl_program_state::finish_link_shaders(uint32_t handle32, vogl_program_restore_pending &pending) const
 {
     VOGL_FUNC_TRACER
 
+    const vogl_program_state *pOwner = pending.m_pLink_shader_owner;
+
+    for (uint32_t i = 0; i < pending.m_link_shader_handles.size(); i++)
+    {
+        GLuint shader_handle = pending.m_link_shader_handles[i];
+
+        pOwner->m_shaders[i].restore_end(shader_handle);
+        if (!pOwner->m_shaders[i].get_restore_compile_status())
+        {
+            vogl_warning_printf("Failed compiling shadowed link-time shader while restoring program, trace program %u GL program %u\n", pOwner->m_snapshot_handle, handle32);
+            pending.m_any_restore_warnings = true;
+        }
+
+        GL_ENTRYPOINT(glDetachShader)(handle32, shader_handle);
+        if (vogl_check_gl_error())
+            pending.m_any_gl_errors = true;
+
+        GL_ENTRYPOINT(glDeleteShader)(shader_handle);
+        if (vogl_check_gl_error())
+            pending.m_any_gl_errors = true;
+    }
+
+    pending.m_link_shader_handles.clear();
+    pending.m_pLink_shader_owner = NULL;
+}
+
+bool vogl_program_state::link_program(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, vogl_program_restore_pending &pending) const
+{
+    VOGL_FUNC_TRACER
+
+    bool &any_restore_warnings = pending.m_any_restore_warnings;
+    bool &any_gl_errors = pending.m_any_gl_errors;
+
     if (vogl_check_gl_error())
         any_gl_errors = true;
 
     if (m_link_snapshot)
-        return restore_link_snapshot(handle32, context_info, remapper, any_restore_warnings, any_gl_errors, link_succeeded);
+        return restore_link_snapshot(handle32, context_info, remapper, pending);
 
     // First restore the program's linked state.
     if (m_pLink_time_snapshot.get())
     {
-        if (!m_pLink_time_snapshot->link_program(handle32, context_info, remapper, any_restore_warnings, any_gl_errors, link_succeeded))
+        if (!m_pLink_time_snapshot->link_program(handle32, context_info, remapper, pending))
             return false;
     }
 
@@ -1436,16 +1539,27 @@ bool vogl_program_state::restore(const vogl_context_info &context_info, vogl_han
 {
     VOGL_FUNC_TRACER
 
-    VOGL_NOTE_UNUSED(context_info);
+    vogl_program_restore_pending pending;
+    pending.m_handle = handle;
+
+    bool success = restore_begin(context_info, remapper, pending);
+    if (success)
+        success = restore_end(context_info, remapper, pending);
+
+    handle = pending.m_handle;
+    return success;
+}
+
+bool vogl_program_state::restore_begin(const vogl_context_info &context_info, vogl_handle_remapper &remapper, vogl_program_restore_pending &pending) const
+{
+    VOGL_FUNC_TRACER
 
     VOGL_CHECK_GL_ERROR;
 
     if (!m_is_valid)
         return false;
 
-    vogl_scoped_binding_state orig_binding(GL_PROGRAM);
-
-    bool created_handle = false;
+    GLuint64 &handle = pending.m_handle;
 
     if (!handle)
     {
@@ -1469,27 +1583,68 @@ bool vogl_program_state::restore(const vogl_context_info &context_info, vogl_han
         remapper.declare_handle(VOGL_NAMESPACE_PROGRAMS, m_snapshot_handle, handle, GL_NONE);
         VOGL_ASSERT(remapper.remap_handle(VOGL_NAMESPACE_PROGRAMS, m_snapshot_handle) == handle);
 
-        created_handle = true;
+        pending.m_created_handle = true;
     }
 
     VOGL_ASSERT(handle <= cUINT32_MAX);
     GLuint handle32 = static_cast<GLuint>(handle);
 
-    bool any_gl_errors = false;
-    bool any_restore_warnings = false;
-
-    bool link_succeeded = false;
-
     if (m_link_entrypoint == VOGL_ENTRYPOINT_glCreateShaderProgramv)
     {
-        link_succeeded = get_program_bool(handle32, GL_LINK_STATUS);
+        pending.m_link_succeeded = get_program_bool(handle32, GL_LINK_STATUS);
     }
     else
     {
-        if (!link_program(handle32, context_info, remapper, any_restore_warnings, any_gl_errors, link_succeeded))
+        if (!link_program(handle32, context_info, remapper, pending))
             goto handle_error;
     }
 
+    return true;
+
+handle_error:
+    vogl_error_printf("Failed restoring trace program %u GL program %u\n", m_snapshot_handle, handle32);
+
+    finish_link_shaders(handle32, pending);
+
+    if ((handle) && (pending.m_created_handle))
+    {
+        remapper.delete_handle_and_object(VOGL_NAMESPACE_PROGRAMS, m_snapshot_handle, handle);
+
+        handle = 0;
+    }
+
+    return false;
+}
+
+bool vogl_program_state::restore_end(const vogl_context_info &context_info, vogl_handle_remapper &remapper, vogl_program_restore_pending &pending) const
+{
+    VOGL_FUNC_TRACER
+
+    vogl_scoped_binding_state orig_binding(GL_PROGRAM);
+
+    GLuint64 &handle = pending.m_handle;
+    VOGL_ASSERT(handle <= cUINT32_MAX);
+    GLuint handle32 = static_cast<GLuint>(handle);
+
+    bool &any_gl_errors = pending.m_any_gl_errors;
+    bool &any_restore_warnings = pending.m_any_restore_warnings;
+    bool &link_succeeded = pending.m_link_succeeded;
+
+    if (pending.m_link_submitted)
+    {
+        pending.m_link_submitted = false;
+
+        if (get_program_bool(handle32, GL_LINK_STATUS))
+        {
+            link_succeeded = true;
+
+            if (pending.m_store_in_binary_cache)
+                vogl_program_binary_cache::get_instance()->store(handle32, pending.m_binary_cache_key);
+        }
+    }
+
+    finish_link_shaders(handle32, pending);
+
     if ((m_pLink_time_snapshot.get()) && (link_succeeded != m_pLink_time_snapshot->m_link_status))
     {
         if (!link_succeeded)
@@ -1543,7 +1698,7 @@ bool vogl_program_state::restore(const vogl_context_info &context_info, vogl_han
 handle_error:
     vogl_error_printf("Failed restoring trace program %u GL program %u\n", m_snapshot_handle, handle32);
 
-    if ((handle) && (created_handle))
+    if ((handle) && (pending.m_created_handle))
     {
         GL_ENTRYPOINT(glUseProgram)(0);
         VOGL_CHECK_GL_ERROR;
@@ -29,6 +29,7 @@
 
 #include "vogl_common.h"
 #include "vogl_dynamic_string.h"
+#include "vogl_hash.h"
 #include "vogl_json.h"
 #include "vogl_map.h"
 #include "vogl_unique_ptr.h"
@@ -184,6 +185,47 @@ struct vogl_program_transform_feedback_varying
 
 typedef vogl::vector<vogl_program_transform_feedback_varying> vogl_program_transform_feedback_varying_vec;
 
+class vogl_program_state;
+
+// Work vogl_program_state::restore_begin() has handed to GL without waiting on it yet, finished by restore_end().
+struct vogl_program_restore_pending
+{
+    vogl_program_restore_pending()
+    {
+        clear();
+    }
+
+    void clear()
+    {
+        m_handle = 0;
+        m_pLink_shader_owner = NULL;
+        m_link_shader_handles.clear();
+        m_binary_cache_key.m_lo = 0;
+        m_binary_cache_key.m_hi = 0;
+        m_created_handle = false;
+        m_link_submitted = false;
+        m_link_succeeded = false;
+        m_store_in_binary_cache = false;
+        m_any_restore_warnings = false;
+        m_any_gl_errors = false;
+    }
+
+    GLuint64 m_handle;
+
+    // Temporary shaders compiled from a link time snapshot, owned by m_pLink_shader_owner->m_shaders.
+    const vogl_program_state *m_pLink_shader_owner;
+    uint_vec m_link_shader_handles;
+
+    hash128_t m_binary_cache_key;
+
+    bool m_created_handle;
+    bool m_link_submitted;
+    bool m_link_succeeded;
+    bool m_store_in_binary_cache;
+    bool m_any_restore_warnings;
+    bool m_any_gl_errors;
+};
+
 class vogl_program_state : public vogl_gl_object_state
 {
 public:
@@ -206,6 +248,12 @@ public:
 
     virtual bool restore(const vogl_context_info &context_info, vogl_handle_remapper &remapper, GLuint64 &handle) const;
 
+    // restore() split in two, like vogl_shader_state::restore_begin(). restore_begin() creates the program and submits its
+    // compiles and link, restore_end() waits for the link and restores the state that needs a linked program (uniforms etc.)
+    // pending.m_handle is the in/out handle restore() takes.
+    bool restore_begin(const vogl_context_info &context_info, vogl_handle_remapper &remapper, vogl_program_restore_pending &pending) const;
+    bool restore_end(const vogl_context_info &context_info, vogl_handle_remapper &remapper, vogl_program_restore_pending &pending) const;
+
     virtual bool remap_handles(vogl_handle_remapper &remapper);
 
     virtual void clear();
@@ -258,6 +306,12 @@ public:
         return m_link_snapshot;
     }
 
+    // Writes this program's attrib, output and transform feedback bindings in the layout of vogltrace's glLinkProgram metadata.
+    void get_link_metadata(json_node &node) const;
+
+    // The program binary cache key of this program, built the same way the replayer builds it for a live link.
+    hash128_t get_binary_cache_key(const vogl_context_info &context_info) const;
+
     bool get_link_status() const
     {
         return m_link_status;
@@ -409,8 +463,9 @@ private:
     bool restore_active_attribs(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, bool &any_restore_warnings, bool &any_gl_errors) const;
     bool restore_outputs(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, bool &any_restore_warnings, bool &any_gl_errors) const;
     bool restore_transform_feedback(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, bool &any_restore_warnings, bool &any_gl_errors) const;
-    bool restore_link_snapshot(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, bool &any_restore_warnings, bool &any_gl_errors, bool &link_succeeded) const;
-    bool link_program(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, bool &any_restore_warnings, bool &any_gl_errors, bool &link_succeeded) const;
+    bool restore_link_snapshot(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, vogl_program_restore_pending &pending) const;
+    bool link_program(uint32_t handle32, const vogl_context_info &context_info, vogl_handle_remapper &remapper, vogl_program_restore_pending &pending) const;
+    void finish_link_shaders(uint32_t handle32, vogl_program_restore_pending &pending) const;
 };
 
 typedef vogl::map<GLuint, vogl_program_state> vogl_program_state_map;
@@ -0,0 +1,439 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_replay_profiler.cpp
+#include "vogl_replay_profiler.h"
+#include "vogl_trace_packet.h"
+#include "vogl_cfile_stream.h"
+#include "vogl_json.h"
+#include "vogl_file_utils.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+// entrypoint_time_sorter
+//----------------------------------------------------------------------------------------------------------------------
+struct entrypoint_time_sorter
+{
+    entrypoint_time_sorter(const vogl::vector<vogl_replay_profiler::entrypoint_stats> &stats)
+        : m_stats(stats)
+    {
+    }
+
+    bool operator()(gl_entrypoint_id_t lhs, gl_entrypoint_id_t rhs) const
+    {
+        return m_stats[lhs].m_times.m_total_ticks > m_stats[rhs].m_times.m_total_ticks;
+    }
+
+    const vogl::vector<vogl_replay_profiler::entrypoint_stats> &m_stats;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::vogl_replay_profiler
+//----------------------------------------------------------------------------------------------------------------------
+vogl_replay_profiler::vogl_replay_profiler()
+    : m_total_calls(0),
+      m_trace_ticks_per_sec(0),
+      m_record_timeline(false),
+      m_pending_decode_ticks(0),
+      m_call_start_ticks(0),
+      m_cur_driver_ticks(0),
+      m_driver_call_start_ticks(0),
+      m_in_call(false),
+      m_callbacks_installed(false),
+      m_pPrev_prolog_func(NULL),
+      m_pPrev_prolog_user_data(NULL),
+      m_pPrev_epilog_func(NULL),
+      m_pPrev_epilog_user_data(NULL)
+{
+    VOGL_FUNC_TRACER
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::~vogl_replay_profiler
+//----------------------------------------------------------------------------------------------------------------------
+vogl_replay_profiler::~vogl_replay_profiler()
+{
+    VOGL_FUNC_TRACER
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::init
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_replay_profiler::init(bool record_timeline)
+{
+    VOGL_FUNC_TRACER
+
+    m_record_timeline = record_timeline;
+
+    if (!m_trace_ticks_per_sec)
+        m_trace_ticks_per_sec = estimate_trace_ticks_per_sec();
+
+    reset();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::reset
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_replay_profiler::reset()
+{
+    VOGL_FUNC_TRACER
+
+    m_entrypoints.clear();
+    m_entrypoints.resize(VOGL_NUM_ENTRYPOINTS);
+    m_frames.clear();
+    m_timeline.clear();
+    m_totals.clear();
+    m_total_calls = 0;
+
+    m_pending_decode_ticks = 0;
+    m_cur_driver_ticks = 0;
+    m_in_call = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::estimate_trace_ticks_per_sec
+//----------------------------------------------------------------------------------------------------------------------
+double vogl_replay_profiler::estimate_trace_ticks_per_sec()
+{
+    VOGL_FUNC_TRACER
+
+    // Without a reliable TSC vogltrace falls back to CLOCK_MONOTONIC nanoseconds.
+    if (!utils::init_rdtsc())
+        return 1000000000.0;
+
+    timer_ticks start_ticks = timer::get_ticks();
+    uint64_t start_tsc = utils::RDTSC();
+
+    vogl_sleep(50);
+
+    timer_ticks end_ticks = timer::get_ticks();
+    uint64_t end_tsc = utils::RDTSC();
+
+    double secs = timer::ticks_to_secs(end_ticks - start_ticks);
+    return (secs > 0.0) ? ((end_tsc - start_tsc) / secs) : 0.0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::install_gl_callbacks
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_replay_profiler::install_gl_callbacks(bool install)
+{
+    VOGL_FUNC_TRACER
+
+    if (install == m_callbacks_installed)
+        return;
+
+    if (install)
+    {
+        // Chain to whatever was installed before us (-gl_debug_log, etc.).
+        m_pPrev_prolog_func = vogl_get_direct_gl_func_prolog(&m_pPrev_prolog_user_data);
+        m_pPrev_epilog_func = vogl_get_direct_gl_func_epilog(&m_pPrev_epilog_user_data);
+
+        vogl_set_direct_gl_func_prolog(gl_func_prolog, this);
+        vogl_set_direct_gl_func_epilog(gl_func_epilog, this);
+    }
+    else
+    {
+        vogl_set_direct_gl_func_prolog(m_pPrev_prolog_func, m_pPrev_prolog_user_data);
+        vogl_set_direct_gl_func_epilog(m_pPrev_epilog_func, m_pPrev_epilog_user_data);
+
+        m_pPrev_prolog_func = NULL;
+        m_pPrev_prolog_user_data = NULL;
+        m_pPrev_epilog_func = NULL;
+        m_pPrev_epilog_user_data = NULL;
+    }
+
+    m_callbacks_installed = install;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::gl_func_prolog
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_replay_profiler::gl_func_prolog(gl_entrypoint_id_t entrypoint_id, void *pUser_data, void **ppStack_data)
+{
+    vogl_replay_profiler *pProfiler = static_cast<vogl_replay_profiler *>(pUser_data);
+
+    // The chained callback runs outside of the measured interval.
+    if (pProfiler->m_pPrev_prolog_func)
+        pProfiler->m_pPrev_prolog_func(entrypoint_id, pProfiler->m_pPrev_prolog_user_data, ppStack_data);
+
+    pProfiler->m_driver_call_start_ticks = timer::get_ticks();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::gl_func_epilog
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_replay_profiler::gl_func_epilog(gl_entrypoint_id_t entrypoint_id, void *pUser_data, void **ppStack_data)
+{
+    vogl_replay_profiler *pProfiler = static_cast<vogl_replay_profiler *>(pUser_data);
+
+    // GL calls made outside of a replayed call (snapshotting, window setup) aren't attributed to anything.
+    if (pProfiler->m_in_call)
+        pProfiler->m_cur_driver_ticks += timer::get_ticks() - pProfiler->m_driver_call_start_ticks;
+
+    if (pProfiler->m_pPrev_epilog_func)
+        pProfiler->m_pPrev_epilog_func(entrypoint_id, pProfiler->m_pPrev_epilog_user_data, ppStack_data);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::end_call
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_replay_profiler::end_call(const vogl_trace_packet &gl_packet, uint32_t frame_index)
+{
+    timer_ticks end_ticks = timer::get_ticks();
+
+    m_in_call = false;
+
+    gl_entrypoint_id_t entrypoint_id = gl_packet.get_entrypoint_id();
+    if ((entrypoint_id < 0) || (entrypoint_id >= VOGL_NUM_ENTRYPOINTS) || (m_entrypoints.size() != VOGL_NUM_ENTRYPOINTS))
+        return;
+
+    const vogl_trace_gl_entrypoint_packet &entrypoint_packet = gl_packet.get_entrypoint_packet();
+
+    time_split times;
+    times.m_decode_ticks = m_pending_decode_ticks;
+    times.m_total_ticks = end_ticks - m_call_start_ticks;
+    times.m_driver_ticks = math::minimum(m_cur_driver_ticks, times.m_total_ticks);
+    if (entrypoint_packet.m_gl_end_rdtsc > entrypoint_packet.m_gl_begin_rdtsc)
+        times.m_trace_ticks = entrypoint_packet.m_gl_end_rdtsc - entrypoint_packet.m_gl_begin_rdtsc;
+
+    m_pending_decode_ticks = 0;
+
+    entrypoint_stats &stats = m_entrypoints[entrypoint_id];
+    stats.m_num_calls++;
+    stats.m_times.add(times);
+
+    if ((m_frames.is_empty()) || (m_frames.back().m_frame_index != frame_index))
+    {
+        frame_stats *pFrame = m_frames.enlarge(1);
+        pFrame->m_frame_index = frame_index;
+    }
+    m_frames.back().m_num_calls++;
+    m_frames.back().m_times.add(times);
+
+    m_totals.add(times);
+    m_total_calls++;
+
+    if (m_record_timeline)
+    {
+        call_record *pRecord = m_timeline.enlarge(1);
+        pRecord->m_call_counter = gl_packet.get_call_counter();
+        pRecord->m_entrypoint_id = entrypoint_id;
+        pRecord->m_frame_index = frame_index;
+        pRecord->m_times = times;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::print_report
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_replay_profiler::print_report(uint32_t max_entrypoints) const
+{
+    VOGL_FUNC_TRACER
+
+    if (!m_total_calls)
+        return;
+
+    vogl::vector<gl_entrypoint_id_t> ids;
+    for (uint32_t i = 0; i < m_entrypoints.size(); i++)
+        if (m_entrypoints[i].m_num_calls)
+            ids.push_back(static_cast<gl_entrypoint_id_t>(i));
+
+    // Most expensive first
+    ids.sort(entrypoint_time_sorter(m_entrypoints));
+
+    vogl_printf("Replay profile: %" PRIu64 " calls, %u frames\n", m_total_calls, m_frames.size());
+    vogl_printf("  Decode: %.3f ms, Replayer: %.3f ms, Driver: %.3f ms, Trace GL: %.3f ms\n",
+                timer::ticks_to_ms(m_totals.m_decode_ticks), timer::ticks_to_ms(m_totals.get_replayer_ticks()),
+                timer::ticks_to_ms(m_totals.m_driver_ticks), trace_ticks_to_ms(m_totals.m_trace_ticks));
+
+    vogl_printf("%-40s %10s %11s %11s %11s %11s %9s %8s\n", "Entrypoint", "Calls", "Decode ms", "Replayer ms", "Driver ms", "Trace GL ms", "Drv/Trace", "us/call");
+
+    for (uint32_t i = 0; i < math::minimum(ids.size(), max_entrypoints); i++)
+    {
+        const entrypoint_stats &stats = m_entrypoints[ids[i]];
+
+        double driver_ms = timer::ticks_to_ms(stats.m_times.m_driver_ticks);
+        double trace_ms = trace_ticks_to_ms(stats.m_times.m_trace_ticks);
+
+        vogl_printf("%-40s %10" PRIu64 " %11.3f %11.3f %11.3f %11.3f %9.2f %8.3f\n",
+                    g_vogl_entrypoint_descs[ids[i]].m_pName, stats.m_num_calls,
+                    timer::ticks_to_ms(stats.m_times.m_decode_ticks), timer::ticks_to_ms(stats.m_times.get_replayer_ticks()),
+                    driver_ms, trace_ms, (trace_ms > 0.0) ? (driver_ms / trace_ms) : 0.0,
+                    (timer::ticks_to_secs(stats.m_times.m_total_ticks) * 1000000.0) / stats.m_num_calls);
+    }
+
+    if (m_frames.size())
+    {
+        uint32_t slowest_frame = 0;
+        timer_ticks min_frame_ticks = cUINT64_MAX;
+        for (uint32_t i = 0; i < m_frames.size(); i++)
+        {
+            timer_ticks frame_ticks = m_frames[i].m_times.m_decode_ticks + m_frames[i].m_times.m_total_ticks;
+            min_frame_ticks = math::minimum(min_frame_ticks, frame_ticks);
+            if (frame_ticks > (m_frames[slowest_frame].m_times.m_decode_ticks + m_frames[slowest_frame].m_times.m_total_ticks))
+                slowest_frame = i;
+        }
+
+        const frame_stats &slowest = m_frames[slowest_frame];
+        vogl_printf("Frames: avg %.3f ms, min %.3f ms, max %.3f ms (frame %u: decode %.3f ms, replayer %.3f ms, driver %.3f ms, trace GL %.3f ms)\n",
+                    timer::ticks_to_ms(m_totals.m_decode_ticks + m_totals.m_total_ticks) / m_frames.size(),
+                    timer::ticks_to_ms(min_frame_ticks),
+                    timer::ticks_to_ms(slowest.m_times.m_decode_ticks + slowest.m_times.m_total_ticks), slowest.m_frame_index,
+                    timer::ticks_to_ms(slowest.m_times.m_decode_ticks), timer::ticks_to_ms(slowest.m_times.get_replayer_ticks()),
+                    timer::ticks_to_ms(slowest.m_times.m_driver_ticks), trace_ticks_to_ms(slowest.m_times.m_trace_ticks));
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::write_timeline
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_replay_profiler::write_timeline(const char *pFilename) const
+{
+    VOGL_FUNC_TRACER
+
+    cfile_stream stream;
+    if (!stream.open(pFilename, cDataStreamWritable))
+    {
+        vogl_error_printf("Failed opening profile timeline file \"%s\"\n", pFilename);
+        return false;
+    }
+
+    dynamic_string ext(pFilename);
+    file_utils::get_extension(ext);
+
+    bool success = ext.compare("json", false) ? write_timeline_csv(stream) : write_timeline_json(stream);
+
+    if ((!stream.close()) || (!success))
+    {
+        vogl_error_printf("Failed writing profile timeline file \"%s\"\n", pFilename);
+        return false;
+    }
+
+    vogl_printf("Wrote profile timeline to \"%s\"\n", pFilename);
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::write_timeline_csv
+// Frames are rows with an empty call counter and entrypoint.
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_replay_profiler::write_timeline_csv(data_stream &stream) const
+{
+    VOGL_FUNC_TRACER
+
+    bool success = stream.puts("type,frame,call_counter,entrypoint,decode_ms,replayer_ms,driver_ms,trace_gl_ms\n");
+
+    for (uint32_t i = 0; (i < m_frames.size()) && (success); i++)
+    {
+        const frame_stats &frame = m_frames[i];
+        success = stream.printf("frame,%u,,,%f,%f,%f,%f\n", frame.m_frame_index,
+                                timer::ticks_to_ms(frame.m_times.m_decode_ticks), timer::ticks_to_ms(frame.m_times.get_replayer_ticks()),
+                                timer::ticks_to_ms(frame.m_times.m_driver_ticks), trace_ticks_to_ms(frame.m_times.m_trace_ticks));
+    }
+
+    for (uint32_t i = 0; (i < m_timeline.size()) && (success); i++)
+    {
+        const call_record &rec = m_timeline[i];
+        success = stream.printf("call,%u,%" PRIu64 ",%s,%f,%f,%f,%f\n", rec.m_frame_index, rec.m_call_counter, g_vogl_entrypoint_descs[rec.m_entrypoint_id].m_pName,
+                                timer::ticks_to_ms(rec.m_times.m_decode_ticks), timer::ticks_to_ms(rec.m_times.get_replayer_ticks()),
+                                timer::ticks_to_ms(rec.m_times.m_driver_ticks), trace_ticks_to_ms(rec.m_times.m_trace_ticks));
+    }
+
+    return success;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_replay_profiler::write_timeline_json
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_replay_profiler::write_timeline_json(data_stream &stream) const
+{
+    VOGL_FUNC_TRACER
+
+    json_stream_writer writer;
+    if (!writer.open(stream))
+        return false;
+
+    writer.begin_object();
+
+    writer.add_value("trace_ticks_per_sec", m_trace_ticks_per_sec);
+
+    writer.begin_array("entrypoints");
+    for (uint32_t i = 0; i < m_entrypoints.size(); i++)
+    {
+        const entrypoint_stats &stats = m_entrypoints[i];
+        if (!stats.m_num_calls)
+            continue;
+
+        writer.begin_object();
+        writer.add_value("name", g_vogl_entrypoint_descs[i].m_pName);
+        writer.add_value("calls", stats.m_num_calls);
+        writer.add_value("decode_ms", timer::ticks_to_ms(stats.m_times.m_decode_ticks));
+        writer.add_value("replayer_ms", timer::ticks_to_ms(stats.m_times.get_replayer_ticks()));
+        writer.add_value("driver_ms", timer::ticks_to_ms(stats.m_times.m_driver_ticks));
+        writer.add_value("trace_gl_ms", trace_ticks_to_ms(stats.m_times.m_trace_ticks));
+        writer.end();
+    }
+    writer.end();
+
+    writer.begin_array("frames");
+    for (uint32_t i = 0; i < m_frames.size(); i++)
+    {
+        const frame_stats &frame = m_frames[i];
+
+        writer.begin_object();
+        writer.add_value("frame", frame.m_frame_index);
+        writer.add_value("calls", frame.m_num_calls);
+        writer.add_value("decode_ms", timer::ticks_to_ms(frame.m_times.m_decode_ticks));
+        writer.add_value("replayer_ms", timer::ticks_to_ms(frame.m_times.get_replayer_ticks()));
+        writer.add_value("driver_ms", timer::ticks_to_ms(frame.m_times.m_driver_ticks));
+        writer.add_value("trace_gl_ms", trace_ticks_to_ms(frame.m_times.m_trace_ticks));
+        writer.end();
+    }
+    writer.end();
+
+    if (m_record_timeline)
+    {
+        writer.begin_array("calls");
+        for (uint32_t i = 0; i < m_timeline.size(); i++)
+        {
+            const call_record &rec = m_timeline[i];
+
+            writer.begin_object();
+            writer.add_value("call_counter", rec.m_call_counter);
+            writer.add_value("entrypoint", g_vogl_entrypoint_descs[rec.m_entrypoint_id].m_pName);
+            writer.add_value("frame", rec.m_frame_index);
+            writer.add_value("decode_ms", timer::ticks_to_ms(rec.m_times.m_decode_ticks));
+            writer.add_value("replayer_ms", timer::ticks_to_ms(rec.m_times.get_replayer_ticks()));
+            writer.add_value("driver_ms", timer::ticks_to_ms(rec.m_times.m_driver_ticks));
+            writer.add_value("trace_gl_ms", trace_ticks_to_ms(rec.m_times.m_trace_ticks));
+            writer.end();
+        }
+        writer.end();
+    }
+
+    writer.end();
+
+    return writer.close();
+}
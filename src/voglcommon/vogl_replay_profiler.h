@@ -0,0 +1,211 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_replay_profiler.h
+#ifndef VOGL_REPLAY_PROFILER_H
+#define VOGL_REPLAY_PROFILER_H
+
+#include "vogl_common.h"
+#include "vogl_timer.h"
+
+class vogl_trace_packet;
+
+//----------------------------------------------------------------------------------------------------------------------
+// class vogl_replay_profiler
+// Opt-in per-call profiler for vogl_gl_replayer (see vogl_gl_replayer::set_profiler()). Each replayed call's time is split into:
+//  decode   - reading and deserializing the packet from the trace file
+//  replayer - the replayer's own work (handle remapping, shadowing, etc.)
+//  driver   - time inside GL/GLX entrypoints, measured by the direct GL func prolog/epilog callbacks. This requires the
+//             actual entrypoints to be wrapped (vogl_init_actual_gl_entrypoints(..., true)), otherwise it's counted as replayer time.
+// and compared against the GL time recorded in the trace (m_gl_begin_rdtsc/m_gl_end_rdtsc).
+// Stats are kept per entrypoint and per frame, and optionally per call (the timeline) which can be written as CSV or JSON.
+//----------------------------------------------------------------------------------------------------------------------
+class vogl_replay_profiler
+{
+    VOGL_NO_COPY_OR_ASSIGNMENT_OP(vogl_replay_profiler);
+
+public:
+    struct time_split
+    {
+        time_split()
+        {
+            clear();
+        }
+
+        void clear()
+        {
+            m_decode_ticks = 0;
+            m_total_ticks = 0;
+            m_driver_ticks = 0;
+            m_trace_ticks = 0;
+        }
+
+        void add(const time_split &other)
+        {
+            m_decode_ticks += other.m_decode_ticks;
+            m_total_ticks += other.m_total_ticks;
+            m_driver_ticks += other.m_driver_ticks;
+            m_trace_ticks += other.m_trace_ticks;
+        }
+
+        timer_ticks get_replayer_ticks() const
+        {
+            return (m_total_ticks > m_driver_ticks) ? (m_total_ticks - m_driver_ticks) : 0;
+        }
+
+        // Local timer ticks. m_total_ticks covers the replayer and driver, but not decoding.
+        timer_ticks m_decode_ticks;
+        timer_ticks m_total_ticks;
+        timer_ticks m_driver_ticks;
+
+        // Trace ticks (see set_trace_ticks_per_sec()).
+        uint64_t m_trace_ticks;
+    };
+
+    struct entrypoint_stats
+    {
+        entrypoint_stats()
+            : m_num_calls(0)
+        {
+        }
+
+        uint64_t m_num_calls;
+        time_split m_times;
+    };
+
+    struct frame_stats
+    {
+        frame_stats()
+            : m_frame_index(0), m_num_calls(0)
+        {
+        }
+
+        uint32_t m_frame_index;
+        uint32_t m_num_calls;
+        time_split m_times;
+    };
+
+    struct call_record
+    {
+        uint64_t m_call_counter;
+        gl_entrypoint_id_t m_entrypoint_id;
+        uint32_t m_frame_index;
+        time_split m_times;
+    };
+
+    vogl_replay_profiler();
+    ~vogl_replay_profiler();
+
+    // record_timeline enables per-call records (needed for write_timeline()).
+    void init(bool record_timeline);
+    void reset();
+
+    // The rate of the rdtsc values in the trace. vogltrace records raw TSC ticks (or nanoseconds when the TSC is unreliable),
+    // but not their rate, so by default this is estimated on this machine.
+    void set_trace_ticks_per_sec(double ticks_per_sec)
+    {
+        m_trace_ticks_per_sec = ticks_per_sec;
+    }
+    double get_trace_ticks_per_sec() const
+    {
+        return m_trace_ticks_per_sec;
+    }
+    static double estimate_trace_ticks_per_sec();
+
+    // Installs (or removes) the direct GL func prolog/epilog callbacks used to measure driver time.
+    // Any callbacks already set with vogl_set_direct_gl_func_prolog()/epilog() are still called, and are restored on removal.
+    void install_gl_callbacks(bool install);
+
+    // Called by vogl_gl_replayer.
+    inline void add_decode_ticks(timer_ticks ticks)
+    {
+        m_pending_decode_ticks += ticks;
+    }
+    inline void begin_call()
+    {
+        m_cur_driver_ticks = 0;
+        m_in_call = true;
+        m_call_start_ticks = timer::get_ticks();
+    }
+    void end_call(const vogl_trace_packet &gl_packet, uint32_t frame_index);
+
+    const entrypoint_stats &get_entrypoint_stats(gl_entrypoint_id_t id) const
+    {
+        return m_entrypoints[id];
+    }
+    const vogl::vector<frame_stats> &get_frames() const
+    {
+        return m_frames;
+    }
+    const vogl::vector<call_record> &get_timeline() const
+    {
+        return m_timeline;
+    }
+    const time_split &get_totals() const
+    {
+        return m_totals;
+    }
+
+    // Prints the max_entrypoints most expensive entrypoints (by replay time), and frame time stats.
+    void print_report(uint32_t max_entrypoints = 50) const;
+
+    // Writes the per-frame and per-call (if recorded) timeline. The format is picked from the extension: .json, otherwise CSV.
+    bool write_timeline(const char *pFilename) const;
+
+private:
+    vogl::vector<entrypoint_stats> m_entrypoints;
+    vogl::vector<frame_stats> m_frames;
+    vogl::vector<call_record> m_timeline;
+    time_split m_totals;
+    uint64_t m_total_calls;
+
+    double m_trace_ticks_per_sec;
+    bool m_record_timeline;
+
+    timer_ticks m_pending_decode_ticks;
+    timer_ticks m_call_start_ticks;
+    timer_ticks m_cur_driver_ticks;
+    timer_ticks m_driver_call_start_ticks;
+    bool m_in_call;
+
+    bool m_callbacks_installed;
+    vogl_gl_func_prolog_epilog_func_t m_pPrev_prolog_func;
+    void *m_pPrev_prolog_user_data;
+    vogl_gl_func_prolog_epilog_func_t m_pPrev_epilog_func;
+    void *m_pPrev_epilog_user_data;
+
+    static void gl_func_prolog(gl_entrypoint_id_t entrypoint_id, void *pUser_data, void **ppStack_data);
+    static void gl_func_epilog(gl_entrypoint_id_t entrypoint_id, void *pUser_data, void **ppStack_data);
+
+    double trace_ticks_to_ms(uint64_t ticks) const
+    {
+        return m_trace_ticks_per_sec ? (ticks * 1000.0) / m_trace_ticks_per_sec : 0.0;
+    }
+
+    bool write_timeline_csv(data_stream &stream) const;
+    bool write_timeline_json(data_stream &stream) const;
+};
+
+#endif // VOGL_REPLAY_PROFILER_H
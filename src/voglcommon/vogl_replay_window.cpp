@@ -33,6 +33,8 @@ vogl_replay_window::vogl_replay_window()
 #endif
 , m_width(0)
 , m_height(0)
+, m_null_mode(false)
+, m_next_null_context(1)
 {
     VOGL_FUNC_TRACER
 }
@@ -49,6 +51,14 @@ bool vogl_replay_window::open(int width, int height, int samples)
     VOGL_FUNC_TRACER
     close();
 
+    if (m_null_mode)
+    {
+        m_width = width;
+        m_height = height;
+        vogl_debug_printf("Created null window, dimensions %ux%u\n", m_width, m_height);
+        return true;
+    }
+
     const char *pWindow_name = (sizeof(void *) == sizeof(uint32_t)) ? "voglreplay 32-bit" : "voglreplay 64-bit";
 
     #if (VOGL_PLATFORM_HAS_SDL)
@@ -110,7 +120,8 @@ bool vogl_replay_window::resize(int new_width, int new_height)
         return true;
 
     #if (VOGL_PLATFORM_HAS_SDL)
-        SDL_SetWindowSize(m_win, new_width, new_height);
+        if (m_win)
+            SDL_SetWindowSize(m_win, new_width, new_height);
     #else
         #error "Need vogl_replay_window::resize this platform."
         return false;
@@ -142,7 +153,7 @@ void vogl_replay_window::update_dimensions()
 {
     VOGL_FUNC_TRACER
 
-    uint32_t w, h;
+    uint32_t w = 0, h = 0;
     get_actual_dimensions(w, h);
     m_width = w;
     m_height = h;
@@ -152,6 +163,13 @@ bool vogl_replay_window::get_actual_dimensions(uint32_t &width, uint32_t &height
 {
     VOGL_FUNC_TRACER
 
+    if (m_null_mode)
+    {
+        width = m_width;
+        height = m_height;
+        return true;
+    }
+
     #if (VOGL_PLATFORM_HAS_SDL)
         if (m_win == NULL)
             return false;
@@ -169,8 +187,17 @@ bool vogl_replay_window::get_actual_dimensions(uint32_t &width, uint32_t &height
     #endif
 }
 
+GLReplayContextType vogl_replay_window::create_null_context()
+{
+    // Any unique non-NULL value will do, nothing ever dereferences it.
+    return reinterpret_cast<GLReplayContextType>(m_next_null_context++);
+}
+
 GLReplayContextType vogl_replay_window::create_context(GLReplayContextType replay_share_context, Bool direct)
 {
+    if (m_null_mode)
+        return create_null_context();
+
     #if (VOGL_PLATFORM_HAS_SDL)
         if (replay_share_context) 
         {
@@ -189,6 +216,9 @@ GLReplayContextType vogl_replay_window::create_context(GLReplayContextType repla
 
 GLReplayContextType vogl_replay_window::create_new_context(GLReplayContextType replay_share_context, int render_type, Bool direct)
 {
+    if (m_null_mode)
+        return create_null_context();
+
     #if (VOGL_PLATFORM_HAS_SDL)
         if (replay_share_context) 
         {
@@ -208,6 +238,9 @@ GLReplayContextType vogl_replay_window::create_new_context(GLReplayContextType r
 
 GLReplayContextType vogl_replay_window::create_context_attrib(GLReplayContextType replay_share_context, Bool direct, const int * pAttrib_list)
 {
+    if (m_null_mode)
+        return create_null_context();
+
     #if (VOGL_PLATFORM_HAS_SDL)
         // TODO: This is actually a bit complicated, we need to decode the the attrib list into SDL attribs. 
         #pragma message("warning Need to decode pAttrib_list into SDL attribs")
@@ -227,6 +260,9 @@ GLReplayContextType vogl_replay_window::create_context_attrib(GLReplayContextTyp
 
 bool vogl_replay_window::make_current(GLReplayContextType context)
 {
+    if (m_null_mode)
+        return true;
+
     #if (VOGL_PLATFORM_HAS_SDL)
         return SDL_GL_MakeCurrent(m_win, context) >= 0;
     #else
@@ -237,6 +273,9 @@ bool vogl_replay_window::make_current(GLReplayContextType context)
 
 void vogl_replay_window::destroy_context(GLReplayContextType context)
 {
+    if (m_null_mode)
+        return;
+
     #if (VOGL_PLATFORM_HAS_SDL)
         SDL_GL_DeleteContext(context);
     #else
@@ -258,6 +297,9 @@ Bool vogl_replay_window::is_direct(GLReplayContextType replay_context)
 
 void vogl_replay_window::swap_buffers()
 {
+    if (m_null_mode)
+        return;
+
     #if (VOGL_PLATFORM_HAS_SDL)
         SDL_GL_SwapWindow(m_win);
     #else
@@ -55,7 +55,7 @@ public:
     bool is_opened() const
     {
         #if (VOGL_PLATFORM_HAS_SDL)
-            return (m_width > 0) && (m_win != NULL);
+            return (m_width > 0) && ((m_win != NULL) || m_null_mode);
         #else
             #error "Need is_opened for this platform."
         #endif
@@ -63,6 +63,18 @@ public:
 
     bool open(int width, int height, int samples = 1);
 
+    // In null mode no platform window or GL context is created: contexts are dummy handles, and make_current/swap_buffers
+    // do nothing. Used together with the null GL driver (see vogl_null_gl.h). Must be set before open().
+    void set_null_mode(bool enabled)
+    {
+        m_null_mode = enabled;
+    }
+
+    bool get_null_mode() const
+    {
+        return m_null_mode;
+    }
+
     void set_title(const char *pTitle);
 
     bool resize(int new_width, int new_height);
@@ -122,6 +134,11 @@ private:
     int m_width;
     int m_height;
 
+    bool m_null_mode;
+    uintptr_t m_next_null_context;
+
+    GLReplayContextType create_null_context();
+
 
     bool check_glx_version();
 };
@@ -153,6 +153,19 @@ bool vogl_shader_state::restore(const vogl_context_info &context_info, vogl_hand
 {
     VOGL_FUNC_TRACER
 
+    if (!restore_begin(context_info, remapper, handle))
+        return false;
+
+    // Immediately get the compile status now to avoid driver bugs I've seen in the wild.
+    restore_end(handle);
+
+    return true;
+}
+
+bool vogl_shader_state::restore_begin(const vogl_context_info &context_info, vogl_handle_remapper &remapper, GLuint64 &handle) const
+{
+    VOGL_FUNC_TRACER
+
     VOGL_NOTE_UNUSED(context_info);
 
     VOGL_CHECK_GL_ERROR;
@@ -205,8 +218,31 @@ bool vogl_shader_state::restore(const vogl_context_info &context_info, vogl_hand
         GL_ENTRYPOINT(glCompileShader)(static_cast<GLuint>(handle));
         if (vogl_check_gl_error())
             goto handle_error;
+    }
+
+    return true;
 
-        // Immediately get the compile status now to avoid driver bugs I've seen in the wild.
+handle_error:
+    if (created_handle)
+    {
+        remapper.delete_handle_and_object(VOGL_NAMESPACE_SHADERS, m_snapshot_handle, handle);
+
+        //GL_ENTRYPOINT(glDeleteShader)(static_cast<GLuint>(handle));
+        //VOGL_CHECK_GL_ERROR;
+
+        handle = 0;
+    }
+    return false;
+}
+
+void vogl_shader_state::restore_end(GLuint64 handle) const
+{
+    VOGL_FUNC_TRACER
+
+    VOGL_ASSERT(handle <= cUINT32_MAX);
+
+    if ((m_source.get_len()) && (handle))
+    {
         GLint val;
         GL_ENTRYPOINT(glGetShaderiv)(static_cast<GLuint>(handle), GL_COMPILE_STATUS, &val);
         VOGL_CHECK_GL_ERROR;
@@ -240,20 +276,6 @@ bool vogl_shader_state::restore(const vogl_context_info &context_info, vogl_hand
                                 m_compile_status, m_snapshot_handle, (uint32_t)handle, get_gl_enums().find_gl_name(m_shader_type), m_source_blob_id.get_ptr());
         }
     }
-
-    return true;
-
-handle_error:
-    if (created_handle)
-    {
-        remapper.delete_handle_and_object(VOGL_NAMESPACE_SHADERS, m_snapshot_handle, handle);
-
-        //GL_ENTRYPOINT(glDeleteShader)(static_cast<GLuint>(handle));
-        //VOGL_CHECK_GL_ERROR;
-
-        handle = 0;
-    }
-    return false;
 }
 
 bool vogl_shader_state::remap_handles(vogl_handle_remapper &remapper)
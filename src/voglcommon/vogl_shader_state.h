@@ -59,6 +59,11 @@ public:
 
     virtual bool restore(const vogl_context_info &context_info, vogl_handle_remapper &remapper, GLuint64 &handle) const;
 
+    // restore() split in two: restore_begin() creates the shader and submits its compile, restore_end() waits for the
+    // compile status. Submitting many shaders before ending any of them lets drivers compile them concurrently.
+    bool restore_begin(const vogl_context_info &context_info, vogl_handle_remapper &remapper, GLuint64 &handle) const;
+    void restore_end(GLuint64 handle) const;
+
     virtual bool remap_handles(vogl_handle_remapper &remapper);
 
     virtual void clear();
@@ -25,6 +25,9 @@
 
 // File: vogl_shader_utils.cpp
 #include "vogl_shader_utils.h"
+#include "vogl_context_info.h"
+
+typedef void (GLAPIENTRY *vogl_max_shader_compiler_threads_func_ptr_t)(GLuint count);
 
 GLuint vogl_create_program(const char *pVertex_shader_source, const char *pFragment_shader_source)
 {
@@ -141,6 +144,28 @@ failure:
     return 0;
 }
 
+bool vogl_enable_parallel_shader_compile(const vogl_context_info &context_info, vogl_gl_get_proc_address_helper_func_ptr_t pGet_proc_address_helper_func)
+{
+    if (!pGet_proc_address_helper_func)
+        return false;
+
+    const char *pFunc_name = NULL;
+    if (context_info.supports_extension("GL_KHR_parallel_shader_compile"))
+        pFunc_name = "glMaxShaderCompilerThreadsKHR";
+    else if (context_info.supports_extension("GL_ARB_parallel_shader_compile"))
+        pFunc_name = "glMaxShaderCompilerThreadsARB";
+    else
+        return false;
+
+    vogl_max_shader_compiler_threads_func_ptr_t pMax_shader_compiler_threads = reinterpret_cast<vogl_max_shader_compiler_threads_func_ptr_t>(pGet_proc_address_helper_func(pFunc_name));
+    if (!pMax_shader_compiler_threads)
+        return false;
+
+    // 0xFFFFFFFF means "implementation defined maximum".
+    pMax_shader_compiler_threads(0xFFFFFFFF);
+    return !vogl_check_gl_error();
+}
+
 vogl_simple_gl_program::vogl_simple_gl_program() :
     m_program(0)
 {
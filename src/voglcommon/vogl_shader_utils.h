@@ -31,8 +31,14 @@
 #include "vogl_common.h"
 #include "vogl_matrix.h"
 
+class vogl_context_info;
+
 GLuint vogl_create_program(const char *pVertex_shader, const char *pFragment_shader);
 
+// Lets the driver compile and link on as many background threads as it likes in the current context, using
+// GL_KHR_parallel_shader_compile or GL_ARB_parallel_shader_compile. Returns false if neither is supported.
+bool vogl_enable_parallel_shader_compile(const vogl_context_info &context_info, vogl_gl_get_proc_address_helper_func_ptr_t pGet_proc_address_helper_func);
+
 class vogl_scoped_program_binder
 {
     VOGL_NO_COPY_OR_ASSIGNMENT_OP(vogl_scoped_program_binder);
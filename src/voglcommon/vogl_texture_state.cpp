@@ -1086,6 +1086,127 @@ bool vogl_texture_state::set_tex_parameter(GLenum pname) const
     return !vogl_check_gl_error();
 }
 
+// Gathers the slices of layered/3D texture images straight into a mapped pixel unpack buffer, instead of concatenating
+// them into a temporary client side image that the driver then has to copy again. Falls back to client memory if PBO's
+// aren't available or mapping fails.
+class vogl_texture_upload_stager
+{
+    VOGL_NO_COPY_OR_ASSIGNMENT_OP(vogl_texture_upload_stager);
+
+public:
+    vogl_texture_upload_stager(const vogl_context_info &context_info)
+        : m_buffer(0),
+          m_is_bound(false),
+          m_use_pbo((context_info.get_version() >= VOGL_GL_VERSION_2_1) || context_info.supports_extension("GL_ARB_pixel_buffer_object"))
+    {
+        VOGL_FUNC_TRACER
+    }
+
+    ~vogl_texture_upload_stager()
+    {
+        VOGL_FUNC_TRACER
+
+        unbind();
+
+        if (m_buffer)
+        {
+            GL_ENTRYPOINT(glDeleteBuffers)(1, &m_buffer);
+            VOGL_CHECK_GL_ERROR;
+        }
+    }
+
+    // Returns the pointer to pass to glTexImage*/glCompressedTexImage*. If it's an offset into the bound PBO, call unbind() after the upload.
+    const GLvoid *gather(const vogl::vector<const uint8_vec *> &slices, uint8_vec &temp_img, uint32_t &total_size)
+    {
+        VOGL_FUNC_TRACER
+
+        total_size = 0;
+        for (uint32_t i = 0; i < slices.size(); i++)
+            total_size += slices[i]->size();
+
+        if ((m_use_pbo) && (total_size))
+        {
+            const GLvoid *pData = gather_into_pbo(slices, total_size);
+            if (m_is_bound)
+                return pData;
+        }
+
+        temp_img.resize(0);
+        temp_img.reserve(total_size);
+
+        for (uint32_t i = 0; i < slices.size(); i++)
+            temp_img.append(*slices[i]);
+
+        return temp_img.get_ptr();
+    }
+
+    void unbind()
+    {
+        VOGL_FUNC_TRACER
+
+        if (m_is_bound)
+        {
+            GL_ENTRYPOINT(glBindBuffer)(GL_PIXEL_UNPACK_BUFFER, 0);
+            VOGL_CHECK_GL_ERROR;
+
+            m_is_bound = false;
+        }
+    }
+
+private:
+    GLuint m_buffer;
+    bool m_is_bound;
+    bool m_use_pbo;
+
+    const GLvoid *gather_into_pbo(const vogl::vector<const uint8_vec *> &slices, uint32_t total_size)
+    {
+        if (!m_buffer)
+        {
+            GL_ENTRYPOINT(glGenBuffers)(1, &m_buffer);
+            if ((vogl_check_gl_error()) || (!m_buffer))
+            {
+                m_buffer = 0;
+                m_use_pbo = false;
+                return NULL;
+            }
+        }
+
+        GL_ENTRYPOINT(glBindBuffer)(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+        VOGL_CHECK_GL_ERROR;
+        m_is_bound = true;
+
+        // Orphan the previous contents so the driver doesn't stall on any upload still sourcing from this buffer.
+        GL_ENTRYPOINT(glBufferData)(GL_PIXEL_UNPACK_BUFFER, total_size, NULL, GL_STREAM_DRAW);
+
+        uint8_t *pDst = vogl_check_gl_error() ? NULL : static_cast<uint8_t *>(GL_ENTRYPOINT(glMapBuffer)(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY));
+        if (!pDst)
+        {
+            vogl_check_gl_error();
+
+            vogl_warning_printf("Failed mapping texture upload PBO, falling back to client memory uploads\n");
+            unbind();
+            m_use_pbo = false;
+            return NULL;
+        }
+
+        for (uint32_t i = 0; i < slices.size(); i++)
+        {
+            memcpy(pDst, slices[i]->get_ptr(), slices[i]->size());
+            pDst += slices[i]->size();
+        }
+
+        GLboolean unmap_status = GL_ENTRYPOINT(glUnmapBuffer)(GL_PIXEL_UNPACK_BUFFER);
+        if ((vogl_check_gl_error()) || (!unmap_status))
+        {
+            unbind();
+            return NULL;
+        }
+
+        // The image starts at offset 0 of the bound PBO.
+        return NULL;
+    }
+};
+
 // Note: We'll need the remapper for buffer textures.
 bool vogl_texture_state::restore(const vogl_context_info &context_info, vogl_handle_remapper &remapper, GLuint64 &handle) const
 {
@@ -1144,6 +1265,8 @@ bool vogl_texture_state::restore(const vogl_context_info &context_info, vogl_han
 
     uint32_t face = 0, level = 0;
     uint8_vec temp_img;
+    vogl::vector<const uint8_vec *> upload_slices;
+    vogl_texture_upload_stager upload_stager(context_info);
 
     uint32_t tex_width = 0, tex_height = 0, tex_depth = 0, total_actual_levels = 0, num_faces = 0;
     int base_level = 0, max_level = 0;
@@ -1502,43 +1625,48 @@ bool vogl_texture_state::restore(const vogl_context_info &context_info, vogl_han
                     case GL_TEXTURE_CUBE_MAP:
                     case GL_TEXTURE_1D_ARRAY:
                     {
+                        // Single images are uploaded directly from the deserialized texture, only 1D arrays need their slices gathered.
+                        const GLvoid *pImage_data = src_img.get_ptr();
+                        uint32_t image_size = src_img.size();
+
                         if (m_target == GL_TEXTURE_1D_ARRAY)
                         {
                             uint32_t array_size = tex0.get_array_size();
+
+                            upload_slices.resize(0);
                             for (uint32_t array_index = 0; array_index < array_size; array_index++)
                             {
-                                temp_img.append(tex0.get_image_data(level, array_index, face, 0));
+                                upload_slices.push_back(&tex0.get_image_data(level, array_index, face, 0));
                             }
                             level_height = array_size;
-                        }
-                        else
-                        {
-                            temp_img = src_img;
+
+                            pImage_data = upload_stager.gather(upload_slices, temp_img, image_size);
                         }
 
                         if (is_compressed)
                         {
-                            GL_ENTRYPOINT(glCompressedTexImage2D)(target_to_set, level, level_internal_fmt, level_width, level_height, 0, src_img.size(), temp_img.get_ptr());
+                            GL_ENTRYPOINT(glCompressedTexImage2D)(target_to_set, level, level_internal_fmt, level_width, level_height, 0, image_size, pImage_data);
                         }
                         else
                         {
-                            GL_ENTRYPOINT(glTexImage2D)(target_to_set, level, level_internal_fmt, level_width, level_height, 0, tex0.get_ogl_fmt(), tex0.get_ogl_type(), temp_img.get_ptr());
+                            GL_ENTRYPOINT(glTexImage2D)(target_to_set, level, level_internal_fmt, level_width, level_height, 0, tex0.get_ogl_fmt(), tex0.get_ogl_type(), pImage_data);
                         }
 
+                        upload_stager.unbind();
+
                         break;
                     }
                     case GL_TEXTURE_CUBE_MAP_ARRAY:
                     case GL_TEXTURE_2D_ARRAY:
                     case GL_TEXTURE_3D:
                     {
-                        temp_img.resize(0);
-                        temp_img.reserve(src_img.size() * level_depth);
+                        upload_slices.resize(0);
 
                         if (m_target == GL_TEXTURE_3D)
                         {
                             for (int zslice = 0; zslice < level_depth; zslice++)
                             {
-                                temp_img.append(tex0.get_image_data(level, 0, face, zslice));
+                                upload_slices.push_back(&tex0.get_image_data(level, 0, face, zslice));
                             }
                         }
                         else
@@ -1547,20 +1675,25 @@ bool vogl_texture_state::restore(const vogl_context_info &context_info, vogl_han
                             uint32_t array_size = tex0.get_array_size();
                             for (uint32_t array_index = 0; array_index < array_size; array_index++)
                             {
-                                temp_img.append(tex0.get_image_data(level, array_index, face, 0));
+                                upload_slices.push_back(&tex0.get_image_data(level, array_index, face, 0));
                             }
                             level_depth = array_size;
                         }
 
+                        uint32_t image_size = 0;
+                        const GLvoid *pImage_data = upload_stager.gather(upload_slices, temp_img, image_size);
+
                         if (is_compressed)
                         {
-                            GL_ENTRYPOINT(glCompressedTexImage3D)(target_to_set, level, level_internal_fmt, level_width, level_height, level_depth, 0, temp_img.size(), temp_img.get_ptr());
+                            GL_ENTRYPOINT(glCompressedTexImage3D)(target_to_set, level, level_internal_fmt, level_width, level_height, level_depth, 0, image_size, pImage_data);
                         }
                         else
                         {
-                            GL_ENTRYPOINT(glTexImage3D)(target_to_set, level, level_internal_fmt, level_width, level_height, level_depth, 0, tex0.get_ogl_fmt(), tex0.get_ogl_type(), temp_img.get_ptr());
+                            GL_ENTRYPOINT(glTexImage3D)(target_to_set, level, level_internal_fmt, level_width, level_height, level_depth, 0, tex0.get_ogl_fmt(), tex0.get_ogl_type(), pImage_data);
                         }
 
+                        upload_stager.unbind();
+
                         break;
                     }
                     default:
@@ -0,0 +1,406 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_threaded_replayer.cpp
+#include "vogl_threaded_replayer.h"
+
+// The replay thread running on this OS thread, if any.
+#if (defined(COMPILER_MSVC))
+static __declspec(thread) void *s_pCur_replay_thread;
+#else
+static __thread void *s_pCur_replay_thread;
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::vogl_threaded_replayer
+//----------------------------------------------------------------------------------------------------------------------
+vogl_threaded_replayer::vogl_threaded_replayer()
+    : m_pReplayer(NULL),
+      m_pFrames(NULL),
+      m_num_sync_points(0),
+      m_pPrev_prolog_func(NULL),
+      m_pPrev_prolog_user_data(NULL),
+      m_pPrev_epilog_func(NULL),
+      m_pPrev_epilog_user_data(NULL),
+      m_num_packets_done(0),
+      m_num_sync_points_done(0),
+      m_cur_thread_index(-1),
+      m_failure_status(vogl_gl_replayer::cStatusOK),
+      m_failed(false),
+      m_replay_time(0)
+{
+    VOGL_FUNC_TRACER
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::~vogl_threaded_replayer
+//----------------------------------------------------------------------------------------------------------------------
+vogl_threaded_replayer::~vogl_threaded_replayer()
+{
+    VOGL_FUNC_TRACER
+
+    deinit();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::is_sync_point
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_threaded_replayer::is_sync_point(gl_entrypoint_id_t entrypoint_id)
+{
+    switch (entrypoint_id)
+    {
+        case VOGL_ENTRYPOINT_glInternalTraceCommandRAD:
+        case VOGL_ENTRYPOINT_glFinish:
+        case VOGL_ENTRYPOINT_glFlush:
+        case VOGL_ENTRYPOINT_glFenceSync:
+        case VOGL_ENTRYPOINT_glClientWaitSync:
+        case VOGL_ENTRYPOINT_glWaitSync:
+        case VOGL_ENTRYPOINT_glDeleteSync:
+            return true;
+        default:
+            break;
+    }
+
+    const gl_entrypoint_desc_t &desc = g_vogl_entrypoint_descs[entrypoint_id];
+
+    // Window system calls: MakeCurrent handoffs, context creation/destruction, swaps.
+    if (vogl_strcmp(desc.m_pAPI_prefix, "GL") != 0)
+        return true;
+
+    // Object names can be shared between contexts, so creating or deleting them orders against every thread.
+    const char *pName = desc.m_pName;
+    if ((strncmp(pName, "glGen", 5) == 0) && (strncmp(pName, "glGenerate", 10) != 0))
+        return true;
+    if ((strncmp(pName, "glCreate", 8) == 0) || (strncmp(pName, "glDelete", 8) == 0))
+        return true;
+
+    return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::init
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_threaded_replayer::init(vogl_gl_replayer *pReplayer, const vogl_predecoded_frames *pFrames)
+{
+    VOGL_FUNC_TRACER
+
+    deinit();
+
+    if ((!pReplayer) || (!pFrames))
+        return false;
+
+    if (!(pReplayer->get_flags() & cGLReplayerLockWindowDimensions))
+    {
+        vogl_error_printf("Threaded replay requires locked window dimensions\n");
+        return false;
+    }
+
+    vogl::hash_map<uint64_t, uint32_t> thread_indices;
+
+    m_sync_points_before_packet.resize(pFrames->size());
+    m_is_sync_point.resize(pFrames->size());
+
+    for (uint32_t packet_index = 0; packet_index < pFrames->size(); packet_index++)
+    {
+        const vogl_trace_packet &packet = pFrames->get_packet(packet_index);
+
+        vogl::hash_map<uint64_t, uint32_t>::insert_result result(thread_indices.insert(packet.get_thread_id(), m_threads.size()));
+        if (result.second)
+            m_threads.push_back(vogl_new(replay_thread, this, m_threads.size(), packet.get_thread_id()));
+
+        m_threads[result.first->second]->m_packets.push_back(packet_index);
+
+        m_sync_points_before_packet[packet_index] = m_num_sync_points;
+        m_is_sync_point[packet_index] = is_sync_point(packet.get_entrypoint_id());
+        if (m_is_sync_point[packet_index])
+            m_num_sync_points++;
+    }
+
+    // Each replay thread blocks at sync points until the others catch up, so they all need their own pool thread.
+    if (m_threads.size() > task_pool::cMaxThreads)
+    {
+        vogl_error_printf("Trace uses %u GL threads, threaded replay supports at most %u\n", m_threads.size(), task_pool::cMaxThreads);
+        deinit();
+        return false;
+    }
+
+    m_pReplayer = pReplayer;
+    m_pFrames = pFrames;
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::deinit
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_threaded_replayer::deinit()
+{
+    VOGL_FUNC_TRACER
+
+    for (uint32_t i = 0; i < m_threads.size(); i++)
+        vogl_delete(m_threads[i]);
+    m_threads.clear();
+
+    m_sync_points_before_packet.clear();
+    m_is_sync_point.clear();
+    m_num_sync_points = 0;
+
+    m_pReplayer = NULL;
+    m_pFrames = NULL;
+    m_replay_time = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::replay
+//----------------------------------------------------------------------------------------------------------------------
+vogl_gl_replayer::status_t vogl_threaded_replayer::replay()
+{
+    VOGL_FUNC_TRACER
+
+    if (!m_pReplayer)
+        return vogl_gl_replayer::cStatusHardFailure;
+
+    vogl_gl_replayer::status_t status = m_pReplayer->process_pending_packets();
+    if (status != vogl_gl_replayer::cStatusOK)
+        return status;
+
+    // A context can only be current on one thread, so release the caller's. The replay threads make their own contexts current.
+    vogl_gl_replayer::thread_context_binding no_context;
+    m_pReplayer->get_window()->make_current(0);
+    m_pReplayer->set_thread_context_binding(no_context);
+
+    for (uint32_t i = 0; i < m_threads.size(); i++)
+    {
+        m_threads[i]->m_binding = no_context;
+        m_threads[i]->m_waiting = false;
+        m_threads[i]->m_unlock_entrypoint = VOGL_ENTRYPOINT_INVALID;
+        m_threads[i]->m_unlocked = false;
+    }
+
+    m_num_packets_done = 0;
+    m_num_sync_points_done = 0;
+    m_cur_thread_index = -1;
+    m_failure_status = vogl_gl_replayer::cStatusOK;
+    m_failed = false;
+
+    timer tm;
+    tm.start();
+
+    task_pool pool;
+    if (!pool.init(m_threads.size()))
+    {
+        vogl_error_printf("Failed creating %u replay threads\n", m_threads.size());
+        return vogl_gl_replayer::cStatusHardFailure;
+    }
+
+    m_pPrev_prolog_func = vogl_get_direct_gl_func_prolog(&m_pPrev_prolog_user_data);
+    m_pPrev_epilog_func = vogl_get_direct_gl_func_epilog(&m_pPrev_epilog_user_data);
+    vogl_set_direct_gl_func_prolog(gl_func_prolog, this);
+    vogl_set_direct_gl_func_epilog(gl_func_epilog, this);
+
+    pool.queue_multiple_object_tasks(this, &vogl_threaded_replayer::replay_thread_func, 0, m_threads.size());
+    pool.join();
+    pool.deinit();
+
+    vogl_set_direct_gl_func_prolog(m_pPrev_prolog_func, m_pPrev_prolog_user_data);
+    vogl_set_direct_gl_func_epilog(m_pPrev_epilog_func, m_pPrev_epilog_user_data);
+
+    m_replay_time = tm.get_elapsed_secs();
+
+    return m_failed ? m_failure_status : vogl_gl_replayer::cStatusAtEOF;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::is_packet_runnable
+// Sync points wait for all earlier packets, everything else only waits for the earlier sync points.
+//----------------------------------------------------------------------------------------------------------------------
+bool vogl_threaded_replayer::is_packet_runnable(uint32_t packet_index) const
+{
+    if (m_is_sync_point[packet_index])
+        return m_num_packets_done == packet_index;
+
+    return m_num_sync_points_done == m_sync_points_before_packet[packet_index];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::wake_waiting_threads
+// m_mutex must be held.
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_threaded_replayer::wake_waiting_threads()
+{
+    for (uint32_t i = 0; i < m_threads.size(); i++)
+    {
+        replay_thread &thread = *m_threads[i];
+        if (thread.m_waiting)
+        {
+            thread.m_waiting = false;
+            thread.m_wake.release();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::bind_thread
+// Swaps the thread's current context and in-flight packet into the replayer. The context is already current on the
+// thread, so there's no MakeCurrent. m_mutex must be held.
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_threaded_replayer::bind_thread(replay_thread &thread)
+{
+    if (m_cur_thread_index == thread.m_index)
+        return;
+
+    if (m_cur_thread_index >= 0)
+        m_pReplayer->get_thread_context_binding(m_threads[m_cur_thread_index]->m_binding);
+
+    m_pReplayer->set_thread_context_binding(thread.m_binding);
+    m_cur_thread_index = thread.m_index;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::gl_func_prolog
+// Releases m_mutex while the packet's own GL call is in the driver, so other replay threads can use the replayer.
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_threaded_replayer::gl_func_prolog(gl_entrypoint_id_t entrypoint_id, void *pUser_data, void **pStack_data)
+{
+    vogl_threaded_replayer *pThis = static_cast<vogl_threaded_replayer *>(pUser_data);
+
+    if (pThis->m_pPrev_prolog_func)
+        pThis->m_pPrev_prolog_func(entrypoint_id, pThis->m_pPrev_prolog_user_data, pStack_data);
+
+    replay_thread *pThread = static_cast<replay_thread *>(s_pCur_replay_thread);
+    if ((!pThread) || (pThread->m_pOwner != pThis) || (pThread->m_unlock_entrypoint != entrypoint_id))
+        return;
+
+    pThread->m_unlock_entrypoint = VOGL_ENTRYPOINT_INVALID;
+
+    // The draw reads the shared client side arrays, which another thread's draw setup could overwrite.
+    if (pThis->m_pReplayer->get_cur_packet_uses_client_side_arrays())
+        return;
+
+    pThread->m_unlocked = true;
+    pThis->m_mutex.unlock();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::gl_func_epilog
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_threaded_replayer::gl_func_epilog(gl_entrypoint_id_t entrypoint_id, void *pUser_data, void **pStack_data)
+{
+    vogl_threaded_replayer *pThis = static_cast<vogl_threaded_replayer *>(pUser_data);
+
+    replay_thread *pThread = static_cast<replay_thread *>(s_pCur_replay_thread);
+    if ((pThread) && (pThread->m_pOwner == pThis) && (pThread->m_unlocked))
+    {
+        pThis->m_mutex.lock();
+        pThread->m_unlocked = false;
+
+        // Another thread may have used the replayer while the call was in the driver.
+        pThis->bind_thread(*pThread);
+    }
+
+    if (pThis->m_pPrev_epilog_func)
+        pThis->m_pPrev_epilog_func(entrypoint_id, pThis->m_pPrev_epilog_user_data, pStack_data);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogl_threaded_replayer::replay_thread_func
+//----------------------------------------------------------------------------------------------------------------------
+void vogl_threaded_replayer::replay_thread_func(uint64_t data, void *pData_ptr)
+{
+    VOGL_FUNC_TRACER
+
+    VOGL_NOTE_UNUSED(pData_ptr);
+
+    const int thread_index = static_cast<int>(data);
+    replay_thread &thread = *m_threads[thread_index];
+
+    s_pCur_replay_thread = &thread;
+
+    for (uint32_t i = 0; i < thread.m_packets.size(); i++)
+    {
+        const uint32_t packet_index = thread.m_packets[i];
+
+        m_mutex.lock();
+
+        while ((!m_failed) && (!is_packet_runnable(packet_index)))
+        {
+            thread.m_waiting = true;
+            m_mutex.unlock();
+
+            thread.m_wake.wait();
+
+            m_mutex.lock();
+        }
+
+        if (m_failed)
+        {
+            m_mutex.unlock();
+            break;
+        }
+
+        bind_thread(thread);
+
+        // m_mutex is held across the call, except while the packet's own GL call is in the driver (see gl_func_prolog()).
+        // Sync points keep it the whole time, nothing else is runnable while they're replayed anyway.
+        const vogl_trace_packet &packet = m_pFrames->get_packet(packet_index);
+        thread.m_unlock_entrypoint = m_is_sync_point[packet_index] ? VOGL_ENTRYPOINT_INVALID : packet.get_entrypoint_id();
+
+        vogl_gl_replayer::status_t status = m_pReplayer->process_next_packet(packet);
+
+        thread.m_unlock_entrypoint = VOGL_ENTRYPOINT_INVALID;
+        if (status < 0)
+        {
+            vogl_error_printf("Replay thread %u (trace thread 0x%" PRIX64 ") failed replaying packet %u\n", thread_index, thread.m_trace_thread_id, packet_index);
+
+            m_failure_status = status;
+            m_failed = true;
+        }
+
+        m_num_packets_done++;
+        if (m_is_sync_point[packet_index])
+            m_num_sync_points_done++;
+
+        wake_waiting_threads();
+
+        m_mutex.unlock();
+    }
+
+    // Release whatever this thread left current, so the context can be made current again after the pool threads are gone.
+    m_mutex.lock();
+
+    if (m_cur_thread_index == thread_index)
+    {
+        m_pReplayer->get_thread_context_binding(thread.m_binding);
+        m_pReplayer->set_thread_context_binding(vogl_gl_replayer::thread_context_binding());
+        m_cur_thread_index = -1;
+    }
+
+    if (thread.m_binding.m_replay_context)
+        m_pReplayer->get_window()->make_current(0);
+
+    m_mutex.unlock();
+
+    s_pCur_replay_thread = NULL;
+}
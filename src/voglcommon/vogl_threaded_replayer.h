@@ -0,0 +1,152 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_threaded_replayer.h
+#ifndef VOGL_THREADED_REPLAYER_H
+#define VOGL_THREADED_REPLAYER_H
+
+#include "vogl_common.h"
+#include "vogl_threading.h"
+#include "vogl_gl_replayer.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+// class vogl_threaded_replayer
+// Replays pre-decoded frames (see vogl_predecoded_frames.h) with one replay thread per GL thread seen in the trace, so
+// each traced context stays current on its own thread like it was in the traced app, instead of the replayer forcing a
+// MakeCurrent every time consecutive packets come from different contexts.
+// Packets from different threads are only ordered against each other at sync points: window system calls (MakeCurrent,
+// context creation/destruction, swaps), fences, glFinish/glFlush, and object name creation/deletion. A sync point waits
+// for every earlier packet, and every later packet waits for the sync point. Between sync points the replay threads run
+// concurrently.
+// The replayer itself isn't thread safe, so its bookkeeping (handle remapping, shadow state, etc.) is still done by one
+// thread at a time, but the lock is dropped while a non-sync packet's own GL call is in the driver, so other threads'
+// packets overlap with it. This uses the GL func prolog/epilog callbacks, so the GL entrypoints must have been
+// initialized with wrap_all_gl_calls. Draws that source the replayer's shared client side arrays keep the lock.
+//----------------------------------------------------------------------------------------------------------------------
+class vogl_threaded_replayer
+{
+    VOGL_NO_COPY_OR_ASSIGNMENT_OP(vogl_threaded_replayer);
+
+public:
+    vogl_threaded_replayer();
+    ~vogl_threaded_replayer();
+
+    // pReplayer and pFrames must remain valid until deinit(). The replayer must have been initialized with
+    // cGLReplayerLockWindowDimensions, because replay threads can't wait for the window to resize.
+    bool init(vogl_gl_replayer *pReplayer, const vogl_predecoded_frames *pFrames);
+    void deinit();
+
+    bool is_initialized() const
+    {
+        return m_pReplayer != NULL;
+    }
+
+    // Replays all of the frames, returns once all replay threads are done. Returns cStatusAtEOF on success.
+    // The calling thread's current context is released first, and no context is current on it afterwards.
+    // Any GL func prolog/epilog callbacks already set are still called, but they must be thread safe.
+    vogl_gl_replayer::status_t replay();
+
+    uint32_t get_num_threads() const
+    {
+        return m_threads.size();
+    }
+
+    uint32_t get_num_sync_points() const
+    {
+        return m_num_sync_points;
+    }
+
+    // Wall clock time of the last replay() in seconds.
+    double get_replay_time() const
+    {
+        return m_replay_time;
+    }
+
+    static bool is_sync_point(gl_entrypoint_id_t entrypoint_id);
+
+private:
+    struct replay_thread
+    {
+        vogl_threaded_replayer *m_pOwner;
+        int m_index;
+        uint64_t m_trace_thread_id;
+
+        // Indices of this thread's packets in the frames, in trace order.
+        vogl::vector<uint32_t> m_packets;
+
+        // This thread's current context while another thread is using the replayer.
+        vogl_gl_replayer::thread_context_binding m_binding;
+
+        semaphore m_wake;
+        bool m_waiting;
+
+        // The entrypoint of the packet being replayed, whose first call releases m_mutex until it returns. VOGL_ENTRYPOINT_INVALID
+        // when the packet must be replayed with m_mutex held, or once the call has been made.
+        gl_entrypoint_id_t m_unlock_entrypoint;
+        bool m_unlocked;
+
+        replay_thread(vogl_threaded_replayer *pOwner, int index, uint64_t trace_thread_id)
+            : m_pOwner(pOwner), m_index(index), m_trace_thread_id(trace_thread_id), m_wake(0, 1), m_waiting(false),
+              m_unlock_entrypoint(VOGL_ENTRYPOINT_INVALID), m_unlocked(false)
+        {
+        }
+    };
+
+    vogl_gl_replayer *m_pReplayer;
+    const vogl_predecoded_frames *m_pFrames;
+
+    vogl::vector<replay_thread *> m_threads;
+
+    // Number of sync points before each packet, and whether each packet is a sync point.
+    vogl::vector<uint32_t> m_sync_points_before_packet;
+    vogl::vector<bool> m_is_sync_point;
+    uint32_t m_num_sync_points;
+
+    vogl_gl_func_prolog_epilog_func_t m_pPrev_prolog_func;
+    void *m_pPrev_prolog_user_data;
+    vogl_gl_func_prolog_epilog_func_t m_pPrev_epilog_func;
+    void *m_pPrev_epilog_user_data;
+
+    // Everything below is protected by m_mutex, which is held while a replay thread is inside the replayer, except while
+    // its packet's GL call is in the driver.
+    mutex m_mutex;
+    uint32_t m_num_packets_done;
+    uint32_t m_num_sync_points_done;
+    int m_cur_thread_index;
+    vogl_gl_replayer::status_t m_failure_status;
+    bool m_failed;
+
+    double m_replay_time;
+
+    bool is_packet_runnable(uint32_t packet_index) const;
+    void wake_waiting_threads();
+    void bind_thread(replay_thread &thread);
+    void replay_thread_func(uint64_t data, void *pData_ptr);
+
+    static void gl_func_prolog(gl_entrypoint_id_t entrypoint_id, void *pUser_data, void **pStack_data);
+    static void gl_func_epilog(gl_entrypoint_id_t entrypoint_id, void *pUser_data, void **pStack_data);
+};
+
+#endif // VOGL_THREADED_REPLAYER_H
@@ -484,6 +484,9 @@ vogl_json_trace_file_reader::vogl_json_trace_file_reader()
       m_trace_packet(&m_trace_ctypes)
 {
     VOGL_FUNC_TRACER
+
+    // One document is parsed and thrown away per frame, and nothing is moved out of it, so let it recycle its memory.
+    m_cur_doc.set_arena_enabled(true);
 }
 
 vogl_json_trace_file_reader::~vogl_json_trace_file_reader()
@@ -0,0 +1,213 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * Copyright 2010-2014 Rich Geldreich and Tenacious Software LLC
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_dense_hash_map.cpp
+#include "vogl_core.h"
+#include "vogl_dense_hash_map.h"
+#include "vogl_rand.h"
+#include "vogl_timer.h"
+
+namespace vogl
+{
+#define VOGL_DENSE_HASHMAP_VERIFY(x) \
+    if (!(x))                          \
+        return false;
+
+    typedef dense_hash_map<uint32_t, uint32_t> dense_test_map;
+    typedef hash_map<uint32_t, uint32_t> dense_test_ref_map;
+
+    static bool dense_hash_map_compare(const dense_test_map &m, const dense_test_ref_map &ref)
+    {
+        VOGL_DENSE_HASHMAP_VERIFY(m.size() == ref.size());
+
+        uint32_t found_count = 0;
+        for (dense_test_map::const_iterator it = m.begin(); it != m.end(); ++it)
+        {
+            const uint32_t *pRef_value = ref.find_value(it->first);
+            VOGL_DENSE_HASHMAP_VERIFY(pRef_value);
+            VOGL_DENSE_HASHMAP_VERIFY(*pRef_value == it->second);
+            found_count++;
+        }
+        VOGL_DENSE_HASHMAP_VERIFY(found_count == ref.size());
+
+        for (dense_test_ref_map::const_iterator it = ref.begin(); it != ref.end(); ++it)
+        {
+            dense_test_map::const_iterator dit(m.find(it->first));
+            VOGL_DENSE_HASHMAP_VERIFY(dit != m.end());
+            VOGL_DENSE_HASHMAP_VERIFY(dit->first == it->first);
+            VOGL_DENSE_HASHMAP_VERIFY(dit->second == it->second);
+        }
+
+        return true;
+    }
+
+    template <typename MapType>
+    static uint32_t dense_hash_map_sum_lookups(const MapType &m, const vogl::vector<uint32_t> &keys)
+    {
+        uint32_t sum = 0;
+        for (uint32_t i = 0; i < keys.size(); i++)
+        {
+            typename MapType::const_iterator it(m.find(keys[i]));
+            if (it != m.end())
+                sum += it->second;
+        }
+        return sum;
+    }
+
+    bool dense_hash_map_test()
+    {
+        random r0, r1;
+
+        for (uint32_t t = 0; t < 500; t++)
+        {
+            r1.seed(t + 1);
+
+            dense_test_map m;
+            dense_test_ref_map ref;
+
+            // Mostly small GL-style names, with some sparse and "negative" outliers mixed in.
+            const uint32_t n = r0.irand(1, 20000);
+            const uint32_t max_dense_key = r0.irand(1, 100000);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                uint32_t k;
+                const uint32_t type = r1.irand(0, 100);
+                if (type < 90)
+                    k = r1.irand(0, max_dense_key);
+                else if (type < 98)
+                    k = r1.urand32();
+                else
+                    k = static_cast<uint32_t>(-r1.irand(1, 1000));
+
+                uint32_t v = k ^ 0xdeadbeef;
+
+                dense_test_map::insert_result res(m.insert(k, v));
+                dense_test_ref_map::insert_result ref_res(ref.insert(k, v));
+                VOGL_DENSE_HASHMAP_VERIFY(res.second == ref_res.second);
+                VOGL_DENSE_HASHMAP_VERIFY(res.first->first == k);
+                VOGL_DENSE_HASHMAP_VERIFY(res.first->second == ref_res.first->second);
+
+                if (r1.irand(0, 8) == 0)
+                {
+                    res.first->second = ~v;
+                    ref_res.first->second = ~v;
+                }
+
+                if (r1.irand(0, 4) == 0)
+                {
+                    bool erased = m.erase(k);
+                    bool ref_erased = ref.erase(k);
+                    VOGL_DENSE_HASHMAP_VERIFY(erased == ref_erased);
+                }
+            }
+
+            if (!dense_hash_map_compare(m, ref))
+                return false;
+
+            dense_test_map m2(m);
+            VOGL_DENSE_HASHMAP_VERIFY(m2 == m);
+            m2.reset();
+            VOGL_DENSE_HASHMAP_VERIFY(m2.is_empty());
+            VOGL_DENSE_HASHMAP_VERIFY(m2 != m || m.is_empty());
+
+            if (ref.size())
+            {
+                dense_test_ref_map::const_iterator it(ref.begin());
+                VOGL_DENSE_HASHMAP_VERIFY(m.search_table_for_value(it->second) != m.end());
+                VOGL_DENSE_HASHMAP_VERIFY(m.search_table_for_value_get_count(it->second) == ref.search_table_for_value_get_count(it->second));
+            }
+        }
+
+        // A typical trace: a few thousand small object names, looked up over and over (including some misses).
+        {
+            dense_test_map m;
+            dense_test_ref_map ref;
+            vogl::vector<uint32_t> keys;
+
+            r1.seed(1234);
+            for (uint32_t i = 1; i <= 4096; i++)
+            {
+                m.insert(i, i * 3);
+                ref.insert(i, i * 3);
+            }
+            for (uint32_t i = 0; i < 65536; i++)
+                keys.push_back(r1.irand(0, 4100));
+
+            VOGL_DENSE_HASHMAP_VERIFY(dense_hash_map_sum_lookups(m, keys) == dense_hash_map_sum_lookups(ref, keys));
+        }
+
+        return true;
+    }
+
+    template <typename MapType>
+    static double dense_hash_map_time_lookups(MapType &m, const vogl::vector<uint32_t> &keys, uint32_t num_passes, uint32_t &sum)
+    {
+        timer tm;
+        tm.start();
+
+        for (uint32_t pass = 0; pass < num_passes; pass++)
+        {
+            for (uint32_t i = 0; i < keys.size(); i++)
+            {
+                typename MapType::const_iterator it(m.find(keys[i]));
+                if (it != m.end())
+                    sum += it->second;
+            }
+        }
+
+        return tm.get_elapsed_secs();
+    }
+
+    // Not part of --all, run with "vogltest --test dense_hash_map_bench".
+    // Lookup timing with a typical trace: a few thousand small object names, looked up over and over.
+    bool dense_hash_map_bench()
+    {
+        dense_test_map m;
+        dense_test_ref_map ref;
+        vogl::vector<uint32_t> keys;
+
+        random r1;
+        r1.seed(1234);
+        for (uint32_t i = 1; i <= 4096; i++)
+        {
+            m.insert(i, i * 3);
+            ref.insert(i, i * 3);
+        }
+        for (uint32_t i = 0; i < 65536; i++)
+            keys.push_back(r1.irand(1, 4097));
+
+        const uint32_t num_passes = 100;
+        uint32_t dense_sum = 0, ref_sum = 0;
+        double dense_time = dense_hash_map_time_lookups(m, keys, num_passes, dense_sum);
+        double ref_time = dense_hash_map_time_lookups(ref, keys, num_passes, ref_sum);
+        VOGL_DENSE_HASHMAP_VERIFY(dense_sum == ref_sum);
+
+        vogl_printf("%u lookups: dense_hash_map %3.3f ms, hash_map %3.3f ms\n", keys.size() * num_passes, dense_time * 1000.0f, ref_time * 1000.0f);
+
+        return true;
+    }
+
+} // namespace vogl
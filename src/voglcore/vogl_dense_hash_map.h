@@ -0,0 +1,561 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * Copyright 2010-2014 Rich Geldreich and Tenacious Software LLC
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_dense_hash_map.h
+//
+// Notes:
+// hash_map-compatible container for small unsigned integer keys, such as GL object names and uniform locations.
+// Keys below an adaptive limit are stored in a directly indexed array, so lookups don't hash or probe.
+// Keys which are too large relative to the number of items in the container (or keys which are negative when
+// cast to uint32_t) fall back to a regular vogl::hash_map.
+// Like hash_map, iterators are invalidated by insert() (which may grow the dense array) and erase().
+#pragma once
+
+#include "vogl_core.h"
+#include "vogl_hash_map.h"
+
+namespace vogl
+{
+    template <typename Key, typename Value>
+    class dense_hash_map
+    {
+        VOGL_ASSUME(sizeof(Key) <= sizeof(uint32_t));
+
+        enum
+        {
+            // The dense array always covers at least this many keys once it's allocated.
+            cMinDenseSize = 16,
+
+            // Keys below this limit are always placed into the dense array.
+            cMinDenseKeyLimit = 1024,
+
+            // Keys beyond (cDenseKeyLimitScale * size()) or cMaxDenseSize go into the fallback hash map.
+            cDenseKeyLimitScale = 4,
+            cMaxDenseSize = 1U << 20U
+        };
+
+    public:
+        typedef dense_hash_map<Key, Value> dense_hash_map_type;
+        typedef hash_map<Key, Value> sparse_hash_map_type;
+        typedef std::pair<Key, Value> value_type;
+        typedef Key key_type;
+        typedef Value referent_type;
+
+        inline dense_hash_map()
+            : m_num_dense(0)
+        {
+        }
+
+        inline void clear()
+        {
+            m_dense.clear();
+            m_dense_valid.clear();
+            m_num_dense = 0;
+            m_sparse.clear();
+        }
+
+        inline void reset()
+        {
+            if (m_num_dense)
+            {
+                for (uint32_t i = 0; i < m_dense.size(); i++)
+                {
+                    if (m_dense_valid[i])
+                    {
+                        m_dense[i].second = Value();
+                        m_dense_valid[i] = false;
+                    }
+                }
+                m_num_dense = 0;
+            }
+
+            m_sparse.reset();
+        }
+
+        inline uint32_t size() const
+        {
+            return m_num_dense + m_sparse.size();
+        }
+
+        inline bool is_empty() const
+        {
+            return !size();
+        }
+
+        // Reserves room in the dense array, assuming the keys will be roughly 0 to new_capacity-1.
+        inline void reserve(uint32_t new_capacity)
+        {
+            new_capacity = math::minimum<uint32_t>(new_capacity, cMaxDenseSize);
+            m_dense.reserve(new_capacity);
+            m_dense_valid.reserve(new_capacity);
+        }
+
+        // Number of keys covered by the dense array.
+        inline uint32_t get_dense_size() const
+        {
+            return m_dense.size();
+        }
+
+        // Number of items which didn't fit in the dense array.
+        inline uint32_t get_num_sparse() const
+        {
+            return m_sparse.size();
+        }
+
+        class const_iterator;
+
+        class iterator
+        {
+            friend class dense_hash_map<Key, Value>;
+            friend class dense_hash_map<Key, Value>::const_iterator;
+
+        public:
+            inline iterator()
+                : m_pTable(NULL), m_dense_index(0)
+            {
+            }
+            inline iterator(dense_hash_map_type &table, uint32_t dense_index, const typename sparse_hash_map_type::iterator &sparse_it)
+                : m_pTable(&table), m_dense_index(dense_index), m_sparse_it(sparse_it)
+            {
+            }
+
+            // post-increment
+            inline iterator operator++(int)
+            {
+                iterator result(*this);
+                ++*this;
+                return result;
+            }
+
+            // pre-increment
+            inline iterator &operator++()
+            {
+                VOGL_ASSERT(m_pTable);
+                if (m_dense_index < m_pTable->m_dense.size())
+                {
+                    m_dense_index = m_pTable->find_next_dense(m_dense_index);
+                    if (m_dense_index == m_pTable->m_dense.size())
+                        m_sparse_it = m_pTable->m_sparse.begin();
+                }
+                else
+                {
+                    ++m_sparse_it;
+                }
+                return *this;
+            }
+
+            inline value_type &operator*() const
+            {
+                return *get_cur();
+            }
+            inline value_type *operator->() const
+            {
+                return get_cur();
+            }
+
+            inline bool operator==(const iterator &b) const
+            {
+                return (m_pTable == b.m_pTable) && (m_dense_index == b.m_dense_index) && (m_sparse_it == b.m_sparse_it);
+            }
+            inline bool operator!=(const iterator &b) const
+            {
+                return !(*this == b);
+            }
+            inline bool operator==(const const_iterator &b) const
+            {
+                return (m_pTable == b.m_pTable) && (m_dense_index == b.m_dense_index) && (m_sparse_it == b.m_sparse_it);
+            }
+            inline bool operator!=(const const_iterator &b) const
+            {
+                return !(*this == b);
+            }
+
+        private:
+            dense_hash_map_type *m_pTable;
+            uint32_t m_dense_index;
+            typename sparse_hash_map_type::iterator m_sparse_it;
+
+            inline value_type *get_cur() const
+            {
+                VOGL_ASSERT(m_pTable);
+                if (m_dense_index < m_pTable->m_dense.size())
+                {
+                    VOGL_ASSERT(m_pTable->m_dense_valid[m_dense_index]);
+                    return &m_pTable->m_dense[m_dense_index];
+                }
+                return &*m_sparse_it;
+            }
+        };
+
+        class const_iterator
+        {
+            friend class dense_hash_map<Key, Value>;
+            friend class dense_hash_map<Key, Value>::iterator;
+
+        public:
+            inline const_iterator()
+                : m_pTable(NULL), m_dense_index(0)
+            {
+            }
+            inline const_iterator(const dense_hash_map_type &table, uint32_t dense_index, const typename sparse_hash_map_type::const_iterator &sparse_it)
+                : m_pTable(&table), m_dense_index(dense_index), m_sparse_it(sparse_it)
+            {
+            }
+            inline const_iterator(const iterator &other)
+                : m_pTable(other.m_pTable), m_dense_index(other.m_dense_index), m_sparse_it(other.m_sparse_it)
+            {
+            }
+
+            inline const_iterator &operator=(const iterator &other)
+            {
+                m_pTable = other.m_pTable;
+                m_dense_index = other.m_dense_index;
+                m_sparse_it = other.m_sparse_it;
+                return *this;
+            }
+
+            // post-increment
+            inline const_iterator operator++(int)
+            {
+                const_iterator result(*this);
+                ++*this;
+                return result;
+            }
+
+            // pre-increment
+            inline const_iterator &operator++()
+            {
+                VOGL_ASSERT(m_pTable);
+                if (m_dense_index < m_pTable->m_dense.size())
+                {
+                    m_dense_index = m_pTable->find_next_dense(m_dense_index);
+                    if (m_dense_index == m_pTable->m_dense.size())
+                        m_sparse_it = m_pTable->m_sparse.begin();
+                }
+                else
+                {
+                    ++m_sparse_it;
+                }
+                return *this;
+            }
+
+            inline const value_type &operator*() const
+            {
+                return *get_cur();
+            }
+            inline const value_type *operator->() const
+            {
+                return get_cur();
+            }
+
+            inline bool operator==(const const_iterator &b) const
+            {
+                return (m_pTable == b.m_pTable) && (m_dense_index == b.m_dense_index) && (m_sparse_it == b.m_sparse_it);
+            }
+            inline bool operator!=(const const_iterator &b) const
+            {
+                return !(*this == b);
+            }
+            inline bool operator==(const iterator &b) const
+            {
+                return (m_pTable == b.m_pTable) && (m_dense_index == b.m_dense_index) && (m_sparse_it == b.m_sparse_it);
+            }
+            inline bool operator!=(const iterator &b) const
+            {
+                return !(*this == b);
+            }
+
+        private:
+            const dense_hash_map_type *m_pTable;
+            uint32_t m_dense_index;
+            typename sparse_hash_map_type::const_iterator m_sparse_it;
+
+            inline const value_type *get_cur() const
+            {
+                VOGL_ASSERT(m_pTable);
+                if (m_dense_index < m_pTable->m_dense.size())
+                {
+                    VOGL_ASSERT(m_pTable->m_dense_valid[m_dense_index]);
+                    return &m_pTable->m_dense[m_dense_index];
+                }
+                return &*m_sparse_it;
+            }
+        };
+
+        inline const_iterator begin() const
+        {
+            uint32_t first = m_num_dense ? find_next_dense(-1) : m_dense.size();
+            return const_iterator(*this, first, (first == m_dense.size()) ? m_sparse.begin() : m_sparse.end());
+        }
+
+        inline const_iterator end() const
+        {
+            return const_iterator(*this, m_dense.size(), m_sparse.end());
+        }
+
+        inline iterator begin()
+        {
+            uint32_t first = m_num_dense ? find_next_dense(-1) : m_dense.size();
+            return iterator(*this, first, (first == m_dense.size()) ? m_sparse.begin() : m_sparse.end());
+        }
+
+        inline iterator end()
+        {
+            return iterator(*this, m_dense.size(), m_sparse.end());
+        }
+
+        // Same semantics as hash_map::insert_result.
+        typedef std::pair<iterator, bool> insert_result;
+
+        inline insert_result insert(const Key &k, const Value &v = Value())
+        {
+            const uint32_t index = static_cast<uint32_t>(k);
+
+            if ((index >= m_dense.size()) && (should_be_dense(index)))
+                grow_dense(index);
+
+            insert_result result;
+            if (index < m_dense.size())
+            {
+                result.first = iterator(*this, index, m_sparse.end());
+                result.second = !m_dense_valid[index];
+                if (result.second)
+                {
+                    m_dense[index].second = v;
+                    m_dense_valid[index] = true;
+                    m_num_dense++;
+                }
+            }
+            else
+            {
+                typename sparse_hash_map_type::insert_result sparse_result(m_sparse.insert(k, v));
+                result.first = iterator(*this, m_dense.size(), sparse_result.first);
+                result.second = sparse_result.second;
+            }
+
+            return result;
+        }
+
+        inline insert_result insert(const value_type &v)
+        {
+            return insert(v.first, v.second);
+        }
+
+        inline Value &operator[](const Key &key)
+        {
+            return (insert(key).first)->second;
+        }
+
+        // Returns const ref to value if key is found, otherwise returns the default.
+        inline const Value &value(const Key &key, const Value &def = Value()) const
+        {
+            const Value *pValue = find_value(key);
+            return pValue ? *pValue : def;
+        }
+
+        inline const_iterator find(const Key &k) const
+        {
+            const uint32_t index = static_cast<uint32_t>(k);
+            if (index < m_dense.size())
+                return m_dense_valid[index] ? const_iterator(*this, index, m_sparse.end()) : end();
+            return const_iterator(*this, m_dense.size(), m_sparse.find(k));
+        }
+
+        inline iterator find(const Key &k)
+        {
+            const uint32_t index = static_cast<uint32_t>(k);
+            if (index < m_dense.size())
+                return m_dense_valid[index] ? iterator(*this, index, m_sparse.end()) : end();
+            return iterator(*this, m_dense.size(), m_sparse.find(k));
+        }
+
+        inline Value *find_value(const Key &key)
+        {
+            const uint32_t index = static_cast<uint32_t>(key);
+            if (index < m_dense.size())
+                return m_dense_valid[index] ? &m_dense[index].second : NULL;
+            return m_sparse.find_value(key);
+        }
+
+        inline const Value *find_value(const Key &key) const
+        {
+            const uint32_t index = static_cast<uint32_t>(key);
+            if (index < m_dense.size())
+                return m_dense_valid[index] ? &m_dense[index].second : NULL;
+            return m_sparse.find_value(key);
+        }
+
+        inline bool contains(const Key &key) const
+        {
+            return find_value(key) != NULL;
+        }
+
+        // All active iterators become invalid after erase().
+        inline bool erase(const Key &k)
+        {
+            const uint32_t index = static_cast<uint32_t>(k);
+            if (index < m_dense.size())
+            {
+                if (!m_dense_valid[index])
+                    return false;
+
+                m_dense[index].second = Value();
+                m_dense_valid[index] = false;
+                m_num_dense--;
+                return true;
+            }
+
+            return m_sparse.erase(k);
+        }
+
+        inline void swap(dense_hash_map_type &other)
+        {
+            m_dense.swap(other.m_dense);
+            m_dense_valid.swap(other.m_dense_valid);
+            utils::swap(m_num_dense, other.m_num_dense);
+            m_sparse.swap(other.m_sparse);
+        }
+
+        // Obviously, this method is very slow! It scans the entire container.
+        inline const_iterator search_table_for_value(const Value &val) const
+        {
+            for (const_iterator it = begin(); it != end(); ++it)
+                if (it->second == val)
+                    return it;
+            return end();
+        }
+
+        // Obviously, this method is very slow! It scans the entire container.
+        inline iterator search_table_for_value(const Value &val)
+        {
+            for (iterator it = begin(); it != end(); ++it)
+                if (it->second == val)
+                    return it;
+            return end();
+        }
+
+        // Obviously, this method is very slow! It scans the entire container.
+        inline uint32_t search_table_for_value_get_count(const Value &val) const
+        {
+            uint32_t count = 0;
+            for (const_iterator it = begin(); it != end(); ++it)
+                if (it->second == val)
+                    ++count;
+            return count;
+        }
+
+        bool operator==(const dense_hash_map &other) const
+        {
+            if (this == &other)
+                return true;
+
+            if (size() != other.size())
+                return false;
+
+            for (const_iterator it = begin(); it != end(); ++it)
+            {
+                const Value *pOther_value = other.find_value(it->first);
+                if (!pOther_value)
+                    return false;
+
+                if (!(it->second == *pOther_value))
+                    return false;
+            }
+
+            return true;
+        }
+
+        bool operator!=(const dense_hash_map &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        vogl::vector<value_type> m_dense;
+        vogl::vector<bool> m_dense_valid;
+        uint32_t m_num_dense;
+
+        sparse_hash_map_type m_sparse;
+
+        inline uint32_t find_next_dense(int index) const
+        {
+            for (index++; index < static_cast<int>(m_dense.size()); index++)
+                if (m_dense_valid[index])
+                    break;
+            return index;
+        }
+
+        inline bool should_be_dense(uint32_t index) const
+        {
+            if (index >= cMaxDenseSize)
+                return false;
+
+            return index < math::maximum<uint32_t>(cMinDenseKeyLimit, (size() + 1) * cDenseKeyLimitScale);
+        }
+
+        void grow_dense(uint32_t index)
+        {
+            const uint32_t old_size = m_dense.size();
+            const uint32_t new_size = math::minimum<uint32_t>(cMaxDenseSize, math::maximum<uint32_t>(cMinDenseSize, math::next_pow2(index + 1)));
+            VOGL_ASSERT(new_size > index);
+
+            m_dense.resize(new_size);
+            m_dense_valid.resize(new_size);
+            for (uint32_t i = old_size; i < new_size; i++)
+                m_dense[i].first = static_cast<Key>(i);
+
+            // Migrate any fallback items which are now covered by the dense array.
+            if (m_sparse.size())
+            {
+                vogl::vector<Key> migrated;
+                for (typename sparse_hash_map_type::const_iterator it = m_sparse.begin(); it != m_sparse.end(); ++it)
+                {
+                    const uint32_t i = static_cast<uint32_t>(it->first);
+                    if (i < new_size)
+                    {
+                        m_dense[i].second = it->second;
+                        m_dense_valid[i] = true;
+                        m_num_dense++;
+                        migrated.push_back(it->first);
+                    }
+                }
+
+                for (uint32_t i = 0; i < migrated.size(); i++)
+                    m_sparse.erase(migrated[i]);
+            }
+        }
+    };
+
+    template <typename Key, typename Value>
+    inline void swap(dense_hash_map<Key, Value> &a, dense_hash_map<Key, Value> &b)
+    {
+        a.swap(b);
+    }
+
+    bool dense_hash_map_test();
+    bool dense_hash_map_bench();
+
+} // namespace vogl
@@ -39,6 +39,16 @@
 #define get16bits(d) ((((uint32_t)(((const uint8_t *)(d))[1])) << 8) + (uint32_t)(((const uint8_t *)(d))[0]))
 #endif
 
+// The PCLMULQDQ CRC-64 path is compiled with a function level target attribute, so it's available without building everything with -mpclmul.
+#if defined(COMPILER_GCCLIKE) && (defined(__x86_64__) || defined(__i386__))
+    #define VOGL_CRC64_CLMUL 1
+    #define VOGL_CRC64_CLMUL_TARGET __attribute__((target("pclmul,sse2")))
+    #include <emmintrin.h>
+    #include <wmmintrin.h>
+#else
+    #define VOGL_CRC64_CLMUL 0
+#endif
+
 namespace vogl
 {
     struct well_known_hash_t
@@ -141,7 +151,163 @@ namespace vogl
     // Public domain code originally from http://svn.r-project.org/R/trunk/src/extra/xz/check/crc64_small.c
     uint64_t g_crc64_table[256];
 
-    void crc64_init()
+    // s_crc64_slice_tables[k][b] is the CRC of byte b followed by k zero bytes.
+    static uint64_t s_crc64_slice_tables[16][256];
+
+    // Reflected x^(64+D-1) and x^(D-1) mod P, used to fold a 128-bit remainder forward by D bits (D=512 and D=128).
+    static uint64_t s_crc64_fold_consts[2][2];
+
+    typedef uint64_t (*crc64_update_func_ptr)(uint64_t crc, const uint8_t *buf, size_t size);
+    static uint64_t crc64_update_first_call(uint64_t crc, const uint8_t *buf, size_t size);
+    static crc64_update_func_ptr s_pCRC64_update = crc64_update_first_call;
+
+    // Returns x^n mod P, reflected.
+    static uint64_t crc64_xpow_mod(uint32_t n)
+    {
+        static const uint64_t poly64 = 0xC96C5795D7870F42ULL;
+
+        uint64_t r = 1ULL << 63;
+        for (uint32_t i = 0; i < n; i++)
+            r = (r >> 1) ^ ((r & 1) ? poly64 : 0);
+        return r;
+    }
+
+    static inline uint64_t crc64_read_le64(const uint8_t *p)
+    {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    // The crc64_update_*() functions operate on the raw (not inverted) CRC register.
+    static uint64_t crc64_update_bytewise(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        while (size != 0)
+        {
+            crc = g_crc64_table[*buf++ ^ (crc & 0xFF)] ^ (crc >> 8);
+            --size;
+        }
+
+        return crc;
+    }
+
+#if VOGL_LITTLE_ENDIAN_CPU
+    static uint64_t crc64_update_slice8(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        const uint64_t (*t)[256] = s_crc64_slice_tables;
+
+        while (size >= 8)
+        {
+            const uint64_t v = crc64_read_le64(buf) ^ crc;
+
+            crc = t[7][v & 0xFF] ^ t[6][(v >> 8) & 0xFF] ^ t[5][(v >> 16) & 0xFF] ^ t[4][(v >> 24) & 0xFF] ^
+                  t[3][(v >> 32) & 0xFF] ^ t[2][(v >> 40) & 0xFF] ^ t[1][(v >> 48) & 0xFF] ^ t[0][v >> 56];
+
+            buf += 8;
+            size -= 8;
+        }
+
+        return crc64_update_bytewise(crc, buf, size);
+    }
+
+    static uint64_t crc64_update_slice16(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        const uint64_t (*t)[256] = s_crc64_slice_tables;
+
+        while (size >= 16)
+        {
+            const uint64_t v0 = crc64_read_le64(buf) ^ crc;
+            const uint64_t v1 = crc64_read_le64(buf + 8);
+
+            crc = t[15][v0 & 0xFF] ^ t[14][(v0 >> 8) & 0xFF] ^ t[13][(v0 >> 16) & 0xFF] ^ t[12][(v0 >> 24) & 0xFF] ^
+                  t[11][(v0 >> 32) & 0xFF] ^ t[10][(v0 >> 40) & 0xFF] ^ t[9][(v0 >> 48) & 0xFF] ^ t[8][v0 >> 56] ^
+                  t[7][v1 & 0xFF] ^ t[6][(v1 >> 8) & 0xFF] ^ t[5][(v1 >> 16) & 0xFF] ^ t[4][(v1 >> 24) & 0xFF] ^
+                  t[3][(v1 >> 32) & 0xFF] ^ t[2][(v1 >> 40) & 0xFF] ^ t[1][(v1 >> 48) & 0xFF] ^ t[0][v1 >> 56];
+
+            buf += 16;
+            size -= 16;
+        }
+
+        return crc64_update_slice8(crc, buf, size);
+    }
+#else
+    static uint64_t crc64_update_slice8(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        return crc64_update_bytewise(crc, buf, size);
+    }
+
+    static uint64_t crc64_update_slice16(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        return crc64_update_bytewise(crc, buf, size);
+    }
+#endif
+
+#if VOGL_CRC64_CLMUL
+    // Folds the data down into a single 128-bit value using carryless multiplies (see Intel's "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ").
+    // A message which starts with the 16-byte folded value has the same CRC as the data it replaces, so instead of a Barrett reduction the last 16 bytes are finished with the tables.
+    // The constants are one power of x lower than the fold distance, because multiplying two reflected 64-bit values leaves the product shifted down by one bit.
+    static VOGL_CRC64_CLMUL_TARGET inline __m128i crc64_clmul_fold(__m128i a, __m128i k, __m128i next)
+    {
+        const __m128i h = _mm_clmulepi64_si128(a, k, 0x00);
+        const __m128i l = _mm_clmulepi64_si128(a, k, 0x11);
+        return _mm_xor_si128(_mm_xor_si128(h, l), next);
+    }
+
+    static VOGL_CRC64_CLMUL_TARGET uint64_t crc64_update_clmul(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        if (size < 64)
+            return crc64_update_slice16(crc, buf, size);
+
+        const __m128i k512 = _mm_set_epi64x(s_crc64_fold_consts[0][1], s_crc64_fold_consts[0][0]);
+        const __m128i k128 = _mm_set_epi64x(s_crc64_fold_consts[1][1], s_crc64_fold_consts[1][0]);
+
+        __m128i x0 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(buf)), _mm_set_epi64x(0, crc));
+        __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 16));
+        __m128i x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 32));
+        __m128i x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 48));
+        buf += 64;
+        size -= 64;
+
+        while (size >= 64)
+        {
+            x0 = crc64_clmul_fold(x0, k512, _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf)));
+            x1 = crc64_clmul_fold(x1, k512, _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 16)));
+            x2 = crc64_clmul_fold(x2, k512, _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 32)));
+            x3 = crc64_clmul_fold(x3, k512, _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf + 48)));
+            buf += 64;
+            size -= 64;
+        }
+
+        __m128i x = crc64_clmul_fold(x0, k128, x1);
+        x = crc64_clmul_fold(x, k128, x2);
+        x = crc64_clmul_fold(x, k128, x3);
+
+        while (size >= 16)
+        {
+            x = crc64_clmul_fold(x, k128, _mm_loadu_si128(reinterpret_cast<const __m128i *>(buf)));
+            buf += 16;
+            size -= 16;
+        }
+
+        uint8_t folded[16];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(folded), x);
+
+        crc = crc64_update_slice16(0, folded, sizeof(folded));
+        return crc64_update_slice16(crc, buf, size);
+    }
+#endif
+
+    bool crc64_clmul_supported()
+    {
+#if VOGL_CRC64_CLMUL
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse2");
+#else
+        return false;
+#endif
+    }
+
+    static void crc64_init_tables()
     {
         static const uint64_t poly64 = 0xC96C5795D7870F42ULL;
 
@@ -157,25 +323,181 @@ namespace vogl
             }
 
             g_crc64_table[b] = r;
+            s_crc64_slice_tables[0][b] = r;
         }
 
-        return;
+        for (size_t k = 1; k < 16; ++k)
+        {
+            for (size_t b = 0; b < 256; ++b)
+            {
+                const uint64_t r = s_crc64_slice_tables[k - 1][b];
+                s_crc64_slice_tables[k][b] = (r >> 8) ^ g_crc64_table[r & 0xFF];
+            }
+        }
+
+        s_crc64_fold_consts[0][0] = crc64_xpow_mod(64 + 512 - 1);
+        s_crc64_fold_consts[0][1] = crc64_xpow_mod(512 - 1);
+        s_crc64_fold_consts[1][0] = crc64_xpow_mod(64 + 128 - 1);
+        s_crc64_fold_consts[1][1] = crc64_xpow_mod(128 - 1);
+
+        s_pCRC64_update = crc64_update_slice16;
+#if VOGL_CRC64_CLMUL
+        if (crc64_clmul_supported())
+            s_pCRC64_update = crc64_update_clmul;
+#endif
+    }
+
+    void crc64_init()
+    {
+        static pthread_once_t s_crc64_init_once = PTHREAD_ONCE_INIT;
+        pthread_once(&s_crc64_init_once, crc64_init_tables);
+    }
+
+    // The tables are built when the library is loaded, so calc_crc64() doesn't need to check for them.
+    VOGL_CONSTRUCTOR_FUNCTION(crc64_init_at_startup)
+    {
+        crc64_init();
+    }
+
+    // s_pCRC64_update's initial value, in case a CRC is needed by another constructor before ours has run.
+    static uint64_t crc64_update_first_call(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        crc64_init();
+        return (*s_pCRC64_update)(crc, buf, size);
     }
 
     uint64_t calc_crc64(uint64_t crc, const uint8_t *buf, size_t size)
     {
-        if (!g_crc64_table[0])
-            crc64_init();
+        return ~(*s_pCRC64_update)(~crc, buf, size);
+    }
 
-        crc = ~crc;
+    uint64_t calc_crc64_bytewise(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        crc64_init();
+        return ~crc64_update_bytewise(~crc, buf, size);
+    }
 
-        while (size != 0)
+    uint64_t calc_crc64_slice8(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        crc64_init();
+        return ~crc64_update_slice8(~crc, buf, size);
+    }
+
+    uint64_t calc_crc64_slice16(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        crc64_init();
+        return ~crc64_update_slice16(~crc, buf, size);
+    }
+
+    uint64_t calc_crc64_clmul(uint64_t crc, const uint8_t *buf, size_t size)
+    {
+        crc64_init();
+#if VOGL_CRC64_CLMUL
+        return ~crc64_update_clmul(~crc, buf, size);
+#else
+        VOGL_VERIFY(!"calc_crc64_clmul: not supported");
+        return ~crc64_update_slice16(~crc, buf, size);
+#endif
+    }
+
+    // MurmurHash3 was written by Austin Appleby, and is placed in the public domain. See https://github.com/aappleby/smhasher
+    static inline uint64_t hash128_rotl64(uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static inline uint64_t hash128_fmix64(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xFF51AFD7ED558CCDULL;
+        k ^= k >> 33;
+        k *= 0xC4CEB9FE1A85EC53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    hash128_t calc_hash128(const void *p, size_t size, uint64_t seed)
+    {
+        const uint8_t *pData = static_cast<const uint8_t *>(p);
+        const size_t num_blocks = size / 16;
+
+        const uint64_t c1 = 0x87C37B91114253D5ULL;
+        const uint64_t c2 = 0x4CF5AD432745937FULL;
+
+        uint64_t h1 = seed;
+        uint64_t h2 = seed;
+
+        for (size_t i = 0; i < num_blocks; i++)
         {
-            crc = g_crc64_table[*buf++ ^ (crc & 0xFF)] ^ (crc >> 8);
-            --size;
+            uint64_t k1, k2;
+            memcpy(&k1, pData + i * 16, sizeof(k1));
+            memcpy(&k2, pData + i * 16 + 8, sizeof(k2));
+#if !VOGL_LITTLE_ENDIAN_CPU
+            k1 = utils::swap64(k1);
+            k2 = utils::swap64(k2);
+#endif
+
+            k1 *= c1;
+            k1 = hash128_rotl64(k1, 31);
+            k1 *= c2;
+            h1 ^= k1;
+
+            h1 = hash128_rotl64(h1, 27);
+            h1 += h2;
+            h1 = h1 * 5 + 0x52DCE729;
+
+            k2 *= c2;
+            k2 = hash128_rotl64(k2, 33);
+            k2 *= c1;
+            h2 ^= k2;
+
+            h2 = hash128_rotl64(h2, 31);
+            h2 += h1;
+            h2 = h2 * 5 + 0x38495AB5;
         }
 
-        return ~crc;
+        const uint8_t *pTail = pData + num_blocks * 16;
+        const size_t tail_size = size & 15;
+
+        uint64_t k1 = 0;
+        uint64_t k2 = 0;
+        for (size_t i = tail_size; i > 8; i--)
+            k2 = (k2 << 8) | pTail[i - 1];
+        for (size_t i = math::minimum<size_t>(tail_size, 8); i > 0; i--)
+            k1 = (k1 << 8) | pTail[i - 1];
+
+        if (tail_size > 8)
+        {
+            k2 *= c2;
+            k2 = hash128_rotl64(k2, 33);
+            k2 *= c1;
+            h2 ^= k2;
+        }
+
+        if (tail_size)
+        {
+            k1 *= c1;
+            k1 = hash128_rotl64(k1, 31);
+            k1 *= c2;
+            h1 ^= k1;
+        }
+
+        h1 ^= size;
+        h2 ^= size;
+
+        h1 += h2;
+        h2 += h1;
+
+        h1 = hash128_fmix64(h1);
+        h2 = hash128_fmix64(h2);
+
+        h1 += h2;
+        h2 += h1;
+
+        hash128_t result;
+        result.m_lo = h1;
+        result.m_hi = h2;
+        return result;
     }
 
     uint64_t calc_sum64(const uint8_t *buf, size_t size, uint32_t shift_amount)
@@ -193,4 +515,134 @@ namespace vogl
         return sum;
     }
 
+    typedef uint64_t (*crc64_func_ptr)(uint64_t crc, const uint8_t *buf, size_t size);
+    struct crc64_impl_t
+    {
+        const char *m_pName;
+        crc64_func_ptr m_pFunc;
+    };
+    static const crc64_impl_t s_crc64_impls[] =
+    {
+        { "bytewise", calc_crc64_bytewise },
+        { "slice8", calc_crc64_slice8 },
+        { "slice16", calc_crc64_slice16 },
+        { "clmul", calc_crc64_clmul },
+        { "calc_crc64", calc_crc64 },
+    };
+
+    // clmul is skipped when the CPU doesn't support it, calc_crc64 is always last.
+    static uint32_t crc64_get_num_impls()
+    {
+        return crc64_clmul_supported() ? VOGL_ARRAY_SIZE(s_crc64_impls) : VOGL_ARRAY_SIZE(s_crc64_impls) - 1;
+    }
+
+    static const crc64_impl_t &crc64_get_impl(uint32_t index, uint32_t num_impls)
+    {
+        return s_crc64_impls[(index == (num_impls - 1)) ? (VOGL_ARRAY_SIZE(s_crc64_impls) - 1) : index];
+    }
+
+    bool hash_test()
+    {
+        const uint32_t num_impls = crc64_get_num_impls();
+
+        // CRC-64/XZ check value
+        const uint8_t *pCheck = reinterpret_cast<const uint8_t *>("123456789");
+        for (uint32_t i = 0; i < num_impls; i++)
+        {
+            const crc64_impl_t &impl = crc64_get_impl(i, num_impls);
+            if (impl.m_pFunc(CRC64_INIT, pCheck, 9) != 0x995DC9BBDF1939FAULL)
+                return false;
+        }
+
+        random rm(2);
+
+        vogl::vector<uint8_t> buf(128 * 1024);
+        for (uint32_t i = 0; i < buf.size(); i++)
+            buf[i] = rm.urand32() >> 24;
+
+        // Every implementation must match the original bytewise CRC at all alignments and lengths, including when the CRC is computed in pieces.
+        for (uint32_t trial = 0; trial < 4000; trial++)
+        {
+            const uint32_t ofs = rm.irand(0, 16);
+            const uint32_t size = (trial < 1000) ? trial : rm.irand(0, (trial & 1) ? 300 : 70000);
+            const uint32_t split = rm.irand(0, size + 1);
+            const uint8_t *pBuf = buf.get_ptr() + ofs;
+
+            const uint64_t expected = calc_crc64_bytewise(CRC64_INIT, pBuf, size);
+
+            for (uint32_t i = 0; i < num_impls; i++)
+            {
+                const crc64_impl_t &impl = crc64_get_impl(i, num_impls);
+                if (impl.m_pFunc(CRC64_INIT, pBuf, size) != expected)
+                {
+                    vogl_error_printf("%s CRC64 mismatch, size %u offset %u\n", impl.m_pName, size, ofs);
+                    return false;
+                }
+
+                uint64_t crc = impl.m_pFunc(CRC64_INIT, pBuf, split);
+                if (impl.m_pFunc(crc, pBuf + split, size - split) != expected)
+                {
+                    vogl_error_printf("%s incremental CRC64 mismatch, size %u split %u\n", impl.m_pName, size, split);
+                    return false;
+                }
+            }
+        }
+
+        // MurmurHash3 x64 128 reference values
+        hash128_t h = calc_hash128("", 0);
+        if ((h.m_lo != 0) || (h.m_hi != 0))
+            return false;
+        h = calc_hash128("", 0, 1);
+        if ((h.m_lo != 0x4610ABE56EFF5CB5ULL) || (h.m_hi != 0x51622DAA78F83583ULL))
+            return false;
+        h = calc_hash128("hello", 5);
+        if ((h.m_lo != 0xCBD8A7B341BD9B02ULL) || (h.m_hi != 0x5B1E906A48AE1D19ULL))
+            return false;
+        h = calc_hash128("The quick brown fox jumps over the lazy dog", 43);
+        if ((h.m_lo != 0xE34BBC7BBC071B6CULL) || (h.m_hi != 0x7A433CA9C49A9347ULL))
+            return false;
+
+        uint8_t seq[1027];
+        for (uint32_t i = 0; i < sizeof(seq); i++)
+            seq[i] = (i < 1024) ? static_cast<uint8_t>(i) : static_cast<uint8_t>("abc"[i - 1024]);
+        h = calc_hash128(seq, sizeof(seq), 0x1234);
+        if ((h.m_lo != 0x33E7444AC4178DF2ULL) || (h.m_hi != 0xE8FA4530DEB9E5BFULL))
+            return false;
+
+        return true;
+    }
+
+    // Not part of --all, run with "vogltest --test hash_bench".
+    bool hash_bench()
+    {
+        const uint32_t num_impls = crc64_get_num_impls();
+
+        random rm(2);
+
+        vogl::vector<uint8_t> buf(64 * 1024 * 1024);
+        for (uint32_t i = 0; i < buf.size(); i++)
+            buf[i] = rm.urand32() >> 24;
+
+        const double mb = buf.size() / (1024.0 * 1024.0);
+        for (uint32_t i = 0; i < num_impls; i++)
+        {
+            const crc64_impl_t &impl = crc64_get_impl(i, num_impls);
+
+            timer tm;
+            tm.start();
+            uint64_t crc = impl.m_pFunc(CRC64_INIT, buf.get_ptr(), buf.size());
+            tm.stop();
+
+            vogl_printf("crc64 %-10s: %8.1f MB/sec (0x%016" PRIX64 ")\n", impl.m_pName, mb / math::maximum(tm.get_elapsed_secs(), 1e-9), crc);
+        }
+
+        timer tm;
+        tm.start();
+        hash128_t h = calc_hash128(buf.get_ptr(), buf.size());
+        tm.stop();
+        vogl_printf("hash128          : %8.1f MB/sec (0x%016" PRIX64 "%016" PRIX64 ")\n", mb / math::maximum(tm.get_elapsed_secs(), 1e-9), h.m_hi, h.m_lo);
+
+        return true;
+    }
+
 } // namespace vogl
@@ -33,10 +33,38 @@ namespace vogl
 {
     extern uint64_t g_crc64_table[256];
 
+    // CRC-64 (ECMA-182 polynomial, reflected, same as xz). calc_crc64() uses the fastest implementation supported by the CPU, picked when voglcore is loaded.
+    // All implementations return identical results, so CRC's may be compared across machines.
     const uint64_t CRC64_INIT = 0;
     void crc64_init();
     uint64_t calc_crc64(uint64_t crc, const uint8_t *buf, size_t size);
 
+    // The individual CRC-64 implementations, exposed for testing and benchmarking.
+    uint64_t calc_crc64_bytewise(uint64_t crc, const uint8_t *buf, size_t size);
+    uint64_t calc_crc64_slice8(uint64_t crc, const uint8_t *buf, size_t size);
+    uint64_t calc_crc64_slice16(uint64_t crc, const uint8_t *buf, size_t size);
+    // Carryless multiply folding, only call this if crc64_clmul_supported() returns true.
+    bool crc64_clmul_supported();
+    uint64_t calc_crc64_clmul(uint64_t crc, const uint8_t *buf, size_t size);
+
+    // 128-bit non-cryptographic hash (MurmurHash3 x64 128), much faster than md5 and far less collision prone than a 64-bit CRC. Intended for content-addressed IDs.
+    struct hash128_t
+    {
+        uint64_t m_lo;
+        uint64_t m_hi;
+
+        inline bool operator==(const hash128_t &other) const
+        {
+            return (m_lo == other.m_lo) && (m_hi == other.m_hi);
+        }
+        inline bool operator!=(const hash128_t &other) const
+        {
+            return !(*this == other);
+        }
+    };
+
+    hash128_t calc_hash128(const void *p, size_t size, uint64_t seed = 0);
+
     uint64_t calc_sum64(const uint8_t *buf, size_t size, uint32_t shift_amount = 0);
 
     uint32_t fast_hash(const void *p, int len);
@@ -236,4 +264,7 @@ namespace vogl
 
     const char *find_well_known_string_hash(const string_hash &hash);
 
+    bool hash_test();
+    bool hash_bench();
+
 } // namespace vogl
@@ -31,6 +31,19 @@
 #include "vogl_growable_array.h"
 #include "vogl_hash_map.h"
 #include "vogl_map.h"
+#include "vogl_rand.h"
+#include "vogl_data_stream.h"
+#include "vogl_dynamic_stream.h"
+
+#include <locale.h>
+
+// SSE2 is always available on x64, x86 builds only use it if the compiler has been told it's available.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+    #define VOGL_JSON_USE_SSE2 1
+    #include <emmintrin.h>
+#else
+    #define VOGL_JSON_USE_SSE2 0
+#endif
 
 namespace vogl
 {
@@ -41,6 +54,9 @@ namespace vogl
 
     const uint32_t cMaxValidDepth = 511;
 
+    // Keys shorter than this are decoded on the stack, so short keys land in dynamic_string's inline buffer without touching the heap.
+    const uint32_t cMaxSmallKeyBufSize = 64;
+
     const uint32_t cJSONTabSize = 3;
 
     void json_node_pool_init()
@@ -195,6 +211,44 @@ namespace vogl
         return *this;
     }
 
+    // Returns a pointer to the first character in [p, pEnd) which can't be copied verbatim from inside a quoted string
+    // (a quote, backslash, CR, LF or 0), or pEnd if there isn't one.
+    static inline const char *json_find_string_special_char(const char *p, const char *pEnd)
+    {
+#if VOGL_JSON_USE_SSE2
+        const __m128i quote = _mm_set1_epi8('\"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i cr = _mm_set1_epi8('\r');
+        const __m128i lf = _mm_set1_epi8('\n');
+        const __m128i zero = _mm_setzero_si128();
+
+        while ((pEnd - p) >= 16)
+        {
+            const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+
+            __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chars, quote), _mm_cmpeq_epi8(chars, backslash));
+            special = _mm_or_si128(special, _mm_or_si128(_mm_cmpeq_epi8(chars, cr), _mm_cmpeq_epi8(chars, lf)));
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(chars, zero));
+
+            const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+            if (mask)
+                return p + math::count_trailing_zero_bits(mask);
+
+            p += 16;
+        }
+#endif
+
+        while (p < pEnd)
+        {
+            const char c = *p;
+            if ((c == '\"') || (c == '\\') || (c == '\r') || (c == '\n') || (!c))
+                break;
+            ++p;
+        }
+
+        return p;
+    }
+
     // class json_growable_char_buf
 
     class json_growable_char_buf
@@ -336,6 +390,7 @@ namespace vogl
 
     json_value::json_value(const json_value &other)
         : m_type(other.m_type),
+          m_arena_string(false),
           m_line(0)
     {
         if (other.m_type == cJSONValueTypeString)
@@ -1007,6 +1062,11 @@ namespace vogl
     }
 
     bool json_value::binary_deserialize(FILE *pFile)
+    {
+        return binary_deserialize(pFile, NULL);
+    }
+
+    bool json_value::binary_deserialize(FILE *pFile, json_arena *pArena)
     {
         vogl_fseek(pFile, 0, SEEK_END);
         const uint64_t filesize = vogl_ftell(pFile);
@@ -1028,7 +1088,7 @@ namespace vogl
             return false;
         }
 
-        bool status = binary_deserialize(pBuf, static_cast<size_t>(filesize));
+        bool status = binary_deserialize(pBuf, static_cast<size_t>(filesize), pArena);
 
         vogl_free(pBuf);
 
@@ -1042,10 +1102,15 @@ namespace vogl
 
     bool json_value::binary_deserialize(const uint8_t *pBuf, size_t n)
     {
-        return binary_deserialize(pBuf, pBuf + n, NULL, 0);
+        return binary_deserialize(pBuf, pBuf + n, NULL, 0, NULL);
+    }
+
+    bool json_value::binary_deserialize(const uint8_t *pBuf, size_t n, json_arena *pArena)
+    {
+        return binary_deserialize(pBuf, pBuf + n, NULL, 0, pArena);
     }
 
-    bool json_value::binary_deserialize(const uint8_t *&pBuf, const uint8_t *pBuf_end, json_node *pParent, uint32_t depth)
+    bool json_value::binary_deserialize(const uint8_t *&pBuf, const uint8_t *pBuf_end, json_node *pParent, uint32_t depth, json_arena *pArena)
     {
 #define JSON_BD_FAIL() \
     do                 \
@@ -1110,7 +1175,7 @@ namespace vogl
                 else if (l == 255)
                     unknown_len = true;
 
-                json_node *pNode = set_value_to_node(is_object, pParent);
+                json_node *pNode = set_value_to_node(is_object, pParent, pArena);
                 if (!unknown_len)
                     pNode->resize(l);
 
@@ -1151,7 +1216,7 @@ namespace vogl
                         uint32_t l2 = *pSrc++;
                         n--;
 
-                        if (c == 'S')
+                        if (q == 'S')
                         {
                             if (n < 3)
                                 JSON_BD_FAIL();
@@ -1168,7 +1233,7 @@ namespace vogl
                         pSrc += l2;
                     }
 
-                    if (!pNode->get_value(idx).binary_deserialize(pSrc, pBuf_end, pNode, depth + 1))
+                    if (!pNode->get_value(idx).binary_deserialize(pSrc, pBuf_end, pNode, depth + 1, pArena))
                         JSON_BD_FAIL();
 
                     ++idx;
@@ -1197,15 +1262,11 @@ namespace vogl
                 if (n < l)
                     JSON_BD_FAIL();
 
-                m_type = cJSONValueTypeString;
-                m_data.m_pStr = (char *)vogl_malloc(l + 1);
-                if (!m_data.m_pStr)
-                {
-                    set_value_to_null();
+                char *pStr = alloc_string_value(l + 1, pArena);
+                if (!pStr)
                     JSON_BD_FAIL();
-                }
-                memcpy(m_data.m_pStr, pSrc, l);
-                m_data.m_pStr[l] = '\0';
+                memcpy(pStr, pSrc, l);
+                pStr[l] = '\0';
                 pSrc += l;
                 break;
             }
@@ -1324,12 +1385,12 @@ namespace vogl
         return fwrite(buf.get_ptr(), 1, buf.size(), pFile) == buf.size();
     }
 
-    bool json_value::deserialize_node(json_deserialize_buf_ptr &pStr, json_node *pParent, uint32_t level, json_error_info_t &error_info)
+    bool json_value::deserialize_node(json_deserialize_buf_ptr &pStr, json_node *pParent, uint32_t level, json_error_info_t &error_info, json_arena *pArena)
     {
         const bool is_object = (*pStr == '{');
         const char end_char = is_object ? '}' : ']';
 
-        json_node *pNode = set_value_to_node(is_object, pParent);
+        json_node *pNode = set_value_to_node(is_object, pParent, pArena);
         pNode->m_line = pStr.get_cur_line();
 
         pStr.advance_in_line_no_end_check(1);
@@ -1363,15 +1424,26 @@ namespace vogl
                     return false;
                 }
                 uint32_t buf_size = estimated_len + 1;
-                char *pBuf = dynamic_string::create_raw_buffer(buf_size);
-
-                char *pDst = pBuf;
-                if (!deserialize_quoted_string_to_buf(pDst, buf_size, pStr, error_info))
+                if (buf_size <= cMaxSmallKeyBufSize)
                 {
-                    dynamic_string::free_raw_buffer(pBuf);
-                    return false;
+                    char key_buf[cMaxSmallKeyBufSize];
+                    char *pDst = key_buf;
+                    if (!deserialize_quoted_string_to_buf(pDst, buf_size, pStr, error_info))
+                        return false;
+                    pNode->get_key(value_index).set_from_buf(key_buf, static_cast<uint32_t>(pDst - key_buf));
+                }
+                else
+                {
+                    char *pBuf = dynamic_string::create_raw_buffer(buf_size);
+
+                    char *pDst = pBuf;
+                    if (!deserialize_quoted_string_to_buf(pDst, buf_size, pStr, error_info))
+                    {
+                        dynamic_string::free_raw_buffer(pBuf);
+                        return false;
+                    }
+                    pNode->get_key(value_index).set_from_raw_buf_and_assume_ownership(pBuf, buf_size, static_cast<uint32_t>(pDst - pBuf));
                 }
-                pNode->get_key(value_index).set_from_raw_buf_and_assume_ownership(pBuf, buf_size, static_cast<uint32_t>(pDst - pBuf));
 
                 pStr.skip_whitespace();
 
@@ -1393,7 +1465,7 @@ namespace vogl
                 return false;
             }
 
-            if (!newVal.deserialize(pStr, pNode, level + 1, error_info))
+            if (!newVal.deserialize(pStr, pNode, level + 1, error_info, pArena))
                 return false;
 
             pStr.skip_whitespace();
@@ -1422,31 +1494,39 @@ namespace vogl
 
     bool json_value::estimate_deserialized_string_size(json_deserialize_buf_ptr &pStr, json_error_info_t &error_info, uint32_t &size)
     {
-        json_deserialize_buf_ptr pTmpStr(pStr);
-        uint32_t len = 0;
+        const char *p = pStr;
+        const char *pEnd = pStr.get_end();
+        uint64_t len = 0;
         for (;;)
         {
-            char c = pTmpStr.get_and_advance();
-            if ((!c) || (c == '\n'))
+            const char *pSpecial = json_find_string_special_char(p, pEnd);
+            len += pSpecial - p;
+            p = pSpecial;
+
+            char c = (p < pEnd) ? *p++ : 0;
+            if ((!c) || (c == '\n') || (c == '\r'))
             {
                 error_info.set_error(pStr.get_cur_line(), "Missing end quote in string");
                 return false;
             }
             if (c == '\"')
                 break;
-            else if (c == '\\')
+
+            // Backslash
+            c = (p < pEnd) ? *p++ : 0;
+            if ((!c) || (c == '\n') || (c == '\r'))
             {
-                c = pTmpStr.get_and_advance();
-                if ((!c) || (c == '\n'))
-                {
-                    error_info.set_error(pStr.get_cur_line(), "Missing escape character");
-                    return false;
-                }
-                len++; // in case the escape char is a backslash
+                error_info.set_error(pStr.get_cur_line(), "Missing escape character");
+                return false;
             }
-            len++;
+            len += 2; // in case the escape char is a backslash
+        }
+        if (len >= cUINT32_MAX)
+        {
+            error_info.set_error(pStr.get_cur_line(), "Quoted string is too long");
+            return false;
         }
-        size = len;
+        size = static_cast<uint32_t>(len);
         return true;
     }
 
@@ -1458,6 +1538,13 @@ namespace vogl
         char *pDst = pBuf;
         for (;;)
         {
+            // Copy the run of plain characters in one go, there can't be any line breaks in it.
+            const char *pSrc = pStr;
+            const size_t n = json_find_string_special_char(pSrc, pStr.get_end()) - pSrc;
+            memcpy(pDst, pSrc, n);
+            pDst += n;
+            pStr.advance_in_line_no_end_check(static_cast<uint32_t>(n));
+
             char c = pStr.get_and_advance();
             if (c == '\"')
                 break;
@@ -1550,7 +1637,7 @@ namespace vogl
         return true;
     }
 
-    bool json_value::deserialize_string(json_deserialize_buf_ptr &pStr, json_error_info_t &error_info)
+    bool json_value::deserialize_string(json_deserialize_buf_ptr &pStr, json_error_info_t &error_info, json_arena *pArena)
     {
         pStr.advance_in_line_no_end_check(1);
 
@@ -1558,8 +1645,10 @@ namespace vogl
         if (!estimate_deserialized_string_size(pStr, error_info, estimated_len))
             return false;
 
+        set_value_to_null();
+
         uint32_t buf_size = estimated_len + 1;
-        char *pBuf = (char *)vogl_malloc(buf_size);
+        char *pBuf = alloc_string_value(buf_size, pArena);
         if (!pBuf)
         {
             error_info.set_error(pStr.get_cur_line(), "Out of memory");
@@ -1568,9 +1657,10 @@ namespace vogl
 
         char *pDst = pBuf;
         if (!deserialize_quoted_string_to_buf(pDst, buf_size, pStr, error_info))
+        {
+            set_value_to_null();
             return false;
-
-        set_value_assume_ownership(pBuf);
+        }
 
         return true;
     }
@@ -1621,119 +1711,146 @@ namespace vogl
         return true;
     }
 
-    static const double g_pow10_table[63] =
+    // Powers of 10 which are exactly representable as doubles.
+    static const double g_exact_pow10_table[23] =
         {
-            1.e-031, 1.e-030, 1.e-029, 1.e-028, 1.e-027, 1.e-026, 1.e-025, 1.e-024, 1.e-023, 1.e-022, 1.e-021, 1.e-020, 1.e-019, 1.e-018, 1.e-017, 1.e-016,
-            1.e-015, 1.e-014, 1.e-013, 1.e-012, 1.e-011, 1.e-010, 1.e-009, 1.e-008, 1.e-007, 1.e-006, 1.e-005, 1.e-004, 1.e-003, 1.e-002, 1.e-001, 1.e+000,
-            1.e+001, 1.e+002, 1.e+003, 1.e+004, 1.e+005, 1.e+006, 1.e+007, 1.e+008, 1.e+009, 1.e+010, 1.e+011, 1.e+012, 1.e+013, 1.e+014, 1.e+015, 1.e+016,
-            1.e+017, 1.e+018, 1.e+019, 1.e+020, 1.e+021, 1.e+022, 1.e+023, 1.e+024, 1.e+025, 1.e+026, 1.e+027, 1.e+028, 1.e+029, 1.e+030, 1.e+031
+            1.e+000, 1.e+001, 1.e+002, 1.e+003, 1.e+004, 1.e+005, 1.e+006, 1.e+007, 1.e+008, 1.e+009, 1.e+010, 1.e+011,
+            1.e+012, 1.e+013, 1.e+014, 1.e+015, 1.e+016, 1.e+017, 1.e+018, 1.e+019, 1.e+020, 1.e+021, 1.e+022
         };
 
+    // Converts a JSON number which can't take the fast path in deserialize_number() using the C runtime, which rounds correctly.
+    // strtod() honors the current locale's decimal point, which the app we're running inside may have changed.
+    static double json_slow_string_to_double(const char *pStart, const char *pEnd)
+    {
+        const char decimal_point = localeconv()->decimal_point[0];
+
+        const size_t len = pEnd - pStart;
+
+        char local_buf[128];
+        vogl::vector<char> heap_buf;
+        char *pBuf = local_buf;
+        if (len >= sizeof(local_buf))
+        {
+            heap_buf.resize(static_cast<uint32_t>(len + 1));
+            pBuf = heap_buf.get_ptr();
+        }
+
+        for (size_t i = 0; i < len; i++)
+            pBuf[i] = (pStart[i] == '.') ? decimal_point : pStart[i];
+        pBuf[len] = '\0';
+
+        return strtod(pBuf, NULL);
+    }
+
     bool json_value::deserialize_number(json_deserialize_buf_ptr &pStr, json_error_info_t &error_info)
     {
-        uint64_t n = 0, limit = cINT64_MAX;
-        int sign = 1;
-        bool bParseAsDouble = false;
+        // Numbers never span lines, so scan the raw characters directly.
+        const char *pStart = pStr;
+        const char *pEnd = pStr.get_end();
+        const char *p = pStart;
 
-        char c = pStr.get_char();
-        if (c == '-')
+        uint64_t limit = cINT64_MAX;
+        bool negative = false;
+        if ((p < pEnd) && (*p == '-'))
         {
-            sign = -1;
+            negative = true;
             limit++;
-            pStr.advance_in_line_no_end_check(1);
-            c = pStr.get_char();
+            p++;
         }
 
-        while ((c >= '0') && (c <= '9'))
+        // Accumulate up to 19 significant digits (always fits in 64-bits), digits past that only adjust the exponent.
+        uint64_t mantissa = 0;
+        uint32_t num_sig_digits = 0;
+        int64_t exponent = 0;
+        bool parse_as_double = false;
+
+        while ((p < pEnd) && (*p >= '0') && (*p <= '9'))
         {
-            if (n > 0x1999999999999998ULL)
+            if (num_sig_digits < 19)
             {
-                bParseAsDouble = true;
-                break;
+                mantissa = mantissa * 10U + (*p - '0');
+                num_sig_digits += (mantissa != 0);
             }
-            n = n * 10U + c - '0';
-            pStr.advance_in_line_no_end_check(1);
-            c = pStr.get_char();
+            else
+                exponent++;
+            p++;
         }
 
-        if ((bParseAsDouble) || (n > limit) || (c == 'e') || (c == 'E') || (c == '.'))
+        if ((p < pEnd) && (*p == '.'))
         {
-            double f = static_cast<double>(n);
-            int scale = 0, escalesign = 1, escale = 0;
-
-            while ((c >= '0') && (c <= '9'))
-            {
-                f = f * 10.0f + (c - '0');
-                pStr.advance_in_line_no_end_check(1);
-                c = pStr.get_char();
-            }
-
-            if (c == '.')
+            parse_as_double = true;
+            p++;
+            while ((p < pEnd) && (*p >= '0') && (*p <= '9'))
             {
-                pStr.advance_in_line_no_end_check(1);
-                c = pStr.get_char();
-                while ((c >= '0') && (c <= '9'))
+                if (num_sig_digits < 19)
                 {
-                    scale--;
-                    f = f * 10.0f + (c - '0');
-                    pStr.advance_in_line_no_end_check(1);
-                    c = pStr.get_char();
+                    mantissa = mantissa * 10U + (*p - '0');
+                    num_sig_digits += (mantissa != 0);
+                    exponent--;
                 }
+                p++;
             }
+        }
 
-            if ((c == 'e') || (c == 'E'))
-            {
-                pStr.advance_in_line_no_end_check(1);
+        if ((p < pEnd) && ((*p == 'e') || (*p == 'E')))
+        {
+            parse_as_double = true;
+            p++;
 
-                c = pStr.get_char();
-                if (c == '-')
-                {
-                    escalesign = -1;
-                    pStr.advance_in_line_no_end_check(1);
-                    c = pStr.get_char();
-                }
-                else if (c == '+')
-                {
-                    pStr.advance_in_line_no_end_check(1);
-                    c = pStr.get_char();
-                }
-                while ((c >= '0') && (c <= '9'))
-                {
-                    if (escale > 0xCCCCCCB)
-                    {
-                        error_info.set_error(pStr.get_cur_line(), "Failed parsing numeric value");
-                        return false;
-                    }
-                    escale = escale * 10 + (c - '0');
-                    pStr.advance_in_line_no_end_check(1);
-                    c = pStr.get_char();
-                }
+            int escalesign = 1;
+            if ((p < pEnd) && (*p == '-'))
+            {
+                escalesign = -1;
+                p++;
             }
+            else if ((p < pEnd) && (*p == '+'))
+                p++;
 
-            double v = sign * f;
-            int64_t final_scale = scale + escale * escalesign;
-            if ((final_scale < -31) || (final_scale > 31))
+            int escale = 0;
+            while ((p < pEnd) && (*p >= '0') && (*p <= '9'))
             {
-                if ((final_scale < cINT32_MIN) || (final_scale > cINT32_MAX))
+                if (escale > 0xCCCCCCB)
                 {
                     error_info.set_error(pStr.get_cur_line(), "Failed parsing numeric value");
                     return false;
                 }
-                v *= pow(10.0, static_cast<int>(final_scale));
+                escale = escale * 10 + (*p - '0');
+                p++;
             }
-            else
-                v *= g_pow10_table[static_cast<int>(final_scale) + 31];
+            exponent += escale * escalesign;
+        }
+
+        pStr.advance_in_line_no_end_check(static_cast<uint32_t>(p - pStart));
+
+        if ((!parse_as_double) && (!exponent) && (mantissa <= limit))
+        {
+            set_value(static_cast<int64_t>(negative ? (0 - mantissa) : mantissa));
+            return true;
+        }
 
-            set_value(v);
+        if ((exponent < cINT32_MIN) || (exponent > cINT32_MAX))
+        {
+            error_info.set_error(pStr.get_cur_line(), "Failed parsing numeric value");
+            return false;
+        }
+
+        double v;
+        if ((mantissa <= (1ULL << 53)) && (exponent >= -22) && (exponent <= 22))
+        {
+            // Both operands are exact, so the single rounding of the multiply or divide gives the correctly rounded result.
+            v = static_cast<double>(mantissa);
+            if (exponent < 0)
+                v /= g_exact_pow10_table[-exponent];
+            else
+                v *= g_exact_pow10_table[exponent];
         }
         else
         {
-            int64_t v = static_cast<int64_t>(n);
-            if (sign < 0)
-                v = -v;
-            set_value(v);
+            v = json_slow_string_to_double(negative ? (pStart + 1) : pStart, p);
         }
 
+        set_value(negative ? -v : v);
+
         return true;
     }
 
@@ -1749,7 +1866,7 @@ namespace vogl
             return false;
         }
 
-        bool success = deserialize(pFile, pError_info);
+        bool success = deserialize(pFile, pError_info, NULL);
 
         if (vogl_fclose(pFile) == EOF)
             success = false;
@@ -1763,6 +1880,11 @@ namespace vogl
     }
 
     bool json_value::deserialize(FILE *pFile, json_error_info_t *pError_info)
+    {
+        return deserialize(pFile, pError_info, NULL);
+    }
+
+    bool json_value::deserialize(FILE *pFile, json_error_info_t *pError_info, json_arena *pArena)
     {
         vogl_fseek(pFile, 0, SEEK_END);
         const uint64_t filesize = vogl_ftell(pFile);
@@ -1794,7 +1916,7 @@ namespace vogl
         // Not really necesssary
         pBuf[filesize] = '\0';
 
-        bool status = deserialize(pBuf, static_cast<size_t>(filesize), pError_info);
+        bool status = deserialize(pBuf, static_cast<size_t>(filesize), pError_info, pArena);
 
         vogl_free(pBuf);
 
@@ -1812,6 +1934,11 @@ namespace vogl
     }
 
     bool json_value::deserialize(const char *pBuf, size_t buf_size, json_error_info_t *pError_info)
+    {
+        return deserialize(pBuf, buf_size, pError_info, NULL);
+    }
+
+    bool json_value::deserialize(const char *pBuf, size_t buf_size, json_error_info_t *pError_info, json_arena *pArena)
     {
         set_value_to_null();
 
@@ -1832,7 +1959,7 @@ namespace vogl
         }
 
         json_error_info_t dummy_error_info;
-        if (!deserialize(buf_ptr, NULL, 0, pError_info ? *pError_info : dummy_error_info))
+        if (!deserialize(buf_ptr, NULL, 0, pError_info ? *pError_info : dummy_error_info, pArena))
             return false;
 
         buf_ptr.skip_whitespace();
@@ -1845,7 +1972,7 @@ namespace vogl
         return true;
     }
 
-    bool json_value::deserialize(json_deserialize_buf_ptr &pStr, json_node *pParent, uint32_t level, json_error_info_t &error_info)
+    bool json_value::deserialize(json_deserialize_buf_ptr &pStr, json_node *pParent, uint32_t level, json_error_info_t &error_info, json_arena *pArena)
     {
         m_line = pStr.get_cur_line();
 
@@ -1854,9 +1981,9 @@ namespace vogl
         {
             case '{':
             case '[':
-                return deserialize_node(pStr, pParent, level, error_info);
+                return deserialize_node(pStr, pParent, level, error_info, pArena);
             case '\"':
-                return deserialize_string(pStr, error_info);
+                return deserialize_string(pStr, error_info, pArena);
             case 'n':
             {
                 if (pStr.compare_string("null", 4))
@@ -1902,14 +2029,18 @@ namespace vogl
 
     json_node::json_node()
         : m_pParent(NULL),
+          m_pArena(NULL),
           m_line(0),
+          m_num_indexed_keys(0),
           m_is_object(false)
     {
     }
 
     json_node::json_node(const json_node &other)
         : m_pParent(NULL),
+          m_pArena(NULL),
           m_line(0),
+          m_num_indexed_keys(0),
           m_is_object(false)
     {
         *this = other;
@@ -1917,7 +2048,9 @@ namespace vogl
 
     json_node::json_node(const json_node *pParent, bool is_object)
         : m_pParent(pParent),
+          m_pArena(NULL),
           m_line(0),
+          m_num_indexed_keys(0),
           m_is_object(is_object)
     {
     }
@@ -1964,12 +2097,83 @@ namespace vogl
         return (index < 0) ? get_null_json_value() : m_values[index];
     }
 
+    // Case insensitive FNV-1a, must agree with dynamic_string::compare().
+    static inline uint32_t json_key_hash(const char *pKey)
+    {
+        uint32_t h = 2166136261U;
+        while (*pKey)
+        {
+            h ^= static_cast<uint8_t>(vogl_tolower(*pKey++));
+            h *= 16777619U;
+        }
+        return h;
+    }
+
+    void json_node::update_key_index() const
+    {
+        const uint32_t num_keys = m_keys.size();
+        if (m_num_indexed_keys == num_keys)
+            return;
+
+        // Keep the table at most half full, rehashing everything if it needs to grow.
+        if ((num_keys * 2U) > m_key_index.size())
+        {
+            m_key_index.resize(0);
+            m_key_index.resize(math::next_pow2(num_keys * 2U));
+            m_num_indexed_keys = 0;
+        }
+
+        const uint32_t mask = m_key_index.size() - 1;
+        uint32_t *pTable = m_key_index.get_ptr();
+
+        for (uint32_t i = m_num_indexed_keys; i < num_keys; i++)
+        {
+            const char *pKey = m_keys[i].get_ptr();
+
+            uint32_t slot = json_key_hash(pKey) & mask;
+            for (;;)
+            {
+                uint32_t cur = pTable[slot];
+                if (!cur)
+                {
+                    pTable[slot] = i + 1;
+                    break;
+                }
+                // Duplicate keys: find_key() must return the first one, which is already in the table.
+                if (m_keys[cur - 1] == pKey)
+                    break;
+                slot = (slot + 1) & mask;
+            }
+        }
+
+        m_num_indexed_keys = num_keys;
+    }
+
     int json_node::find_key(const char *pKey) const
     {
-        for (uint32_t i = 0; i < m_keys.size(); i++)
-            if (m_keys[i] == pKey)
-                return i;
-        return cInvalidIndex;
+        if (m_keys.size() < cKeyIndexThreshold)
+        {
+            for (uint32_t i = 0; i < m_keys.size(); i++)
+                if (m_keys[i] == pKey)
+                    return i;
+            return cInvalidIndex;
+        }
+
+        update_key_index();
+
+        const uint32_t mask = m_key_index.size() - 1;
+        const uint32_t *pTable = m_key_index.get_ptr();
+
+        uint32_t slot = json_key_hash(pKey) & mask;
+        for (;;)
+        {
+            uint32_t cur = pTable[slot];
+            if (!cur)
+                return cInvalidIndex;
+            if (m_keys[cur - 1] == pKey)
+                return cur - 1;
+            slot = (slot + 1) & mask;
+        }
     }
 
     int json_node::find_child(const json_node *pNode) const
@@ -2256,12 +2460,15 @@ namespace vogl
     {
         m_keys.clear();
         m_values.clear();
+        m_key_index.clear();
+        m_num_indexed_keys = 0;
         m_is_object = false;
         m_line = 0;
     }
 
     void json_node::resize(uint32_t new_size)
     {
+        invalidate_key_index(new_size);
         if (m_is_object)
             m_keys.resize(new_size, true);
         m_values.resize(new_size, true);
@@ -2281,7 +2488,10 @@ namespace vogl
         if (is_object)
             m_keys.resize(size());
         else
+        {
             m_keys.clear();
+            invalidate_key_index();
+        }
         m_is_object = is_object;
     }
 
@@ -2372,12 +2582,15 @@ namespace vogl
             VOGL_ASSERT_ALWAYS;
             return get_empty_dynamic_string();
         }
+        // The caller may modify the key.
+        invalidate_key_index(index);
         return m_keys[index];
     }
 
     void json_node::set_key_value(uint32_t index, const char *pKey, const json_value &val)
     {
         ensure_is_object();
+        invalidate_key_index(index);
         m_keys[index].set(pKey);
 
         m_values[index] = val;
@@ -2388,6 +2601,7 @@ namespace vogl
     void json_node::set_key(uint32_t index, const char *pKey)
     {
         ensure_is_object();
+        invalidate_key_index(index);
         m_keys[index].set(pKey);
     }
 
@@ -2450,10 +2664,7 @@ namespace vogl
         ensure_is_object();
         m_keys.push_back(pKey);
 
-        json_node *pNode = get_json_node_pool()->alloc(this, true);
-        m_values.enlarge(1);
-        m_values.back().set_value_assume_ownership(pNode);
-        return *pNode;
+        return *m_values.enlarge(1)->set_value_to_node(true, this, m_pArena);
     }
 
     json_node &json_node::add_array(const char *pKey)
@@ -2461,27 +2672,21 @@ namespace vogl
         ensure_is_object();
         m_keys.push_back(pKey);
 
-        json_node *pNode = get_json_node_pool()->alloc(this, false);
-        m_values.enlarge(1)->set_value_assume_ownership(pNode);
-        return *pNode;
+        return *m_values.enlarge(1)->set_value_to_node(false, this, m_pArena);
     }
 
     json_node &json_node::add_object()
     {
         if (m_is_object)
             m_keys.enlarge(1);
-        json_node *pNode = get_json_node_pool()->alloc(this, true);
-        m_values.enlarge(1)->set_value_assume_ownership(pNode);
-        return *pNode;
+        return *m_values.enlarge(1)->set_value_to_node(true, this, m_pArena);
     }
 
     json_node &json_node::add_array()
     {
         if (m_is_object)
             m_keys.enlarge(1);
-        json_node *pNode = get_json_node_pool()->alloc(this, false);
-        m_values.enlarge(1)->set_value_assume_ownership(pNode);
-        return *pNode;
+        return *m_values.enlarge(1)->set_value_to_node(false, this, m_pArena);
     }
 
     bool json_node::erase(const char *pKey)
@@ -2497,6 +2702,7 @@ namespace vogl
 
     void json_node::erase(uint32_t index)
     {
+        invalidate_key_index(index);
         if (m_is_object)
             m_keys.erase(index);
         m_values.erase(index);
@@ -2871,16 +3077,79 @@ namespace vogl
         return get_value(index).get_enum(pStringList, val, def);
     }
 
+    // class json_arena
+
+    json_arena::json_arena()
+        : m_node_pool(256, cObjectPoolGrowExponential),
+          m_cur_string_block(0),
+          m_cur_string_block_ofs(0)
+    {
+    }
+
+    json_arena::~json_arena()
+    {
+        reset();
+
+        for (uint32_t i = 0; i < m_string_blocks.size(); i++)
+            vogl_free(m_string_blocks[i]);
+    }
+
+    json_node *json_arena::alloc_node(const json_node *pParent, bool is_object)
+    {
+        json_node *pNode = m_node_pool.alloc(pParent, is_object);
+        pNode->m_pArena = this;
+        return pNode;
+    }
+
+    char *json_arena::alloc_string_slow(uint32_t buf_size)
+    {
+        if (buf_size > cMaxSmallString)
+        {
+            char *p = static_cast<char *>(vogl_malloc(buf_size));
+            if (p)
+                m_large_strings.push_back(p);
+            return p;
+        }
+
+        if (m_cur_string_block < m_string_blocks.size())
+            m_cur_string_block++;
+
+        if (m_cur_string_block == m_string_blocks.size())
+        {
+            char *pBlock = static_cast<char *>(vogl_malloc(cStringBlockSize));
+            if (!pBlock)
+                return NULL;
+            m_string_blocks.push_back(pBlock);
+        }
+
+        m_cur_string_block_ofs = buf_size;
+        return m_string_blocks[m_cur_string_block];
+    }
+
+    void json_arena::reset()
+    {
+        VOGL_ASSERT(!m_node_pool.get_total_used_nodes());
+
+        for (uint32_t i = 0; i < m_large_strings.size(); i++)
+            vogl_free(m_large_strings[i]);
+        m_large_strings.resize(0);
+
+        m_cur_string_block = 0;
+        m_cur_string_block_ofs = 0;
+    }
+
     // class json_document
 
     json_document::json_document()
-        : m_error_line(0)
+        : m_error_line(0),
+          m_pArena(NULL)
     {
         init_object();
     }
 
     json_document::json_document(const json_value &other)
-        : m_error_line(0)
+        : m_error_line(0),
+          m_pArena(NULL)
     {
         get_value() = other;
     }
@@ -2899,7 +3168,8 @@ namespace vogl
 
     json_document::json_document(const json_document &other)
         : json_value(other),
-          m_error_line(0)
+          m_error_line(0),
+          m_pArena(NULL)
     {
         *this = other;
     }
@@ -2921,42 +3191,88 @@ namespace vogl
     }
 
     json_document::json_document(const char *pStr, const char *pFilename)
-        : m_error_line(0)
+        : m_error_line(0),
+          m_pArena(NULL)
     {
         deserialize(pStr, pFilename);
     }
 
     json_document::json_document(const char *pBuf, uint32_t n, const char *pFilename)
-        : m_error_line(0)
+        : m_error_line(0),
+          m_pArena(NULL)
     {
         deserialize(pBuf, n, pFilename);
     }
 
     json_document::json_document(json_value_type_t value_type)
-        : m_error_line(0)
+        : m_error_line(0),
+          m_pArena(NULL)
     {
         init(value_type);
     }
 
     json_document::~json_document()
     {
-        clear();
+        clear(false);
+
+        vogl_delete(m_pArena);
     }
 
     void json_document::swap(json_document &other)
     {
+        std::swap(m_pArena, other.m_pArena);
         std::swap(m_error_line, other.m_error_line);
         m_error_msg.swap(other.m_error_msg);
         m_filename.swap(other.m_filename);
         get_value().swap(other.get_value());
     }
 
+    void json_document::set_arena_enabled(bool enabled)
+    {
+        if (enabled == is_arena_enabled())
+            return;
+
+        clear(false);
+
+        if (enabled)
+        {
+            m_pArena = vogl_new(json_arena);
+        }
+        else
+        {
+            vogl_delete(m_pArena);
+            m_pArena = NULL;
+        }
+
+        init_object();
+    }
+
+    void json_document::reset_arena()
+    {
+        if (m_pArena)
+            m_pArena->reset();
+    }
+
     bool json_document::deserialize_file(const char *pFilename)
     {
         set_filename(pFilename);
+        clear(false);
+
+        FILE *pFile = vogl_fopen(pFilename, "rb");
+        if (!pFile)
+        {
+            m_error_msg = "Unable to open file";
+            m_error_line = 0;
+            return false;
+        }
 
         json_error_info_t err_info;
-        if (!json_value::deserialize_file(pFilename, &err_info))
+        bool success = json_value::deserialize(pFile, &err_info, m_pArena);
+
+        if (vogl_fclose(pFile) == EOF)
+            success = false;
+
+        if (!success)
         {
             m_error_msg.swap(err_info.m_error_msg);
             m_error_line = err_info.m_error_line;
@@ -2976,8 +3292,10 @@ namespace vogl
     {
         set_filename(pFilename);
 
+        clear(false);
+
         json_error_info_t err_info;
-        if (!json_value::deserialize(pFile, &err_info))
+        if (!json_value::deserialize(pFile, &err_info, m_pArena))
         {
             m_error_msg.swap(err_info.m_error_msg);
             m_error_line = err_info.m_error_line;
@@ -2992,8 +3310,10 @@ namespace vogl
     {
         set_filename(pFilename);
 
+        clear(false);
+
         json_error_info_t err_info;
-        if (!json_value::deserialize(pBuf, n, &err_info))
+        if (!json_value::deserialize(pBuf, n, &err_info, m_pArena))
         {
             m_error_msg.swap(err_info.m_error_msg);
             m_error_line = err_info.m_error_line;
@@ -3014,42 +3334,944 @@ namespace vogl
         return deserialize(str.get_ptr(), str.get_len(), pFilename);
     }
 
-    class my_type
+    bool json_document::binary_deserialize_file(const char *pFilename)
     {
-    public:
-        vogl::vector<dynamic_string> a1;
-        vogl::map<dynamic_string, dynamic_string_array> a2;
-        dynamic_string a;
-        dynamic_string b;
+        set_filename(pFilename);
+        clear_error();
 
-        bool json_serialize(json_value &val) const
+        FILE *pFile = vogl_fopen(pFilename, "rb");
+        if (!pFile)
+            return false;
+        bool success = binary_deserialize(pFile);
+        if (vogl_fclose(pFile) == EOF)
+            success = false;
+        return success;
+    }
+
+    bool json_document::binary_deserialize(FILE *pFile)
+    {
+        clear(false);
+        return json_value::binary_deserialize(pFile, m_pArena);
+    }
+
+    bool json_document::binary_deserialize(const vogl::vector<uint8_t> &buf)
+    {
+        return buf.size() ? binary_deserialize(buf.get_ptr(), buf.size()) : false;
+    }
+
+    bool json_document::binary_deserialize(const uint8_t *pBuf, size_t buf_size)
+    {
+        clear(false);
+        return json_value::binary_deserialize(pBuf, buf_size, m_pArena);
+    }
+
+    // class json_stream_writer
+
+    const uint32_t cJSONStreamFlushSize = 64 * 1024;
+
+    static void json_binary_serialize_string(vogl::vector<uint8_t> &buf, const char *pStr, uint32_t len)
+    {
+        uint8_t *pDst;
+        if (len <= 254)
         {
-            json_node *pObj = val.init_object();
-            pObj->add_object("a1", a1);
-            pObj->add_object("a2", a2);
-            pObj->add_object("a", a);
-            pObj->add_object("b", b);
-            return true;
+            pDst = buf.enlarge(2 + len);
+            *pDst++ = 's';
+            *pDst++ = static_cast<uint8_t>(len);
         }
-
-        bool json_deserialize(const json_value &val)
+        else
         {
-            const json_node *pObj = val.get_node_ptr();
-            if (!pObj)
-                return false;
-            pObj->get_object("a1", a1);
-            pObj->get_object("a2", a2);
-            pObj->get_object("a", a);
-            pObj->get_object("b", b);
-            return true;
+            pDst = buf.enlarge(5 + len);
+            *pDst++ = 'S';
+            *pDst++ = static_cast<uint8_t>(len >> 24);
+            *pDst++ = static_cast<uint8_t>(len >> 16);
+            *pDst++ = static_cast<uint8_t>(len >> 8);
+            *pDst++ = static_cast<uint8_t>(len);
         }
-    };
+        memcpy(pDst, pStr, len);
+    }
 
-    // TODO: Actually test these classes.
-    bool json_test()
+    json_stream_writer::json_stream_writer()
+        : m_pStream(NULL),
+          m_pending_array(NULL, false),
+          m_has_pending_array(false),
+          m_max_line_len(CMaxLineLenDefault),
+          m_binary(false),
+          m_formatted(true),
+          m_wrote_root(false),
+          m_root_is_node(false),
+          m_error(false)
     {
-        // Create a JSON document
-        json_document doc;
+    }
+
+    json_stream_writer::~json_stream_writer()
+    {
+        if (m_pStream)
+            flush();
+    }
+
+    bool json_stream_writer::open(data_stream &stream, bool binary, bool formatted, uint32_t max_line_len)
+    {
+        if (m_pStream)
+            close();
+
+        m_pStream = &stream;
+        m_text_buf.resize(0);
+        m_binary_buf.resize(0);
+        m_container_sizes.resize(0);
+        m_container_is_object.resize(0);
+        m_pending_array.clear();
+        m_has_pending_array = false;
+        m_max_line_len = max_line_len;
+        m_binary = binary;
+        m_formatted = formatted;
+        m_wrote_root = false;
+        m_root_is_node = false;
+        m_error = !stream.is_writable();
+
+        return !m_error;
+    }
+
+    bool json_stream_writer::close()
+    {
+        if (!m_pStream)
+            return false;
+
+        bool success = m_wrote_root && !m_container_sizes.size();
+        if ((success) && (!m_binary) && (m_formatted) && (m_root_is_node))
+            m_text_buf.push_back('\n');
+
+        if (!flush())
+            success = false;
+
+        m_pStream = NULL;
+        m_pending_array.clear();
+        m_has_pending_array = false;
+
+        return success;
+    }
+
+    bool json_stream_writer::flush()
+    {
+        if (!m_pStream)
+            return false;
+
+        if (m_text_buf.size())
+        {
+            if (m_pStream->write(m_text_buf.get_ptr(), m_text_buf.size()) != m_text_buf.size())
+                m_error = true;
+
+            // Don't hang on to the space used by a huge node.
+            if (m_text_buf.capacity() > cJSONStreamFlushSize * 4)
+                m_text_buf.clear();
+            else
+                m_text_buf.resize(0);
+        }
+
+        if (m_binary_buf.size())
+        {
+            if (m_pStream->write(m_binary_buf.get_ptr(), m_binary_buf.size()) != m_binary_buf.size())
+                m_error = true;
+
+            if (m_binary_buf.capacity() > cJSONStreamFlushSize * 4)
+                m_binary_buf.clear();
+            else
+                m_binary_buf.resize(0);
+        }
+
+        return !m_error;
+    }
+
+    inline bool json_stream_writer::flush_if_full()
+    {
+        if ((m_text_buf.size() + m_binary_buf.size()) >= cJSONStreamFlushSize)
+            return flush();
+        return !m_error;
+    }
+
+    // Writes the separator and key (if any) which precede a new item in the current object/array.
+    bool json_stream_writer::begin_item(const char *pKey)
+    {
+        if ((!m_pStream) || (m_error))
+            return false;
+
+        if (!m_container_sizes.size())
+        {
+            if ((m_wrote_root) || (pKey))
+            {
+                VOGL_ASSERT_ALWAYS;
+                return false;
+            }
+            m_wrote_root = true;
+            return true;
+        }
+
+        const bool in_object = m_container_is_object.back() != 0;
+        if (in_object != (pKey != NULL))
+        {
+            VOGL_ASSERT_ALWAYS;
+            return false;
+        }
+
+        uint32_t &size = m_container_sizes.back();
+
+        if (m_binary)
+        {
+            if (in_object)
+            {
+                size_t len = strlen(pKey);
+                if (len > cUINT32_MAX)
+                    return false;
+                json_binary_serialize_string(m_binary_buf, pKey, static_cast<uint32_t>(len));
+            }
+        }
+        else
+        {
+            json_growable_char_buf buf(m_text_buf);
+            if (size)
+                buf.print_char(',');
+            if (m_formatted)
+            {
+                buf.print_char('\n');
+                buf.print_tabs(m_container_sizes.size());
+            }
+            if (in_object)
+            {
+                buf.print_escaped(pKey);
+                buf.puts(m_formatted ? " : " : ":");
+            }
+        }
+
+        size++;
+        return true;
+    }
+
+    // The pending array turned out to have a child object or array, so write it the same way json_node::serialize() would.
+    void json_stream_writer::flush_pending_array()
+    {
+        VOGL_ASSERT(m_has_pending_array);
+        m_has_pending_array = false;
+
+        m_text_buf.push_back('[');
+        for (uint32_t i = 0; i < m_pending_array.size(); i++)
+        {
+            begin_item(NULL);
+            write_scalar(m_pending_array.get_value(i));
+        }
+
+        m_pending_array.resize(0);
+    }
+
+    void json_stream_writer::write_scalar(const json_value &val)
+    {
+        if (m_binary)
+            val.binary_serialize(m_binary_buf);
+        else if (val.is_string())
+        {
+            json_growable_char_buf buf(m_text_buf);
+            buf.print_escaped(val.as_string_ptr());
+        }
+        else
+        {
+            dynamic_string str;
+            val.get_string(str);
+            m_text_buf.append(str.get_ptr(), str.get_len());
+        }
+    }
+
+    bool json_stream_writer::begin_container(const char *pKey, bool is_object)
+    {
+        if (m_has_pending_array)
+            flush_pending_array();
+
+        if (m_container_sizes.size() > cMaxValidDepth)
+            return false;
+
+        const bool is_root = !m_container_sizes.size();
+        if (!begin_item(pKey))
+            return false;
+        if (is_root)
+            m_root_is_node = true;
+
+        m_container_sizes.push_back(0);
+        m_container_is_object.push_back(is_object);
+
+        if (m_binary)
+        {
+            // Unknown length, terminated by 'E'.
+            uint8_t *pDst = m_binary_buf.enlarge(2);
+            pDst[0] = is_object ? 'o' : 'a';
+            pDst[1] = 255;
+        }
+        else if ((!is_object) && (m_formatted))
+            m_has_pending_array = true;
+        else
+            m_text_buf.push_back(is_object ? '{' : '[');
+
+        return flush_if_full();
+    }
+
+    bool json_stream_writer::begin_object(const char *pKey)
+    {
+        return begin_container(pKey, true);
+    }
+
+    bool json_stream_writer::begin_array(const char *pKey)
+    {
+        return begin_container(pKey, false);
+    }
+
+    bool json_stream_writer::end()
+    {
+        if ((!m_pStream) || (m_error) || (!m_container_sizes.size()))
+            return false;
+
+        const uint32_t size = m_container_sizes.back();
+        const bool is_object = m_container_is_object.back() != 0;
+        m_container_sizes.pop_back();
+        m_container_is_object.pop_back();
+
+        if (m_binary)
+            m_binary_buf.push_back('E');
+        else if (m_has_pending_array)
+        {
+            m_has_pending_array = false;
+
+            json_growable_char_buf buf(m_text_buf);
+            m_pending_array.serialize(buf, m_formatted, m_container_sizes.size(), m_max_line_len);
+            m_pending_array.resize(0);
+        }
+        else
+        {
+            json_growable_char_buf buf(m_text_buf);
+            if (m_formatted)
+            {
+                if (size)
+                {
+                    buf.print_char('\n');
+                    buf.print_tabs(m_container_sizes.size());
+                }
+                else
+                    buf.print_char(' ');
+            }
+            buf.print_char(is_object ? '}' : ']');
+        }
+
+        return flush_if_full();
+    }
+
+    bool json_stream_writer::add_value(const char *pKey, const json_value &val)
+    {
+        if (val.is_node())
+        {
+            const json_node *pNode = val.get_node_ptr();
+            return pNode ? add_node(pKey, *pNode) : false;
+        }
+
+        if (m_has_pending_array)
+        {
+            if ((pKey) || (m_error))
+                return false;
+            m_pending_array.add_value(val);
+            return true;
+        }
+
+        if (!begin_item(pKey))
+            return false;
+
+        write_scalar(val);
+
+        return flush_if_full();
+    }
+
+    bool json_stream_writer::add_node(const char *pKey, const json_node &node)
+    {
+        if (m_has_pending_array)
+            flush_pending_array();
+
+        const bool is_root = !m_container_sizes.size();
+        if (!begin_item(pKey))
+            return false;
+        if (is_root)
+            m_root_is_node = true;
+
+        if (m_binary)
+            node.binary_serialize(m_binary_buf);
+        else
+        {
+            json_growable_char_buf buf(m_text_buf);
+            node.serialize(buf, m_formatted, m_container_sizes.size(), m_max_line_len);
+        }
+
+        return flush_if_full();
+    }
+
+    // class json_stream_reader
+
+    const uint32_t cJSONStreamReadSize = 64 * 1024;
+
+    json_stream_reader::json_stream_reader()
+        : m_pStream(NULL),
+          m_buf_ofs(0),
+          m_buf_end(0),
+          m_eof(false),
+          m_cur_line(1)
+    {
+        m_error_info.m_error_line = 0;
+    }
+
+    json_stream_reader::~json_stream_reader()
+    {
+    }
+
+    void json_stream_reader::init(data_stream &stream)
+    {
+        m_pStream = &stream;
+        m_buf_ofs = 0;
+        m_buf_end = 0;
+        m_eof = false;
+        m_cur_line = 1;
+        m_error_info.m_error_line = 0;
+        m_error_info.m_error_msg.clear();
+    }
+
+    // Makes sure at least min_avail bytes are buffered, returns false if the stream ends first.
+    bool json_stream_reader::fill(uint32_t min_avail)
+    {
+        while ((m_buf_end - m_buf_ofs) < min_avail)
+        {
+            if (m_eof)
+                return false;
+
+            if (m_buf_ofs)
+            {
+                memmove(m_buf.get_ptr(), m_buf.get_ptr() + m_buf_ofs, m_buf_end - m_buf_ofs);
+                m_buf_end -= m_buf_ofs;
+                m_buf_ofs = 0;
+            }
+
+            if ((m_buf.size() - m_buf_end) < cJSONStreamReadSize)
+                m_buf.resize(math::maximum(m_buf.size() * 2, m_buf_end + cJSONStreamReadSize));
+
+            uint32_t n = m_pStream->read(m_buf.get_ptr() + m_buf_end, m_buf.size() - m_buf_end);
+            if (!n)
+                m_eof = true;
+            m_buf_end += n;
+        }
+        return true;
+    }
+
+    // Same rules as json_deserialize_buf_ptr::skip_whitespace(). Returns false at the end of the stream.
+    bool json_stream_reader::skip_whitespace()
+    {
+        for (;;)
+        {
+            if ((m_buf_ofs >= m_buf_end) && (!fill(1)))
+                return false;
+
+            char c = m_buf[m_buf_ofs];
+            if (c == '/')
+            {
+                if ((!fill(2)) || (m_buf[m_buf_ofs + 1] != '/'))
+                    return true;
+
+                m_buf_ofs += 2;
+                for (;;)
+                {
+                    if ((m_buf_ofs >= m_buf_end) && (!fill(1)))
+                        return false;
+                    c = m_buf[m_buf_ofs];
+                    if ((c == '\n') || (c == '\r'))
+                        break;
+                    m_buf_ofs++;
+                }
+                continue;
+            }
+            else if (c > ' ')
+                return true;
+            else if (c == '\r')
+            {
+                if ((fill(2)) && (m_buf[m_buf_ofs + 1] == '\n'))
+                    m_buf_ofs++;
+                m_cur_line++;
+            }
+            else if (c == '\n')
+                m_cur_line++;
+
+            m_buf_ofs++;
+        }
+    }
+
+    // Buffers the entire string, number or literal at the current position and parses it with json_value::deserialize().
+    bool json_stream_reader::read_text_token(bool quoted, json_value &val)
+    {
+        uint32_t len = quoted ? 1 : 0;
+        for (;;)
+        {
+            if (((m_buf_ofs + len) >= m_buf_end) && (!fill(len + 1)))
+            {
+                if (quoted)
+                {
+                    m_error_info.set_error(m_cur_line, "Unexpected end of file within string");
+                    return false;
+                }
+                break;
+            }
+
+            const char *pStart = m_buf.get_ptr() + m_buf_ofs;
+            if (quoted)
+            {
+                const char *p = json_find_string_special_char(pStart + len, m_buf.get_ptr() + m_buf_end);
+                len = static_cast<uint32_t>(p - pStart);
+                if (p == (m_buf.get_ptr() + m_buf_end))
+                    continue;
+
+                if (*p == '\"')
+                {
+                    len++;
+                    break;
+                }
+
+                // Skip the escaped character too, it may be a quote.
+                len += (*p == '\\') ? 2 : 1;
+            }
+            else
+            {
+                char c = pStart[len];
+                if ((c <= ' ') || (c == ',') || (c == ']') || (c == '}') || (c == ':') || (c == '/'))
+                    break;
+                len++;
+            }
+        }
+
+        if (!len)
+        {
+            m_error_info.set_error(m_cur_line, "Unrecognized character: '%c'", m_buf[m_buf_ofs]);
+            return false;
+        }
+
+        json_error_info_t error_info;
+        if (!val.deserialize(m_buf.get_ptr() + m_buf_ofs, len, &error_info))
+        {
+            m_error_info.set_error(m_cur_line, "%s", error_info.m_error_msg.get_ptr());
+            return false;
+        }
+
+        m_buf_ofs += len;
+        return true;
+    }
+
+    bool json_stream_reader::parse(data_stream &stream, json_stream_handler &handler)
+    {
+        init(stream);
+
+        vogl::vector<uint8_t> container_is_object;
+
+        if (!skip_whitespace())
+        {
+            m_error_info.set_error(0, "Nothing to deserialize");
+            return false;
+        }
+
+        for (;;)
+        {
+            const char *pKey = NULL;
+            bool closed_container = false;
+
+            if (container_is_object.size())
+            {
+                const bool is_object = container_is_object.back() != 0;
+
+                if (!skip_whitespace())
+                {
+                    m_error_info.set_error(m_cur_line, "Unexpected end of file within object or array");
+                    return false;
+                }
+
+                char c = m_buf[m_buf_ofs];
+                if (c == (is_object ? '}' : ']'))
+                {
+                    m_buf_ofs++;
+                    container_is_object.pop_back();
+                    if (!handler.end())
+                    {
+                        m_error_info.set_error(m_cur_line, "Parsing stopped by handler");
+                        return false;
+                    }
+                    closed_container = true;
+                }
+                else if (is_object)
+                {
+                    if (c != '\"')
+                    {
+                        m_error_info.set_error(m_cur_line, "Expected quoted key string");
+                        return false;
+                    }
+
+                    if (!read_text_token(true, m_value))
+                        return false;
+                    m_key.set(m_value.as_string_ptr());
+                    pKey = m_key.get_ptr();
+
+                    if ((!skip_whitespace()) || (m_buf[m_buf_ofs] != ':'))
+                    {
+                        m_error_info.set_error(m_cur_line, "Missing colon after key");
+                        return false;
+                    }
+                    m_buf_ofs++;
+                }
+            }
+
+            if (!closed_container)
+            {
+                if (!skip_whitespace())
+                {
+                    m_error_info.set_error(m_cur_line, "Unexpected end of file");
+                    return false;
+                }
+
+                char c = m_buf[m_buf_ofs];
+                if ((c == '{') || (c == '['))
+                {
+                    if (container_is_object.size() > cMaxValidDepth)
+                    {
+                        m_error_info.set_error(m_cur_line, "Document is too complex");
+                        return false;
+                    }
+
+                    m_buf_ofs++;
+                    container_is_object.push_back(c == '{');
+
+                    if (!((c == '{') ? handler.begin_object(pKey) : handler.begin_array(pKey)))
+                    {
+                        m_error_info.set_error(m_cur_line, "Parsing stopped by handler");
+                        return false;
+                    }
+                    continue;
+                }
+
+                if (!read_text_token(c == '\"', m_value))
+                    return false;
+
+                if (!handler.add_value(pKey, m_value))
+                {
+                    m_error_info.set_error(m_cur_line, "Parsing stopped by handler");
+                    return false;
+                }
+            }
+
+            if (!container_is_object.size())
+                break;
+
+            if (!skip_whitespace())
+            {
+                m_error_info.set_error(m_cur_line, "Unexpected end of file within object or array");
+                return false;
+            }
+
+            char c = m_buf[m_buf_ofs];
+            if (c == ',')
+            {
+                m_buf_ofs++;
+
+                if (!skip_whitespace())
+                {
+                    m_error_info.set_error(m_cur_line, "Unexpected end of file within object or array");
+                    return false;
+                }
+
+                c = m_buf[m_buf_ofs];
+                if ((c == '}') || (c == ']'))
+                {
+                    m_error_info.set_error(m_cur_line, "Trailing comma within object or array");
+                    return false;
+                }
+            }
+            else if (c != (container_is_object.back() ? '}' : ']'))
+            {
+                m_error_info.set_error(m_cur_line, "Unexpected character within object or array");
+                return false;
+            }
+        }
+
+        if (skip_whitespace())
+        {
+            m_error_info.set_error(m_cur_line, "Syntax error on/near line");
+            return false;
+        }
+
+        return true;
+    }
+
+    // Returns a pointer to the next n bytes, which stays valid until the next read.
+    const uint8_t *json_stream_reader::read_bytes(uint32_t n)
+    {
+        if (!fill(n))
+            return NULL;
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(m_buf.get_ptr() + m_buf_ofs);
+        m_buf_ofs += n;
+        return p;
+    }
+
+    // Reads the next type byte, skipping no-op's.
+    bool json_stream_reader::read_binary_type(uint8_t &type)
+    {
+        for (;;)
+        {
+            const uint8_t *p = read_bytes(1);
+            if (!p)
+                return false;
+            if (*p != 'N')
+            {
+                type = *p;
+                return true;
+            }
+        }
+    }
+
+    static inline uint32_t json_read_be32(const uint8_t *p)
+    {
+        return (static_cast<uint32_t>(p[0]) << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+
+    bool json_stream_reader::binary_parse(data_stream &stream, json_stream_handler &handler)
+    {
+        init(stream);
+
+        // Number of items left in each open object/array, or cUINT32_MAX if it's terminated by 'E'.
+        vogl::vector<uint32_t> container_sizes;
+        vogl::vector<uint8_t> container_is_object;
+
+        for (;;)
+        {
+            const char *pKey = NULL;
+            uint8_t type = 0;
+
+            if (container_sizes.size())
+            {
+                uint32_t &remaining = container_sizes.back();
+
+                bool at_end = !remaining;
+                if (!at_end)
+                {
+                    if (!read_binary_type(type))
+                    {
+                        m_error_info.set_error(0, "Unexpected end of file within object or array");
+                        return false;
+                    }
+                    at_end = (type == 'E');
+                }
+
+                if (at_end)
+                {
+                    container_sizes.pop_back();
+                    container_is_object.pop_back();
+
+                    if (!handler.end())
+                    {
+                        m_error_info.set_error(0, "Parsing stopped by handler");
+                        return false;
+                    }
+
+                    if (!container_sizes.size())
+                        break;
+                    continue;
+                }
+
+                if (remaining != cUINT32_MAX)
+                    remaining--;
+
+                if (container_is_object.back())
+                {
+                    if ((type != 's') && (type != 'S'))
+                    {
+                        m_error_info.set_error(0, "Expected key string");
+                        return false;
+                    }
+
+                    const uint8_t *p = read_bytes((type == 's') ? 1 : 4);
+                    const uint32_t len = p ? ((type == 's') ? *p : json_read_be32(p)) : 0;
+                    if ((!p) || (len >= cMaxDynamicStringLen) || ((p = read_bytes(len)) == NULL))
+                    {
+                        m_error_info.set_error(0, "Invalid key string");
+                        return false;
+                    }
+
+                    m_key.set_from_buf(p, len);
+                    pKey = m_key.get_ptr();
+
+                    if (!read_binary_type(type))
+                    {
+                        m_error_info.set_error(0, "Unexpected end of file within object");
+                        return false;
+                    }
+                }
+            }
+            else if (!read_binary_type(type))
+            {
+                m_error_info.set_error(0, "Nothing to deserialize");
+                return false;
+            }
+
+            if ((type == 'a') || (type == 'o') || (type == 'A') || (type == 'O'))
+            {
+                const bool is_object = (type == 'o') || (type == 'O');
+
+                const uint8_t *p = read_bytes((type >= 'a') ? 1 : 4);
+                if (!p)
+                {
+                    m_error_info.set_error(0, "Unexpected end of file");
+                    return false;
+                }
+
+                uint32_t size;
+                if (type >= 'a')
+                    size = (*p == 255) ? cUINT32_MAX : *p;
+                else
+                    size = json_read_be32(p);
+
+                if (container_sizes.size() > cMaxValidDepth)
+                {
+                    m_error_info.set_error(0, "Document is too complex");
+                    return false;
+                }
+
+                container_sizes.push_back(size);
+                container_is_object.push_back(is_object);
+
+                if (!(is_object ? handler.begin_object(pKey) : handler.begin_array(pKey)))
+                {
+                    m_error_info.set_error(0, "Parsing stopped by handler");
+                    return false;
+                }
+                continue;
+            }
+
+            // The type byte was just read so it's still buffered, put it back so json_value can decode the whole value.
+            m_buf_ofs--;
+
+            uint32_t size = 1;
+            switch (type)
+            {
+                case 'Z':
+                case 'T':
+                case 'F':
+                    break;
+                case 'B':
+                    size += 1;
+                    break;
+                case 'i':
+                    size += 2;
+                    break;
+                case 'I':
+                case 'd':
+                    size += 4;
+                    break;
+                case 'L':
+                case 'D':
+                    size += 8;
+                    break;
+                case 's':
+                case 'h':
+                {
+                    if (!fill(2))
+                        size = 0;
+                    else
+                        size += 1 + static_cast<uint8_t>(m_buf[m_buf_ofs + 1]);
+                    break;
+                }
+                case 'S':
+                case 'H':
+                {
+                    uint32_t len = fill(5) ? json_read_be32(reinterpret_cast<const uint8_t *>(m_buf.get_ptr() + m_buf_ofs + 1)) : cUINT32_MAX;
+                    if (len > (cUINT32_MAX - 5U))
+                        size = 0;
+                    else
+                        size += 4 + len;
+                    break;
+                }
+                default:
+                    size = 0;
+                    break;
+            }
+
+            const uint8_t *p = size ? read_bytes(size) : NULL;
+            if ((!p) || (!m_value.binary_deserialize(p, size)))
+            {
+                m_error_info.set_error(0, "Invalid or truncated value");
+                return false;
+            }
+
+            if (!handler.add_value(pKey, m_value))
+            {
+                m_error_info.set_error(0, "Parsing stopped by handler");
+                return false;
+            }
+
+            if (!container_sizes.size())
+                break;
+        }
+
+        return true;
+    }
+
+    // Writes a json_value as individual json_stream_writer events, instead of letting the writer serialize whole nodes.
+    static bool json_test_write_events(json_stream_writer &writer, const char *pKey, const json_value &val)
+    {
+        const json_node *pNode = val.get_node_ptr();
+        if (!pNode)
+            return writer.add_value(pKey, val);
+
+        if (!(pNode->is_object() ? writer.begin_object(pKey) : writer.begin_array(pKey)))
+            return false;
+
+        for (uint32_t i = 0; i < pNode->size(); i++)
+            if (!json_test_write_events(writer, pNode->is_object() ? pNode->get_key(i).get_ptr() : NULL, pNode->get_value(i)))
+                return false;
+
+        return writer.end();
+    }
+
+    static bool json_test_stream_equals(const dynamic_stream &stream, const vogl::vector<char> &buf)
+    {
+        return (stream.get_buf().size() == buf.size()) && (!memcmp(stream.get_buf().get_ptr(), buf.get_ptr(), buf.size()));
+    }
+
+    class my_type
+    {
+    public:
+        vogl::vector<dynamic_string> a1;
+        vogl::map<dynamic_string, dynamic_string_array> a2;
+        dynamic_string a;
+        dynamic_string b;
+
+        bool json_serialize(json_value &val) const
+        {
+            json_node *pObj = val.init_object();
+            pObj->add_object("a1", a1);
+            pObj->add_object("a2", a2);
+            pObj->add_object("a", a);
+            pObj->add_object("b", b);
+            return true;
+        }
+
+        bool json_deserialize(const json_value &val)
+        {
+            const json_node *pObj = val.get_node_ptr();
+            if (!pObj)
+                return false;
+            pObj->get_object("a1", a1);
+            pObj->get_object("a2", a2);
+            pObj->get_object("a", a);
+            pObj->get_object("b", b);
+            return true;
+        }
+    };
+
+    // TODO: Actually test these classes.
+    bool json_test()
+    {
+        // Create a JSON document
+        json_document doc;
         json_node *pRoot = doc.get_root();
 
         typedef vogl::growable_array<uint32_t, 16> my_growable_array_type;
@@ -3156,6 +4378,222 @@ namespace vogl
                 printf(" %s\n", b[i].get_ptr());
         }
 
+        // Large objects look up their keys through a lazily built index, which must behave exactly like the linear search.
+        json_node big_node(NULL, true);
+        for (uint32_t i = 0; i < 1000; i++)
+            big_node.add_key_value(dynamic_string(cVarArg, "key%u", i).get_ptr(), i);
+        big_node.add_key_value("KEY5", 5000U);
+
+        if ((big_node.find_key("key999") != 999) || (big_node.find_key("Key5") != 5) || (big_node.find_key("key1000") != cInvalidIndex))
+            return false;
+
+        big_node.add_key_value("key1000", 1000U);
+        if ((big_node.find_key("key1000") != 1001) || (big_node.value_as_uint32("key1000") != 1000U))
+            return false;
+
+        big_node.erase(0U);
+        big_node.set_key(0, "renamed");
+        if ((big_node.find_key("key1") != cInvalidIndex) || (big_node.find_key("renamed") != 0) || (big_node.find_key("key2") != 1))
+            return false;
+
+        json_document big_doc;
+        big_doc.get_root()->add_key_value("big", json_value(static_cast<const json_node *>(&big_node)));
+        dynamic_string big_str;
+        big_doc.serialize(big_str, false);
+        if (!big_doc.deserialize(big_str))
+            return false;
+
+        const json_node *pBig = big_doc.get_root()->find_child_object("big");
+        if ((!pBig) || (pBig->size() != big_node.size()) || (pBig->get_key(0) != "renamed") || (pBig->find_key("key998") != 997))
+            return false;
+
+        // Numbers must parse to exactly what the C runtime gives us, no matter which path they take.
+        random rm(1);
+        for (uint32_t i = 0; i < 100000; i++)
+        {
+            double d;
+            uint64_t bits = rm.urand64();
+            memcpy(&d, &bits, sizeof(d));
+            if ((d != d) || (fabs(d) > 1e300))
+                continue;
+
+            const char *pFmt = (i & 1) ? "%.17g" : "%1.18f";
+            if (i & 2)
+                d = rm.drand(-1e6, 1e6);
+
+            dynamic_string num_str(cVarArg, pFmt, d);
+            json_value num_val;
+            if (!num_val.deserialize(num_str))
+                return false;
+
+            double expected = strtod(num_str.get_ptr(), NULL);
+            double actual = num_val.as_double();
+            if (memcmp(&expected, &actual, sizeof(double)) != 0)
+            {
+                vogl_error_printf("Number mismatch parsing %s: %.17g vs. %.17g\n", num_str.get_ptr(), actual, expected);
+                return false;
+            }
+        }
+
+        static const char *s_int_strs[] = { "0", "-0", "9223372036854775807", "-9223372036854775808", "00012", "-45" };
+        static const int64_t s_int_vals[] = { 0, 0, cINT64_MAX, cINT64_MIN, 12, -45 };
+        for (uint32_t i = 0; i < VOGL_ARRAY_SIZE(s_int_strs); i++)
+        {
+            json_value int_val;
+            if ((!int_val.deserialize(s_int_strs[i])) || (!int_val.is_int()) || (int_val.as_int64() != s_int_vals[i]))
+                return false;
+        }
+
+        json_value big_int_val;
+        if ((!big_int_val.deserialize("9223372036854775808")) || (!big_int_val.is_double()) || (big_int_val.as_double() != 9223372036854775808.0))
+            return false;
+
+        // Strings are copied in runs between escapes, so put escapes at every alignment.
+        for (uint32_t i = 0; i < 40; i++)
+        {
+            dynamic_string plain_str;
+            for (uint32_t j = 0; j < i; j++)
+                plain_str.append_char(static_cast<char>('a' + (j % 26)));
+            plain_str.append("\"\\\t/\xC3\xA9");
+            for (uint32_t j = 0; j < 40 - i; j++)
+                plain_str.append_char(static_cast<char>('A' + (j % 26)));
+
+            json_value str_val(plain_str);
+            dynamic_string str_json;
+            str_val.serialize(str_json, false);
+
+            json_value parsed_str_val;
+            if ((!parsed_str_val.deserialize(str_json)) || (parsed_str_val.as_string() != plain_str))
+                return false;
+        }
+
+        json_value unterminated_val;
+        if ((unterminated_val.deserialize("\"abcdefghijklmnopqrstuvwxyz")) || (unterminated_val.deserialize("\"abcdefghijklmnopq\nrstuvwxyz\"")))
+            return false;
+
+        // The streaming writer must output exactly what the DOM serializer does, and the streaming readers must reproduce the same events.
+        json_document stream_doc;
+        json_node *pStream_root = stream_doc.get_root();
+        pStream_root->add_key_value("test", json_value(static_cast<const json_node *>(pRoot)));
+        pStream_root->add_object("empty_object");
+        pStream_root->add_array("empty_array");
+        json_node &mixed_array = pStream_root->add_array("mixed");
+        mixed_array.add_value(1);
+        mixed_array.add_value("two\n\"2\"");
+        mixed_array.add_object().add_key_value("three", 3.25f);
+        mixed_array.add_array().add_value(false);
+        mixed_array.add_value(json_value());
+        json_node &stream_items = pStream_root->add_array("items");
+        for (uint32_t i = 0; i < 3000; i++)
+        {
+            json_node &item = stream_items.add_object();
+            item.add_key_value("index", i);
+            item.add_key_value("name", dynamic_string(cVarArg, "item \"%u\"\t", i));
+            item.add_key_value("value", rm.drand(-1e6, 1e6));
+            json_node &values = item.add_array("values");
+            for (uint32_t j = 0; j < (i % 50); j++)
+                values.add_value(rm.irand(cINT32_MIN, cINT32_MAX));
+        }
+
+        json_stream_writer writer;
+        json_stream_reader reader;
+
+        for (uint32_t formatted = 0; formatted < 2; formatted++)
+        {
+            vogl::vector<char> expected_text;
+            stream_doc.serialize(expected_text, formatted != 0, 0, false);
+
+            dynamic_stream text_stream;
+            if ((!writer.open(text_stream, false, formatted != 0)) || (!json_test_write_events(writer, NULL, stream_doc)) || (!writer.close()))
+                return false;
+            if (!json_test_stream_equals(text_stream, expected_text))
+                return false;
+
+            text_stream.seek(0, false);
+            dynamic_stream round_trip_stream;
+            if ((!writer.open(round_trip_stream, false, formatted != 0)) || (!reader.parse(text_stream, writer)) || (!writer.close()))
+                return false;
+            if (!json_test_stream_equals(round_trip_stream, expected_text))
+                return false;
+        }
+
+        vogl::vector<uint8_t> dom_ubj;
+        stream_doc.binary_serialize(dom_ubj);
+
+        json_document dom_ubj_doc;
+        if (!dom_ubj_doc.binary_deserialize(dom_ubj))
+            return false;
+        vogl::vector<char> expected_ubj_text;
+        dom_ubj_doc.serialize(expected_ubj_text, true, 0, false);
+
+        dynamic_stream ubj_stream;
+        if ((!writer.open(ubj_stream, true)) || (!json_test_write_events(writer, NULL, stream_doc)) || (!writer.close()))
+            return false;
+
+        json_document stream_ubj_doc;
+        if (!stream_ubj_doc.binary_deserialize(ubj_stream.get_buf()))
+            return false;
+        vogl::vector<char> stream_ubj_text;
+        stream_ubj_doc.serialize(stream_ubj_text, true, 0, false);
+        if (stream_ubj_text != expected_ubj_text)
+            return false;
+
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            dynamic_stream src_stream(i ? ubj_stream.get_buf().get_ptr() : dom_ubj.get_ptr(), i ? ubj_stream.get_buf().size() : dom_ubj.size());
+            dynamic_stream text_stream;
+            if ((!writer.open(text_stream)) || (!reader.binary_parse(src_stream, writer)) || (!writer.close()))
+                return false;
+            if (!json_test_stream_equals(text_stream, expected_ubj_text))
+                return false;
+        }
+
+        static const char *s_bad_texts[] = { "{ \"a\" : [ 1, 2 }", "[1,]", "[ 1 , ]", "{ \"a\" : 1, }", "{ \"a\" : [ 1 ], }" };
+        for (uint32_t i = 0; i < VOGL_ARRAY_SIZE(s_bad_texts); i++)
+        {
+            dynamic_stream bad_stream(s_bad_texts[i], vogl_strlen(s_bad_texts[i]));
+            dynamic_stream bad_out_stream;
+            writer.open(bad_out_stream);
+            if ((reader.parse(bad_stream, writer)) || (writer.close()))
+                return false;
+        }
+
+        // Arena documents must parse identically, be reusable after clear(), and interoperate with regular (heap) values.
+        vogl::vector<char> stream_doc_text;
+        stream_doc.serialize(stream_doc_text, true, 0, false);
+
+        json_document arena_doc;
+        arena_doc.set_arena_enabled(true);
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            if ((!arena_doc.deserialize(stream_doc_text)) || (!arena_doc.is_equal(stream_doc)) || (!arena_doc.validate()))
+                return false;
+            if ((!arena_doc.binary_deserialize(dom_ubj)) || (!arena_doc.is_equal(dom_ubj_doc)))
+                return false;
+        }
+
+        json_document arena_copy(arena_doc);
+        dynamic_string long_str;
+        long_str.set_len(65536, 'x');
+        arena_doc.get_root()->add_key_value("a key which is too long for the small string buffer", long_str);
+        arena_doc.get_root()->add_object("added").add_array("nested").add_value("not from the arena");
+        arena_doc.get_root()->add_key_value("copied", json_value(static_cast<const json_node *>(pRoot)));
+        if ((!arena_doc.validate()) || (!arena_copy.is_equal(dom_ubj_doc)))
+            return false;
+
+        vogl::vector<char> mixed_text;
+        arena_doc.serialize(mixed_text, false, 0, false);
+        json_document heap_mixed_doc;
+        if ((!heap_mixed_doc.deserialize(mixed_text)) || (!arena_doc.deserialize(mixed_text)) || (!arena_doc.is_equal(heap_mixed_doc)))
+            return false;
+
+        arena_doc.clear();
+        if ((!arena_doc.get_root()) || (arena_doc.get_root()->size()))
+            return false;
+
+        if (arena_doc.deserialize("{ \"a\" : [ 1, 2 }") || (!arena_doc.deserialize(stream_doc_text)) || (!arena_doc.is_equal(stream_doc)))
+            return false;
+
         return true;
     }
 
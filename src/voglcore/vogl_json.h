@@ -44,6 +44,9 @@ namespace vogl
     class json_growable_char_buf;
     class json_deserialize_buf_ptr;
     class json_document;
+    class json_arena;
+    class json_stream_writer;
+    class data_stream;
 
     template <typename T, uint32_t N>
     class growable_array;
@@ -277,7 +280,8 @@ namespace vogl
 
     protected:
         json_value_data_t m_data;
-        json_value_type_t m_type;
+        uint8_t m_type; // json_value_type_t
+        bool m_arena_string; // true if m_pStr points into a json_arena, which owns it
         uint32_t m_line;
 
         bool convert_to_bool(bool &val, bool def) const;
@@ -288,23 +292,26 @@ namespace vogl
         bool convert_to_double(double &val, double def) const;
         bool convert_to_string(dynamic_string &val, const char *pDef) const;
 
-        inline void free_data()
-        {
-            if (m_type == cJSONValueTypeString)
-                vogl_free(m_data.m_pStr);
-            else if (m_type == cJSONValueTypeNode)
-                get_json_node_pool()->destroy(m_data.m_pNode);
-        }
+        inline void free_data();
+
+        // Same as the public versions, except any nodes/strings are allocated from pArena (if it's not NULL).
+        bool deserialize(FILE *pFile, json_error_info_t *pError_info, json_arena *pArena);
+        bool deserialize(const char *pBuf, size_t buf_size, json_error_info_t *pError_info, json_arena *pArena);
+        bool binary_deserialize(FILE *pFile, json_arena *pArena);
+        bool binary_deserialize(const uint8_t *pBuf, size_t buf_size, json_arena *pArena);
 
-        bool deserialize_node(json_deserialize_buf_ptr &pStr, json_node *pParent, uint32_t level, json_error_info_t &error_info);
+        inline json_node *set_value_to_node(bool is_object, json_node *pParent, json_arena *pArena);
+        inline char *alloc_string_value(uint32_t buf_size, json_arena *pArena);
+
+        bool deserialize_node(json_deserialize_buf_ptr &pStr, json_node *pParent, uint32_t level, json_error_info_t &error_info, json_arena *pArena);
         bool estimate_deserialized_string_size(json_deserialize_buf_ptr &pStr, json_error_info_t &error_info, uint32_t &size);
         bool deserialize_quoted_string_to_buf(char *&pBuf, uint32_t buf_size, json_deserialize_buf_ptr &pStr, json_error_info_t &error_info);
-        bool deserialize_string(json_deserialize_buf_ptr &pStr, json_error_info_t &error_info);
+        bool deserialize_string(json_deserialize_buf_ptr &pStr, json_error_info_t &error_info, json_arena *pArena);
         bool deserialize_number(json_deserialize_buf_ptr &pStr, json_error_info_t &error_info);
-        bool deserialize(json_deserialize_buf_ptr &pStr, json_node *pParent, uint32_t level, json_error_info_t &error_info);
+        bool deserialize(json_deserialize_buf_ptr &pStr, json_node *pParent, uint32_t level, json_error_info_t &error_info, json_arena *pArena);
 
         void binary_serialize_value(vogl::vector<uint8_t> &buf) const;
-        bool binary_deserialize(const uint8_t *&pBuf, const uint8_t *pBuf_end, json_node *pParent, uint32_t depth);
+        bool binary_deserialize(const uint8_t *&pBuf, const uint8_t *pBuf_end, json_node *pParent, uint32_t depth, json_arena *pArena);
 
     private:
         // Optional: Forbid (the super annoying) implicit conversions of all pointers/const pointers to bool, except for the specializations below.
@@ -334,7 +341,7 @@ namespace vogl
     // A json_node can be either a JSON object (key/values) or array (values only).
     // It contains one or two separate unsorted arrays: one for keys (JSON objects only), and another for values (JSON objects or arrays).
     // json_node's are multisets, not sets, so duplicate keys do not cause errors, although the find() helpers will only find the first key.
-    // The order of the key/value arrays is preserved in this design, but find()'s in large objects/array can be slow.
+    // The order of the key/value arrays is preserved in this design. Key finds in small objects are linear, larger objects (see cKeyIndexThreshold) lazily build a hash index of their keys.
     // json_value's may point to other child json_nodes, which are allocated and freed from the heap.
     // The keys are simple zero terminated strings, and the values are instances of the json_value class above.
     // This design allows all keys/values at each object/array level to be stored in simple contiguous arrays.
@@ -343,8 +350,16 @@ namespace vogl
     class json_node
     {
         friend class json_value;
+        friend class json_stream_writer;
+        friend class json_arena;
 
     public:
+        enum
+        {
+            // Objects with at least this many keys build a key index on the first find_key().
+            cKeyIndexThreshold = 16
+        };
+
         json_node();
         json_node(const json_node &other);
         json_node(const json_node *pParent, bool is_object);
@@ -625,20 +640,76 @@ namespace vogl
         template <typename T>
         bool get_map(const char *pKey, T &hash_map) const;
 
+        // The arena this node was allocated from, or NULL if it came from the global node pool. Child nodes added to this node come from the same arena.
+        inline json_arena *get_arena() const
+        {
+            return m_pArena;
+        }
+
     private:
         const json_node *m_pParent;
+        json_arena *m_pArena;
 
         dynamic_string_array m_keys;
         json_value_array m_values;
 
         uint32_t m_line;
 
+        // Open addressing hash table of (key index + 1), 0 = empty slot. Only the first m_num_indexed_keys keys are present.
+        // Keys are only appended between finds in the common case, so the index is caught up lazily and only thrown away when an already indexed key is changed or removed.
+        mutable vogl::vector<uint32_t> m_key_index;
+        mutable uint32_t m_num_indexed_keys;
+
         bool m_is_object;
 
         void ensure_is_object();
+        void update_key_index() const;
+        inline void invalidate_key_index(uint32_t first_changed_index = 0);
         void serialize(json_growable_char_buf &buf, bool formatted, uint32_t cur_index, uint32_t max_line_len = CMaxLineLenDefault) const;
     };
 
+    // json_arena is a single threaded allocator for the nodes and string values of a single document.
+    // Nodes come from a private (unlocked) pool, and strings are carved out of large blocks which are never individually freed.
+    // reset() recycles everything at once, keeping the memory around for the next document. Nothing allocated from an arena may outlive it, or be used after reset().
+    // Note the key and value arrays inside each node (and keys too long for dynamic_string's small string buffer) still live on the heap.
+    class json_arena
+    {
+        VOGL_NO_COPY_OR_ASSIGNMENT_OP(json_arena);
+
+    public:
+        json_arena();
+        ~json_arena();
+
+        json_node *alloc_node(const json_node *pParent, bool is_object);
+        inline void destroy_node(json_node *pNode);
+
+        // Returns a buffer of buf_size bytes, which is only freed by reset() or the arena's destructor.
+        inline char *alloc_string(uint32_t buf_size);
+
+        // All nodes must have been destroyed before calling reset().
+        void reset();
+
+    private:
+        enum
+        {
+            cStringBlockSize = 64 * 1024,
+            cMaxSmallString = cStringBlockSize / 16
+        };
+
+        typedef object_pool<json_node, object_pool_no_lock_policy> node_pool;
+        node_pool m_node_pool;
+
+        // Fixed size blocks, reused after reset().
+        vogl::vector<char *> m_string_blocks;
+        // Strings too large to be placed into the fixed size blocks. Freed by reset().
+        vogl::vector<char *> m_large_strings;
+
+        uint32_t m_cur_string_block;
+        uint32_t m_cur_string_block_ofs;
+
+        char *alloc_string_slow(uint32_t buf_size);
+    };
+
     // json_document is an optional helper class that derives from json_value.
     // It may optionally have been parsed from a file, string, or buffer and contains filename/error/line information.
     // It's not derived from json_node because a valid JSON document may be a single value and not necessarily an object or array, although in practice it will be an object or maybe an array (and NOT a plain value) 99.999% of the time.
@@ -671,6 +742,16 @@ namespace vogl
         // Swaps two documents.
         void swap(json_document &other);
 
+        // When enabled, the document's nodes and string values are allocated from a private arena owned by the document, which is recycled as a whole by clear() and deserialization.
+        // This avoids the global node pool's lock and most per-value heap frees, which matters when parsing and discarding many documents.
+        // Values moved out of an arena document (by swap(), release_ownership(), etc.) must not outlive the document's next clear/deserialize, copies are always safe.
+        // Changing this clears the document.
+        void set_arena_enabled(bool enabled);
+        inline bool is_arena_enabled() const
+        {
+            return m_pArena != NULL;
+        }
+
         // Deserialize UTF8 text from files, buffer, or a string.
         bool deserialize_file(const char *pFilename);
         bool deserialize(FILE *pFile, const char *pFilename = "<FILE>");
@@ -679,6 +760,12 @@ namespace vogl
         bool deserialize(const char *pStr, const char *pFilename = "<string>");
         bool deserialize(const dynamic_string &str, const char *pFilename = "<string>");
 
+        // Deserialize UBJ from files or buffers.
+        bool binary_deserialize_file(const char *pFilename);
+        bool binary_deserialize(FILE *pFile);
+        bool binary_deserialize(const vogl::vector<uint8_t> &buf);
+        bool binary_deserialize(const uint8_t *pBuf, size_t buf_size);
+
         // document's filename
         inline const dynamic_string &get_filename() const;
         inline void set_filename(const char *pFilename);
@@ -693,6 +780,136 @@ namespace vogl
 
         dynamic_string m_error_msg;
         uint32_t m_error_line;
+
+        json_arena *m_pArena;
+
+        void reset_arena();
+    };
+
+    // Event interface used by json_stream_reader (and implemented by json_stream_writer).
+    // pKey is the member's key when the event is directly inside an object, otherwise it's NULL. Values are never nodes.
+    // Returning false from any method stops parsing.
+    class json_stream_handler
+    {
+    public:
+        virtual ~json_stream_handler()
+        {
+        }
+
+        virtual bool begin_object(const char *pKey) = 0;
+        virtual bool begin_array(const char *pKey) = 0;
+        virtual bool end() = 0;
+        virtual bool add_value(const char *pKey, const json_value &val) = 0;
+    };
+
+    // json_stream_writer writes text JSON or UBJ to a data_stream as it goes, so huge documents never have to be built as a json_node tree first.
+    // Entire json_node's can be written at any point, so callers can stream the outer levels of a document and build small subtrees as usual.
+    // Formatted text output is identical to json_value::serialize() of the equivalent tree. To do this, arrays which only contain values are
+    // held in memory until they're ended (or until a child object/array is added) because they are printed on as few lines as possible.
+    class json_stream_writer : public json_stream_handler
+    {
+        VOGL_NO_COPY_OR_ASSIGNMENT_OP(json_stream_writer);
+
+    public:
+        json_stream_writer();
+        virtual ~json_stream_writer();
+
+        // The stream is not owned by the writer.
+        bool open(data_stream &stream, bool binary = false, bool formatted = true, uint32_t max_line_len = CMaxLineLenDefault);
+
+        // Flushes buffered output to the stream. Fails if any objects/arrays haven't been ended, or if any write failed.
+        bool close();
+
+        inline bool is_open() const
+        {
+            return m_pStream != NULL;
+        }
+
+        // Number of currently open objects/arrays.
+        inline uint32_t get_depth() const
+        {
+            return m_container_sizes.size();
+        }
+
+        virtual bool begin_object(const char *pKey = NULL);
+        virtual bool begin_array(const char *pKey = NULL);
+        virtual bool end();
+        virtual bool add_value(const char *pKey, const json_value &val);
+
+        // Writes an entire node (and its children) as a single value.
+        bool add_node(const char *pKey, const json_node &node);
+
+        // Writes any buffered output to the stream.
+        bool flush();
+
+    private:
+        data_stream *m_pStream;
+
+        vogl::vector<char> m_text_buf;
+        vogl::vector<uint8_t> m_binary_buf;
+
+        vogl::vector<uint32_t> m_container_sizes;
+        vogl::vector<uint8_t> m_container_is_object;
+
+        // The innermost array, while it only contains values (text output only).
+        json_node m_pending_array;
+        bool m_has_pending_array;
+
+        uint32_t m_max_line_len;
+        bool m_binary;
+        bool m_formatted;
+        bool m_wrote_root;
+        bool m_root_is_node;
+        bool m_error;
+
+        bool begin_item(const char *pKey);
+        bool begin_container(const char *pKey, bool is_object);
+        void flush_pending_array();
+        void write_scalar(const json_value &val);
+        inline bool flush_if_full();
+    };
+
+    // json_stream_reader parses text JSON or UBJ from a data_stream and calls a json_stream_handler for each value, without building a json_node tree.
+    // Only the current token (or UBJ value) and a small read buffer are kept in memory. It accepts the same text syntax as json_value::deserialize().
+    class json_stream_reader
+    {
+        VOGL_NO_COPY_OR_ASSIGNMENT_OP(json_stream_reader);
+
+    public:
+        json_stream_reader();
+        ~json_stream_reader();
+
+        // Parses UTF8 text JSON.
+        bool parse(data_stream &stream, json_stream_handler &handler);
+
+        // Parses Universal Binary JSON (UBJ).
+        bool binary_parse(data_stream &stream, json_stream_handler &handler);
+
+        inline const json_error_info_t &get_error_info() const
+        {
+            return m_error_info;
+        }
+
+    private:
+        data_stream *m_pStream;
+
+        vogl::vector<char> m_buf;
+        uint32_t m_buf_ofs;
+        uint32_t m_buf_end;
+        bool m_eof;
+
+        uint32_t m_cur_line;
+        json_error_info_t m_error_info;
+
+        dynamic_string m_key;
+        json_value m_value;
+
+        void init(data_stream &stream);
+        bool fill(uint32_t min_avail);
+        bool skip_whitespace();
+        bool read_text_token(bool quoted, json_value &val);
+        const uint8_t *read_bytes(uint32_t n);
+        bool read_binary_type(uint8_t &type);
     };
 
     bool json_test();
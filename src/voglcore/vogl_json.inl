@@ -4,75 +4,76 @@ namespace vogl
 {
 
     inline json_value::json_value()
-        : m_type(cJSONValueTypeNull), m_line(0)
+        : m_type(cJSONValueTypeNull), m_arena_string(false), m_line(0)
     {
         m_data.m_nVal = 0;
     }
 
     inline json_value::json_value(bool val)
-        : m_type(cJSONValueTypeBool), m_line(0)
+        : m_type(cJSONValueTypeBool), m_arena_string(false), m_line(0)
     {
         m_data.m_nVal = val;
     }
 
     inline json_value::json_value(int32_t nVal)
-        : m_type(cJSONValueTypeInt), m_line(0)
+        : m_type(cJSONValueTypeInt), m_arena_string(false), m_line(0)
     {
         m_data.m_nVal = nVal;
     }
 
     inline json_value::json_value(uint32_t nVal)
-        : m_type(cJSONValueTypeInt), m_line(0)
+        : m_type(cJSONValueTypeInt), m_arena_string(false), m_line(0)
     {
         m_data.m_nVal = nVal;
     }
 
     inline json_value::json_value(int64_t nVal)
-        : m_type(cJSONValueTypeInt), m_line(0)
+        : m_type(cJSONValueTypeInt), m_arena_string(false), m_line(0)
     {
         m_data.m_nVal = nVal;
     }
 
     // Note uint64_t values may be encoded as hex strings or int64_t
     inline json_value::json_value(uint64_t nVal)
-        : m_type(cJSONValueTypeNull), m_line(0)
+        : m_type(cJSONValueTypeNull), m_arena_string(false), m_line(0)
     {
         m_data.m_nVal = 0;
         set_value(nVal);
     }
 
     inline json_value::json_value(double flVal)
-        : m_type(cJSONValueTypeDouble), m_line(0)
+        : m_type(cJSONValueTypeDouble), m_arena_string(false), m_line(0)
     {
         m_data.m_flVal = flVal;
     }
 
     inline json_value::json_value(char *pStr)
-        : m_type(cJSONValueTypeString), m_line(0)
+        : m_type(cJSONValueTypeString), m_arena_string(false), m_line(0)
     {
         m_data.m_pStr = vogl_strdup(pStr);
     }
 
     inline json_value::json_value(const char *pStr)
-        : m_type(cJSONValueTypeString), m_line(0)
+        : m_type(cJSONValueTypeString), m_arena_string(false), m_line(0)
     {
         m_data.m_pStr = vogl_strdup(pStr);
     }
 
     inline json_value::json_value(const dynamic_string &str)
-        : m_type(cJSONValueTypeString), m_line(0)
+        : m_type(cJSONValueTypeString), m_arena_string(false), m_line(0)
     {
         m_data.m_pStr = vogl_strdup(str.get_ptr());
     }
 
     inline json_value::json_value(const json_node *pNode)
-        : m_type(cJSONValueTypeNode), m_line(0)
+        : m_type(cJSONValueTypeNode), m_arena_string(false), m_line(0)
     {
         m_data.m_pNode = get_json_node_pool()->alloc(*pNode);
     }
 
     inline json_value::json_value(json_value_type_t type)
         : m_type(type),
+          m_arena_string(false),
           m_line(0)
     {
         m_data.m_nVal = 0;
@@ -89,7 +90,7 @@ namespace vogl
 
     inline json_value_type_t json_value::get_type() const
     {
-        return m_type;
+        return static_cast<json_value_type_t>(m_type);
     }
 
     inline const json_value_data_t &json_value::get_raw_data() const
@@ -217,6 +218,49 @@ namespace vogl
         return pRoot;
     }
 
+    inline json_node *json_value::set_value_to_node(bool is_object, json_node *pParent, json_arena *pArena)
+    {
+        if (!pArena)
+            return set_value_to_node(is_object, pParent);
+
+        json_node *pRoot = pArena->alloc_node(pParent, is_object);
+        set_value_assume_ownership(pRoot);
+        return pRoot;
+    }
+
+    // Allocates a string buffer for this value (which must currently be null) from pArena, or from the heap if pArena is NULL.
+    inline char *json_value::alloc_string_value(uint32_t buf_size, json_arena *pArena)
+    {
+        VOGL_ASSERT(m_type == cJSONValueTypeNull);
+
+        char *pBuf = pArena ? pArena->alloc_string(buf_size) : static_cast<char *>(vogl_malloc(buf_size));
+        if (!pBuf)
+            return NULL;
+
+        m_data.m_pStr = pBuf;
+        m_type = cJSONValueTypeString;
+        m_arena_string = (pArena != NULL);
+        return pBuf;
+    }
+
+    inline void json_value::free_data()
+    {
+        if (m_type == cJSONValueTypeString)
+        {
+            if (!m_arena_string)
+                vogl_free(m_data.m_pStr);
+            m_arena_string = false;
+        }
+        else if (m_type == cJSONValueTypeNode)
+        {
+            json_node *pNode = m_data.m_pNode;
+            if (pNode->m_pArena)
+                pNode->m_pArena->destroy_node(pNode);
+            else
+                get_json_node_pool()->destroy(pNode);
+        }
+    }
+
     inline void json_value::set_value_to_null()
     {
         free_data();
@@ -541,6 +585,7 @@ namespace vogl
     inline void json_value::swap(json_value &other)
     {
         std::swap(m_type, other.m_type);
+        std::swap(m_arena_string, other.m_arena_string);
         VOGL_ASSUME(sizeof(m_data.m_nVal) == sizeof(m_data));
         std::swap(m_data.m_nVal, other.m_data.m_nVal);
     }
@@ -756,6 +801,16 @@ namespace vogl
         m_pParent = pParent;
     }
 
+    // Throws away the key index if any key at or after first_changed_index has already been indexed.
+    inline void json_node::invalidate_key_index(uint32_t first_changed_index)
+    {
+        if (first_changed_index < m_num_indexed_keys)
+        {
+            m_key_index.clear();
+            m_num_indexed_keys = 0;
+        }
+    }
+
     inline void json_node::init_object()
     {
         set_is_object(true);
@@ -1240,6 +1295,23 @@ namespace vogl
         return pNode->get_vector(NULL, vec);
     }
 
+    inline void json_arena::destroy_node(json_node *pNode)
+    {
+        VOGL_ASSERT(pNode->m_pArena == this);
+        m_node_pool.destroy(pNode);
+    }
+
+    inline char *json_arena::alloc_string(uint32_t buf_size)
+    {
+        if ((m_cur_string_block < m_string_blocks.size()) && (buf_size <= (cStringBlockSize - m_cur_string_block_ofs)))
+        {
+            char *p = m_string_blocks[m_cur_string_block] + m_cur_string_block_ofs;
+            m_cur_string_block_ofs += buf_size;
+            return p;
+        }
+        return alloc_string_slow(buf_size);
+    }
+
     // root value manipulation
     inline const json_value &json_document::get_value() const
     {
@@ -1265,8 +1337,16 @@ namespace vogl
     inline void json_document::clear(bool reinitialize_to_object)
     {
         json_value::clear();
-        if (reinitialize_to_object)
+        if (m_pArena)
+        {
+            reset_arena();
+            if (reinitialize_to_object)
+                set_value_to_node(true, NULL, m_pArena);
+        }
+        else if (reinitialize_to_object)
+        {
             init_object();
+        }
     }
 
     // document's filename
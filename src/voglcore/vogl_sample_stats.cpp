@@ -0,0 +1,225 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * Copyright 2010-2014 Rich Geldreich and Tenacious Software LLC
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_sample_stats.cpp
+#include "vogl_core.h"
+#include "vogl_sample_stats.h"
+
+namespace vogl
+{
+    void sample_stats::clear()
+    {
+        m_samples.clear();
+        m_sorted_samples.clear();
+        m_sorted_samples_valid = false;
+        m_min = 0;
+        m_max = 0;
+        m_total = 0;
+        m_mean = 0;
+        m_m2 = 0;
+    }
+
+    void sample_stats::add_sample(double val)
+    {
+        if (m_samples.is_empty())
+        {
+            m_min = val;
+            m_max = val;
+        }
+        else
+        {
+            m_min = math::minimum(m_min, val);
+            m_max = math::maximum(m_max, val);
+        }
+
+        m_samples.push_back(val);
+        m_sorted_samples_valid = false;
+
+        m_total += val;
+
+        double delta = val - m_mean;
+        m_mean += delta / m_samples.size();
+        m_m2 += delta * (val - m_mean);
+    }
+
+    double sample_stats::get_variance() const
+    {
+        if (m_samples.size() < 2)
+            return 0;
+
+        return m_m2 / (m_samples.size() - 1);
+    }
+
+    double sample_stats::get_std_dev() const
+    {
+        return sqrt(get_variance());
+    }
+
+    double sample_stats::get_percentile(double percentile) const
+    {
+        if (m_samples.is_empty())
+            return 0;
+
+        if (!m_sorted_samples_valid)
+        {
+            m_sorted_samples = m_samples;
+            m_sorted_samples.sort();
+            m_sorted_samples_valid = true;
+        }
+
+        double rank = math::clamp(percentile, 0.0, 100.0) * (m_sorted_samples.size() - 1) / 100.0;
+
+        uint32_t lo = static_cast<uint32_t>(floor(rank));
+        uint32_t hi = math::minimum<uint32_t>(lo + 1, m_sorted_samples.size() - 1);
+
+        return math::lerp(m_sorted_samples[lo], m_sorted_samples[hi], rank - lo);
+    }
+
+    bool sample_stats_welch_t_test(const sample_stats &a, const sample_stats &b, double &t, double &dof)
+    {
+        t = 0;
+        dof = 0;
+
+        if ((a.size() < 2) || (b.size() < 2))
+            return false;
+
+        double va = a.get_variance() / a.size();
+        double vb = b.get_variance() / b.size();
+        double se2 = va + vb;
+
+        if (se2 <= 0)
+        {
+            // Both sets are constant, any difference at all is significant.
+            t = (b.get_mean() > a.get_mean()) ? math::cNearlyInfinite : ((b.get_mean() < a.get_mean()) ? -math::cNearlyInfinite : 0);
+            dof = a.size() + b.size() - 2;
+            return true;
+        }
+
+        t = (b.get_mean() - a.get_mean()) / sqrt(se2);
+
+        // Welch-Satterthwaite equation
+        double denom = 0;
+        if (va > 0)
+            denom += (va * va) / (a.size() - 1);
+        if (vb > 0)
+            denom += (vb * vb) / (b.size() - 1);
+        dof = (se2 * se2) / denom;
+
+        return true;
+    }
+
+    double student_t_critical_value_95(double dof)
+    {
+        static const double s_crit_values[30] =
+        {
+            12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+            2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+        };
+
+        if (dof < 1.0)
+            return s_crit_values[0];
+
+        if (dof < 30.0)
+        {
+            // Round down to be conservative.
+            return s_crit_values[static_cast<uint32_t>(dof) - 1];
+        }
+
+        if (dof < 60.0)
+            return 2.021;
+        if (dof < 120.0)
+            return 2.000;
+
+        return 1.960;
+    }
+
+#define VOGL_SAMPLE_STATS_VERIFY(x) \
+    if (!(x))                         \
+        return false;
+
+    static bool sample_stats_is_close(double a, double b)
+    {
+        return fabs(a - b) <= 1e-9 * math::maximum(1.0, fabs(a), fabs(b));
+    }
+
+    bool sample_stats_test()
+    {
+        sample_stats s;
+        VOGL_SAMPLE_STATS_VERIFY(s.is_empty());
+        VOGL_SAMPLE_STATS_VERIFY(s.get_median() == 0);
+        VOGL_SAMPLE_STATS_VERIFY(s.get_variance() == 0);
+
+        static const double s_vals[] = { 9, 2, 7, 4, 5, 6, 3, 8, 1, 10 };
+        for (uint32_t i = 0; i < VOGL_ARRAY_SIZE(s_vals); i++)
+            s.add_sample(s_vals[i]);
+
+        VOGL_SAMPLE_STATS_VERIFY(s.size() == 10);
+        VOGL_SAMPLE_STATS_VERIFY(s.get_min() == 1);
+        VOGL_SAMPLE_STATS_VERIFY(s.get_max() == 10);
+        VOGL_SAMPLE_STATS_VERIFY(sample_stats_is_close(s.get_total(), 55));
+        VOGL_SAMPLE_STATS_VERIFY(sample_stats_is_close(s.get_mean(), 5.5));
+        VOGL_SAMPLE_STATS_VERIFY(sample_stats_is_close(s.get_variance(), 55.0 / 6.0));
+        VOGL_SAMPLE_STATS_VERIFY(sample_stats_is_close(s.get_median(), 5.5));
+        VOGL_SAMPLE_STATS_VERIFY(sample_stats_is_close(s.get_percentile(0), 1));
+        VOGL_SAMPLE_STATS_VERIFY(sample_stats_is_close(s.get_percentile(100), 10));
+        VOGL_SAMPLE_STATS_VERIFY(sample_stats_is_close(s.get_percentile(95), 9.55));
+
+        // The samples themselves must stay in insertion order.
+        VOGL_SAMPLE_STATS_VERIFY(s.get_samples()[0] == 9);
+
+        s.add_sample(100);
+        VOGL_SAMPLE_STATS_VERIFY(s.get_max() == 100);
+        VOGL_SAMPLE_STATS_VERIFY(sample_stats_is_close(s.get_median(), 6));
+
+        // Two clearly separated sets are significant, two draws from the same set aren't.
+        sample_stats a, b, c;
+        for (uint32_t i = 0; i < 50; i++)
+        {
+            double noise = static_cast<double>((i * 7919) % 13) / 13.0;
+            a.add_sample(10.0 + noise);
+            b.add_sample(11.0 + noise);
+            c.add_sample(10.0 + static_cast<double>((i * 104729) % 13) / 13.0);
+        }
+
+        double t, dof;
+        VOGL_SAMPLE_STATS_VERIFY(sample_stats_welch_t_test(a, b, t, dof));
+        VOGL_SAMPLE_STATS_VERIFY(t > student_t_critical_value_95(dof));
+
+        VOGL_SAMPLE_STATS_VERIFY(sample_stats_welch_t_test(a, c, t, dof));
+        VOGL_SAMPLE_STATS_VERIFY(fabs(t) < student_t_critical_value_95(dof));
+
+        VOGL_SAMPLE_STATS_VERIFY(!sample_stats_welch_t_test(sample_stats(), a, t, dof));
+
+        VOGL_SAMPLE_STATS_VERIFY(student_t_critical_value_95(1) > student_t_critical_value_95(10));
+        VOGL_SAMPLE_STATS_VERIFY(student_t_critical_value_95(1000) == 1.960);
+
+        return true;
+    }
+
+#undef VOGL_SAMPLE_STATS_VERIFY
+
+} // namespace vogl
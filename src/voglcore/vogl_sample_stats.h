@@ -0,0 +1,112 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * Copyright 2010-2014 Rich Geldreich and Tenacious Software LLC
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+// File: vogl_sample_stats.h
+#pragma once
+
+#include "vogl_core.h"
+
+namespace vogl
+{
+    // Collects a set of samples (such as per-frame times) and computes summary statistics over them.
+    // The mean and variance are accumulated as samples are added (Welford's method), percentiles sort a copy of the samples on demand.
+    class sample_stats
+    {
+    public:
+        sample_stats()
+        {
+            clear();
+        }
+
+        void clear();
+
+        void add_sample(double val);
+
+        uint32_t size() const
+        {
+            return m_samples.size();
+        }
+        bool is_empty() const
+        {
+            return m_samples.is_empty();
+        }
+
+        const vogl::vector<double> &get_samples() const
+        {
+            return m_samples;
+        }
+
+        double get_min() const
+        {
+            return m_min;
+        }
+        double get_max() const
+        {
+            return m_max;
+        }
+        double get_total() const
+        {
+            return m_total;
+        }
+        double get_mean() const
+        {
+            return m_mean;
+        }
+
+        // Unbiased (N-1) sample variance, 0 with less than 2 samples.
+        double get_variance() const;
+        double get_std_dev() const;
+
+        // percentile is in [0,100], linearly interpolates between the closest ranks.
+        double get_percentile(double percentile) const;
+        double get_median() const
+        {
+            return get_percentile(50.0);
+        }
+
+    private:
+        vogl::vector<double> m_samples;
+
+        mutable vogl::vector<double> m_sorted_samples;
+        mutable bool m_sorted_samples_valid;
+
+        double m_min;
+        double m_max;
+        double m_total;
+        double m_mean;
+        double m_m2;
+    };
+
+    // Welch's unequal variances t-test. t is positive when the mean of b is larger than the mean of a.
+    // Returns false if either set has less than 2 samples.
+    bool sample_stats_welch_t_test(const sample_stats &a, const sample_stats &b, double &t, double &dof);
+
+    // Two-sided 95% critical value of Student's t distribution with the specified degrees of freedom.
+    double student_t_critical_value_95(double dof);
+
+    bool sample_stats_test();
+
+} // namespace vogl
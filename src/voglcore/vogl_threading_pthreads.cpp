@@ -84,6 +84,17 @@ namespace vogl
         return plat_posix_gettid();
     }
 
+    uint32_t vogl_get_max_helper_threads()
+    {
+        if (g_number_of_processors > 1)
+        {
+            // use all CPU's
+            return VOGL_MIN((int)task_pool::cMaxThreads, (int)g_number_of_processors - 1);
+        }
+
+        return 0;
+    }
+
     void vogl_sleep(unsigned int milliseconds)
     {
         #if defined(PLATFORM_WINDOWS)
@@ -27,17 +27,30 @@
 
 //#define VOGL_X11
 #include "vogleditor.h"
+#include "vogleditor_benchmark.h"
 
 int main(int argc, char *argv[])
 {
     // Initialize vogl_core.
     vogl_core_init();
 
+    // the benchmark measures the models and painting without a display
+    bool bBenchmark = (argc >= 2) && (strcmp(argv[1], "--benchmark") == 0);
+    if (bBenchmark && qgetenv("QT_QPA_PLATFORM").isEmpty())
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication a(argc, argv);
 
     vogl_common_lib_early_init();
     vogl_common_lib_global_init();
 
+    if (bBenchmark)
+    {
+        return vogleditor_run_benchmark(a.arguments().mid(2));
+    }
+
     VoglEditor w;
     w.show();
 
@@ -32,6 +32,8 @@
 #include <QCoreApplication>
 #include <QGraphicsBlurEffect>
 #include <QScrollBar>
+#include <QEventLoop>
+#include <QProgressDialog>
 
 #include "ui_vogleditor.h"
 #include "vogleditor.h"
@@ -784,15 +786,13 @@ void VoglEditor::close_trace_file()
     {
         vogleditor_output_message("Closing trace file.");
         vogleditor_output_message("-------------------");
-        m_pTraceReader->close();
-        vogl_delete(m_pTraceReader);
-        m_pTraceReader = NULL;
 
         setWindowTitle(g_PROJECT_NAME);
 
         m_openFilename.clear();
         m_backtraceToJsonMap.clear();
         m_backtraceDoc.clear();
+        m_traceReplayer.clear_keyframes();
 
         reset_tracefile_ui();
 
@@ -813,6 +813,13 @@ void VoglEditor::close_trace_file()
             delete m_pApiCallTreeModel;
             m_pApiCallTreeModel = NULL;
         }
+
+        m_sessionBlobManager.deinit();
+
+        // the api call tree reads packets on demand, so the reader has to outlive it
+        m_pTraceReader->close();
+        vogl_delete(m_pTraceReader);
+        m_pTraceReader = NULL;
     }
 }
 
@@ -863,7 +870,7 @@ void VoglEditor::on_actionEdit_triggered()
     dialog.exec();
 }
 
-QString VoglEditor::get_sessionfile_name(const QString &tracefile, const vogl_trace_file_reader &traceReader)
+QString VoglEditor::get_sessionfile_name(const QString &tracefile, const vogl_trace_file_reader &traceReader, const char *pExtension)
 {
     dynamic_string tracefilename;
     file_utils::split_path(tracefile.toStdString().c_str(), NULL, NULL, &tracefilename, NULL);
@@ -875,7 +882,7 @@ QString VoglEditor::get_sessionfile_name(const QString &tracefile, const vogl_tr
     }
 
     dynamic_string tmp;
-    QString sessionFile = tmp.format("%s-%x-%x-%x-%x.json", tracefilename.c_str(), uuid[0], uuid[1], uuid[2], uuid[3]).c_str();
+    QString sessionFile = tmp.format("%s-%x-%x-%x-%x.%s", tracefilename.c_str(), uuid[0], uuid[1], uuid[2], uuid[3], pExtension).c_str();
     return sessionFile;
 }
 
@@ -900,19 +907,35 @@ QString VoglEditor::get_sessiondata_path(const QString &tracefile, const vogl_tr
     return sessionFolder;
 }
 
-QString VoglEditor::get_sessionfile_path(const QString &tracefile, const vogl_trace_file_reader &traceReader)
+QString VoglEditor::get_sessionfile_path(const QString &tracefile, const vogl_trace_file_reader &traceReader, const char *pExtension)
 {
     QString sessionFolder = QStandardPaths::writableLocation(QStandardPaths::DataLocation);
     sessionFolder += "/sessions";
 
     dynamic_string tmp;
-    QString sessionFile = tmp.format("%s/%s", sessionFolder.toStdString().c_str(), get_sessionfile_name(tracefile, traceReader).toStdString().c_str()).c_str();
+    QString sessionFile = tmp.format("%s/%s", sessionFolder.toStdString().c_str(), get_sessionfile_name(tracefile, traceReader, pExtension).toStdString().c_str()).c_str();
     return sessionFile;
 }
 
 bool VoglEditor::load_or_create_session(const char *tracefile, vogl_trace_file_reader *pTraceReader)
 {
+    QString sessionDataPath = get_sessiondata_path(tracefile, *pTraceReader);
+    if (!m_sessionBlobManager.init(sessionDataPath.toStdString().c_str(), &pTraceReader->get_multi_blob_manager()))
+    {
+        vogleditor_output_warning("Unable to initialize the session blob manager.");
+    }
+
+    // sessions from older versions are stored as text json, they will be saved in the current format
     QString sessionFile = get_sessionfile_path(tracefile, *pTraceReader);
+    if (!QFileInfo(sessionFile).exists())
+    {
+        QString legacySessionFile = get_sessionfile_path(tracefile, *pTraceReader, VOGL_TEXT_JSON_EXTENSION);
+        if (QFileInfo(legacySessionFile).exists())
+        {
+            sessionFile = legacySessionFile;
+        }
+    }
+
     QFileInfo sessionFileInfo(sessionFile);
 
     bool bLoaded = false;
@@ -949,13 +972,21 @@ bool VoglEditor::load_or_create_session(const char *tracefile, vogl_trace_file_r
 }
 
 static const unsigned int VOGLEDITOR_SESSION_FILE_FORMAT_VERSION_1 = 1;
-static const unsigned int VOGLEDITOR_SESSION_FILE_FORMAT_VERSION = VOGLEDITOR_SESSION_FILE_FORMAT_VERSION_1;
+static const unsigned int VOGLEDITOR_SESSION_FILE_FORMAT_VERSION_2 = 2;
+static const unsigned int VOGLEDITOR_SESSION_FILE_FORMAT_VERSION = VOGLEDITOR_SESSION_FILE_FORMAT_VERSION_2;
 
 bool VoglEditor::load_session_from_disk(const QString &sessionFile)
 {
-    // open the json doc
+    // open the json doc, version 1 sessions are text json
     json_document sessionDoc;
-    if (!sessionDoc.deserialize_file(sessionFile.toStdString().c_str()))
+    if (sessionFile.endsWith("." VOGL_TEXT_JSON_EXTENSION))
+    {
+        if (!sessionDoc.deserialize_file(sessionFile.toStdString().c_str()))
+        {
+            return false;
+        }
+    }
+    else if (!sessionDoc.binary_deserialize_file(sessionFile.toStdString().c_str()))
     {
         return false;
     }
@@ -973,8 +1004,9 @@ bool VoglEditor::load_session_from_disk(const QString &sessionFile)
         return false;
     }
 
-    if (rFormatVersion.as_uint32() < VOGLEDITOR_SESSION_FILE_FORMAT_VERSION_1 ||
-        rFormatVersion.as_uint32() > VOGLEDITOR_SESSION_FILE_FORMAT_VERSION_1)
+    uint32_t formatVersion = rFormatVersion.as_uint32();
+    if (formatVersion < VOGLEDITOR_SESSION_FILE_FORMAT_VERSION_1 ||
+        formatVersion > VOGLEDITOR_SESSION_FILE_FORMAT_VERSION_2)
     {
         return false;
     }
@@ -1049,6 +1081,7 @@ bool VoglEditor::load_session_from_disk(const QString &sessionFile)
             const json_value &frameNumber = pSnapshotNode->find_value("frame_number");
             const json_value &callIndex = pSnapshotNode->find_value("call_index");
             const json_value &path = pSnapshotNode->find_value("rel_path");
+            const json_value &blobId = pSnapshotNode->find_value("blob_id");
 
             // make sure expected nodes are valid
             if (!isValid.is_valid() || !isEdited.is_valid() || !isOutdated.is_valid())
@@ -1057,8 +1090,14 @@ bool VoglEditor::load_session_from_disk(const QString &sessionFile)
             }
 
             vogl_gl_state_snapshot *pSnapshot = NULL;
+            bool bHasSnapshot = false;
 
-            if (path.is_valid() && isValid.as_bool() && uuid.is_valid())
+            if (formatVersion >= VOGLEDITOR_SESSION_FILE_FORMAT_VERSION_2)
+            {
+                // the snapshot is only read from its blob once it is displayed
+                bHasSnapshot = blobId.is_valid() && isValid.as_bool();
+            }
+            else if (path.is_valid() && isValid.as_bool() && uuid.is_valid())
             {
                 dynamic_string snapshotPath = sessionDataPath;
                 snapshotPath += "/";
@@ -1103,33 +1142,41 @@ bool VoglEditor::load_session_from_disk(const QString &sessionFile)
                     vogl_warning_printf("Unable to deserialize the snapshot with uuid %s.", uuid.as_string_ptr());
                     continue;
                 }
+
+                bHasSnapshot = true;
             }
 
-            vogleditor_gl_state_snapshot *pContainer = vogl_new(vogleditor_gl_state_snapshot, pSnapshot);
+            vogleditor_gl_state_snapshot *pContainer = NULL;
+            if (pSnapshot != NULL || !bHasSnapshot)
+            {
+                pContainer = vogl_new(vogleditor_gl_state_snapshot, pSnapshot);
+            }
+            else
+            {
+                pContainer = vogl_new(vogleditor_gl_state_snapshot, blobId.as_string(), &m_sessionBlobManager.get_reader(), m_pApiCallTreeModel->get_trace_ctypes());
+            }
             pContainer->set_edited(isEdited.as_bool());
             pContainer->set_outdated(isOutdated.as_bool());
+            if (pSnapshot == NULL && bHasSnapshot)
+            {
+                // set_edited() forgets the blob, but the stored blob already includes the edits
+                pContainer->set_blob_id(blobId.as_string());
+
+                // sessions saved before blobs were listed per snapshot have none, so their blobs are never deleted
+                dynamic_string_array sessionBlobIds;
+                pSnapshotNode->get_vector("session_blob_ids", sessionBlobIds);
+                pContainer->set_session_blob_ids(sessionBlobIds);
+                m_sessionBlobManager.add_session_blob_ids(sessionBlobIds);
+            }
 
+            vogleditor_apiCallTreeItem *pItem = NULL;
             if (callIndex.is_valid())
             {
                 // the snapshot is associated with an api call
-                vogleditor_apiCallTreeItem *pItem = m_pApiCallTreeModel->find_call_number(callIndex.as_uint64());
-                if (pItem != NULL)
-                {
-                    pItem->set_snapshot(pContainer);
-                }
-                else
+                pItem = m_pApiCallTreeModel->find_call_number(callIndex.as_uint64());
+                if (pItem == NULL)
                 {
                     vogl_warning_printf("Unable to find API call index %" PRIu64 " to load the snapshot into.", callIndex.as_uint64());
-                    if (pSnapshot != NULL)
-                    {
-                        vogl_delete(pSnapshot);
-                        pSnapshot = NULL;
-                    }
-                    if (pContainer != NULL)
-                    {
-                        vogl_delete(pContainer);
-                        pContainer = NULL;
-                    }
                 }
             }
             else if (frameNumber.is_valid())
@@ -1138,42 +1185,29 @@ bool VoglEditor::load_session_from_disk(const QString &sessionFile)
                 // frame snapshots have the additional requirement that the snapshot itself MUST exist since
                 // we only save a frame snapshot if it is the inital frame and it has been edited.
                 // If we allow NULL snapshots, then we could accidently remove the initial snapshot that was loaded with the trace file.
-                if (pSnapshot != NULL)
+                if (bHasSnapshot)
                 {
-                    vogleditor_apiCallTreeItem *pItem = m_pApiCallTreeModel->find_frame_number(frameNumber.as_uint64());
-                    if (pItem != NULL)
-                    {
-                        pItem->set_snapshot(pContainer);
-                    }
-                    else
+                    pItem = m_pApiCallTreeModel->find_frame_number(frameNumber.as_uint64());
+                    if (pItem == NULL)
                     {
                         vogl_warning_printf("Unable to find frame number %" PRIu64 " to load the snapshot into.", frameNumber.as_uint64());
-                        if (pSnapshot != NULL)
-                        {
-                            vogl_delete(pSnapshot);
-                            pSnapshot = NULL;
-                        }
-                        if (pContainer != NULL)
-                        {
-                            vogl_delete(pContainer);
-                            pContainer = NULL;
-                        }
                     }
                 }
             }
             else
             {
-                vogl_warning_printf("Session file contains invalid call or frame number for snapshot with uuid %s", uuid.as_string_ptr());
-                if (pSnapshot != NULL)
-                {
-                    vogl_delete(pSnapshot);
-                    pSnapshot = NULL;
-                }
-                if (pContainer != NULL)
-                {
-                    vogl_delete(pContainer);
-                    pContainer = NULL;
-                }
+                vogl_warning_printf("Session file contains a snapshot without a valid call or frame number");
+            }
+
+            if (pItem != NULL)
+            {
+                pItem->set_snapshot(pContainer);
+            }
+            else
+            {
+                // the container owns the snapshot
+                vogl_delete(pContainer);
+                pContainer = NULL;
             }
         } // for each snapshot
     }     // if snapshots
@@ -1219,6 +1253,25 @@ bool VoglEditor::load_session_from_disk(const QString &sessionFile)
  * Below is a summary of the information that needs to be saved out in a session's json file so that we can reload the session and be fully-featured.
  * Note that not all of this information is currently supported (either by VoglEditor or the save/load functionality).
  *
+ * Version 2 sessions are stored as binary json (.ubj). Instead of a "rel_path" to a json file, each stored snapshot has the
+ * "blob_id" of a binary json blob in the session's blob manager (see vogleditor_sessionBlobManager). Blob ids are content
+ * addressed, so blobs that the trace already contains are not copied, and a snapshot that was not edited since it was
+ * last loaded or saved keeps its blob and is not serialized again. Snapshots are only read from their blob once they are used.
+ *
+ * Edits are made to whole snapshots, so the "snapshots" array is the index of edited objects: each entry records whether
+ * its snapshot was edited, the blob holding it, and in "session_blob_ids" every blob in the session data folder that the
+ * snapshot needs (the snapshot blob and the texture, buffer, etc. blobs it references). Blobs no entry lists anymore are
+ * deleted when the session is saved.
+ *
+ *          {
+ *              "is_valid" : true,
+ *              "is_edited" : true,
+ *              "is_outdated" : false,
+ *              "call_index" : 881075,
+ *              "blob_id" : "snapshot_C2F4B2A7E8E7B29D_1875382.radblob.ubj",
+ *              "session_blob_ids" : [ "snapshot_C2F4B2A7E8E7B29D_1875382.radblob.ubj", "tex_0E5A2C41B9E0D7F3_65536.radblob.raw" ]
+ *          },
+ *
  * sample data structure for version 1:
 {
     "metadata" : {
@@ -1278,9 +1331,11 @@ bool VoglEditor::save_session_to_disk(const QString &sessionFile, const QString
     QString sessionDataFolder = sessionFolder + "/" + get_sessiondata_folder(traceFile, *pTraceReader);
     file_utils::create_directories(sessionDataFolder.toStdString().c_str(), false);
 
-    vogl_loose_file_blob_manager file_blob_manager;
-    file_blob_manager.init(cBMFReadWrite, sessionDataFolder.toStdString().c_str());
-    vogl_blob_manager *pBlob_manager = static_cast<vogl_blob_manager *>(&file_blob_manager);
+    if (!m_sessionBlobManager.is_initialized() &&
+        !m_sessionBlobManager.init(sessionDataFolder.toStdString().c_str(), &pTraceReader->get_multi_blob_manager()))
+    {
+        return false;
+    }
 
     QCursor origCursor = this->cursor();
     setCursor(Qt::WaitCursor);
@@ -1308,6 +1363,7 @@ bool VoglEditor::save_session_to_disk(const QString &sessionFile, const QString
     json_node &screenshotArray = sessionDataNode.add_array("screenshots");
 
     bool bSavedSuccessfully = true;
+    dynamic_string_array referencedBlobIds;
 
     if (pApiCallTreeModel != NULL)
     {
@@ -1316,54 +1372,47 @@ bool VoglEditor::save_session_to_disk(const QString &sessionFile, const QString
         vogleditor_apiCallTreeItem *pLastItem = NULL;
         while (pItem != pLastItem && pItem != NULL)
         {
-            dynamic_string filename;
+            vogleditor_gl_state_snapshot *pContainer = pItem->get_snapshot();
+
+            // snapshots that have not been read yet are valid as far as we know, and don't need to be read just to save them
+            bool bLoaded = pContainer->is_loaded();
+            bool bHasSnapshot = !bLoaded || pContainer->get_snapshot() != NULL;
 
             json_node &snapshotNode = snapshotArray.add_object();
-            if (pItem->get_snapshot()->get_snapshot() != NULL)
-            {
-                dynamic_string strUUID;
-                snapshotNode.add_key_value("uuid", pItem->get_snapshot()->get_snapshot()->get_uuid().get_string(strUUID));
-            }
-            snapshotNode.add_key_value("is_valid", pItem->get_snapshot()->is_valid());
-            snapshotNode.add_key_value("is_edited", pItem->get_snapshot()->is_edited());
-            snapshotNode.add_key_value("is_outdated", pItem->get_snapshot()->is_outdated());
+            snapshotNode.add_key_value("is_valid", !bLoaded || pContainer->is_valid());
+            snapshotNode.add_key_value("is_edited", pContainer->is_edited());
+            snapshotNode.add_key_value("is_outdated", pContainer->is_outdated());
 
+            // the first frame of a trim will have a snapshot.
+            // this should only be saved out if the snapshot has been edited
+            bool bStoreSnapshot = false;
             if (pItem->apiCallItem() != NULL)
             {
-                uint64_t callIndex = pItem->apiCallItem()->globalCallIndex();
-                snapshotNode.add_key_value("call_index", callIndex);
-                if (pItem->get_snapshot()->get_snapshot() != NULL)
-                {
-                    filename = filename.format("snapshot_call_%" PRIu64 ".json", callIndex);
-                    snapshotNode.add_key_value("rel_path", filename);
-                    dynamic_string filepath = sessionDataFolder.toStdString().c_str();
-                    filepath += "/";
-                    filepath += filename;
-                    if (!save_snapshot_to_disk(pItem->get_snapshot()->get_snapshot(), filepath, pBlob_manager))
-                    {
-                        bSavedSuccessfully = false;
-                        break;
-                    }
-                }
+                snapshotNode.add_key_value("call_index", pItem->apiCallItem()->globalCallIndex());
+                bStoreSnapshot = bHasSnapshot;
             }
             else if (pItem->frameItem() != NULL)
             {
-                // the first frame of a trim will have a snapshot.
-                // this should only be saved out if the snapshot has been edited
-                uint64_t frameNumber = pItem->frameItem()->frameNumber();
-                snapshotNode.add_key_value("frame_number", frameNumber);
-                if (pItem->get_snapshot()->is_edited())
+                snapshotNode.add_key_value("frame_number", pItem->frameItem()->frameNumber());
+                bStoreSnapshot = bHasSnapshot && pContainer->is_edited();
+            }
+
+            if (bStoreSnapshot)
+            {
+                if (!save_snapshot_to_session(pContainer))
                 {
-                    filename = filename.format("snapshot_frame_%" PRIu64 ".json", frameNumber);
-                    snapshotNode.add_key_value("rel_path", filename);
-                    dynamic_string filepath = sessionDataFolder.toStdString().c_str();
-                    filepath.append(filename);
-                    if (!save_snapshot_to_disk(pItem->get_snapshot()->get_snapshot(), filepath, pBlob_manager))
-                    {
-                        bSavedSuccessfully = false;
-                        break;
-                    }
+                    bSavedSuccessfully = false;
+                    break;
                 }
+                snapshotNode.add_key_value("blob_id", pContainer->get_blob_id());
+
+                const dynamic_string_array &sessionBlobIds = pContainer->get_session_blob_ids();
+                json_node &sessionBlobIdsArray = snapshotNode.add_array("session_blob_ids");
+                for (uint32_t i = 0; i < sessionBlobIds.size(); i++)
+                {
+                    sessionBlobIdsArray.add_value(sessionBlobIds[i]);
+                }
+                referencedBlobIds.append(sessionBlobIds);
             }
 
             pLastItem = pItem;
@@ -1388,7 +1437,13 @@ bool VoglEditor::save_session_to_disk(const QString &sessionFile, const QString
 
     if (bSavedSuccessfully)
     {
-        bSavedSuccessfully = sessionDoc.serialize_to_file(sessionFile.toStdString().c_str());
+        bSavedSuccessfully = sessionDoc.binary_serialize_to_file(sessionFile.toStdString().c_str());
+    }
+
+    // only once the new session file is written, so the previous one stays loadable if saving fails
+    if (bSavedSuccessfully)
+    {
+        m_sessionBlobManager.delete_unreferenced_blobs(referencedBlobIds);
     }
 
     setCursor(origCursor);
@@ -1396,8 +1451,15 @@ bool VoglEditor::save_session_to_disk(const QString &sessionFile, const QString
     return bSavedSuccessfully;
 }
 
-bool VoglEditor::save_snapshot_to_disk(vogl_gl_state_snapshot *pSnapshot, dynamic_string filename, vogl_blob_manager *pBlob_manager)
+bool VoglEditor::save_snapshot_to_session(vogleditor_gl_state_snapshot *pContainer)
 {
+    // unchanged snapshots are already stored in the session or the trace
+    if (!pContainer->get_blob_id().is_empty() && m_sessionBlobManager.get_reader().does_exist(pContainer->get_blob_id()))
+    {
+        return true;
+    }
+
+    vogl_gl_state_snapshot *pSnapshot = pContainer->get_snapshot();
     if (pSnapshot == NULL)
     {
         return false;
@@ -1407,21 +1469,39 @@ bool VoglEditor::save_snapshot_to_disk(vogl_gl_state_snapshot *pSnapshot, dynami
 
     vogl_ctypes trace_gl_ctypes(m_pTraceReader->get_sof_packet().m_pointer_sizes);
 
-    if (!pSnapshot->serialize(*doc.get_root(), *pBlob_manager, &trace_gl_ctypes))
+    // record the blobs the snapshot writes into the session, so they are kept as long as the snapshot is
+    dynamic_string_array sessionBlobIds;
+    m_sessionBlobManager.set_added_blob_ids(&sessionBlobIds);
+
+    bool bSerialized = pSnapshot->serialize(*doc.get_root(), m_sessionBlobManager, &trace_gl_ctypes);
+
+    dynamic_string blobId;
+    if (bSerialized)
     {
-        vogl_error_printf("Failed serializing state snapshot document!\n");
-        return false;
+        uint8_vec binary_snapshot_data;
+        doc.binary_serialize(binary_snapshot_data);
+
+        blobId = m_sessionBlobManager.add_buf_compute_unique_id(binary_snapshot_data.get_ptr(), binary_snapshot_data.size(), "snapshot", VOGL_BINARY_JSON_EXTENSION);
     }
-    else if (!doc.serialize_to_file(filename.get_ptr(), true))
+
+    m_sessionBlobManager.set_added_blob_ids(NULL);
+
+    if (!bSerialized)
     {
-        vogl_error_printf("Failed writing state snapshot to file \"%s\"!\n", filename.get_ptr());
+        vogl_error_printf("Failed serializing state snapshot document!\n");
         return false;
     }
-    else
+
+    if (blobId.is_empty())
     {
-        vogl_printf("Successfully wrote JSON snapshot to file \"%s\"\n", filename.get_ptr());
+        vogl_error_printf("Failed adding state snapshot to the session blob manager!\n");
+        return false;
     }
 
+    vogl_printf("Successfully wrote binary JSON snapshot to session blob \"%s\"\n", blobId.get_ptr());
+
+    pContainer->set_blob_id(blobId);
+    pContainer->set_session_blob_ids(sessionBlobIds);
     return true;
 }
 
@@ -1642,9 +1722,16 @@ bool VoglEditor::open_trace_file(dynamic_string filename)
         return false;
     }
 
-    if (!m_pApiCallTreeModel->init(m_pTraceReader))
+    // The calls are parsed on a worker thread with a second reader of the trace, so the first
+    // frames can already be browsed while the rest of the trace is loading.
+    dynamic_string load_filename(filename);
+    dynamic_string actual_load_filename;
+    vogl_trace_file_reader *pLoadReader = vogl_open_trace_file(load_filename, actual_load_filename, NULL);
+
+    if (pLoadReader == NULL || !m_pApiCallTreeModel->begin_init(m_pTraceReader))
     {
         vogleditor_output_error("The API calls within the trace could not be parsed properly.");
+        vogl_delete(pLoadReader);
         close_trace_file();
         this->setCursor(origCursor);
         return false;
@@ -1657,10 +1744,22 @@ bool VoglEditor::open_trace_file(dynamic_string filename)
         connect(ui->treeView->selectionModel(), SIGNAL(currentChanged(const QModelIndex &, const QModelIndex &)), this, SLOT(slot_treeView_currentChanged(const QModelIndex &, const QModelIndex &)));
     }
 
-    if (m_pApiCallTreeModel->hasChildren())
+    // timeline
+    m_pTimelineModel = new vogleditor_apiCallTimelineModel(m_pApiCallTreeModel->root());
+    m_timeline->setModel(m_pTimelineModel);
+
+    connect(m_pApiCallTreeModel, SIGNAL(framesAvailable()), m_pApiCallTreeModel, SLOT(publish_loaded_frames()), Qt::QueuedConnection);
+    connect(m_pApiCallTreeModel, SIGNAL(framesPublished()), this, SLOT(slot_apiCallTree_framesPublished()));
+
+    bool bParsed = load_trace_in_background(pLoadReader);
+    vogl_delete(pLoadReader);
+
+    if (!bParsed)
     {
-        ui->treeView->setExpanded(m_pApiCallTreeModel->index(0, 0), true);
-        ui->treeView->setCurrentIndex(m_pApiCallTreeModel->index(0, 0));
+        vogleditor_output_error("The API calls within the trace could not be parsed properly.");
+        close_trace_file();
+        this->setCursor(origCursor);
+        return false;
     }
 
     int flagsColumnWidth = 30;
@@ -1685,6 +1784,10 @@ bool VoglEditor::open_trace_file(dynamic_string filename)
     ui->prevDrawcallButton->setEnabled(true);
     ui->nextDrawcallButton->setEnabled(true);
 
+    // snapshots taken while replaying let later snapshots start part way into the trace
+    QString keyframePath = get_sessiondata_path(filename.c_str(), *m_pTraceReader) + "keyframes";
+    m_traceReplayer.enable_keyframes(g_settings.replay_keyframe_interval(), g_settings.replay_keyframes_in_memory(), keyframePath.toStdString().c_str());
+
     m_backtraceToJsonMap.clear();
     m_backtraceDoc.clear();
 
@@ -1748,8 +1851,7 @@ bool VoglEditor::open_trace_file(dynamic_string filename)
     m_pCollectScreenshotsButton->setEnabled(true);
 
     // timeline
-    m_pTimelineModel = new vogleditor_apiCallTimelineModel(m_pApiCallTreeModel->root());
-    m_timeline->setModel(m_pTimelineModel);
+    m_pTimelineModel->refresh();
     m_timeline->repaint();
 
     m_openFilename = filename.c_str();
@@ -1760,6 +1862,65 @@ bool VoglEditor::open_trace_file(dynamic_string filename)
     return true;
 }
 
+bool VoglEditor::load_trace_in_background(vogl_trace_file_reader *pLoadReader)
+{
+    QProgressDialog progress(tr("Loading trace..."), tr("Cancel"), 0, 100, this);
+    progress.setWindowModality(Qt::NonModal);
+    progress.setMinimumDuration(1000);
+    connect(m_pApiCallTreeModel, SIGNAL(loadProgress(int)), &progress, SLOT(setValue(int)));
+    connect(&progress, SIGNAL(canceled()), m_pApiCallTreeModel, SLOT(cancel_load()));
+    connect(qApp, SIGNAL(lastWindowClosed()), m_pApiCallTreeModel, SLOT(cancel_load()));
+
+    vogleditor_apiCallTreeLoader loader(m_pApiCallTreeModel, pLoadReader);
+
+    QEventLoop loop;
+    connect(&loader, SIGNAL(finished()), &loop, SLOT(quit()));
+
+    // the trace can't be closed or replaced while it is being parsed
+    ui->menuBar->setEnabled(false);
+
+    loader.start();
+    loop.exec();
+    loader.wait();
+
+    ui->menuBar->setEnabled(true);
+
+    // publish whatever was handed over after the last queued notification
+    m_pApiCallTreeModel->publish_loaded_frames();
+
+    if (m_pApiCallTreeModel->load_was_cancelled())
+    {
+        vogleditor_output_warning("Loading was cancelled, only the frames that were loaded so far are available.");
+    }
+
+    return loader.succeeded();
+}
+
+void VoglEditor::slot_apiCallTree_framesPublished()
+{
+    if (m_pApiCallTreeModel == NULL)
+    {
+        return;
+    }
+
+    // select the first frame as soon as it is available
+    if (!ui->treeView->currentIndex().isValid() && m_pApiCallTreeModel->hasChildren())
+    {
+        ui->treeView->setExpanded(m_pApiCallTreeModel->index(0, 0), true);
+        ui->treeView->setCurrentIndex(m_pApiCallTreeModel->index(0, 0));
+    }
+
+    // Rebuilding the timeline takes time linear in the number of loaded calls, so while loading it is only
+    // rebuilt once the number of frames has doubled. It still grows with the load, but the total time spent on
+    // it stays linear. open_trace_file() builds the final timeline once loading is done.
+    int numFrames = m_pApiCallTreeModel->root()->childCount();
+    if (m_pTimelineModel != NULL && numFrames > 0 && numFrames >= 2 * m_pTimelineModel->get_num_frames())
+    {
+        m_pTimelineModel->refresh();
+        m_timeline->repaint();
+    }
+}
+
 bool VoglEditor::resetApiCallTreeModel()
 {
     dynamic_string filename(m_openFilename.toLocal8Bit().data());
@@ -2135,16 +2296,23 @@ void VoglEditor::update_ui_for_context(vogl_context_snapshot *pContext, vogledit
 
     vogleditor_gl_state_snapshot *pBaseSnapshot = findMostRecentSnapshot(m_pApiCallTreeModel->root(), m_currentSnapshot);
 
-    // state viewer
-    if (m_pStateTreeModel != NULL)
+    // state viewer, while it is shown the model is updated in place so that the expanded items stay expanded
+    if (m_pStateTreeModel != NULL && ui->stateTreeView->model() == m_pStateTreeModel)
     {
-        delete m_pStateTreeModel;
+        m_pStateTreeModel->set_snapshot(pStateSnapshot, pContext, pBaseSnapshot);
     }
-    m_pStateTreeModel = new vogleditor_QStateTreeModel(pStateSnapshot, pContext, pBaseSnapshot, NULL);
+    else
+    {
+        if (m_pStateTreeModel != NULL)
+        {
+            delete m_pStateTreeModel;
+        }
+        m_pStateTreeModel = new vogleditor_QStateTreeModel(pStateSnapshot, pContext, pBaseSnapshot, NULL);
 
-    ui->stateTreeView->setModel(m_pStateTreeModel);
-    ui->stateTreeView->expandToDepth(0);
-    ui->stateTreeView->setColumnWidth(0, ui->stateTreeView->width() * 0.5);
+        ui->stateTreeView->setModel(m_pStateTreeModel);
+        ui->stateTreeView->expandToDepth(0);
+        ui->stateTreeView->setColumnWidth(0, ui->stateTreeView->width() * 0.5);
+    }
 
     VOGLEDITOR_ENABLE_STATE_TAB(ui->stateTab);
 
@@ -2291,7 +2459,12 @@ void VoglEditor::update_vertex_array_explorer_for_apicall(vogleditor_apiCallTree
     }
 
     gl_entrypoint_id_t callId = (gl_entrypoint_id_t)pApiCall->apiCallItem()->getGLPacket()->m_entrypoint_id;
-    vogl_trace_packet &trace_packet = *(pApiCall->apiCallItem()->getTracePacket());    
+    vogl_trace_packet *pTrace_packet = pApiCall->apiCallItem()->getTracePacket();
+    if (pTrace_packet == NULL)
+    {
+        return;
+    }
+    vogl_trace_packet &trace_packet = *pTrace_packet;
 
     //This is used to tell the visulizer how to render
     GLenum drawMode = trace_packet.get_param_value<GLsizei>(0);
@@ -2836,6 +3009,14 @@ void VoglEditor::slot_program_edited(vogl_arb_program_state *pNewProgramState)
 
     m_currentSnapshot->set_edited(true);
 
+    // the edited state changes the replay after this snapshot
+    m_traceReplayer.clear_keyframes();
+
+    if (m_pStateTreeModel != NULL)
+    {
+        m_pStateTreeModel->update_changed_items();
+    }
+
     // update all the snapshot flags
     bool bFoundEditedSnapshot = false;
     recursive_update_snapshot_flags(m_pApiCallTreeModel->root(), bFoundEditedSnapshot);
@@ -2853,6 +3034,14 @@ void VoglEditor::slot_program_edited(vogl_program_state *pNewProgramState)
 
     m_currentSnapshot->set_edited(true);
 
+    // the edited state changes the replay after this snapshot
+    m_traceReplayer.clear_keyframes();
+
+    if (m_pStateTreeModel != NULL)
+    {
+        m_pStateTreeModel->update_changed_items();
+    }
+
     // update all the snapshot flags
     bool bFoundEditedSnapshot = false;
     recursive_update_snapshot_flags(m_pApiCallTreeModel->root(), bFoundEditedSnapshot);
@@ -30,6 +30,7 @@
 #include <QString>
 
 #include "vogleditor_qtextureexplorer.h"
+#include "vogleditor_sessionblobmanager.h"
 #include "vogleditor_tracereplayer.h"
 
 namespace Ui
@@ -81,8 +82,8 @@ public:
     bool pre_open_trace_file(dynamic_string filename);
     void close_trace_file();
 
-    QString get_sessionfile_name(const QString &tracefile, const vogl_trace_file_reader &traceReader);
-    QString get_sessionfile_path(const QString &tracefile, const vogl_trace_file_reader &traceReader);
+    QString get_sessionfile_name(const QString &tracefile, const vogl_trace_file_reader &traceReader, const char *pExtension = VOGL_BINARY_JSON_EXTENSION);
+    QString get_sessionfile_path(const QString &tracefile, const vogl_trace_file_reader &traceReader, const char *pExtension = VOGL_BINARY_JSON_EXTENSION);
     QString get_sessiondata_folder(const QString &tracefile, const vogl_trace_file_reader &traceReader);
     QString get_sessiondata_path(const QString &tracefile, const vogl_trace_file_reader &traceReader);
 
@@ -135,12 +136,17 @@ slots:
 
     void selectAPICallItem(vogleditor_snapshotItem *pItem);
 
+    void slot_apiCallTree_framesPublished();
+
 private:
     Ui::VoglEditor *ui;
 
     // Opens a trace file without looking for associated session data
     bool open_trace_file(vogl::dynamic_string filename);
 
+    // Parses the api calls into m_pApiCallTreeModel on a worker thread while keeping the UI responsive
+    bool load_trace_in_background(vogl_trace_file_reader *pLoadReader);
+
     void onApiCallSelected(const QModelIndex &index, bool bAllowStateSnapshot);
     void setTimeline(vogleditor_apiCallTreeItem *pCallTreeItem);
     bool displayTexture(GLuint64 textureHandle, bool bBringTabToFront);
@@ -180,7 +186,7 @@ private:
     bool load_or_create_session(const char *tracefile, vogl_trace_file_reader *pTraceReader);
     bool load_session_from_disk(const QString &sessionFile);
     bool save_session_to_disk(const QString &sessionFile, const QString &traceFile, vogl_trace_file_reader *pTraceReader, vogleditor_QApiCallTreeModel *pApiCallTreeModel);
-    bool save_snapshot_to_disk(vogl_gl_state_snapshot *pSnapshot, dynamic_string filename, vogl_blob_manager *pBlob_manager);
+    bool save_snapshot_to_session(vogleditor_gl_state_snapshot *pContainer);
 
     QString m_openFilename;
     vogleditor_QFramebufferExplorer *m_pFramebufferExplorer;
@@ -215,6 +221,9 @@ private:
 
     vogleditor_traceReplayer m_traceReplayer;
     vogl_trace_file_reader *m_pTraceReader;
+
+    // snapshots of the session are read lazily through this, so it has to outlive m_pApiCallTreeModel
+    vogleditor_sessionBlobManager m_sessionBlobManager;
     vogl::json_document m_backtraceDoc;
     vogl::hash_map<uint32_t, vogl::json_node *> m_backtraceToJsonMap;
 
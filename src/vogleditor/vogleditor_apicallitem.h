@@ -27,6 +27,7 @@
 #define VOGLEDITOR_APICALLITEM_H
 
 #include "vogleditor_snapshotitem.h"
+#include "vogleditor_tracepacketcache.h"
 
 // predeclared classes
 class vogleditor_frameItem;
@@ -40,6 +41,26 @@ public:
         : m_pParentFrame(pFrame),
           m_glPacket(glPacket),
           m_pTracePacket(pTracePacket),
+          m_pPacketCache(NULL),
+          m_fileOffset(0),
+          m_globalCallIndex(glPacket.m_call_counter),
+          m_begin_rdtsc(glPacket.m_packet_begin_rdtsc),
+          m_end_rdtsc(glPacket.m_packet_end_rdtsc),
+          m_backtrace_hash_index(glPacket.m_backtrace_hash_index)
+    {
+        if (m_end_rdtsc < m_begin_rdtsc)
+        {
+            m_end_rdtsc = m_begin_rdtsc + 1;
+        }
+    }
+
+    // The decoded packet isn't kept with the call, it's fetched from pPacketCache (and re-read from the trace if needed)
+    vogleditor_apiCallItem(vogleditor_frameItem *pFrame, vogleditor_tracePacketCache *pPacketCache, uint64_t fileOffset, const vogl_trace_gl_entrypoint_packet &glPacket)
+        : m_pParentFrame(pFrame),
+          m_glPacket(glPacket),
+          m_pTracePacket(NULL),
+          m_pPacketCache(pPacketCache),
+          m_fileOffset(fileOffset),
           m_globalCallIndex(glPacket.m_call_counter),
           m_begin_rdtsc(glPacket.m_packet_begin_rdtsc),
           m_end_rdtsc(glPacket.m_packet_end_rdtsc),
@@ -95,9 +116,16 @@ public:
         return &m_glPacket;
     }
 
+    // Note: packets fetched from the packet cache are only guaranteed to stay valid until the cache has handed out
+    // another vogleditor_tracePacketCache::cDefaultMaxPackets packets. Returns NULL if the packet couldn't be read.
     vogl_trace_packet *getTracePacket()
     {
-        return m_pTracePacket;
+        if (m_pTracePacket != NULL)
+        {
+            return m_pTracePacket;
+        }
+
+        return m_pPacketCache->get(m_fileOffset);
     }
 
     inline uint64_t backtraceHashIndex() const
@@ -108,43 +136,59 @@ public:
     // Returns the api function call and its args as a string
     QString apiFunctionCall()
     {
-        const gl_entrypoint_desc_t &entrypoint_desc = g_vogl_entrypoint_descs[m_pTracePacket->get_entrypoint_id()];
+        vogl_trace_packet *pTracePacket = getTracePacket();
+        if (pTracePacket == NULL)
+        {
+            return QString(g_vogl_entrypoint_descs[m_glPacket.m_entrypoint_id].m_pName) + "( <unreadable> )";
+        }
+
+        return formatApiFunctionCall(pTracePacket);
+    }
+
+    // Returns the string argument of an apicall in apiFunctionCall() output format
+    //
+    // TODO: (as needed) Add logic to return which string (argument count) from
+    //                   a multi-string argument list (or all as a QStringList)
+    QString stringArg()
+    {
+        return extractStringArg(apiFunctionCall());
+    }
+
+    // Formats the api function call and its args of a decoded packet
+    static QString formatApiFunctionCall(vogl_trace_packet *pTracePacket)
+    {
+        const gl_entrypoint_desc_t &entrypoint_desc = g_vogl_entrypoint_descs[pTracePacket->get_entrypoint_id()];
 
         QString funcCall = entrypoint_desc.m_pName;
 
         // format parameters
         funcCall.append("( ");
         dynamic_string paramStr;
-        for (uint param_index = 0; param_index < m_pTracePacket->total_params(); param_index++)
+        for (uint param_index = 0; param_index < pTracePacket->total_params(); param_index++)
         {
             if (param_index != 0)
                 funcCall.append(", ");
 
             paramStr.clear();
-            m_pTracePacket->pretty_print_param(paramStr, param_index, false);
+            pTracePacket->pretty_print_param(paramStr, param_index, false);
 
             funcCall.append(paramStr.c_str());
         }
         funcCall.append(" )");
 
-        if (m_pTracePacket->has_return_value())
+        if (pTracePacket->has_return_value())
         {
             funcCall.append(" = ");
             paramStr.clear();
-            m_pTracePacket->pretty_print_return_value(paramStr, false);
+            pTracePacket->pretty_print_return_value(paramStr, false);
             funcCall.append(paramStr.c_str());
         }
         return funcCall;
     }
 
-    // Returns the string argument of an apicall in apiFunctionCall() output format
-    //
-    // TODO: (as needed) Add logic to return which string (argument count) from
-    //                   a multi-string argument list (or all as a QStringList)
-    QString stringArg()
+    // Extracts the (quoted) string argument from apiFunctionCall() output
+    static QString extractStringArg(const QString &apiCall)
     {
-        QString apiCall = apiFunctionCall();
-
         QString sec, name;
         int start = 1;
         while (!(sec = apiCall.section('\'', start, start)).isEmpty())
@@ -160,6 +204,8 @@ private:
     vogleditor_groupItem *m_pParentGroup;
     const vogl_trace_gl_entrypoint_packet m_glPacket;
     vogl_trace_packet *m_pTracePacket;
+    vogleditor_tracePacketCache *m_pPacketCache;
+    uint64_t m_fileOffset;
 
     uint64_t m_globalCallIndex;
     uint64_t m_begin_rdtsc;
@@ -0,0 +1,433 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+#include <algorithm>
+
+#include "vogleditor_apicallsearchindex.h"
+
+static bool is_token_char(QChar c)
+{
+    return c.isLetterOrNumber() || (c == '_') || (c == '.') || (c == '-');
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogleditor_apiCallSearchQuery
+//----------------------------------------------------------------------------------------------------------------------
+vogleditor_apiCallSearchQuery::vogleditor_apiCallSearchQuery()
+    : m_type(cText),
+      m_bUseRegExp(false)
+{
+}
+
+vogleditor_apiCallSearchQuery::vogleditor_apiCallSearchQuery(const QString &searchText)
+    : m_searchText(searchText),
+      m_type(cText),
+      m_text(searchText),
+      m_bUseRegExp(false)
+{
+    if (searchText.startsWith("func:"))
+    {
+        m_type = cFunction;
+        m_text = searchText.mid(5);
+    }
+    else if (searchText.startsWith("arg:"))
+    {
+        m_type = cArg;
+        m_text = searchText.mid(4).trimmed().toLower();
+    }
+    else if (searchText.size() >= 2 && searchText.startsWith('/') && searchText.endsWith('/'))
+    {
+        m_type = cRegExp;
+        m_text = searchText.mid(1, searchText.size() - 2);
+    }
+
+    if (m_type == cRegExp || (m_type == cFunction && m_text.size() >= 2 && m_text.startsWith('/') && m_text.endsWith('/')))
+    {
+        if (m_type == cFunction)
+        {
+            m_text = m_text.mid(1, m_text.size() - 2);
+        }
+
+        m_bUseRegExp = true;
+        m_regExp.setPattern(m_text);
+        m_regExp.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    }
+}
+
+bool vogleditor_apiCallSearchQuery::is_valid() const
+{
+    return !m_bUseRegExp || m_regExp.isValid();
+}
+
+bool vogleditor_apiCallSearchQuery::matches(const QString &apiCallColumn, gl_entrypoint_id_t entrypointId) const
+{
+    if (is_empty() || !is_valid())
+    {
+        return false;
+    }
+
+    switch (m_type)
+    {
+        case cText:
+            return apiCallColumn.contains(m_text, Qt::CaseInsensitive);
+        case cRegExp:
+            return m_regExp.match(apiCallColumn).hasMatch();
+        case cFunction:
+        {
+            if (entrypointId == VOGL_ENTRYPOINT_INVALID)
+            {
+                return false;
+            }
+
+            QString name(g_vogl_entrypoint_descs[entrypointId].m_pName);
+            return m_bUseRegExp ? m_regExp.match(name).hasMatch() : name.contains(m_text, Qt::CaseInsensitive);
+        }
+        case cArg:
+        {
+            if (entrypointId == VOGL_ENTRYPOINT_INVALID)
+            {
+                return false;
+            }
+
+            QVector<QString> argTokens;
+            QVector<QString> tokens;
+            vogleditor_apiCallSearchIndex::tokenize(m_text, argTokens);
+            vogleditor_apiCallSearchIndex::tokenize(apiCallColumn, tokens);
+            for (int i = 0; i < argTokens.size(); i++)
+            {
+                if (!tokens.contains(argTokens[i]))
+                {
+                    return false;
+                }
+            }
+            return !argTokens.isEmpty();
+        }
+    }
+
+    return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// vogleditor_apiCallSearchIndex
+//----------------------------------------------------------------------------------------------------------------------
+vogleditor_apiCallSearchIndex::vogleditor_apiCallSearchIndex()
+    : m_size(0),
+      m_candidatesSize(-1),
+      m_bAllCandidates(false)
+{
+}
+
+void vogleditor_apiCallSearchIndex::clear()
+{
+    m_size = 0;
+    m_tokens.clear();
+    m_entrypoints.clear();
+    m_callNumbers.clear();
+    m_labels.clear();
+    m_drawcalls.clear();
+    m_snapshots.clear();
+
+    m_candidatesQuery.clear();
+    m_candidatesSize = -1;
+    m_bAllCandidates = false;
+    m_candidates.clear();
+}
+
+void vogleditor_apiCallSearchIndex::tokenize(const QString &text, QVector<QString> &tokens)
+{
+    tokens.clear();
+
+    int start = -1;
+    for (int i = 0; i <= text.size(); i++)
+    {
+        if (i < text.size() && is_token_char(text[i]))
+        {
+            if (start < 0)
+                start = i;
+        }
+        else if (start >= 0)
+        {
+            QString token = text.mid(start, i - start).toLower();
+            if (!tokens.contains(token))
+                tokens.append(token);
+            start = -1;
+        }
+    }
+}
+
+void vogleditor_apiCallSearchIndex::add_item(const QString &apiCallColumn, gl_entrypoint_id_t entrypointId, uint64_t callNumber, bool bHasSnapshot)
+{
+    int position = m_size++;
+
+    QVector<QString> tokens;
+    tokenize(apiCallColumn, tokens);
+    for (int i = 0; i < tokens.size(); i++)
+    {
+        m_tokens[tokens[i]].append(position);
+    }
+
+    if (entrypointId != VOGL_ENTRYPOINT_INVALID)
+    {
+        m_entrypoints[entrypointId].append(position);
+        m_callNumbers.insert(callNumber, position);
+
+        if (vogl_is_frame_buffer_write_entrypoint(entrypointId))
+        {
+            m_drawcalls.append(position);
+        }
+    }
+    else
+    {
+        m_labels.append(position);
+    }
+
+    if (bHasSnapshot)
+    {
+        m_snapshots.append(position);
+    }
+}
+
+void vogleditor_apiCallSearchIndex::append_positions(position_vec &positions, const position_vec &other, int offset)
+{
+    positions.reserve(positions.size() + other.size());
+    for (int i = 0; i < other.size(); i++)
+    {
+        positions.append(other[i] + offset);
+    }
+}
+
+void vogleditor_apiCallSearchIndex::append(const vogleditor_apiCallSearchIndex &other)
+{
+    int offset = m_size;
+
+    for (QHash<QString, position_vec>::const_iterator it = other.m_tokens.constBegin(); it != other.m_tokens.constEnd(); ++it)
+    {
+        append_positions(m_tokens[it.key()], it.value(), offset);
+    }
+
+    for (QHash<int, position_vec>::const_iterator it = other.m_entrypoints.constBegin(); it != other.m_entrypoints.constEnd(); ++it)
+    {
+        append_positions(m_entrypoints[it.key()], it.value(), offset);
+    }
+
+    for (QHash<uint64_t, int>::const_iterator it = other.m_callNumbers.constBegin(); it != other.m_callNumbers.constEnd(); ++it)
+    {
+        m_callNumbers.insert(it.key(), it.value() + offset);
+    }
+
+    append_positions(m_labels, other.m_labels, offset);
+    append_positions(m_drawcalls, other.m_drawcalls, offset);
+    append_positions(m_snapshots, other.m_snapshots, offset);
+
+    m_size += other.m_size;
+}
+
+void vogleditor_apiCallSearchIndex::set_has_snapshot(int position, bool bHasSnapshot)
+{
+    position_vec::iterator it = std::lower_bound(m_snapshots.begin(), m_snapshots.end(), position);
+    bool bFound = (it != m_snapshots.end()) && (*it == position);
+
+    if (bHasSnapshot && !bFound)
+    {
+        m_snapshots.insert(it, position);
+    }
+    else if (!bHasSnapshot && bFound)
+    {
+        m_snapshots.erase(it);
+    }
+}
+
+int vogleditor_apiCallSearchIndex::next_position(const position_vec &positions, int position)
+{
+    position_vec::const_iterator it = std::upper_bound(positions.constBegin(), positions.constEnd(), position);
+    return (it != positions.constEnd()) ? *it : -1;
+}
+
+int vogleditor_apiCallSearchIndex::prev_position(const position_vec &positions, int position)
+{
+    position_vec::const_iterator it = std::lower_bound(positions.constBegin(), positions.constEnd(), position);
+    return (it != positions.constBegin()) ? *(it - 1) : -1;
+}
+
+int vogleditor_apiCallSearchIndex::find_call_number(uint64_t callNumber) const
+{
+    return m_callNumbers.value(callNumber, -1);
+}
+
+int vogleditor_apiCallSearchIndex::find_next_snapshot(int position) const
+{
+    return next_position(m_snapshots, position);
+}
+
+int vogleditor_apiCallSearchIndex::find_prev_snapshot(int position) const
+{
+    return prev_position(m_snapshots, position);
+}
+
+int vogleditor_apiCallSearchIndex::find_next_drawcall(int position) const
+{
+    return next_position(m_drawcalls, position);
+}
+
+int vogleditor_apiCallSearchIndex::find_prev_drawcall(int position) const
+{
+    return prev_position(m_drawcalls, position);
+}
+
+bool vogleditor_apiCallSearchIndex::is_exact(const vogleditor_apiCallSearchQuery &query) const
+{
+    return (query.m_type == vogleditor_apiCallSearchQuery::cFunction) || (query.m_type == vogleditor_apiCallSearchQuery::cArg);
+}
+
+void vogleditor_apiCallSearchIndex::mark_positions(const position_vec &positions, QVector<char> &mask, char value)
+{
+    for (int i = 0; i < positions.size(); i++)
+    {
+        mask[positions[i]] = value;
+    }
+}
+
+const vogleditor_apiCallSearchIndex::position_vec *vogleditor_apiCallSearchIndex::get_candidates(const vogleditor_apiCallSearchQuery &query)
+{
+    if ((m_candidatesSize == m_size) && (m_candidatesQuery == query.m_searchText))
+    {
+        return m_bAllCandidates ? NULL : &m_candidates;
+    }
+
+    m_candidatesQuery = query.m_searchText;
+    m_candidatesSize = m_size;
+    m_bAllCandidates = false;
+    m_candidates.clear();
+
+    if (query.is_empty() || !query.is_valid())
+    {
+        return &m_candidates;
+    }
+
+    // Each word of the query has to be found in (text queries) or be equal to (arg queries) some word of a match,
+    // so the candidates are the intersection of the positions of those words.
+    QVector<QString> queryTokens;
+    if (query.m_type == vogleditor_apiCallSearchQuery::cText || query.m_type == vogleditor_apiCallSearchQuery::cArg)
+    {
+        tokenize(query.m_text, queryTokens);
+    }
+
+    QVector<char> candidates;
+
+    if (query.m_type == vogleditor_apiCallSearchQuery::cFunction)
+    {
+        candidates.fill(0, m_size);
+        for (QHash<int, position_vec>::const_iterator it = m_entrypoints.constBegin(); it != m_entrypoints.constEnd(); ++it)
+        {
+            if (query.matches(QString(), static_cast<gl_entrypoint_id_t>(it.key())))
+            {
+                mark_positions(it.value(), candidates);
+            }
+        }
+    }
+    else if (queryTokens.isEmpty())
+    {
+        // regular expressions and text without any words have to be checked against every item
+        m_bAllCandidates = (query.m_type != vogleditor_apiCallSearchQuery::cArg);
+        return m_bAllCandidates ? NULL : &m_candidates;
+    }
+    else
+    {
+        QVector<char> tokenCandidates;
+        for (int i = 0; i < queryTokens.size(); i++)
+        {
+            tokenCandidates.fill(0, m_size);
+
+            if (query.m_type == vogleditor_apiCallSearchQuery::cArg)
+            {
+                QHash<QString, position_vec>::const_iterator it = m_tokens.constFind(queryTokens[i]);
+                if (it != m_tokens.constEnd())
+                {
+                    mark_positions(it.value(), tokenCandidates);
+                }
+            }
+            else
+            {
+                for (QHash<QString, position_vec>::const_iterator it = m_tokens.constBegin(); it != m_tokens.constEnd(); ++it)
+                {
+                    if (it.key().contains(queryTokens[i]))
+                    {
+                        mark_positions(it.value(), tokenCandidates);
+                    }
+                }
+            }
+
+            if (i == 0)
+            {
+                candidates.swap(tokenCandidates);
+            }
+            else
+            {
+                for (int j = 0; j < m_size; j++)
+                {
+                    candidates[j] &= tokenCandidates[j];
+                }
+            }
+        }
+
+        // the labels of frames and groups aren't parameters
+        if (query.m_type == vogleditor_apiCallSearchQuery::cArg)
+        {
+            mark_positions(m_labels, candidates, 0);
+        }
+    }
+
+    for (int i = 0; i < candidates.size(); i++)
+    {
+        if (candidates[i])
+        {
+            m_candidates.append(i);
+        }
+    }
+
+    return &m_candidates;
+}
+
+int vogleditor_apiCallSearchIndex::find_next_candidate(const vogleditor_apiCallSearchQuery &query, int position)
+{
+    const position_vec *pCandidates = get_candidates(query);
+    if (pCandidates == NULL)
+    {
+        return (position + 1 < m_size) ? VOGL_MAX(position + 1, 0) : -1;
+    }
+
+    return next_position(*pCandidates, position);
+}
+
+int vogleditor_apiCallSearchIndex::find_prev_candidate(const vogleditor_apiCallSearchQuery &query, int position)
+{
+    const position_vec *pCandidates = get_candidates(query);
+    if (pCandidates == NULL)
+    {
+        return (position > 0) ? VOGL_MIN(position - 1, m_size - 1) : -1;
+    }
+
+    return prev_position(*pCandidates, position);
+}
@@ -0,0 +1,150 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+#ifndef VOGLEDITOR_APICALLSEARCHINDEX_H
+#define VOGLEDITOR_APICALLSEARCHINDEX_H
+
+#include <QHash>
+#include <QRegularExpression>
+#include <QString>
+#include <QVector>
+
+#include "vogl_common.h"
+
+// Search box query, one of:
+//   text        items whose api call column contains text, ignoring case (the default)
+//   /regexp/    items whose api call column matches the regular expression
+//   func:text   calls to entrypoints whose name contains text; func:/regexp/ matches the name instead
+//   arg:value   calls with a parameter (enum, handle, pointer, number...) that is exactly value
+class vogleditor_apiCallSearchQuery
+{
+public:
+    enum query_type
+    {
+        cText,
+        cRegExp,
+        cFunction,
+        cArg
+    };
+
+    vogleditor_apiCallSearchQuery();
+    vogleditor_apiCallSearchQuery(const QString &searchText);
+
+    bool is_empty() const
+    {
+        return m_text.isEmpty();
+    }
+
+    bool is_valid() const;
+
+    query_type type() const
+    {
+        return m_type;
+    }
+
+    // Checks an item's api call column; entrypointId is VOGL_ENTRYPOINT_INVALID for frames and groups.
+    bool matches(const QString &apiCallColumn, gl_entrypoint_id_t entrypointId) const;
+
+private:
+    friend class vogleditor_apiCallSearchIndex;
+
+    QString m_searchText;
+    query_type m_type;
+    QString m_text;
+    bool m_bUseRegExp;
+    QRegularExpression m_regExp;
+};
+
+// Inverted index over the items of the api call tree, in the order they were created while parsing
+// (the position of an item). Besides the words of each item's api call column it keeps the positions
+// of every entrypoint, of the draw calls and of the items with snapshots, and maps call numbers to
+// positions, so that the search and navigation buttons don't need to visit every item of the trace.
+//
+// While a trace is loading, the parsing thread indexes each batch of frames into its own index which
+// is then append()ed to the one used by the GUI.
+class vogleditor_apiCallSearchIndex
+{
+public:
+    vogleditor_apiCallSearchIndex();
+
+    void clear();
+
+    // number of items indexed
+    int size() const
+    {
+        return m_size;
+    }
+
+    // Indexes the next item; callNumber and entrypointId are only used for api calls.
+    void add_item(const QString &apiCallColumn, gl_entrypoint_id_t entrypointId, uint64_t callNumber, bool bHasSnapshot);
+
+    // Adds the items of another index after the items of this one.
+    void append(const vogleditor_apiCallSearchIndex &other);
+
+    void set_has_snapshot(int position, bool bHasSnapshot);
+
+    // All return -1 if there is no such item.
+    int find_call_number(uint64_t callNumber) const;
+    int find_next_snapshot(int position) const;
+    int find_prev_snapshot(int position) const;
+    int find_next_drawcall(int position) const;
+    int find_prev_drawcall(int position) const;
+
+    // Returns the first item after (or the last item before) position that may match the query.
+    // Candidates still have to be checked with vogleditor_apiCallSearchQuery::matches() unless
+    // is_exact() returned true for the query.
+    int find_next_candidate(const vogleditor_apiCallSearchQuery &query, int position);
+    int find_prev_candidate(const vogleditor_apiCallSearchQuery &query, int position);
+    bool is_exact(const vogleditor_apiCallSearchQuery &query) const;
+
+    // Splits text into the lower case words that are indexed
+    static void tokenize(const QString &text, QVector<QString> &tokens);
+
+private:
+    typedef QVector<int> position_vec;
+
+    static int next_position(const position_vec &positions, int position);
+    static int prev_position(const position_vec &positions, int position);
+    static void append_positions(position_vec &positions, const position_vec &other, int offset);
+
+    // candidates of the last query, they are recomputed when the query or the index changes
+    const position_vec *get_candidates(const vogleditor_apiCallSearchQuery &query);
+    static void mark_positions(const position_vec &positions, QVector<char> &mask, char value = 1);
+
+    int m_size;
+    QHash<QString, position_vec> m_tokens;
+    QHash<int, position_vec> m_entrypoints;
+    QHash<uint64_t, int> m_callNumbers;
+    position_vec m_labels; // frames and groups
+    position_vec m_drawcalls;
+    position_vec m_snapshots;
+
+    QString m_candidatesQuery;
+    int m_candidatesSize;
+    bool m_bAllCandidates;
+    position_vec m_candidates;
+};
+
+#endif // VOGLEDITOR_APICALLSEARCHINDEX_H
@@ -35,7 +35,8 @@
 
 vogleditor_apiCallTimelineModel::vogleditor_apiCallTimelineModel(vogleditor_apiCallTreeItem *pRootApiCall)
     : m_pRootApiCall(pRootApiCall),
-      m_rawBaseTime(0)
+      m_rawBaseTime(0),
+      m_numFrames(0)
 {
     refresh();
 }
@@ -113,7 +114,11 @@ void vogleditor_apiCallTimelineModel::refresh()
 
             AddApiCallsToTimeline(pFrameChild, m_rootItem);
         }
+
+        update_summary();
     }
+
+    m_numFrames = numChildren;
 }
 
 float vogleditor_apiCallTimelineModel::u64ToFloat(uint64_t value)
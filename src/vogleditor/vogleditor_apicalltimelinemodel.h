@@ -38,6 +38,12 @@ public:
     void refresh();
     double absoluteToRelativeTime(uint64_t time);
 
+    // Number of frames the timeline was last built from.
+    int get_num_frames() const
+    {
+        return m_numFrames;
+    }
+
 private:
     unsigned int randomRGB();
     void AddApiCallsToTimeline(vogleditor_apiCallTreeItem *pRoot, vogleditor_timelineItem *pDestRoot);
@@ -45,6 +51,7 @@ private:
 
     vogleditor_apiCallTreeItem *m_pRootApiCall;
     uint64_t m_rawBaseTime;
+    int m_numFrames;
 };
 
 #endif // VOGLEDITOR_APICALLTIMELINEMODEL_H
@@ -45,7 +45,8 @@ vogleditor_apiCallTreeItem::vogleditor_apiCallTreeItem(vogleditor_QApiCallTreeMo
       m_pGroupItem(NULL),
       m_pFrameItem(NULL),
       m_pModel(pModel),
-      m_localRowIndex(0)
+      m_localRowIndex(0),
+      m_listIndex(-1)
 {
     m_columnData[VOGL_ACTC_APICALL] = "API Call";
     m_columnData[VOGL_ACTC_INDEX] = "Index";
@@ -63,7 +64,8 @@ vogleditor_apiCallTreeItem::vogleditor_apiCallTreeItem(vogleditor_frameItem *fra
       m_pGroupItem(NULL),
       m_pFrameItem(frameItem),
       m_pModel(NULL),
-      m_localRowIndex(0)
+      m_localRowIndex(0),
+      m_listIndex(-1)
 {
     if (frameItem != NULL)
     {
@@ -87,7 +89,8 @@ vogleditor_apiCallTreeItem::vogleditor_apiCallTreeItem(vogleditor_groupItem *gro
       m_pGroupItem(groupItem),
       m_pFrameItem(NULL),
       m_pModel(NULL),
-      m_localRowIndex(0)
+      m_localRowIndex(0),
+      m_listIndex(-1)
 {
     m_columnData[VOGL_ACTC_APICALL] = cTREEITEM_STATECHANGES;
     if (m_parentItem != NULL)
@@ -105,20 +108,11 @@ vogleditor_apiCallTreeItem::vogleditor_apiCallTreeItem(vogleditor_apiCallItem *a
       m_pGroupItem(NULL),
       m_pFrameItem(NULL),
       m_pModel(NULL),
-      m_localRowIndex(0)
+      m_localRowIndex(0),
+      m_listIndex(-1)
 {
-    m_columnData[VOGL_ACTC_APICALL] = apiCallItem->apiFunctionCall();
-
-    if (apiCallItem != NULL)
-    {
-        m_columnData[VOGL_ACTC_INDEX] = (qulonglong)apiCallItem->globalCallIndex();
-        m_columnData[VOGL_ACTC_FLAGS] = "";
-        dynamic_string strContext;
-        m_columnData[VOGL_ACTC_GLCONTEXT] = strContext.format("0x%" PRIx64, apiCallItem->getGLPacket()->m_context_handle).c_str();
-        //m_columnData[VOGL_ACTC_BEGINTIME] = (qulonglong)apiCallItem->startTime();
-        //m_columnData[VOGL_ACTC_ENDTIME] = (qulonglong)apiCallItem->endTime();
-        m_columnData[VOGL_ACTC_DURATION] = (qulonglong)apiCallItem->duration();
-    }
+    // The column strings of api calls aren't stored with the item; they are created
+    // on demand in columnData() so that only the visible rows need formatting.
 
     if (m_parentItem != NULL)
     {
@@ -208,6 +202,19 @@ void vogleditor_apiCallTreeItem::popChild()
     m_childItems.removeLast();
 }
 
+void vogleditor_apiCallTreeItem::adoptChild(vogleditor_apiCallTreeItem *pChild)
+{
+    pChild->m_parentItem = this;
+    appendChild(pChild);
+}
+
+QList<vogleditor_apiCallTreeItem *> vogleditor_apiCallTreeItem::takeChildren()
+{
+    QList<vogleditor_apiCallTreeItem *> children;
+    children.swap(m_childItems);
+    return children;
+}
+
 int vogleditor_apiCallTreeItem::childCount() const
 {
     return m_childItems.size();
@@ -300,6 +307,11 @@ void vogleditor_apiCallTreeItem::set_snapshot(vogleditor_gl_state_snapshot *pSna
     {
         m_pApiCallItem->set_snapshot(pSnapshot);
     }
+
+    if (m_pModel != NULL)
+    {
+        m_pModel->snapshot_changed(this);
+    }
 }
 
 bool vogleditor_apiCallTreeItem::has_snapshot() const
@@ -386,6 +398,29 @@ QVariant vogleditor_apiCallTreeItem::columnData(int column, int role) const
 
     if (role == Qt::DisplayRole)
     {
+        // explicitly set column data (e.g. marker group labels) takes precedence
+        if (!m_columnData[column].isValid() && (m_pApiCallItem != NULL))
+        {
+            switch (column)
+            {
+                case VOGL_ACTC_APICALL:
+                    return m_pModel->apiCallString(m_pApiCallItem);
+                case VOGL_ACTC_INDEX:
+                    return (qulonglong)m_pApiCallItem->globalCallIndex();
+                case VOGL_ACTC_FLAGS:
+                    return "";
+                case VOGL_ACTC_GLCONTEXT:
+                {
+                    dynamic_string strContext;
+                    return strContext.format("0x%" PRIx64, m_pApiCallItem->getGLPacket()->m_context_handle).c_str();
+                }
+                case VOGL_ACTC_DURATION:
+                    return (qulonglong)m_pApiCallItem->duration();
+                default:
+                    break;
+            }
+        }
+
         return m_columnData[column];
     }
 
@@ -461,5 +496,5 @@ int vogleditor_apiCallTreeItem::row() const
 
 gl_entrypoint_id_t vogleditor_apiCallTreeItem::entrypoint_id() const
 {
-   return m_pApiCallItem ? m_pApiCallItem->getTracePacket()->get_entrypoint_id() : VOGL_ENTRYPOINT_INVALID;
+   return m_pApiCallItem ? (gl_entrypoint_id_t)m_pApiCallItem->getGLPacket()->m_entrypoint_id : VOGL_ENTRYPOINT_INVALID;
 }
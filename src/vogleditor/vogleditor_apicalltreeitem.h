@@ -81,6 +81,12 @@ public:
     void appendChild(vogleditor_apiCallTreeItem *pChild);
     void popChild();
 
+    // Moves a child that was built under another (staging) parent to this item
+    void adoptChild(vogleditor_apiCallTreeItem *pChild);
+
+    // Removes all children without deleting them; the caller takes ownership
+    QList<vogleditor_apiCallTreeItem *> takeChildren();
+
     int childCount() const;
 
     vogleditor_apiCallTreeItem *child(int index) const;
@@ -124,6 +130,16 @@ public:
 
     gl_entrypoint_id_t entrypoint_id() const;
 
+    // Position of the item in the model's list of all items (and in its search index), -1 until it has been added.
+    int listIndex() const
+    {
+        return m_listIndex;
+    }
+    void setListIndex(int index)
+    {
+        m_listIndex = index;
+    }
+
 private:
     void setColumnData(QVariant data, int column);
 
@@ -136,6 +152,7 @@ private:
     vogleditor_frameItem *m_pFrameItem;
     vogleditor_QApiCallTreeModel *m_pModel;
     int m_localRowIndex;
+    int m_listIndex;
 };
 
 #endif // VOGLEDITOR_APICALLTREEITEM_H
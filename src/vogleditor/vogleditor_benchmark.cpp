@@ -0,0 +1,453 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+
+#include "vogleditor_benchmark.h"
+
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <QScrollBar>
+
+#include "vogl_common.h"
+#include "vogl_timer.h"
+#include "vogl_trace_file_reader.h"
+#include "vogl_trace_file_writer.h"
+
+#include "vogleditor_apicalltimelinemodel.h"
+#include "vogleditor_apicalltreeitem.h"
+#include "vogleditor_gl_state_snapshot.h"
+#include "vogleditor_qapicalltreemodel.h"
+#include "vogleditor_qstatetreemodel.h"
+#include "vogleditor_qtimelineview.h"
+
+struct vogleditor_benchmarkSettings
+{
+    vogleditor_benchmarkSettings()
+        : m_frames(1000),
+          m_callsPerFrame(200),
+          m_searchLoops(10),
+          m_paintLoops(20),
+          m_timelineWidth(1280),
+          m_timelineHeight(120),
+          m_bKeepTrace(false)
+    {
+    }
+
+    QString m_traceFile; // empty to write a synthetic trace
+    QString m_outputFile; // empty to print to stdout
+    QStringList m_searches;
+    uint32_t m_frames;
+    uint32_t m_callsPerFrame;
+    uint32_t m_searchLoops;
+    uint32_t m_paintLoops;
+    int m_timelineWidth;
+    int m_timelineHeight;
+    bool m_bKeepTrace;
+};
+
+static bool parse_benchmark_args(const QStringList &args, vogleditor_benchmarkSettings &settings)
+{
+    for (int i = 0; i < args.size(); i++)
+    {
+        QString name = args[i];
+        while (name.startsWith('-'))
+        {
+            name = name.mid(1);
+        }
+
+        if (name == "keep_trace")
+        {
+            settings.m_bKeepTrace = true;
+            continue;
+        }
+
+        if (i + 1 >= args.size())
+        {
+            vogl_error_printf("Missing value for benchmark option \"%s\"\n", args[i].toStdString().c_str());
+            return false;
+        }
+        QString value = args[++i];
+
+        bool bOk = true;
+        if (name == "trace")
+            settings.m_traceFile = value;
+        else if (name == "output")
+            settings.m_outputFile = value;
+        else if (name == "search")
+            settings.m_searches.append(value);
+        else if (name == "frames")
+            settings.m_frames = value.toUInt(&bOk);
+        else if (name == "calls_per_frame")
+            settings.m_callsPerFrame = value.toUInt(&bOk);
+        else if (name == "search_loops")
+            settings.m_searchLoops = value.toUInt(&bOk);
+        else if (name == "paint_loops")
+            settings.m_paintLoops = value.toUInt(&bOk);
+        else if (name == "timeline_width")
+            settings.m_timelineWidth = value.toInt(&bOk);
+        else if (name == "timeline_height")
+            settings.m_timelineHeight = value.toInt(&bOk);
+        else
+        {
+            vogl_error_printf("Unknown benchmark option \"%s\"\n", args[i - 1].toStdString().c_str());
+            return false;
+        }
+
+        if (!bOk)
+        {
+            vogl_error_printf("Invalid value \"%s\" for benchmark option \"%s\"\n", value.toStdString().c_str(), args[i - 1].toStdString().c_str());
+            return false;
+        }
+    }
+
+    // a swap is needed to end each frame
+    settings.m_callsPerFrame = VOGL_MAX(settings.m_callsPerFrame, 2U);
+    settings.m_searchLoops = VOGL_MAX(settings.m_searchLoops, 1U);
+    settings.m_paintLoops = VOGL_MAX(settings.m_paintLoops, 1U);
+
+    if (settings.m_searches.isEmpty())
+    {
+        settings.m_searches << "glDrawArrays"
+                            << "func:BindTexture"
+                            << "arg:GL_TRIANGLES"
+                            << "/glBindTexture.*, 1[0-9]\\)/"
+                            << "glNoSuchFunction";
+    }
+
+    return true;
+}
+
+// Returns the peak resident set size of the process in KB, or 0 where it isn't available.
+static uint64_t get_peak_rss_kb()
+{
+    uint64_t peakKB = 0;
+#if defined(PLATFORM_LINUX)
+    FILE *pFile = vogl_fopen("/proc/self/status", "r");
+    if (pFile != NULL)
+    {
+        char line[256];
+        while (fgets(line, sizeof(line), pFile) != NULL)
+        {
+            unsigned long long value = 0;
+            if (sscanf(line, "VmHWM: %llu kB", &value) == 1)
+            {
+                peakKB = value;
+                break;
+            }
+        }
+        vogl_fclose(pFile);
+    }
+#endif
+    return peakKB;
+}
+
+// Writes a call to the trace; parameters past numValues (and the return value) are 0.
+static bool write_synthetic_call(vogl_trace_file_writer &writer, vogl_trace_packet &packet, gl_entrypoint_id_t id, const uint64_t *pValues, uint32_t numValues, uint64_t &rdtsc, uint64_t duration)
+{
+    packet.begin_construction(id, 1, writer.get_next_gl_call_counter(), 1, rdtsc);
+    packet.set_gl_begin_rdtsc(rdtsc + 1);
+    packet.set_gl_end_rdtsc(rdtsc + 1 + duration);
+
+    const vogl_ctypes &ctypes = *packet.get_ctypes();
+    for (uint32_t i = 0; i < g_vogl_entrypoint_descs[id].m_num_params; i++)
+    {
+        vogl_ctype_t ctype = g_vogl_entrypoint_param_descs[id][i].m_ctype;
+        uint64_t value = (i < numValues) ? pValues[i] : 0;
+        packet.set_param(static_cast<uint8_t>(i), ctype, &value, ctypes[ctype].m_size);
+    }
+
+    vogl_ctype_t returnCtype = g_vogl_entrypoint_descs[id].m_return_ctype;
+    if (returnCtype != VOGL_VOID)
+    {
+        uint64_t value = 0;
+        packet.set_return_param(returnCtype, &value, ctypes[returnCtype].m_size);
+    }
+
+    rdtsc += duration + 2;
+    packet.end_construction(rdtsc);
+
+    return writer.write_packet(packet);
+}
+
+// Each frame clears, then binds a texture and a program and draws until the frame is full, and swaps.
+// Durations vary from call to call so the timeline has something to show.
+static bool write_synthetic_trace(const QString &filename, uint32_t frames, uint32_t callsPerFrame)
+{
+    vogl_ctypes trace_gl_ctypes(sizeof(void *));
+    vogl_trace_file_writer writer(&trace_gl_ctypes);
+    if (!writer.open(filename.toStdString().c_str()))
+    {
+        return false;
+    }
+
+    vogl_trace_packet packet(&trace_gl_ctypes);
+    uint64_t rdtsc = 1000;
+    uint32_t callIndex = 0;
+    bool bSuccess = true;
+
+    for (uint32_t frame = 0; frame < frames && bSuccess; frame++)
+    {
+        uint64_t clearParams[] = { GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT };
+        bSuccess = write_synthetic_call(writer, packet, VOGL_ENTRYPOINT_glClear, clearParams, VOGL_ARRAY_SIZE(clearParams), rdtsc, 2000);
+
+        for (uint32_t call = 1; call < callsPerFrame - 1 && bSuccess; call++, callIndex++)
+        {
+            uint64_t duration = 100 + ((callIndex * 2654435761U) >> 20) % 400;
+            switch (call % 3)
+            {
+                case 1:
+                {
+                    uint64_t params[] = { GL_TEXTURE_2D, 1 + callIndex % 64 };
+                    bSuccess = write_synthetic_call(writer, packet, VOGL_ENTRYPOINT_glBindTexture, params, VOGL_ARRAY_SIZE(params), rdtsc, duration);
+                    break;
+                }
+                case 2:
+                {
+                    uint64_t params[] = { 1 + callIndex % 16 };
+                    bSuccess = write_synthetic_call(writer, packet, VOGL_ENTRYPOINT_glUseProgram, params, VOGL_ARRAY_SIZE(params), rdtsc, duration);
+                    break;
+                }
+                default:
+                {
+                    uint64_t params[] = { GL_TRIANGLES, 0, 3 * (1 + callIndex % 1000) };
+                    bSuccess = write_synthetic_call(writer, packet, VOGL_ENTRYPOINT_glDrawArrays, params, VOGL_ARRAY_SIZE(params), rdtsc, duration * 10);
+                    break;
+                }
+            }
+        }
+
+        if (bSuccess)
+        {
+            uint64_t swapParams[] = { 1, 1 };
+            bSuccess = write_synthetic_call(writer, packet, VOGL_ENTRYPOINT_glXSwapBuffers, swapParams, VOGL_ARRAY_SIZE(swapParams), rdtsc, 5000);
+        }
+    }
+
+    if (!writer.close())
+    {
+        bSuccess = false;
+    }
+
+    return bSuccess;
+}
+
+static void add_peak_rss(json_node &node, const char *pStage)
+{
+    node.add_key_value(pStage, get_peak_rss_kb());
+}
+
+int vogleditor_run_benchmark(const QStringList &args)
+{
+    vogleditor_benchmarkSettings settings;
+    if (!parse_benchmark_args(args, settings))
+    {
+        vogl_printf("Usage: vogleditor --benchmark [-trace file] [-frames n] [-calls_per_frame n] [-search query]... [-search_loops n]\n"
+                    "                              [-paint_loops n] [-timeline_width n] [-timeline_height n] [-output file.json] [-keep_trace]\n");
+        return EXIT_FAILURE;
+    }
+
+    json_document doc;
+    json_node &results = *doc.get_root();
+    json_node &peakRss = results.add_object("peak_rss_kb");
+    add_peak_rss(peakRss, "start");
+
+    vogl::timer tm;
+
+    // get a trace
+    QString traceFile = settings.m_traceFile;
+    bool bSyntheticTrace = traceFile.isEmpty();
+    if (bSyntheticTrace)
+    {
+        traceFile = QDir::tempPath() + "/vogleditor_benchmark.bin";
+
+        tm.start();
+        if (!write_synthetic_trace(traceFile, settings.m_frames, settings.m_callsPerFrame))
+        {
+            vogl_error_printf("Failed writing synthetic trace \"%s\"\n", traceFile.toStdString().c_str());
+            return EXIT_FAILURE;
+        }
+        tm.stop();
+
+        json_node &synthetic = results.add_object("synthetic_trace");
+        synthetic.add_key_value("frames", settings.m_frames);
+        synthetic.add_key_value("calls_per_frame", settings.m_callsPerFrame);
+        synthetic.add_key_value("write_ms", tm.get_elapsed_ms());
+    }
+    results.add_key_value("trace", traceFile.toStdString().c_str());
+
+    tm.start();
+    dynamic_string filename(traceFile.toStdString().c_str());
+    dynamic_string actualFilename;
+    vogl_trace_file_reader *pTraceReader = vogl_open_trace_file(filename, actualFilename, NULL);
+    if (pTraceReader == NULL)
+    {
+        vogl_error_printf("Failed opening trace \"%s\"\n", traceFile.toStdString().c_str());
+        return EXIT_FAILURE;
+    }
+    tm.stop();
+    results.add_key_value("trace_open_ms", tm.get_elapsed_ms());
+    add_peak_rss(peakRss, "trace_open");
+
+    // api call tree
+    vogleditor_QApiCallTreeModel *pApiCallTreeModel = new vogleditor_QApiCallTreeModel();
+
+    tm.start();
+    bool bLoaded = pApiCallTreeModel->init(pTraceReader);
+    tm.stop();
+
+    json_node &apiCallTree = results.add_object("api_call_tree");
+    apiCallTree.add_key_value("loaded", bLoaded);
+    apiCallTree.add_key_value("build_ms", tm.get_elapsed_ms());
+    apiCallTree.add_key_value("frames", pApiCallTreeModel->rowCount());
+    add_peak_rss(peakRss, "api_call_tree");
+
+    // searches: the first match and all of the matches, like stepping through them with "next"
+    json_node &searches = results.add_array("search");
+    for (int i = 0; i < settings.m_searches.size(); i++)
+    {
+        const QString &query = settings.m_searches[i];
+        double firstMatchMS = 0.0;
+        double allMatchesMS = 0.0;
+        uint32_t matches = 0;
+
+        for (uint32_t loop = 0; loop < settings.m_searchLoops; loop++)
+        {
+            matches = 0;
+
+            tm.start();
+            QModelIndex index = pApiCallTreeModel->find_next_search_result(NULL, query);
+            firstMatchMS += tm.get_elapsed_ms();
+            while (index.isValid())
+            {
+                matches++;
+                index = pApiCallTreeModel->find_next_search_result(static_cast<vogleditor_apiCallTreeItem *>(index.internalPointer()), query);
+            }
+            allMatchesMS += tm.get_elapsed_ms();
+        }
+
+        json_node &search = searches.add_object();
+        search.add_key_value("query", query.toStdString().c_str());
+        search.add_key_value("matches", matches);
+        search.add_key_value("first_match_ms", firstMatchMS / settings.m_searchLoops);
+        search.add_key_value("all_matches_ms", allMatchesMS / settings.m_searchLoops);
+    }
+    add_peak_rss(peakRss, "search");
+
+    // timeline: cold paints have to draw every tile, warm paints are served from the tile cache
+    json_node &timeline = results.add_object("timeline");
+    {
+        tm.start();
+        vogleditor_apiCallTimelineModel timelineModel(pApiCallTreeModel->root());
+        tm.stop();
+        timeline.add_key_value("build_ms", tm.get_elapsed_ms());
+
+        QScrollBar scrollBar(Qt::Horizontal);
+        vogleditor_QTimelineView timelineView;
+        timelineView.setScrollBar(&scrollBar);
+        timelineView.resize(settings.m_timelineWidth, settings.m_timelineHeight);
+        timelineView.setModel(&timelineModel);
+
+        QImage image(timelineView.size(), QImage::Format_ARGB32_Premultiplied);
+
+        double coldPaintMS = 0.0;
+        double warmPaintMS = 0.0;
+        for (uint32_t loop = 0; loop < settings.m_paintLoops; loop++)
+        {
+            timelineView.deleteTiles();
+
+            tm.start();
+            timelineView.render(&image);
+            coldPaintMS += tm.get_elapsed_ms();
+
+            tm.start();
+            timelineView.render(&image);
+            warmPaintMS += tm.get_elapsed_ms();
+        }
+
+        timeline.add_key_value("width", settings.m_timelineWidth);
+        timeline.add_key_value("height", settings.m_timelineHeight);
+        timeline.add_key_value("cold_paint_ms", coldPaintMS / settings.m_paintLoops);
+        timeline.add_key_value("warm_paint_ms", warmPaintMS / settings.m_paintLoops);
+
+        timelineView.setModel(NULL);
+    }
+    add_peak_rss(peakRss, "timeline");
+
+    // state tree of the first snapshot, synthetic traces don't have one
+    vogleditor_apiCallTreeItem *pSnapshotItem = pApiCallTreeModel->find_next_snapshot(NULL);
+    if (pSnapshotItem != NULL)
+    {
+        json_node &stateTree = results.add_object("state_tree");
+
+        vogleditor_gl_state_snapshot *pSnapshot = pSnapshotItem->get_snapshot();
+
+        tm.start();
+        bool bValid = pSnapshot->is_valid();
+        tm.stop();
+        stateTree.add_key_value("snapshot_load_ms", tm.get_elapsed_ms());
+
+        if (bValid && pSnapshot->get_contexts().size() > 0)
+        {
+            vogl_context_snapshot *pContext = pSnapshot->get_context(pSnapshot->get_cur_trace_context());
+            if (pContext == NULL)
+            {
+                pContext = pSnapshot->get_contexts()[0];
+            }
+
+            tm.start();
+            vogleditor_QStateTreeModel *pStateTreeModel = new vogleditor_QStateTreeModel(pSnapshot, pContext, NULL, NULL);
+            tm.stop();
+            stateTree.add_key_value("build_ms", tm.get_elapsed_ms());
+
+            delete pStateTreeModel;
+        }
+        add_peak_rss(peakRss, "state_tree");
+    }
+
+    // the api call tree reads packets on demand, so the reader has to outlive it
+    delete pApiCallTreeModel;
+    pTraceReader->close();
+    vogl_delete(pTraceReader);
+
+    if (bSyntheticTrace && !settings.m_bKeepTrace)
+    {
+        QFile::remove(traceFile);
+    }
+
+    if (settings.m_outputFile.isEmpty())
+    {
+        dynamic_string str;
+        doc.serialize(str);
+        printf("%s\n", str.get_ptr());
+    }
+    else if (!doc.serialize_to_file(settings.m_outputFile.toStdString().c_str()))
+    {
+        vogl_error_printf("Failed writing benchmark results to \"%s\"\n", settings.m_outputFile.toStdString().c_str());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+
+#ifndef VOGLEDITOR_BENCHMARK_H
+#define VOGLEDITOR_BENCHMARK_H
+
+#include <QStringList>
+
+// Headless benchmark of the editor's models, run as "vogleditor --benchmark [options]" (main() selects the
+// offscreen Qt platform unless QT_QPA_PLATFORM is set). Unless -trace is given it writes a synthetic trace of
+// the requested size, then times opening it, building the api call tree and timeline models, searching the
+// api calls, painting the timeline and building the state tree of the first snapshot (if the trace has one),
+// and reports the results and the peak RSS as JSON. Returns the process exit code.
+int vogleditor_run_benchmark(const QStringList &args);
+
+#endif // VOGLEDITOR_BENCHMARK_H
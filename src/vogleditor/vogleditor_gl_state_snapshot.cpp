@@ -1,9 +1,24 @@
 #include "vogleditor_gl_state_snapshot.h"
+#include "vogl_blob_manager.h"
+#include "vogl_texture_state.h"
 
 vogleditor_gl_state_snapshot::vogleditor_gl_state_snapshot(vogl_gl_state_snapshot *pSnapshot)
     : m_pSnapshot(pSnapshot),
       m_bEdited(false),
-      m_bOutdated(false)
+      m_bOutdated(false),
+      m_pBlobManager(NULL),
+      m_pCtypes(NULL)
+{
+}
+
+vogleditor_gl_state_snapshot::vogleditor_gl_state_snapshot(const dynamic_string &blobId, const vogl_blob_manager *pBlobManager, const vogl_ctypes *pCtypes)
+    : m_pSnapshot(NULL),
+      m_bEdited(false),
+      m_bOutdated(false),
+      m_deferredBlobId(blobId),
+      m_blobId(blobId),
+      m_pBlobManager(pBlobManager),
+      m_pCtypes(pCtypes)
 {
 }
 
@@ -24,6 +39,11 @@ void vogleditor_gl_state_snapshot::set_outdated(bool bOutdated)
     m_bOutdated = bOutdated;
     if (m_bOutdated)
     {
+        m_deferredBlobId.clear();
+        m_blobId.clear();
+        m_sessionBlobIds.clear();
+        m_objectHashes.clear();
+
         // for now, we will delete the snapshot to save memory, in the future we will
         // want to keep it around so that we can diff between them.
         if (m_pSnapshot != NULL)
@@ -37,3 +57,93 @@ void vogleditor_gl_state_snapshot::set_outdated(bool bOutdated)
         VOGL_ASSERT(!"We should not be setting a snapshot as no-longer outdated.");
     }
 }
+
+void vogleditor_gl_state_snapshot::load_deferred_snapshot() const
+{
+    dynamic_string id(m_deferredBlobId);
+
+    // only try once, a snapshot that fails to load will be treated like any other invalid snapshot
+    m_deferredBlobId.clear();
+
+    uint8_vec snapshot_data;
+    {
+        timed_scope ts("get_multi_blob_manager().get");
+        if (!m_pBlobManager->get(id, snapshot_data) || (snapshot_data.is_empty()))
+        {
+            vogl_warning_printf("Failed reading snapshot blob data \"%s\"!\n", id.get_ptr());
+            return;
+        }
+    }
+
+    json_document doc;
+    {
+        timed_scope ts("doc.binary_deserialize");
+        if (!doc.binary_deserialize(snapshot_data) || (!doc.get_root()))
+        {
+            vogl_warning_printf("Failed deserializing JSON snapshot blob data \"%s\"!\n", id.get_ptr());
+            return;
+        }
+    }
+
+    vogl_gl_state_snapshot *pGLSnapshot = vogl_new(vogl_gl_state_snapshot);
+
+    timed_scope ts("pPendingSnapshot->deserialize");
+    if (!pGLSnapshot->deserialize(*doc.get_root(), *m_pBlobManager, m_pCtypes))
+    {
+        vogl_delete(pGLSnapshot);
+
+        vogl_warning_printf("Failed deserializing snapshot blob data \"%s\"!\n", id.get_ptr());
+        return;
+    }
+
+    m_pSnapshot = pGLSnapshot;
+}
+
+uint64_t vogleditor_gl_state_snapshot::get_object_hash(const vogl_gl_object_state *pObject) const
+{
+    const uint64_t *pHash = m_objectHashes.find_value(pObject);
+    if (pHash != NULL)
+    {
+        return *pHash;
+    }
+
+    // blobs are only hashed, not stored
+    vogl_null_blob_manager blobManager;
+    blobManager.init(cBMFWritable);
+
+    json_document doc;
+    json_node &node = *doc.get_root();
+    if (pObject->get_type() == cGLSTTexture)
+    {
+        // serializing a texture writes out all of its images, so only the parameters are hashed
+        const vogl_texture_state *pTexture = static_cast<const vogl_texture_state *>(pObject);
+        node.add_key_value("target", pTexture->get_target());
+        node.add_key_value("samples", pTexture->get_num_samples());
+        node.add_key_value("width", pTexture->get_texture().get_width());
+        node.add_key_value("height", pTexture->get_texture().get_height());
+        node.add_key_value("depth", pTexture->get_texture().get_depth());
+        node.add_key_value("format", pTexture->get_texture().get_ogl_internal_fmt());
+        pTexture->get_params().serialize(node.add_object("params"), blobManager);
+
+        json_node &levels = node.add_array("level_params");
+        uint num_faces = (pTexture->get_target() == GL_TEXTURE_CUBE_MAP) ? 6 : 1;
+        for (uint face = 0; face < num_faces; face++)
+        {
+            for (uint level = 0; level < pTexture->get_num_levels(); level++)
+            {
+                pTexture->get_level_params(face, level).serialize(levels.add_object(), blobManager);
+            }
+        }
+    }
+    else
+    {
+        pObject->serialize(node, blobManager);
+    }
+
+    uint8_vec data;
+    doc.binary_serialize(data);
+
+    uint64_t hash = calc_crc64(CRC64_INIT, data.get_ptr(), data.size());
+    m_objectHashes.insert(pObject, hash);
+    return hash;
+}
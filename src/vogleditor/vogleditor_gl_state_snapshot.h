@@ -7,16 +7,27 @@ class vogleditor_gl_state_snapshot
 {
 public:
     vogleditor_gl_state_snapshot(vogl_gl_state_snapshot *pSnapshot);
+
+    // Snapshot that is stored in the trace or session; its blob is only read and deserialized the first time it is used.
+    vogleditor_gl_state_snapshot(const dynamic_string &blobId, const vogl_blob_manager *pBlobManager, const vogl_ctypes *pCtypes);
+
     virtual ~vogleditor_gl_state_snapshot();
 
     bool is_valid() const
     {
-        return m_pSnapshot != NULL && m_pSnapshot->is_valid();
+        return snapshot() != NULL && snapshot()->is_valid();
     }
 
+    // editing changes the snapshot, so it no longer matches the blob it was loaded from or saved to
     void set_edited(bool bEdited)
     {
         m_bEdited = bEdited;
+        if (bEdited)
+        {
+            m_blobId.clear();
+            m_sessionBlobIds.clear();
+            m_objectHashes.clear();
+        }
     }
     bool is_edited() const
     {
@@ -29,37 +40,88 @@ public:
         return m_bOutdated;
     }
 
+    // false while a deferred snapshot has not been read yet
+    bool is_loaded() const
+    {
+        return m_deferredBlobId.is_empty();
+    }
+
+    // id of a blob that holds the unmodified snapshot as binary json, empty if there is none
+    const dynamic_string &get_blob_id() const
+    {
+        return m_blobId;
+    }
+    void set_blob_id(const dynamic_string &blobId)
+    {
+        m_blobId = blobId;
+    }
+
+    // blobs in the session data folder that the blob above needs, including itself
+    const dynamic_string_array &get_session_blob_ids() const
+    {
+        return m_sessionBlobIds;
+    }
+    void set_session_blob_ids(const dynamic_string_array &blobIds)
+    {
+        m_sessionBlobIds = blobIds;
+    }
+
     inline vogl_gl_state_snapshot *get_snapshot()
     {
-        return m_pSnapshot;
+        return snapshot();
     }
 
     // direct accessors to the snapshot object
     vogl_trace_ptr_value get_cur_trace_context() const
     {
-        return m_pSnapshot->get_cur_trace_context();
+        return snapshot()->get_cur_trace_context();
     }
     vogl_context_snapshot_ptr_vec &get_contexts()
     {
-        return m_pSnapshot->get_contexts();
+        return snapshot()->get_contexts();
     }
     const vogl_context_snapshot_ptr_vec &get_contexts() const
     {
-        return m_pSnapshot->get_contexts();
+        return snapshot()->get_contexts();
     }
     vogl_context_snapshot *get_context(vogl_trace_ptr_value contextHandle) const
     {
-        return m_pSnapshot->get_context(contextHandle);
+        return snapshot()->get_context(contextHandle);
     }
     vogl_default_framebuffer_state &get_default_framebuffer()
     {
-        return m_pSnapshot->get_default_framebuffer();
+        return snapshot()->get_default_framebuffer();
     }
 
+    // CRC-64 of the state of one of the objects of this snapshot, which the state tree uses to find the objects
+    // that changed between snapshots. Texture images are not included. Computed once per object.
+    uint64_t get_object_hash(const vogl_gl_object_state *pObject) const;
+
 private:
-    vogl_gl_state_snapshot *m_pSnapshot;
+    inline vogl_gl_state_snapshot *snapshot() const
+    {
+        if (!m_deferredBlobId.is_empty())
+        {
+            load_deferred_snapshot();
+        }
+        return m_pSnapshot;
+    }
+
+    void load_deferred_snapshot() const;
+
+    mutable vogl_gl_state_snapshot *m_pSnapshot;
     bool m_bEdited;
     bool m_bOutdated;
+
+    // set until a snapshot embedded in the trace has been loaded
+    mutable dynamic_string m_deferredBlobId;
+    dynamic_string m_blobId;
+    dynamic_string_array m_sessionBlobIds;
+    const vogl_blob_manager *m_pBlobManager;
+    const vogl_ctypes *m_pCtypes;
+
+    typedef vogl::hash_map<const vogl_gl_object_state *, uint64_t, bit_hasher<const vogl_gl_object_state *> > object_hash_map;
+    mutable object_hash_map m_objectHashes;
 };
 
 #endif // VOGLEDITOR_GL_STATE_SNAPSHOT_H
@@ -25,6 +25,7 @@
 
 #include <QColor>
 #include <QFont>
+#include <QHash>
 #include <QLocale>
 
 #include "vogleditor_qapicalltreemodel.h"
@@ -40,9 +41,21 @@
 #include "vogleditor_apicallitem.h"
 #include "vogleditor_output.h"
 #include "vogleditor_qsettings.h"
+#include "vogleditor_tracepacketcache.h"
+
+// Maximum number of formatted api call strings kept around for display and searching.
+static const int cMaxCachedApiCallStrings = 16384;
+
+// How often the parsing thread hands newly parsed frames over to the tree while loading.
+static const double cLoadHandOffIntervalMS = 250.0;
 
 vogleditor_QApiCallTreeModel::vogleditor_QApiCallTreeModel(QObject *parent)
-    : QAbstractItemModel(parent)
+    : QAbstractItemModel(parent),
+      m_pTrace_ctypes(NULL),
+      m_pPacketCache(NULL),
+      m_apiCallStrings(cMaxCachedApiCallStrings),
+      m_pSnapshotBlobManager(NULL),
+      m_pLoadRoot(NULL)
 {
     m_rootItem = vogl_new(vogleditor_apiCallTreeItem, this);
 }
@@ -55,6 +68,30 @@ vogleditor_QApiCallTreeModel::~vogleditor_QApiCallTreeModel()
         m_rootItem = NULL;
     }
 
+    // frames that were parsed but never published
+    for (int i = 0; i < m_loadedFrames.size(); i++)
+    {
+        vogl_delete(m_loadedFrames[i]);
+    }
+    m_loadedFrames.clear();
+    m_loadedItems.clear();
+    m_loadItemList.clear();
+    m_loadItemText.clear();
+
+    if (m_pLoadRoot != NULL)
+    {
+        vogl_delete(m_pLoadRoot);
+        m_pLoadRoot = NULL;
+    }
+
+    m_apiCallStrings.clear();
+
+    if (m_pPacketCache != NULL)
+    {
+        vogl_delete(m_pPacketCache);
+        m_pPacketCache = NULL;
+    }
+
     if (m_pTrace_ctypes != NULL)
     {
         vogl_delete(m_pTrace_ctypes);
@@ -65,6 +102,157 @@ vogleditor_QApiCallTreeModel::~vogleditor_QApiCallTreeModel()
 }
 
 bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
+{
+    if (!begin_init(pTrace_reader))
+    {
+        return false;
+    }
+
+    bool bParsed = parse_trace(pTrace_reader);
+
+    publish_loaded_frames();
+
+    return bParsed;
+}
+
+bool vogleditor_QApiCallTreeModel::begin_init(vogl_trace_file_reader *pTrace_reader)
+{
+    m_pTrace_ctypes = vogl_new(vogl_ctypes);
+
+    if (m_pTrace_ctypes == NULL)
+    {
+        return false;
+    }
+
+    m_pTrace_ctypes->init(pTrace_reader->get_sof_packet().m_pointer_sizes);
+
+    // Binary traces can be re-read one packet at a time, so only keep a window of decoded packets
+    // instead of every packet in the trace.
+    if (vogleditor_tracePacketCache::is_supported(pTrace_reader))
+    {
+        m_pPacketCache = vogl_new(vogleditor_tracePacketCache, static_cast<vogl_binary_trace_file_reader *>(pTrace_reader), m_pTrace_ctypes);
+    }
+
+    // snapshots embedded in the trace are only deserialized from this reader's blobs once they are used
+    m_pSnapshotBlobManager = &pTrace_reader->get_multi_blob_manager();
+
+    // frames are built under this root while parsing, then moved to m_rootItem by publish_loaded_frames()
+    m_pLoadRoot = vogl_new(vogleditor_apiCallTreeItem, this);
+
+    m_cancelLoad.store(0);
+
+    return true;
+}
+
+void vogleditor_QApiCallTreeModel::cancel_load()
+{
+    m_cancelLoad.store(1);
+}
+
+bool vogleditor_QApiCallTreeModel::load_was_cancelled() const
+{
+    return m_cancelLoad.load() != 0;
+}
+
+void vogleditor_QApiCallTreeModel::add_load_message(const QString &msg, bool bError)
+{
+    QMutexLocker locker(&m_loadMutex);
+    if (bError)
+        m_loadErrors.append(msg);
+    else
+        m_loadMessages.append(msg);
+}
+
+void vogleditor_QApiCallTreeModel::add_load_item(vogleditor_apiCallTreeItem *pItem, const QString &apiCallColumn)
+{
+    m_loadItemList.append(pItem);
+    m_loadItemText.append(apiCallColumn);
+}
+
+void vogleditor_QApiCallTreeModel::hand_off_loaded_frames()
+{
+    // Index the finished frames here, off the GUI thread. Api calls use the text that was formatted while
+    // their packet was decoded, frames and groups their final label.
+    vogleditor_apiCallSearchIndex searchIndex;
+    for (int i = 0; i < m_loadItemList.size(); i++)
+    {
+        vogleditor_apiCallTreeItem *pItem = m_loadItemList[i];
+        if (pItem->isApiCall())
+        {
+            searchIndex.add_item(m_loadItemText[i], pItem->entrypoint_id(), pItem->apiCallItem()->globalCallIndex(), pItem->has_snapshot());
+        }
+        else
+        {
+            searchIndex.add_item(pItem->apiCallColumn(), VOGL_ENTRYPOINT_INVALID, 0, pItem->has_snapshot());
+        }
+    }
+
+    {
+        QMutexLocker locker(&m_loadMutex);
+        m_loadedFrames.append(m_pLoadRoot->takeChildren());
+        m_loadedItems += m_loadItemList;
+        m_loadedSearchIndex.append(searchIndex);
+    }
+
+    m_loadItemList.clear();
+    m_loadItemText.clear();
+
+    emit framesAvailable();
+}
+
+void vogleditor_QApiCallTreeModel::publish_loaded_frames()
+{
+    QList<vogleditor_apiCallTreeItem *> frames;
+    QVector<vogleditor_apiCallTreeItem *> items;
+    QStringList errors;
+    QStringList messages;
+
+    {
+        QMutexLocker locker(&m_loadMutex);
+        frames.swap(m_loadedFrames);
+        items.swap(m_loadedItems);
+        errors.swap(m_loadErrors);
+        messages.swap(m_loadMessages);
+
+        m_searchIndex.append(m_loadedSearchIndex);
+        m_loadedSearchIndex.clear();
+    }
+
+    for (int i = 0; i < errors.size(); i++)
+    {
+        vogleditor_output_error(errors[i].toStdString().c_str());
+    }
+
+    for (int i = 0; i < messages.size(); i++)
+    {
+        vogleditor_output_message(messages[i].toStdString().c_str());
+    }
+
+    if (frames.isEmpty())
+    {
+        return;
+    }
+
+    int firstRow = m_rootItem->childCount();
+    beginInsertRows(QModelIndex(), firstRow, firstRow + frames.size() - 1);
+
+    for (int i = 0; i < frames.size(); i++)
+    {
+        m_rootItem->adoptChild(frames[i]);
+    }
+    for (int i = 0; i < items.size(); i++)
+    {
+        items[i]->setListIndex(m_itemList.size() + i);
+    }
+    m_itemList += items;
+    VOGL_ASSERT(m_itemList.size() == m_searchIndex.size());
+
+    endInsertRows();
+
+    emit framesPublished();
+}
+
+bool vogleditor_QApiCallTreeModel::parse_trace(vogl_trace_file_reader *pTrace_reader)
 {
     const vogl_trace_stream_start_of_file_packet &sof_packet = pTrace_reader->get_sof_packet();
     VOGL_NOTE_UNUSED(sof_packet);
@@ -78,29 +266,52 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
     // appended to the parent
     vogleditor_frameItem *pCurFrame = NULL;
     vogleditor_groupItem *pCurGroup = NULL;
-    vogleditor_apiCallTreeItem *pParentRoot = m_rootItem;
+    vogleditor_apiCallTreeItem *pParentRoot = m_pLoadRoot;
     vogleditor_apiCallTreeItem *pCurParent = pParentRoot;
 
     // Make a PendingSnapshot that may or may not be populated when reading the trace.
     // This snapshot will be assigned to the next API call that occurs.
     vogleditor_gl_state_snapshot *pPendingSnapshot = NULL;
 
-    m_pTrace_ctypes = vogl_new(vogl_ctypes);
-
-    if (m_pTrace_ctypes == NULL)
+    // With a packet cache the api call items only keep the file offsets of their packets, so packets are just decoded
+    // into a scratch packet here. The cache itself belongs to the GUI thread and isn't used while parsing.
+    vogl_trace_packet scratch_packet(m_pTrace_ctypes);
+    if ((m_pPacketCache != NULL) && !vogleditor_tracePacketCache::is_supported(pTrace_reader))
     {
+        add_load_message("The trace must be parsed with a binary trace reader.", true);
         return false;
     }
 
-    m_pTrace_ctypes->init(pTrace_reader->get_sof_packet().m_pointer_sizes);
+    // text of the marker_push calls in the current frame, used to label the matching marker_pop calls
+    QHash<vogleditor_apiCallTreeItem *, QString> markerPushText;
+
+    int64_t max_frame_index = pTrace_reader->get_max_frame_index();
+    timer hand_off_timer;
+    hand_off_timer.start();
 
     for (;;)
     {
+        if (load_was_cancelled())
+        {
+            vogl_printf("Trace loading cancelled on swap %" PRIu64 "\n", total_swaps);
+
+            // Close any remaining State/Render group
+            if (pCurParent->isGroup())
+            {
+                pCurParent->setDurationColumn();
+            }
+
+            found_eof_packet = true;
+            break;
+        }
+
+        uint64_t packet_file_ofs = m_pPacketCache ? static_cast<vogl_binary_trace_file_reader *>(pTrace_reader)->get_cur_file_ofs() : 0;
+
         vogl_trace_file_reader::trace_file_reader_status_t read_status = pTrace_reader->read_next_packet();
 
         if ((read_status != vogl_trace_file_reader::cOK) && (read_status != vogl_trace_file_reader::cEOF))
         {
-            vogleditor_output_error("Failed reading from trace file!");
+            add_load_message("Failed reading from trace file!", true);
             return false;
         }
 
@@ -119,17 +330,17 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
 
         if (pTrace_reader->get_packet_type() == cTSPTGLEntrypoint)
         {
-            vogl_trace_packet *pTrace_packet = vogl_new(vogl_trace_packet, m_pTrace_ctypes);
+            vogl_trace_packet *pTrace_packet = m_pPacketCache ? &scratch_packet : vogl_new(vogl_trace_packet, m_pTrace_ctypes);
 
             if (!pTrace_packet->deserialize(pTrace_reader->get_packet_buf().get_ptr(), pTrace_reader->get_packet_buf().size(), false))
             {
-                vogleditor_output_error("Failed parsing GL entrypoint packet.");
+                add_load_message("Failed parsing GL entrypoint packet.", true);
                 return false;
             }
 
             if (!pTrace_packet->check())
             {
-                vogleditor_output_error("GL entrypoint packet failed consistency check. Please make sure the trace was made with the most recent version of VOGL.");
+                add_load_message("GL entrypoint packet failed consistency check. Please make sure the trace was made with the most recent version of VOGL.", true);
                 return false;
             }
 
@@ -159,37 +370,8 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
                             continue;
                         }
 
-                        uint8_vec snapshot_data;
-                        {
-                            timed_scope ts("get_multi_blob_manager().get");
-                            if (!pTrace_reader->get_multi_blob_manager().get(id, snapshot_data) || (snapshot_data.is_empty()))
-                            {
-                                vogl_warning_printf("Failed reading snapshot blob data \"%s\"!\n", id.get_ptr());
-                                continue;
-                            }
-                        }
-
-                        json_document doc;
-                        {
-                            timed_scope ts("doc.binary_deserialize");
-                            if (!doc.binary_deserialize(snapshot_data) || (!doc.get_root()))
-                            {
-                                vogl_warning_printf("Failed deserializing JSON snapshot blob data \"%s\"!\n", id.get_ptr());
-                                continue;
-                            }
-                        }
-
-                        vogl_gl_state_snapshot *pGLSnapshot = vogl_new(vogl_gl_state_snapshot);
-                        pPendingSnapshot = vogl_new(vogleditor_gl_state_snapshot, pGLSnapshot);
-
-                        timed_scope ts("pPendingSnapshot->deserialize");
-                        if (!pPendingSnapshot->get_snapshot()->deserialize(*doc.get_root(), pTrace_reader->get_multi_blob_manager(), m_pTrace_ctypes))
-                        {
-                            vogl_delete(pPendingSnapshot);
-                            pPendingSnapshot = NULL;
-
-                            vogl_warning_printf("Failed deserializing snapshot blob data \"%s\"!\n", id.get_ptr());
-                        }
+                        // The snapshot blob is only read and deserialized once the snapshot is actually used.
+                        pPendingSnapshot = vogl_new(vogleditor_gl_state_snapshot, id, m_pSnapshotBlobManager, m_pTrace_ctypes);
                     }
                 }
 
@@ -202,7 +384,7 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
             {
                 pCurFrame = vogl_new(vogleditor_frameItem, total_swaps);
                 vogleditor_apiCallTreeItem *pNewFrameNode = vogl_new(vogleditor_apiCallTreeItem, pCurFrame, pParentRoot);
-                m_itemList.append(pNewFrameNode);
+                add_load_item(pNewFrameNode);
 
                 if (pPendingSnapshot != NULL)
                 {
@@ -297,7 +479,10 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
             if (!(isMarkerPopEntrypoint(entrypoint_id) && hideMarkerPopApiCall()))
             {
                 // make apicall item
-                pCallItem = vogl_new(vogleditor_apiCallItem, pCurFrame, pTrace_packet, *pGL_packet);
+                if (m_pPacketCache != NULL)
+                    pCallItem = vogl_new(vogleditor_apiCallItem, pCurFrame, m_pPacketCache, packet_file_ofs, *pGL_packet);
+                else
+                    pCallItem = vogl_new(vogleditor_apiCallItem, pCurFrame, pTrace_packet, *pGL_packet);
                 pCurFrame->appendCall(pCallItem);
                 if (pCurParent->isGroupAncestry())
                 {
@@ -312,7 +497,7 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
 
                 // make tree item for the apicall
                 item = vogl_new(vogleditor_apiCallTreeItem, pCallItem, pCurParent);
-                m_itemList.append(item);
+                add_load_item(item, vogleditor_apiCallItem::formatApiFunctionCall(pTrace_packet));
             }
 
             // Post-process apiCall
@@ -331,6 +516,19 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
 
                 // reset the CurFrame so that a new frame node will be created on the next api call
                 pCurFrame = NULL;
+                markerPushText.clear();
+
+                // hand the finished frames over to the GUI thread every so often, the first one right away
+                if ((total_swaps == 1) || (hand_off_timer.get_elapsed_ms() >= cLoadHandOffIntervalMS))
+                {
+                    if (max_frame_index > 0)
+                    {
+                        emit loadProgress(static_cast<int>(VOGL_MIN(total_swaps * 100 / max_frame_index, 100U)));
+                    }
+
+                    hand_off_loaded_frames();
+                    hand_off_timer.start();
+                }
             }
             else if (isStartNestedEntrypoint(entrypoint_id))
             {
@@ -347,7 +545,7 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
                 else
                 {
                     QString msg(QString("*** Information: unpaired \"") + QString(g_vogl_entrypoint_descs[entrypoint_id].m_pName) + QString("\"."));
-                    vogleditor_output_message(msg.toStdString().c_str());
+                    add_load_message(msg, false);
                     vogl_printf(msg.toStdString().c_str());
                     vogl_printf("\n");
                 }
@@ -357,10 +555,12 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
                 if (displayMarkerTextAsLabel())
                 {
                     // Rename marker_push tree node
-                    QString msg = item->apiCallStringArg();
+                    QString msg = vogleditor_apiCallItem::extractStringArg(vogleditor_apiCallItem::formatApiFunctionCall(pTrace_packet));
+                    markerPushText.insert(item, msg);
 
                     QString pushstring = "\"" + msg + "\"" + " group";
                     item->setApiCallColumn(pushstring);
+                    m_loadItemText.last() = pushstring;
                 }
 
                 // start marker_push with this item as parent
@@ -374,10 +574,11 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
                     if (displayMarkerTextAsLabel() && (!hideMarkerPopApiCall()))
                     {
                         // Rename marker_push/pop tree nodes
-                        QString msg = pCurParent->apiCallStringArg();
+                        QString msg = markerPushText.value(pCurParent);
 
                         QString popstring = "\"" + msg + "\"" + " group end";
                         item->setApiCallColumn(popstring);
+                        m_loadItemText.last() = popstring;
                     }
                     pCurParent = pCurParent->parent();
                 }
@@ -386,7 +587,7 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
                     //if (!hideMarkerPopApiCall()) // inform or not? yes for now
                     {
                         QString msg(QString("*** Information: unpaired \"") + QString(g_vogl_entrypoint_descs[entrypoint_id].m_pName) + QString("\"."));
-                        vogleditor_output_message(msg.toStdString().c_str());
+                        add_load_message(msg, false);
                         vogl_printf(msg.toStdString().c_str());
                         vogl_printf("\n");
                     }
@@ -423,6 +624,10 @@ bool vogleditor_QApiCallTreeModel::init(vogl_trace_file_reader *pTrace_reader)
         }
     }
 
+    hand_off_loaded_frames();
+
+    emit loadProgress(100);
+
     return found_eof_packet;
 }
 
@@ -504,9 +709,9 @@ gl_entrypoint_id_t vogleditor_QApiCallTreeModel::itemApiCallId(vogleditor_apiCal
 gl_entrypoint_id_t vogleditor_QApiCallTreeModel::lastItemApiCallId() const
 {
     gl_entrypoint_id_t id = VOGL_ENTRYPOINT_INVALID;
-    if (!m_itemList.isEmpty())
+    if (!m_loadItemList.isEmpty())
     {
-        id = itemApiCallId(m_itemList.last());
+        id = itemApiCallId(m_loadItemList.last());
     }
     return id;
 }
@@ -524,7 +729,7 @@ vogleditor_apiCallTreeItem *vogleditor_QApiCallTreeModel::create_group(vogledito
 
     // Make a new (group type) apicalltree item and insert into tree
     vogleditor_apiCallTreeItem *pNewGroupNode = vogl_new(vogleditor_apiCallTreeItem, pCurGroupObj, pParentNode);
-    m_itemList.append(pNewGroupNode);
+    add_load_item(pNewGroupNode);
     return pNewGroupNode;
 }
 
@@ -612,14 +817,9 @@ QVariant vogleditor_QApiCallTreeModel::data(const QModelIndex &index, int role)
     // highlight the API call cell if it has a substring which matches the searchString
     if (role == Qt::BackgroundRole && index.column() == VOGL_ACTC_APICALL)
     {
-        if (!m_searchString.isEmpty())
+        if (!m_searchQuery.is_empty() && item_matches(pItem, m_searchQuery))
         {
-            QVariant data = pItem->columnData(VOGL_ACTC_APICALL, Qt::DisplayRole);
-            QString string = data.toString();
-            if (string.contains(m_searchString, Qt::CaseInsensitive))
-            {
-                return QColor(Qt::yellow);
-            }
+            return QColor(Qt::yellow);
         }
     }
 
@@ -654,271 +854,162 @@ QVariant vogleditor_QApiCallTreeModel::headerData(int section, Qt::Orientation o
     return QVariant();
 }
 
+QString vogleditor_QApiCallTreeModel::apiCallString(vogleditor_apiCallItem *pApiCallItem) const
+{
+    QString *pString = m_apiCallStrings.object(pApiCallItem);
+    if (pString != NULL)
+    {
+        return *pString;
+    }
+
+    QString apiCall = pApiCallItem->apiFunctionCall();
+    m_apiCallStrings.insert(pApiCallItem, new QString(apiCall));
+    return apiCall;
+}
+
 void vogleditor_QApiCallTreeModel::set_highlight_search_string(const QString searchString)
 {
-    m_searchString = searchString;
+    m_searchQuery = vogleditor_apiCallSearchQuery(searchString);
 }
 
-QModelIndex vogleditor_QApiCallTreeModel::find_prev_search_result(vogleditor_apiCallTreeItem *start, const QString searchText)
+bool vogleditor_QApiCallTreeModel::item_matches(vogleditor_apiCallTreeItem *pItem, const vogleditor_apiCallSearchQuery &query) const
 {
-    QLinkedListIterator<vogleditor_apiCallTreeItem *> iter(m_itemList);
+    return query.matches(pItem->apiCallColumn(), pItem->isApiCall() ? pItem->entrypoint_id() : VOGL_ENTRYPOINT_INVALID);
+}
 
-    if (start != NULL)
+void vogleditor_QApiCallTreeModel::snapshot_changed(vogleditor_apiCallTreeItem *pItem)
+{
+    if (pItem->listIndex() >= 0)
     {
-        if (iter.findNext(start) == false)
-        {
-            // the object wasn't found in the list, so return a default (invalid) item
-            return QModelIndex();
-        }
-
-        // need to back up past the current item
-        iter.previous();
+        m_searchIndex.set_has_snapshot(pItem->listIndex(), pItem->has_snapshot());
     }
-    else
+}
+
+QModelIndex vogleditor_QApiCallTreeModel::find_prev_search_result(vogleditor_apiCallTreeItem *start, const QString searchText)
+{
+    // if start is NULL, then search will begin from the end of the list
+    int position = (start != NULL) ? start->listIndex() : m_itemList.size();
+    if (position < 0)
     {
-        // set the iterator to the back so that searching starts from the end of the list
-        iter.toBack();
+        // the object isn't in the list, so return a default (invalid) item
+        return QModelIndex();
     }
 
-    // now the iterator is pointing to the desired start object in the list,
-    // continually check the prev item and find one with a snapshot
-    vogleditor_apiCallTreeItem *pFound = NULL;
-    while (iter.hasPrevious())
+    // only the candidates from the index need to be checked against the query
+    vogleditor_apiCallSearchQuery query(searchText);
+    bool bExact = m_searchIndex.is_exact(query);
+    while ((position = m_searchIndex.find_prev_candidate(query, position)) >= 0)
     {
-        vogleditor_apiCallTreeItem *pItem = iter.peekPrevious();
-        QVariant data = pItem->columnData(VOGL_ACTC_APICALL, Qt::DisplayRole);
-        QString string = data.toString();
-        if (string.contains(searchText, Qt::CaseInsensitive))
+        vogleditor_apiCallTreeItem *pItem = m_itemList[position];
+        if (bExact || item_matches(pItem, query))
         {
-            pFound = pItem;
-            break;
+            return indexOf(pItem);
         }
-
-        iter.previous();
     }
 
-    return indexOf(pFound);
+    return QModelIndex();
 }
 
 QModelIndex vogleditor_QApiCallTreeModel::find_next_search_result(vogleditor_apiCallTreeItem *start, const QString searchText)
 {
-    QLinkedListIterator<vogleditor_apiCallTreeItem *> iter(m_itemList);
-
-    if (start != NULL)
+    // if start is NULL, then search will begin from top, otherwise it will begin after the start item
+    int position = (start != NULL) ? start->listIndex() : -1;
+    if (start != NULL && position < 0)
     {
-        if (iter.findNext(start) == false)
-        {
-            // the object wasn't found in the list, so return a default (invalid) item
-            return QModelIndex();
-        }
+        // the object isn't in the list, so return a default (invalid) item
+        return QModelIndex();
     }
 
-    // now the iterator is pointing to the desired start object in the list,
-    // continually check the next item and find one with a snapshot
-    vogleditor_apiCallTreeItem *pFound = NULL;
-    while (iter.hasNext())
+    // only the candidates from the index need to be checked against the query
+    vogleditor_apiCallSearchQuery query(searchText);
+    bool bExact = m_searchIndex.is_exact(query);
+    while ((position = m_searchIndex.find_next_candidate(query, position)) >= 0)
     {
-        vogleditor_apiCallTreeItem *pItem = iter.peekNext();
-        QVariant data = pItem->columnData(VOGL_ACTC_APICALL, Qt::DisplayRole);
-        QString string = data.toString();
-        if (string.contains(searchText, Qt::CaseInsensitive))
+        vogleditor_apiCallTreeItem *pItem = m_itemList[position];
+        if (bExact || item_matches(pItem, query))
         {
-            pFound = pItem;
-            break;
+            return indexOf(pItem);
         }
-
-        iter.next();
     }
 
-    return indexOf(pFound);
+    return QModelIndex();
 }
 
 vogleditor_apiCallTreeItem *vogleditor_QApiCallTreeModel::find_prev_snapshot(vogleditor_apiCallTreeItem *start)
 {
-    QLinkedListIterator<vogleditor_apiCallTreeItem *> iter(m_itemList);
-
-    if (start != NULL)
-    {
-        if (iter.findNext(start) == false)
-        {
-            // the object wasn't found in the list
-            return NULL;
-        }
-
-        // need to back up past the current item
-        iter.previous();
-    }
-    else
-    {
-        // set the iterator to the back so that searching starts from the end of the list
-        iter.toBack();
-    }
-
-    // now the iterator is pointing to the desired start object in the list,
-    // continually check the prev item and find one with a snapshot
-    vogleditor_apiCallTreeItem *pFound = NULL;
-    while (iter.hasPrevious())
+    int position = (start != NULL) ? start->listIndex() : m_itemList.size();
+    if (position < 0)
     {
-        if (iter.peekPrevious()->has_snapshot())
-        {
-            pFound = iter.peekPrevious();
-            break;
-        }
-
-        iter.previous();
+        // the object isn't in the list
+        return NULL;
     }
 
-    return pFound;
+    position = m_searchIndex.find_prev_snapshot(position);
+    return (position >= 0) ? m_itemList[position] : NULL;
 }
 
 vogleditor_apiCallTreeItem *vogleditor_QApiCallTreeModel::find_next_snapshot(vogleditor_apiCallTreeItem *start)
 {
-    QLinkedListIterator<vogleditor_apiCallTreeItem *> iter(m_itemList);
-
-    // if start is NULL, then search will begin from top, otherwise it will begin from the start item and search onwards
-    if (start != NULL)
-    {
-        if (iter.findNext(start) == false)
-        {
-            // the object wasn't found in the list
-            return NULL;
-        }
-    }
-
-    // now the iterator is pointing to the desired start object in the list,
-    // continually check the next item and find one with a snapshot
-    vogleditor_apiCallTreeItem *pFound = NULL;
-    while (iter.hasNext())
+    // if start is NULL, then search will begin from top, otherwise it will begin after the start item
+    int position = (start != NULL) ? start->listIndex() : -1;
+    if (start != NULL && position < 0)
     {
-        if (iter.peekNext()->has_snapshot())
-        {
-            pFound = iter.peekNext();
-            break;
-        }
-
-        iter.next();
+        // the object isn't in the list
+        return NULL;
     }
 
-    return pFound;
+    position = m_searchIndex.find_next_snapshot(position);
+    return (position >= 0) ? m_itemList[position] : NULL;
 }
 
 vogleditor_apiCallTreeItem *vogleditor_QApiCallTreeModel::find_prev_drawcall(vogleditor_apiCallTreeItem *start)
 {
-    QLinkedListIterator<vogleditor_apiCallTreeItem *> iter(m_itemList);
-
-    if (start != NULL)
-    {
-        if (iter.findNext(start) == false)
-        {
-            // the object wasn't found in the list
-            return NULL;
-        }
-
-        // need to back up past the current item
-        iter.previous();
-    }
-    else
+    int position = (start != NULL) ? start->listIndex() : m_itemList.size();
+    if (position < 0)
     {
-        // set the iterator to the back so that searching starts from the end of the list
-        iter.toBack();
-    }
-
-    // now the iterator is pointing to the desired start object in the list,
-    // continually check the prev item and find one with a snapshot
-    vogleditor_apiCallTreeItem *pFound = NULL;
-    while (iter.hasPrevious())
-    {
-        vogleditor_apiCallTreeItem *pItem = iter.peekPrevious();
-        if (pItem->apiCallItem() != NULL)
-        {
-            gl_entrypoint_id_t entrypointId = pItem->apiCallItem()->getTracePacket()->get_entrypoint_id();
-            if (vogl_is_frame_buffer_write_entrypoint(entrypointId))
-            {
-                pFound = iter.peekPrevious();
-                break;
-            }
-        }
-
-        iter.previous();
+        // the object isn't in the list
+        return NULL;
     }
 
-    return pFound;
+    position = m_searchIndex.find_prev_drawcall(position);
+    return (position >= 0) ? m_itemList[position] : NULL;
 }
 
 vogleditor_apiCallTreeItem *vogleditor_QApiCallTreeModel::find_next_drawcall(vogleditor_apiCallTreeItem *start)
 {
-    QLinkedListIterator<vogleditor_apiCallTreeItem *> iter(m_itemList);
-
-    if (iter.findNext(start) == false)
+    if (start == NULL || start->listIndex() < 0)
     {
-        // the object wasn't found in the list
+        // the object isn't in the list
         return NULL;
     }
 
-    // now the iterator is pointing to the desired start object in the list,
-    // continually check the next item and find one with a snapshot
-    vogleditor_apiCallTreeItem *pFound = NULL;
-    while (iter.hasNext())
-    {
-        vogleditor_apiCallTreeItem *pItem = iter.peekNext();
-        if (pItem->apiCallItem() != NULL)
-        {
-            gl_entrypoint_id_t entrypointId = pItem->apiCallItem()->getTracePacket()->get_entrypoint_id();
-            if (vogl_is_frame_buffer_write_entrypoint(entrypointId))
-            {
-                pFound = iter.peekNext();
-                break;
-            }
-        }
-
-        iter.next();
-    }
-
-    return pFound;
+    int position = m_searchIndex.find_next_drawcall(start->listIndex());
+    return (position >= 0) ? m_itemList[position] : NULL;
 }
 
 vogleditor_apiCallTreeItem *vogleditor_QApiCallTreeModel::find_call_number(unsigned int callNumber)
 {
-    QLinkedListIterator<vogleditor_apiCallTreeItem *> iter(m_itemList);
-
-    vogleditor_apiCallTreeItem *pFound = NULL;
-    while (iter.hasNext())
-    {
-        vogleditor_apiCallTreeItem *pItem = iter.peekNext();
-        if (pItem->apiCallItem() != NULL)
-        {
-            if (pItem->apiCallItem()->globalCallIndex() == callNumber)
-            {
-                pFound = iter.peekNext();
-                break;
-            }
-        }
-
-        iter.next();
-    }
-
-    return pFound;
+    int position = m_searchIndex.find_call_number(callNumber);
+    return (position >= 0) ? m_itemList[position] : NULL;
 }
 
 vogleditor_apiCallTreeItem *vogleditor_QApiCallTreeModel::find_frame_number(unsigned int frameNumber)
 {
-    QLinkedListIterator<vogleditor_apiCallTreeItem *> iter(m_itemList);
+    // frames are numbered in order, so the frame is normally the child at the same row of the root
+    vogleditor_apiCallTreeItem *pItem = m_rootItem->child(frameNumber);
+    if (pItem != NULL && pItem->frameItem() != NULL && pItem->frameItem()->frameNumber() == frameNumber)
+    {
+        return pItem;
+    }
 
-    vogleditor_apiCallTreeItem *pFound = NULL;
-    while (iter.hasNext())
+    for (int i = 0; i < m_rootItem->childCount(); i++)
     {
-        vogleditor_apiCallTreeItem *pItem = iter.peekNext();
-        if (pItem->frameItem() != NULL)
+        pItem = m_rootItem->child(i);
+        if (pItem->frameItem() != NULL && pItem->frameItem()->frameNumber() == frameNumber)
         {
-            if (pItem->frameItem()->frameNumber() == frameNumber)
-            {
-                pFound = iter.peekNext();
-                break;
-            }
+            return pItem;
         }
-
-        iter.next();
     }
 
-    return pFound;
+    return NULL;
 }
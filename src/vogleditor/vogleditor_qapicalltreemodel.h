@@ -27,8 +27,14 @@
 #define VOGLEDITOR_QAPICALLTREEMODEL_H
 
 #include <QAbstractItemModel>
-#include <QLinkedList>
+#include <QAtomicInt>
+#include <QCache>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QVector>
 #include "vogl_common.h"
+#include "vogleditor_apicallsearchindex.h"
 
 class QVariant;
 class vogleditor_apiCallTreeItem;
@@ -38,6 +44,8 @@ class vogleditor_groupItem;
 class vogleditor_frameItem;
 class vogl_trace_packet;
 class vogleditor_apiCallItem;
+class vogleditor_tracePacketCache;
+class vogl_blob_manager;
 
 struct vogl_trace_gl_entrypoint_packet;
 
@@ -49,8 +57,16 @@ public:
     vogleditor_QApiCallTreeModel(QObject *parent = 0);
     ~vogleditor_QApiCallTreeModel();
 
+    // Parses the whole trace before returning.
     bool init(vogl_trace_file_reader *pTrace_reader);
 
+    // Loading in the background: begin_init() sets the model up to show the calls of pTrace_reader,
+    // then parse_trace() can run on a worker thread with a second reader of the same trace. It hands
+    // finished frames over through framesAvailable(), which publish_loaded_frames() adds to the tree.
+    bool begin_init(vogl_trace_file_reader *pTrace_reader);
+    bool parse_trace(vogl_trace_file_reader *pTrace_reader);
+    bool load_was_cancelled() const;
+
     virtual QVariant data(const QModelIndex &index, int role) const;
     virtual Qt::ItemFlags flags(const QModelIndex &index) const;
     virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
@@ -66,9 +82,20 @@ public:
         return m_rootItem;
     }
 
+    // Needed to deserialize snapshots of the trace, valid until the model is deleted.
+    const vogl_ctypes *get_trace_ctypes() const
+    {
+        return m_pTrace_ctypes;
+    }
+
+    // Returns the formatted api call of the item; only recently displayed or searched calls are kept formatted.
+    QString apiCallString(vogleditor_apiCallItem *pApiCallItem) const;
+
     vogleditor_apiCallTreeItem *create_group(vogleditor_frameItem *pFrameObj,
                                              vogleditor_groupItem *&pGroupObj,
                                              vogleditor_apiCallTreeItem *pParentNode);
+
+    // searchText is a vogleditor_apiCallSearchQuery, see vogleditor_apicallsearchindex.h
     void set_highlight_search_string(const QString searchString);
     QModelIndex find_prev_search_result(vogleditor_apiCallTreeItem *start, const QString searchText);
     QModelIndex find_next_search_result(vogleditor_apiCallTreeItem *start, const QString searchText);
@@ -82,10 +109,22 @@ public:
     vogleditor_apiCallTreeItem *find_call_number(unsigned int callNumber);
     vogleditor_apiCallTreeItem *find_frame_number(unsigned int frameNumber);
 
+    // Called by tree items when their snapshot is set or removed
+    void snapshot_changed(vogleditor_apiCallTreeItem *pItem);
+
 signals:
+    // emitted from the parsing thread when parsed frames are ready to be published
+    void framesAvailable();
+
+    // emitted after publish_loaded_frames() added new frames to the tree
+    void framesPublished();
+
+    void loadProgress(int percent);
 
 public
 slots:
+    void publish_loaded_frames();
+    void cancel_load();
 
 private:
     gl_entrypoint_id_t itemApiCallId(vogleditor_apiCallTreeItem *apiCall) const;
@@ -100,11 +139,64 @@ private:
     bool displayMarkerTextAsLabel() const;
     bool hideMarkerPopApiCall() const;
 
+    void add_load_message(const QString &msg, bool bError);
+    void add_load_item(vogleditor_apiCallTreeItem *pItem, const QString &apiCallColumn = QString());
+    void hand_off_loaded_frames();
+
+    bool item_matches(vogleditor_apiCallTreeItem *pItem, const vogleditor_apiCallSearchQuery &query) const;
+
 private:
     vogleditor_apiCallTreeItem *m_rootItem;
     vogl_ctypes *m_pTrace_ctypes;
-    QLinkedList<vogleditor_apiCallTreeItem *> m_itemList;
-    QString m_searchString;
+    vogleditor_tracePacketCache *m_pPacketCache;
+    mutable QCache<vogleditor_apiCallItem *, QString> m_apiCallStrings;
+    const vogl_blob_manager *m_pSnapshotBlobManager;
+    QVector<vogleditor_apiCallTreeItem *> m_itemList;
+    vogleditor_apiCallSearchIndex m_searchIndex;
+    vogleditor_apiCallSearchQuery m_searchQuery;
+
+    // only used by the parsing thread
+    vogleditor_apiCallTreeItem *m_pLoadRoot;
+    QVector<vogleditor_apiCallTreeItem *> m_loadItemList;
+    QVector<QString> m_loadItemText; // formatted api calls of m_loadItemList, for indexing
+
+    // handed over from the parsing thread, protected by m_loadMutex
+    QMutex m_loadMutex;
+    QList<vogleditor_apiCallTreeItem *> m_loadedFrames;
+    QVector<vogleditor_apiCallTreeItem *> m_loadedItems;
+    vogleditor_apiCallSearchIndex m_loadedSearchIndex;
+    QStringList m_loadErrors;
+    QStringList m_loadMessages;
+
+    QAtomicInt m_cancelLoad;
+};
+
+// Runs vogleditor_QApiCallTreeModel::parse_trace() on a worker thread.
+class vogleditor_apiCallTreeLoader : public QThread
+{
+public:
+    vogleditor_apiCallTreeLoader(vogleditor_QApiCallTreeModel *pModel, vogl_trace_file_reader *pTrace_reader)
+        : m_pModel(pModel),
+          m_pTrace_reader(pTrace_reader),
+          m_bSucceeded(false)
+    {
+    }
+
+    bool succeeded() const
+    {
+        return m_bSucceeded;
+    }
+
+protected:
+    virtual void run()
+    {
+        m_bSucceeded = m_pModel->parse_trace(m_pTrace_reader);
+    }
+
+private:
+    vogleditor_QApiCallTreeModel *m_pModel;
+    vogl_trace_file_reader *m_pTrace_reader;
+    bool m_bSucceeded;
 };
 
 #endif // VOGLEDITOR_QAPICALLTREEMODEL_H
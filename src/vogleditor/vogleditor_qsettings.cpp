@@ -17,6 +17,9 @@ vogleditor_qsettings::vogleditor_qsettings()
 
     m_defaults.trim_large_trace_prompt_size = 200;
 
+    m_defaults.replay_keyframe_interval = 10;
+    m_defaults.replay_keyframes_in_memory = 4;
+
     m_defaults.window_position_left = 0;
     m_defaults.window_position_top = 0;
     m_defaults.window_size_width = 1024;
@@ -156,6 +159,8 @@ bool vogleditor_qsettings::from_json(const json_document &doc)
 
     // all settings should be considered optional, if they are not in the json, then the current value is used (thus the value remains unchanged)
     m_settings.trim_large_trace_prompt_size = pSettingsNode->value_as_uint32("trim_large_trace_prompt_size", m_settings.trim_large_trace_prompt_size);
+    m_settings.replay_keyframe_interval = pSettingsNode->value_as_uint32("replay_keyframe_interval", m_settings.replay_keyframe_interval);
+    m_settings.replay_keyframes_in_memory = pSettingsNode->value_as_uint32("replay_keyframes_in_memory", m_settings.replay_keyframes_in_memory);
 
     m_settings.window_position_left = pSettingsNode->value_as_int("window_position_left", m_settings.window_position_left);
     m_settings.window_position_top = pSettingsNode->value_as_int("window_position_top", m_settings.window_position_top);
@@ -236,6 +241,8 @@ bool vogleditor_qsettings::to_json(json_document &doc)
     // settings
     json_node &settings = doc.get_root()->add_object("settings");
     settings.add_key_value("trim_large_trace_prompt_size", m_settings.trim_large_trace_prompt_size);
+    settings.add_key_value("replay_keyframe_interval", m_settings.replay_keyframe_interval);
+    settings.add_key_value("replay_keyframes_in_memory", m_settings.replay_keyframes_in_memory);
 
     settings.add_key_value("window_position_left", m_settings.window_position_left);
     settings.add_key_value("window_position_top", m_settings.window_position_top);
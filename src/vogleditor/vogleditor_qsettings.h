@@ -19,6 +19,8 @@ struct vogleditor_setting_struct
     int window_size_width;
     int window_size_height;
     unsigned int trim_large_trace_prompt_size;
+    unsigned int replay_keyframe_interval;  // frames between keyframe snapshots, 0 disables them
+    unsigned int replay_keyframes_in_memory; // the others are written to the session folder
 
     // State/Render groups checkbox
     QString state_render_name;          // checkbox label
@@ -119,6 +121,15 @@ public:
         m_settings.trim_large_trace_prompt_size = trim_large_trace_prompt_size;
     }
 
+    unsigned int replay_keyframe_interval()
+    {
+        return m_settings.replay_keyframe_interval;
+    }
+    unsigned int replay_keyframes_in_memory()
+    {
+        return m_settings.replay_keyframes_in_memory;
+    }
+
     // Groups
 
     // State/Render
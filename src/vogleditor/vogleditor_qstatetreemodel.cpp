@@ -29,6 +29,45 @@
 
 #include "vogl_sync_object.h"
 
+struct vogl_gl_object_state_handle_less_than
+{
+    inline bool operator()(const vogl_gl_object_state *a, const vogl_gl_object_state *b) const
+    {
+        return a->get_snapshot_handle() < b->get_snapshot_handle();
+    }
+};
+
+typedef QHash<GLuint64, vogl_gl_object_state *> vogl_gl_object_state_handle_map;
+
+static void get_objects_by_handle(const vogl_context_snapshot *pContext, vogl_gl_object_state_type category, vogl_gl_object_state_handle_map &objects)
+{
+    vogl_gl_object_state_ptr_vec objectVec;
+    pContext->get_all_objects_of_category(category, objectVec);
+
+    objects.clear();
+    objects.reserve(objectVec.size());
+    for (vogl_gl_object_state **iter = objectVec.begin(); iter != objectVec.end(); iter++)
+    {
+        objects.insert((*iter)->get_snapshot_handle(), *iter);
+    }
+}
+
+static const vogl_context_snapshot *get_diff_base_context(const vogleditor_gl_state_snapshot *pBaseSnapshot, const vogl_context_snapshot *pContext)
+{
+    if (pBaseSnapshot == NULL || !pBaseSnapshot->is_valid() || pBaseSnapshot->get_contexts().size() == 0)
+    {
+        return NULL;
+    }
+
+    return pBaseSnapshot->get_context(pContext->get_context_desc().get_trace_context());
+}
+
+// The "Objects" node and the node of each object type are created with their parent, but they are only children of it while they are shown.
+static bool is_shown(const vogleditor_stateTreeItem *pItem)
+{
+    return pItem->parent() != NULL && pItem->row() >= 0;
+}
+
 //===============================================
 
 vogleditor_QStateTreeModel::vogleditor_QStateTreeModel(QObject *parent)
@@ -36,26 +75,51 @@ vogleditor_QStateTreeModel::vogleditor_QStateTreeModel(QObject *parent)
       m_pSnapshot(NULL),
       m_pBaseSnapshot(NULL)
 {
-    m_ColumnTitles << "State";
-    m_ColumnTitles << "Value";
-
-    m_rootItem = new vogleditor_stateTreeItem(m_ColumnTitles, this);
+    init();
 }
 
 vogleditor_QStateTreeModel::vogleditor_QStateTreeModel(vogleditor_gl_state_snapshot *pSnapshot, vogl_context_snapshot *pContext, vogleditor_gl_state_snapshot *pDiffBaseSnapshot, QObject *parent)
     : QAbstractItemModel(parent),
-      m_pSnapshot(pSnapshot),
-      m_pBaseSnapshot(pDiffBaseSnapshot)
+      m_pSnapshot(NULL),
+      m_pBaseSnapshot(NULL)
+{
+    init();
+    set_snapshot(pSnapshot, pContext, pDiffBaseSnapshot);
+}
+
+void vogleditor_QStateTreeModel::init()
 {
     m_ColumnTitles << "State";
     m_ColumnTitles << "Value";
 
     m_rootItem = new vogleditor_stateTreeItem(m_ColumnTitles, this);
-    setupModelData(m_pSnapshot, pContext, m_rootItem);
+
+    m_pObjectsItem = new vogleditor_stateTreeItem("Objects", "", m_rootItem);
+#define DEF(x) m_categoryItems[cGLST##x] = new vogleditor_stateTreeItem(#x "s", "", m_pObjectsItem);
+    VOGL_GL_OBJECT_STATE_TYPES
+#undef DEF
+
+    m_objectsContext = 0;
 }
 
 vogleditor_QStateTreeModel::~vogleditor_QStateTreeModel()
 {
+    // the nodes that are not shown are not deleted with their parents
+    for (uint i = 0; i < cGLSTTotalTypes; i++)
+    {
+        if (!is_shown(m_categoryItems[i]))
+        {
+            delete m_categoryItems[i];
+        }
+        m_categoryItems[i] = NULL;
+    }
+
+    if (!is_shown(m_pObjectsItem))
+    {
+        delete m_pObjectsItem;
+    }
+    m_pObjectsItem = NULL;
+
     if (m_rootItem != NULL)
     {
         delete m_rootItem;
@@ -144,21 +208,392 @@ vogleditor_gl_state_snapshot *vogleditor_QStateTreeModel::get_snapshot() const
     return m_pSnapshot;
 }
 
-void vogleditor_QStateTreeModel::setupModelData(vogleditor_gl_state_snapshot *pSnapshot, vogl_context_snapshot *pContext, vogleditor_stateTreeItem *parent)
+// Siblings may have the same name, so the key of an item is its name and how many siblings before it have that name.
+static QString item_key(const QString &name, int occurrence)
+{
+    return (occurrence == 0) ? name : name + QString("#%1").arg(occurrence);
+}
+
+static QString item_key(const vogleditor_stateTreeItem *pItem)
+{
+    QString name = pItem->columnData(0, Qt::DisplayRole).toString();
+
+    int occurrence = 0;
+    int row = pItem->row();
+    for (int i = 0; i < row; i++)
+    {
+        if (pItem->parent()->child(i)->columnData(0, Qt::DisplayRole).toString() == name)
+        {
+            occurrence++;
+        }
+    }
+
+    return item_key(name, occurrence);
+}
+
+vogleditor_stateTreeItem *vogleditor_QStateTreeModel::find_matching_item(vogleditor_stateTreeItem *pItem, vogleditor_stateTreeItem *pNewRoot, QHash<vogleditor_stateTreeItem *, childrenByKey> &newChildren) const
 {
-    VOGL_NOTE_UNUSED(pSnapshot);
+    if (pItem == m_rootItem)
+    {
+        return pNewRoot;
+    }
+
+    vogleditor_stateTreeItem *pNewParent = find_matching_item(pItem->parent(), pNewRoot, newChildren);
+    if (pNewParent == NULL)
+    {
+        return NULL;
+    }
 
+    // the children of each new item are only hashed once they are needed
+    QHash<vogleditor_stateTreeItem *, childrenByKey>::iterator iter = newChildren.find(pNewParent);
+    if (iter == newChildren.end())
+    {
+        childrenByKey children;
+        QHash<QString, int> occurrences;
+        for (int i = 0; i < pNewParent->childCount(); i++)
+        {
+            QString name = pNewParent->child(i)->columnData(0, Qt::DisplayRole).toString();
+            children.insert(item_key(name, occurrences[name]++), pNewParent->child(i));
+        }
+        iter = newChildren.insert(pNewParent, children);
+    }
+
+    return iter.value().value(item_key(pItem), NULL);
+}
+
+void vogleditor_QStateTreeModel::set_snapshot(vogleditor_gl_state_snapshot *pSnapshot, vogl_context_snapshot *pContext, vogleditor_gl_state_snapshot *pDiffBaseSnapshot)
+{
+    m_pSnapshot = pSnapshot;
+    m_pBaseSnapshot = pDiffBaseSnapshot;
+
+    update_context_items(pContext);
+    update_object_items(pContext);
+}
+
+void vogleditor_QStateTreeModel::update_context_items(vogl_context_snapshot *pContext)
+{
     QString tmp;
 
     const vogl_context_desc &desc = pContext->get_context_desc();
-    vogleditor_stateTreeContextItem *pContextItem = new vogleditor_stateTreeContextItem(tmp.sprintf("Context %p", (void *)desc.get_trace_context()), "", parent, *pContext);
-    if (m_pBaseSnapshot != NULL && m_pBaseSnapshot->is_valid() && m_pBaseSnapshot->get_contexts().size() > 0 && m_pBaseSnapshot->get_context(desc.get_trace_context()) != NULL)
+    vogleditor_stateTreeContextItem *pContextItem = new vogleditor_stateTreeContextItem(tmp.sprintf("Context %p", (void *)desc.get_trace_context()), "", m_rootItem, *pContext);
+    const vogl_context_snapshot *pDiffContext = get_diff_base_context(m_pBaseSnapshot, pContext);
+    if (pDiffContext != NULL)
     {
         // set the diff state to be the same state, so that there does not appear to be any diff's
-        const vogl_context_snapshot *pDiffContext = m_pBaseSnapshot->get_context(desc.get_trace_context());
         pContextItem->set_diff_base_state(pDiffContext);
     }
 
-    pContextItem->transferChildren(parent);
+    emit layoutAboutToBeChanged();
+
+    // move the indexes that the views hold on to (expanded, selected and current items) over to the matching new items,
+    // the object items are kept
+    QModelIndexList oldIndexes = persistentIndexList();
+    QList<vogleditor_stateTreeItem *> newItems;
+    QHash<vogleditor_stateTreeItem *, childrenByKey> newChildren;
+    for (int i = 0; i < oldIndexes.size(); i++)
+    {
+        vogleditor_stateTreeItem *pOldItem = static_cast<vogleditor_stateTreeItem *>(oldIndexes[i].internalPointer());
+        vogleditor_stateTreeItem *pNewItem = NULL;
+        if (pOldItem != NULL && is_object_item(pOldItem))
+        {
+            pNewItem = pOldItem;
+        }
+        else if (pOldItem != NULL)
+        {
+            pNewItem = find_matching_item(pOldItem, pContextItem, newChildren);
+        }
+
+        newItems.append((pNewItem != pContextItem) ? pNewItem : NULL);
+    }
+
+    // the context items are all the children of the root before the "Objects" node
+    QList<vogleditor_stateTreeItem *> oldItems;
+    int numOldItems = is_shown(m_pObjectsItem) ? m_pObjectsItem->row() : m_rootItem->childCount();
+    for (int i = 0; i < numOldItems; i++)
+    {
+        oldItems.append(m_rootItem->takeChild(0));
+    }
+
+    for (int i = 0; pContextItem->childCount() > 0; i++)
+    {
+        m_rootItem->insertChild(i, pContextItem->takeChild(0));
+    }
     delete pContextItem;
+
+    QModelIndexList newIndexes;
+    for (int i = 0; i < oldIndexes.size(); i++)
+    {
+        if (newItems[i] != NULL)
+        {
+            newIndexes.append(createIndex(newItems[i]->row(), oldIndexes[i].column(), newItems[i]));
+        }
+        else
+        {
+            newIndexes.append(QModelIndex());
+        }
+    }
+
+    changePersistentIndexList(oldIndexes, newIndexes);
+    emit layoutChanged();
+
+    // no index refers to the old items anymore
+    qDeleteAll(oldItems);
+}
+
+void vogleditor_QStateTreeModel::update_object_items(vogl_context_snapshot *pContext)
+{
+    const vogl_context_info &info = pContext->get_context_info();
+    const vogl_context_snapshot *pBaseContext = get_diff_base_context(m_pBaseSnapshot, pContext);
+
+    // objects of different contexts may have the same handles and state, but their items may differ
+    bool keepItems = (pContext->get_context_desc().get_trace_context() == m_objectsContext);
+    m_objectsContext = pContext->get_context_desc().get_trace_context();
+
+    if (info.is_valid() && !is_shown(m_pObjectsItem))
+    {
+        int row = m_rootItem->childCount();
+        beginInsertRows(QModelIndex(), row, row);
+        m_rootItem->insertChild(row, m_pObjectsItem);
+        endInsertRows();
+    }
+
+    vogl_gl_object_state_ptr_vec objects[cGLSTTotalTypes];
+    if (info.is_valid())
+    {
+        vogl_gl_object_state_ptr_vec &allObjects = pContext->get_objects();
+        for (vogl_gl_object_state **iter = allObjects.begin(); iter != allObjects.end(); iter++)
+        {
+            objects[vogleditor_stateTreeContextItem::get_object_category(*iter)].push_back(*iter);
+        }
+    }
+
+    for (uint i = 0; i < cGLSTTotalTypes; i++)
+    {
+        objects[i].sort(vogl_gl_object_state_handle_less_than());
+        update_category_items(static_cast<vogl_gl_object_state_type>(i), objects[i], keepItems, pBaseContext, info);
+    }
+
+    if (!info.is_valid() && is_shown(m_pObjectsItem))
+    {
+        int row = m_pObjectsItem->row();
+        beginRemoveRows(QModelIndex(), row, row);
+        m_rootItem->takeChild(row);
+        endRemoveRows();
+    }
+}
+
+void vogleditor_QStateTreeModel::update_category_items(vogl_gl_object_state_type category, const vogl_gl_object_state_ptr_vec &objects, bool keepItems, const vogl_context_snapshot *pBaseContext, const vogl_context_info &info)
+{
+    vogleditor_stateTreeItem *pCategoryItem = m_categoryItems[category];
+    const vogl::vector<object_item> &oldItems = m_objectItems[category];
+
+    // find the base object of each object by its handle, instead of searching all the base objects for each object
+    vogl_gl_object_state_handle_map baseObjects;
+    if (pBaseContext != NULL)
+    {
+        get_objects_by_handle(pBaseContext, category, baseObjects);
+    }
+
+    // both the objects and the current items are sorted by handle
+    vogl::vector<object_item> newItems;
+    newItems.reserve(objects.size());
+    uint oldIndex = 0;
+    int row = 0;
+    bool changed = false;
+    for (vogl_gl_object_state *const *iter = objects.begin(); iter != objects.end(); iter++)
+    {
+        vogl_gl_object_state *pObject = *iter;
+        GLuint64 handle = pObject->get_snapshot_handle();
+
+        // the objects before this one were deleted
+        while (oldIndex < oldItems.size() && oldItems[oldIndex].handle < handle)
+        {
+            remove_object_item(pCategoryItem, row);
+            oldIndex++;
+            changed = true;
+        }
+
+        const vogl_gl_object_state *pBaseObject = baseObjects.value(handle, NULL);
+
+        object_item item;
+        item.handle = handle;
+        item.type = pObject->get_type();
+        item.hash = m_pSnapshot->get_object_hash(pObject);
+        item.baseHash = (pBaseObject != NULL) ? m_pBaseSnapshot->get_object_hash(pBaseObject) : 0;
+        item.pObject = pObject;
+        item.pItem = NULL;
+
+        if (oldIndex < oldItems.size() && oldItems[oldIndex].handle == handle)
+        {
+            const object_item &oldItem = oldItems[oldIndex++];
+            if (keepItems && oldItem.type == item.type && oldItem.hash == item.hash)
+            {
+                // the state didn't change, so the item only has to refer to the new object
+                item.pItem = oldItem.pItem;
+                vogleditor_stateTreeContextItem::set_object_state(item.pItem, pObject);
+                vogleditor_stateTreeContextItem::set_object_diff_base_state(item.pItem, pObject, pBaseObject);
+
+                if (oldItem.baseHash != item.baseHash)
+                {
+                    item.pItem->clearChangedCache();
+                    if (is_shown(pCategoryItem))
+                    {
+                        QModelIndex itemIndex = createIndex(row, 0, item.pItem);
+                        emit dataChanged(itemIndex, createIndex(row, columnCount() - 1, item.pItem));
+                        emit_children_changed(itemIndex);
+                    }
+                    changed = true;
+                }
+            }
+            else
+            {
+                remove_object_item(pCategoryItem, row);
+                changed = true;
+            }
+        }
+
+        if (item.pItem == NULL)
+        {
+            item.pItem = vogleditor_stateTreeContextItem::create_object_item(pObject, pCategoryItem, info);
+            if (item.pItem == NULL)
+            {
+                // this object is not shown
+                continue;
+            }
+
+            vogleditor_stateTreeContextItem::set_object_diff_base_state(item.pItem, pObject, pBaseObject);
+            insert_object_item(pCategoryItem, row, item.pItem);
+            changed = true;
+        }
+
+        newItems.push_back(item);
+        row++;
+    }
+
+    while (oldIndex < oldItems.size())
+    {
+        remove_object_item(pCategoryItem, row);
+        oldIndex++;
+        changed = true;
+    }
+
+    m_objectItems[category].swap(newItems);
+
+    if (!changed)
+    {
+        return;
+    }
+
+    // the node of a type is only shown if there are objects of that type
+    QString tmp;
+    pCategoryItem->setValue(tmp.sprintf("[%d]", pCategoryItem->childCount()));
+    pCategoryItem->clearParentsChangedCache();
+
+    QModelIndex objectsIndex = createIndex(m_pObjectsItem->row(), 0, m_pObjectsItem);
+    if (is_shown(pCategoryItem) && pCategoryItem->childCount() == 0)
+    {
+        int categoryRow = pCategoryItem->row();
+        beginRemoveRows(objectsIndex, categoryRow, categoryRow);
+        m_pObjectsItem->takeChild(categoryRow);
+        endRemoveRows();
+    }
+    else if (is_shown(pCategoryItem))
+    {
+        int categoryRow = pCategoryItem->row();
+        emit dataChanged(createIndex(categoryRow, 0, pCategoryItem), createIndex(categoryRow, columnCount() - 1, pCategoryItem));
+    }
+    else if (pCategoryItem->childCount() > 0)
+    {
+        int categoryRow = 0;
+        for (uint i = 0; i < static_cast<uint>(category); i++)
+        {
+            if (is_shown(m_categoryItems[i]))
+            {
+                categoryRow++;
+            }
+        }
+
+        beginInsertRows(objectsIndex, categoryRow, categoryRow);
+        m_pObjectsItem->insertChild(categoryRow, pCategoryItem);
+        endInsertRows();
+    }
+
+    emit dataChanged(objectsIndex, createIndex(m_pObjectsItem->row(), columnCount() - 1, m_pObjectsItem));
+}
+
+void vogleditor_QStateTreeModel::insert_object_item(vogleditor_stateTreeItem *pCategoryItem, int row, vogleditor_stateTreeItem *pItem)
+{
+    if (!is_shown(pCategoryItem))
+    {
+        pCategoryItem->insertChild(row, pItem);
+        return;
+    }
+
+    beginInsertRows(createIndex(pCategoryItem->row(), 0, pCategoryItem), row, row);
+    pCategoryItem->insertChild(row, pItem);
+    endInsertRows();
+}
+
+void vogleditor_QStateTreeModel::remove_object_item(vogleditor_stateTreeItem *pCategoryItem, int row)
+{
+    if (is_shown(pCategoryItem))
+    {
+        beginRemoveRows(createIndex(pCategoryItem->row(), 0, pCategoryItem), row, row);
+        vogleditor_stateTreeItem *pItem = pCategoryItem->takeChild(row);
+        endRemoveRows();
+
+        // only delete the item once no index refers to it
+        delete pItem;
+    }
+    else
+    {
+        delete pCategoryItem->takeChild(row);
+    }
+}
+
+bool vogleditor_QStateTreeModel::is_object_item(const vogleditor_stateTreeItem *pItem) const
+{
+    for (; pItem != NULL; pItem = pItem->parent())
+    {
+        if (pItem == m_pObjectsItem)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void vogleditor_QStateTreeModel::update_changed_items()
+{
+    // the edited objects may not match the objects of other snapshots anymore
+    if (m_pSnapshot != NULL)
+    {
+        for (uint i = 0; i < cGLSTTotalTypes; i++)
+        {
+            for (object_item *iter = m_objectItems[i].begin(); iter != m_objectItems[i].end(); iter++)
+            {
+                iter->hash = m_pSnapshot->get_object_hash(iter->pObject);
+            }
+        }
+    }
+
+    m_rootItem->clearChangedCache();
+    emit_children_changed(QModelIndex());
+}
+
+void vogleditor_QStateTreeModel::emit_children_changed(const QModelIndex &parent)
+{
+    int rows = rowCount(parent);
+    if (rows == 0)
+    {
+        return;
+    }
+
+    emit dataChanged(index(0, 0, parent), index(rows - 1, columnCount() - 1, parent));
+
+    for (int i = 0; i < rows; i++)
+    {
+        emit_children_changed(index(i, 0, parent));
+    }
 }
@@ -27,6 +27,7 @@
 #define VOGLEDITOR_QSTATETREEMODEL_H
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QList>
 
 #include "vogleditor_gl_state_snapshot.h"
@@ -66,13 +67,51 @@ public:
 
     vogleditor_gl_state_snapshot *get_snapshot() const;
 
+    // Shows another snapshot (or context) in place. The items of the objects whose state did not change are kept,
+    // only the changed, new and deleted objects are replaced, inserted and removed. The other context state is
+    // rebuilt, and its items are matched to the current items by their names, so expanded and selected items stay the same.
+    void set_snapshot(vogleditor_gl_state_snapshot *pSnapshot, vogl_context_snapshot *pContext, vogleditor_gl_state_snapshot *pDiffBaseSnapshot);
+
+    // Call after the state of the snapshot was edited, to update which items are shown as changed.
+    void update_changed_items();
+
 private:
+    struct object_item
+    {
+        GLuint64 handle;
+        vogl_gl_object_state_type type;
+        uint64_t hash;
+        uint64_t baseHash; // 0 if the object has no diff base
+        const vogl_gl_object_state *pObject;
+        vogleditor_stateTreeItem *pItem;
+    };
+
     vogleditor_stateTreeItem *m_rootItem;
     QList<QVariant> m_ColumnTitles;
     vogleditor_gl_state_snapshot *m_pSnapshot;
     const vogleditor_gl_state_snapshot *m_pBaseSnapshot;
 
-    void setupModelData(vogleditor_gl_state_snapshot *pSnapshot, vogl_context_snapshot *pContext, vogleditor_stateTreeItem *parent);
+    // the "Objects" node and its node for each object type, which are only children of their parents while they are shown
+    vogleditor_stateTreeItem *m_pObjectsItem;
+    vogleditor_stateTreeItem *m_categoryItems[cGLSTTotalTypes];
+
+    // the object items of each type, in the order of their rows, and the context that they belong to
+    vogl::vector<object_item> m_objectItems[cGLSTTotalTypes];
+    vogl_trace_ptr_value m_objectsContext;
+
+    void init();
+
+    void update_context_items(vogl_context_snapshot *pContext);
+    void update_object_items(vogl_context_snapshot *pContext);
+    void update_category_items(vogl_gl_object_state_type category, const vogl_gl_object_state_ptr_vec &objects, bool keepItems, const vogl_context_snapshot *pBaseContext, const vogl_context_info &info);
+    void insert_object_item(vogleditor_stateTreeItem *pCategoryItem, int row, vogleditor_stateTreeItem *pItem);
+    void remove_object_item(vogleditor_stateTreeItem *pCategoryItem, int row);
+    bool is_object_item(const vogleditor_stateTreeItem *pItem) const;
+
+    void emit_children_changed(const QModelIndex &parent);
+
+    typedef QHash<QString, vogleditor_stateTreeItem *> childrenByKey;
+    vogleditor_stateTreeItem *find_matching_item(vogleditor_stateTreeItem *pItem, vogleditor_stateTreeItem *pNewRoot, QHash<vogleditor_stateTreeItem *, childrenByKey> &newChildren) const;
 };
 
 #endif // VOGLEDITOR_QSTATETREEMODEL_H
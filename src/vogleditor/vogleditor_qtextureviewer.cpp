@@ -26,7 +26,30 @@
 #include <QtGui>
 #include "vogleditor_qtextureviewer.h"
 #include "vogl_buffer_stream.h"
-#include "pxfmt.h"
+
+// Converts one tile of a QTextureViewer on the viewer's thread pool.
+class QTextureTileJob : public QRunnable
+{
+public:
+    QTextureTileJob(QTextureViewer *pViewer, const QTextureViewer::tile_request &request)
+        : m_pViewer(pViewer),
+          m_request(request)
+    {
+    }
+
+    virtual void run()
+    {
+        m_pViewer->tile_finished(m_request, m_pViewer->convert_tile(m_request));
+    }
+
+private:
+    QTextureViewer *m_pViewer;
+    QTextureViewer::tile_request m_request;
+};
+
+// position of each cube face in the cross, in units of faces; order is +X, -X, +Y, -Y, +Z, -Z
+static const uint g_cubeFaceColumn[6] = { 0, 2, 1, 1, 3, 1 };
+static const uint g_cubeFaceRow[6] = { 1, 1, 0, 2, 1, 1 };
 
 QTextureViewer::QTextureViewer(QWidget *parent)
     : QWidget(parent),
@@ -36,17 +59,33 @@ QTextureViewer::QTextureViewer(QWidget *parent)
       m_pKtxTexture(NULL),
       m_baseMipLevel(0),
       m_maxMipLevel(0),
-      m_arrayIndex(0)
+      m_arrayIndex(0),
+      m_sliceIndex(0),
+      m_srcFormat(PXFMT_INVALID),
+      m_bCompressed(false),
+      m_bytesPerPixel(0),
+      m_bytesPerBlock(0),
+      m_blockSize(0),
+      m_tiles(cMaxTileCacheCost),
+      m_generation(0)
 {
     m_background = QBrush(QColor(0, 0, 0));
     m_outlinePen = QPen(Qt::black);
     m_outlinePen.setWidth(1);
+
+    connect(this, SIGNAL(tilesAvailable()), this, SLOT(publish_tiles()), Qt::QueuedConnection);
+}
+
+QTextureViewer::~QTextureViewer()
+{
+    // the conversions read the texture and call back into this viewer
+    m_tilePool.clear();
+    m_tilePool.waitForDone();
 }
 
 void QTextureViewer::setTexture(const vogl::ktx_texture *pTexture, uint baseMipLevel, uint maxMipLevel)
 {
     pxfmt_sized_format src_pxfmt;
-    pxfmt_sized_format dest_pxfmt = PXFMT_RGBA8_UNORM;
     bool has_red;
     bool has_green;
     bool has_blue;
@@ -61,7 +100,8 @@ void QTextureViewer::setTexture(const vogl::ktx_texture *pTexture, uint baseMipL
     uint bytes_per_compressed_block;
     uint block_size;
 
-    deleteTexture();
+    delete_tiles();
+    m_pKtxTexture = NULL;
     if (!pTexture->is_valid())
         return;
 
@@ -93,70 +133,252 @@ void QTextureViewer::setTexture(const vogl::ktx_texture *pTexture, uint baseMipL
                              &is_integer, &is_compressed, &bytes_per_pixel,
                              &bytes_per_compressed_block, &block_size);
 
-    for (uint mip_level = 0; mip_level < pTexture->get_num_mips(); mip_level++)
+    // the images are converted one tile at a time as they are drawn, see convert_tile()
+    m_srcFormat = src_pxfmt;
+    m_bCompressed = is_compressed;
+    m_bytesPerPixel = bytes_per_pixel;
+    m_bytesPerBlock = bytes_per_compressed_block;
+    m_blockSize = vogl::math::maximum<uint>(1U, block_size);
+
+    m_draw_enabled = true;
+    m_pKtxTexture = pTexture;
+    m_baseMipLevel = baseMipLevel;
+    m_maxMipLevel = maxMipLevel;
+}
+
+void QTextureViewer::delete_tiles()
+{
+    // drop the queued conversions and wait for the running ones
+    m_tilePool.clear();
+    m_tilePool.waitForDone();
+
+    m_tiles.clear();
+    m_pendingTiles.clear();
+
+    m_finishedMutex.lock();
+    m_finishedTiles.clear();
+    m_finishedMutex.unlock();
+
+    m_generation++;
+}
+
+QTextureViewer::tile_grid QTextureViewer::get_tile_grid(uint mip, uint face, uint shift) const
+{
+    tile_grid grid;
+    grid.m_mip = mip;
+    grid.m_face = face;
+    grid.m_shift = shift;
+
+    // read a smaller mip level if the texture has one, otherwise point sample this one
+    uint srcLevel = mip + shift;
+    if (shift > 0 && m_pKtxTexture->get_depth() == 1 && srcLevel < m_pKtxTexture->get_num_mips())
     {
-        uint mip_width = vogl::math::maximum<uint>(1U, pTexture->get_width() >> mip_level);
-        uint mip_height = vogl::math::maximum<uint>(1U, pTexture->get_height() >> mip_level);
-        uint mip_depth = vogl::math::maximum<uint>(1U, pTexture->get_depth() >> mip_level);
-        for (uint array_index = 0; array_index < pTexture->get_array_size(); array_index++)
+        uint imageIndex = m_pKtxTexture->get_image_index(srcLevel, m_arrayIndex, face, 0);
+        if (imageIndex < m_pKtxTexture->get_num_images() && !m_pKtxTexture->get_image_data(imageIndex).is_empty())
         {
-            for (uint face_index = 0; face_index < pTexture->get_num_faces(); face_index++)
-            {
-                for (uint zslice_index = 0; zslice_index < mip_depth; zslice_index++)
-                {
-                    pxfmt_conversion_status status;
+            grid.m_srcLevel = srcLevel;
+            grid.m_step = 1;
+            grid.m_width = vogl::math::maximum<uint>(1U, m_pKtxTexture->get_width() >> srcLevel);
+            grid.m_height = vogl::math::maximum<uint>(1U, m_pKtxTexture->get_height() >> srcLevel);
+            return grid;
+        }
+    }
 
-                    uint image_index = pTexture->get_image_index(mip_level, array_index,
-                                                                 face_index, zslice_index);
-                    if (image_index >= pTexture->get_num_images())
-                        continue;
+    uint mipWidth = vogl::math::maximum<uint>(1U, m_pKtxTexture->get_width() >> mip);
+    uint mipHeight = vogl::math::maximum<uint>(1U, m_pKtxTexture->get_height() >> mip);
 
-                    const vogl::uint8_vec &image_data = pTexture->get_image_data(image_index);
-                    if (image_data.is_empty())
-                        continue;
+    grid.m_srcLevel = mip;
+    grid.m_step = 1U << shift;
+    grid.m_width = (mipWidth + grid.m_step - 1) >> shift;
+    grid.m_height = (mipHeight + grid.m_step - 1) >> shift;
+    return grid;
+}
 
-                    size_t src_size = bytes_per_pixel * mip_width * mip_height;
-                    uint dest_size = mip_width * sizeof(uint) * mip_height;
-                    vogl::image_u8 *dest_image = vogl_new(vogl::image_u8, mip_width, mip_height);
-                    if (image_index >= m_image.size())
-                    {
-                        m_image.resize(image_index + 1);
-                    }
-                    m_image[image_index] = dest_image;
+quint64 QTextureViewer::tile_key(const tile_grid &grid, uint tileX, uint tileY)
+{
+    return ((quint64)grid.m_mip << 48) | ((quint64)grid.m_face << 45) | ((quint64)grid.m_shift << 40) | ((quint64)tileY << 20) | tileX;
+}
 
-                    if (is_compressed)
-                    {
-                        // FIXME/TBD/TODO: CONSIDER MERGING THIS FUNCTION BACK
-                        // INTO THE NEXT FUNCTION (i.e. have one function for
-                        // both compressed and non-compressed src data):
-                        status = pxfmt_decompress_pixels(dest_image->get_ptr(), image_data.get_ptr(),
-                                                         mip_width, mip_height,
-                                                         dest_pxfmt, src_pxfmt, dest_size, src_size);
-                    }
-                    else
-                    {
-                        status = pxfmt_convert_pixels(dest_image->get_ptr(), image_data.get_ptr(),
-                                                      mip_width, mip_height,
-                                                      dest_pxfmt, src_pxfmt, dest_size, src_size);
-                    }
+QRectF QTextureViewer::tile_rect(const tile_grid &grid, const QRectF &faceRect, uint tileX, uint tileY) const
+{
+    uint left = tileX * cTileSize;
+    uint top = tileY * cTileSize;
+    uint right = vogl::math::minimum<uint>(left + cTileSize, grid.m_width);
+    uint bottom = vogl::math::minimum<uint>(top + cTileSize, grid.m_height);
+
+    double scaleX = faceRect.width() / grid.m_width;
+    double scaleY = faceRect.height() / grid.m_height;
+    return QRectF(faceRect.left() + left * scaleX, faceRect.top() + top * scaleY, (right - left) * scaleX, (bottom - top) * scaleY);
+}
+
+void QTextureViewer::request_tile(const tile_grid &grid, uint tileX, uint tileY, int priority)
+{
+    tile_request request;
+    request.m_grid = grid;
+    request.m_tileX = tileX;
+    request.m_tileY = tileY;
+    request.m_key = tile_key(grid, tileX, tileY);
+    request.m_generation = m_generation;
+
+    if (m_pendingTiles.contains(request.m_key) || m_tiles.contains(request.m_key))
+        return;
+
+    m_pendingTiles.insert(request.m_key);
+    m_tilePool.start(new QTextureTileJob(this, request), priority);
+}
+
+QImage QTextureViewer::convert_tile(const tile_request &request)
+{
+    const tile_grid &grid = request.m_grid;
+    uint left = request.m_tileX * cTileSize;
+    uint top = request.m_tileY * cTileSize;
+    uint width = vogl::math::minimum<uint>(cTileSize, grid.m_width - left);
+    uint height = vogl::math::minimum<uint>(cTileSize, grid.m_height - top);
+
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    image.fill(0);
+
+    uint imageIndex = m_pKtxTexture->get_image_index(grid.m_srcLevel, m_arrayIndex, grid.m_face, m_sliceIndex);
+    if (imageIndex >= m_pKtxTexture->get_num_images())
+        return image;
+
+    const vogl::uint8_vec &imageData = m_pKtxTexture->get_image_data(imageIndex);
+    if (imageData.is_empty())
+        return image;
+
+    uint srcWidth = vogl::math::maximum<uint>(1U, m_pKtxTexture->get_width() >> grid.m_srcLevel);
+    uint srcHeight = vogl::math::maximum<uint>(1U, m_pKtxTexture->get_height() >> grid.m_srcLevel);
+    uint blocksPerRow = (srcWidth + m_blockSize - 1) / m_blockSize;
+    uint blockPixels = m_blockSize * m_blockSize;
+
+    // compressed images are decoded a block at a time; the blocks of the current block row are kept for the following rows
+    vogl::vector<vogl::color_quad_u8> blocks;
+    vogl::vector<uint8_t> blockDecoded;
+    uint firstBlock = (left * grid.m_step) / m_blockSize;
+    uint blockRow = vogl::cUINT32_MAX;
+    if (m_bCompressed)
+    {
+        uint lastBlock = vogl::math::minimum<uint>(((left + width - 1) * grid.m_step) / m_blockSize, blocksPerRow - 1);
+        blocks.resize((lastBlock - firstBlock + 1) * blockPixels);
+        blockDecoded.resize(lastBlock - firstBlock + 1);
+    }
+
+    vogl::vector<vogl::color_quad_u8> row(width);
+    for (uint y = 0; y < height; y++)
+    {
+        // the images are stored bottom up
+        uint srcY = srcHeight - 1 - vogl::math::minimum<uint>((top + y) * grid.m_step, srcHeight - 1);
+
+        pxfmt_conversion_status status = PXFMT_CONVERSION_SUCCESS;
+        if (m_bCompressed)
+        {
+            if (srcY / m_blockSize != blockRow)
+            {
+                blockRow = srcY / m_blockSize;
+                blockDecoded.set_all(0);
+            }
 
-                    if (status != PXFMT_CONVERSION_SUCCESS)
+            for (uint x = 0; x < width && status == PXFMT_CONVERSION_SUCCESS; x++)
+            {
+                uint srcX = vogl::math::minimum<uint>((left + x) * grid.m_step, srcWidth - 1);
+                uint block = srcX / m_blockSize - firstBlock;
+                if (!blockDecoded[block])
+                {
+                    size_t blockOffset = ((size_t)blockRow * blocksPerRow + firstBlock + block) * m_bytesPerBlock;
+                    if (blockOffset + m_bytesPerBlock > imageData.size())
                     {
-                        vogl_error_printf("pxfmt_convert_pixels() returned a non-success status of %d!\n", status);
-                        return;
+                        status = PXFMT_CONVERSION_BAD_SIZE_SRC;
+                        break;
                     }
 
-                    dest_image->flip_y();
-                } // zslice
-            }     // face
-        }         // array
-    }             // mip_level
+                    status = pxfmt_decompress_pixels(&blocks[block * blockPixels], imageData.get_ptr() + blockOffset,
+                                                     m_blockSize, m_blockSize, PXFMT_RGBA8_UNORM, m_srcFormat,
+                                                     blockPixels * sizeof(vogl::color_quad_u8), m_bytesPerBlock);
+                    blockDecoded[block] = 1;
+                }
 
-    delete_pixmaps();
-    m_draw_enabled = true;
-    m_pKtxTexture = pTexture;
-    m_baseMipLevel = baseMipLevel;
-    m_maxMipLevel = maxMipLevel;
+                row[x] = blocks[block * blockPixels + (srcY % m_blockSize) * m_blockSize + (srcX % m_blockSize)];
+            }
+        }
+        else
+        {
+            size_t rowOffset = (size_t)srcY * srcWidth * m_bytesPerPixel;
+            if (rowOffset + srcWidth * m_bytesPerPixel > imageData.size())
+            {
+                status = PXFMT_CONVERSION_BAD_SIZE_SRC;
+            }
+            else if (grid.m_step == 1)
+            {
+                status = pxfmt_convert_pixels(row.get_ptr(), imageData.get_ptr() + rowOffset + left * m_bytesPerPixel,
+                                              width, 1, PXFMT_RGBA8_UNORM, m_srcFormat,
+                                              width * sizeof(vogl::color_quad_u8), width * m_bytesPerPixel);
+            }
+            else
+            {
+                for (uint x = 0; x < width && status == PXFMT_CONVERSION_SUCCESS; x++)
+                {
+                    uint srcX = vogl::math::minimum<uint>((left + x) * grid.m_step, srcWidth - 1);
+                    status = pxfmt_convert_pixels(&row[x], imageData.get_ptr() + rowOffset + srcX * m_bytesPerPixel,
+                                                  1, 1, PXFMT_RGBA8_UNORM, m_srcFormat,
+                                                  sizeof(vogl::color_quad_u8), m_bytesPerPixel);
+                }
+            }
+        }
+
+        if (status != PXFMT_CONVERSION_SUCCESS)
+        {
+            // keep the blank tile, so it isn't converted again
+            vogl_error_printf("pxfmt_convert_pixels() returned a non-success status of %d!\n", status);
+            break;
+        }
+
+        vogl::color_quad_u8 *pPixels = reinterpret_cast<vogl::color_quad_u8 *>(image.scanLine(y));
+        for (uint x = 0; x < width; x++)
+        {
+            vogl::color_quad_u8 pixel = row[x];
+            adjustChannels(m_channelSelection, pixel.r, pixel.g, pixel.b, pixel.a);
+            std::swap(pixel.r, pixel.b);
+            pPixels[x] = pixel;
+        }
+    }
+
+    return image;
+}
+
+void QTextureViewer::tile_finished(const tile_request &request, const QImage &image)
+{
+    finished_tile tile;
+    tile.m_key = request.m_key;
+    tile.m_generation = request.m_generation;
+    tile.m_image = image;
+
+    m_finishedMutex.lock();
+    m_finishedTiles.append(tile);
+    m_finishedMutex.unlock();
+
+    emit tilesAvailable();
+}
+
+void QTextureViewer::publish_tiles()
+{
+    QList<finished_tile> tiles;
+    m_finishedMutex.lock();
+    tiles.swap(m_finishedTiles);
+    m_finishedMutex.unlock();
+
+    if (tiles.isEmpty())
+        return;
+
+    for (QList<finished_tile>::iterator iter = tiles.begin(); iter != tiles.end(); ++iter)
+    {
+        if (iter->m_generation != m_generation)
+            continue;
+
+        m_pendingTiles.remove(iter->m_key);
+        m_tiles.insert(iter->m_key, new QImage(iter->m_image), iter->m_image.byteCount() / 1024 + 1);
+    }
+
+    update();
 }
 
 void QTextureViewer::paintEvent(QPaintEvent *event)
@@ -176,19 +398,104 @@ void QTextureViewer::paintEvent(QPaintEvent *event)
     painter.end();
 }
 
+void QTextureViewer::paint_face(QPainter *painter, const QRectF &visibleRect, const QRectF &faceRect, uint mip, uint face, QSet<quint64> &drawnFallbacks)
+{
+    QRectF visible = visibleRect.intersected(faceRect);
+    if (visible.isEmpty())
+        return;
+
+    // pick the mip chain level at which a tile pixel covers about one screen pixel
+    uint mipWidth = vogl::math::maximum<uint>(1U, m_pKtxTexture->get_width() >> mip);
+    double screenScale = m_zoomFactor * faceRect.width() / mipWidth;
+    uint shift = 0;
+    while (shift < 16 && screenScale * (2U << shift) <= 1.0)
+    {
+        shift++;
+    }
+
+    tile_grid grid = get_tile_grid(mip, face, shift);
+    uint tilesX = (grid.m_width + cTileSize - 1) / cTileSize;
+    uint tilesY = (grid.m_height + cTileSize - 1) / cTileSize;
+
+    double left = (visible.left() - faceRect.left()) / faceRect.width() * grid.m_width;
+    double right = (visible.right() - faceRect.left()) / faceRect.width() * grid.m_width;
+    double top = (visible.top() - faceRect.top()) / faceRect.height() * grid.m_height;
+    double bottom = (visible.bottom() - faceRect.top()) / faceRect.height() * grid.m_height;
+
+    uint firstX = vogl::math::minimum<uint>((uint)vogl::math::maximum(0.0, left) / cTileSize, tilesX - 1);
+    uint lastX = vogl::math::minimum<uint>((uint)vogl::math::maximum(0.0, right) / cTileSize, tilesX - 1);
+    uint firstY = vogl::math::minimum<uint>((uint)vogl::math::maximum(0.0, top) / cTileSize, tilesY - 1);
+    uint lastY = vogl::math::minimum<uint>((uint)vogl::math::maximum(0.0, bottom) / cTileSize, tilesY - 1);
+
+    // Until a tile is converted, draw the closest coarser tile that covers it. If there is none, ask for a
+    // tile at a quarter of the resolution first, since it converts quickly and covers 16 tiles.
+    for (uint tileY = firstY; tileY <= lastY; tileY++)
+    {
+        for (uint tileX = firstX; tileX <= lastX; tileX++)
+        {
+            if (m_tiles.contains(tile_key(grid, tileX, tileY)))
+                continue;
+
+            bool bFallback = false;
+            for (uint coarser = 1; coarser <= 4 && !bFallback; coarser++)
+            {
+                tile_grid coarseGrid = get_tile_grid(mip, face, shift + coarser);
+                uint coarseX = vogl::math::minimum<uint>(tileX >> coarser, (coarseGrid.m_width - 1) / cTileSize);
+                uint coarseY = vogl::math::minimum<uint>(tileY >> coarser, (coarseGrid.m_height - 1) / cTileSize);
+                quint64 coarseKey = tile_key(coarseGrid, coarseX, coarseY);
+
+                QImage *pCoarseTile = m_tiles.object(coarseKey);
+                if (pCoarseTile != NULL)
+                {
+                    if (!drawnFallbacks.contains(coarseKey))
+                    {
+                        painter->drawImage(tile_rect(coarseGrid, faceRect, coarseX, coarseY), *pCoarseTile);
+                        drawnFallbacks.insert(coarseKey);
+                    }
+                    bFallback = true;
+                }
+            }
+
+            if (!bFallback)
+            {
+                tile_grid previewGrid = get_tile_grid(mip, face, shift + 2);
+                request_tile(previewGrid, vogl::math::minimum<uint>(tileX >> 2, (previewGrid.m_width - 1) / cTileSize),
+                             vogl::math::minimum<uint>(tileY >> 2, (previewGrid.m_height - 1) / cTileSize), 1);
+            }
+
+            request_tile(grid, tileX, tileY, 0);
+        }
+    }
+
+    for (uint tileY = firstY; tileY <= lastY; tileY++)
+    {
+        for (uint tileX = firstX; tileX <= lastX; tileX++)
+        {
+            QImage *pTile = m_tiles.object(tile_key(grid, tileX, tileY));
+            if (pTile != NULL)
+            {
+                painter->drawImage(tile_rect(grid, faceRect, tileX, tileY), *pTile);
+            }
+        }
+    }
+}
+
 void QTextureViewer::paint(QPainter *painter, QPaintEvent *event)
 {
-    VOGL_NOTE_UNUSED(event);
     if (m_pKtxTexture == NULL)
     {
         return;
     }
 
-    if (m_image.is_empty() || !m_image[0]->is_valid() || !m_pKtxTexture->get_num_mips())
+    if (!m_pKtxTexture->get_num_mips())
     {
         return;
     }
 
+    // only the conversions for tiles that are still visible are kept queued
+    m_tilePool.clear();
+    m_pendingTiles.clear();
+
     painter->save();
 
     const uint border = 25;
@@ -212,8 +519,6 @@ void QTextureViewer::paint(QPainter *painter, QPaintEvent *event)
 
     maxMip = vogl::math::minimum(maxMip, m_pKtxTexture->get_num_mips() - 1);
 
-    uint mipWidth = 0;
-    uint mipHeight = 0;
     uint mipDepth;
 
     drawWidth = drawWidth >> m_baseMipLevel;
@@ -229,121 +534,49 @@ void QTextureViewer::paint(QPainter *painter, QPaintEvent *event)
     uint minimumWidth = 0;
     uint minimumHeight = drawHeight + border;
 
+    QSet<quint64> drawnFallbacks;
+
     for (uint mip = m_baseMipLevel; mip <= maxMip; mip++)
     {
-        uint imageIndex = m_pKtxTexture->get_image_index(mip, m_arrayIndex, 0, m_sliceIndex);
-
         mipDepth = vogl::math::maximum<uint>(1U, m_pKtxTexture->get_depth() >> mip);
         if (mipDepth <= m_sliceIndex)
             break;
-        if (m_pixmaps.contains(mip) == false && m_image[imageIndex] && m_image[imageIndex]->is_valid())
-        {
-            QWidget *pParent = (QWidget *)this->parent();
-            QCursor origCursor = pParent->cursor();
-            pParent->setCursor(Qt::WaitCursor);
-
-            vogl::color_quad_u8 *pTmpPixels = NULL;
-            if (m_pKtxTexture->get_num_faces() == 6)
-            {
-                vogl::image_u8 *image = m_image[imageIndex];
-
-                mipWidth = image->get_width();
-                mipHeight = image->get_height();
-
-                unsigned char tmp = 0;
-                unsigned int pixelsSize = image->get_total_pixels();
-
-                // store face dimensions
-                uint faceWidth = mipWidth;
-                uint faceHeight = mipHeight;
-
-                uint cubeCrossStride = faceWidth * 4;
-
-                // adjust mip dimensions
-                mipWidth *= 4;
-                mipHeight *= 3;
-
-                pTmpPixels = new vogl::color_quad_u8[pixelsSize * 12];
-                memset(pTmpPixels, 0, pixelsSize * 12 * sizeof(vogl::color_quad_u8));
-
-                // order is +X, -X, +Y, -Y, +Z, -Z
-                uint faceRowOffset[6] = { faceHeight, faceHeight, 0, 2 * faceHeight, faceHeight, faceHeight };
-                uint faceColOffset[6] = { 0, 2 * faceWidth, faceWidth, faceWidth, 3 * faceWidth, faceWidth };
-
-                for (uint face = 0; face < m_pKtxTexture->get_num_faces(); face++)
-                {
-                    vogl::image_u8 *image2 = m_image[m_pKtxTexture->get_image_index(mip, m_arrayIndex, face, 0)];
-                    vogl::color_quad_u8 *pPixels = image2->get_pixels();
-
-                    // calculate write location to start of face
-                    vogl::color_quad_u8 *writeLoc = pTmpPixels + cubeCrossStride * faceRowOffset[face] + faceColOffset[face];
-
-                    for (uint h = 0; h < faceHeight; h++)
-                    {
-                        // copy row of face into cross
-                        memcpy(writeLoc + h * cubeCrossStride, pPixels + h * faceWidth, faceWidth * sizeof(vogl::color_quad_u8));
-
-                        // adjust color of each pixel
-                        for (uint w = 0; w < faceWidth; w++)
-                        {
-                            vogl::color_quad_u8 *pPixel = writeLoc + h * cubeCrossStride + w;
-                            adjustChannels(m_channelSelection, pPixel->r, pPixel->g, pPixel->b, pPixel->a);
-                            tmp = pPixel->r;
-                            pPixel->r = pPixel->b;
-                            pPixel->b = tmp;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                vogl::image_u8 *image = m_image[imageIndex];
-                vogl::color_quad_u8 *pPixels = image->get_pixels();
-
-                mipWidth = image->get_width();
-                mipHeight = image->get_height();
-
-                unsigned char tmp = 0;
-                unsigned int pixelsSize = image->get_total_pixels();
-
-                pTmpPixels = new vogl::color_quad_u8[pixelsSize];
-                memcpy(pTmpPixels, pPixels, pixelsSize * sizeof(vogl::color_quad_u8));
-                for (uint i = 0; i < pixelsSize; i++)
-                {
-                    adjustChannels(m_channelSelection, pTmpPixels[i].r, pTmpPixels[i].g, pTmpPixels[i].b, pTmpPixels[i].a);
-                    tmp = pTmpPixels[i].r;
-                    pTmpPixels[i].r = pTmpPixels[i].b;
-                    pTmpPixels[i].b = tmp;
-                }
-            }
-
-            m_pixmaps.insert(mip, QPixmap::fromImage(QImage((unsigned char *)pTmpPixels, mipWidth, mipHeight, QImage::Format_ARGB32_Premultiplied)));
-            m_pixmapData.insert(mip, pTmpPixels);
-            pParent->setCursor(origCursor);
-        }
 
         // make sure the rect is 1 pixel around the texture
         painter->drawRect(-1, -1, drawWidth + 1, drawHeight + 1);
 
-        if (m_pixmaps.contains(mip))
+        int top = 0;
+        if (m_bInvert)
         {
-            int left = 0;
-            int top = 0;
-            if (m_bInvert)
-            {
-                // invert
-                painter->scale(1, -1);
-                top = -(int)drawHeight;
-            }
+            // invert
+            painter->scale(1, -1);
+            top = -(int)drawHeight;
+        }
 
-            painter->drawPixmap(left, top, drawWidth, drawHeight, m_pixmaps[mip]);
+        QRectF visibleRect = painter->worldTransform().inverted().mapRect(QRectF(event->rect()));
+        QRectF mipRect(0, top, drawWidth, drawHeight);
 
-            if (m_bInvert)
+        if (m_pKtxTexture->get_num_faces() == 6)
+        {
+            double faceWidth = drawWidth / 4.0;
+            double faceHeight = drawHeight / 3.0;
+            for (uint face = 0; face < 6; face++)
             {
-                // restore inversion
-                painter->scale(1, -1);
+                QRectF faceRect(mipRect.left() + g_cubeFaceColumn[face] * faceWidth, mipRect.top() + g_cubeFaceRow[face] * faceHeight, faceWidth, faceHeight);
+                paint_face(painter, visibleRect, faceRect, mip, face, drawnFallbacks);
             }
         }
+        else
+        {
+            paint_face(painter, visibleRect, mipRect, mip, 0, drawnFallbacks);
+        }
+
+        if (m_bInvert)
+        {
+            // restore inversion
+            painter->scale(1, -1);
+        }
+
         painter->translate(drawWidth + border, drawHeight / 2);
 
         minimumWidth += drawWidth + border;
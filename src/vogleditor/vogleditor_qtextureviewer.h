@@ -34,12 +34,18 @@ class QPaintEvent;
 QT_END_NAMESPACE
 
 #include <QBrush>
+#include <QCache>
+#include <QImage>
+#include <QMutex>
 #include <QPen>
+#include <QSet>
+#include <QThreadPool>
 
 #include "vogl_core.h"
-#include "vogl_map.h"
 #include "vogl_image.h"
 #include "vogl_ktx_texture.h"
+#include "gl_types.h"
+#include "pxfmt.h"
 
 typedef enum ChannelSelectionOptions
 {
@@ -63,11 +69,22 @@ typedef enum ChannelSelectionOptions
     VOGL_CSO_ONE_OVER_A,
 } ChannelSelectionOption;
 
+// Draws the mip chain of a texture. Images are converted to RGBA in tiles of cTileSize x cTileSize pixels on a
+// thread pool, and only for the tiles that are visible. Zoomed out, tiles are read from a smaller mip level (or
+// point sampled if there is none), and a coarser tile is drawn in place of tiles that haven't been converted yet.
 class QTextureViewer : public QWidget
 {
     Q_OBJECT
 public:
+    enum
+    {
+        cTileSize = 256,
+        // in KB
+        cMaxTileCacheCost = 192 * 1024
+    };
+
     explicit QTextureViewer(QWidget *parent = 0);
+    ~QTextureViewer();
     void paint(QPainter *painter, QPaintEvent *event);
 
     void setTexture(const vogl::ktx_texture *pTexture, uint baseMipLevel, uint maxMipLevel);
@@ -76,28 +93,17 @@ public:
     {
         if (m_channelSelection != channels)
         {
-            delete_pixmaps();
+            delete_tiles();
             m_channelSelection = channels;
             repaint();
         }
     }
 
-    void deleteTexture()
-    {
-        for (vogl::vector<vogl::image_u8 *>::iterator it = m_image.begin(); it < m_image.end(); ++it)
-        {
-            vogl::image_u8 *img = *it;
-            img->clear();
-            vogl_delete(img);
-        }
-        m_image.clear();
-    }
-
     void clear()
     {
         m_draw_enabled = false;
+        delete_tiles();
         m_pKtxTexture = NULL;
-        deleteTexture();
     }
 
     inline QColor getBackgroundColor() const
@@ -108,8 +114,8 @@ public:
     inline void setBackgroundColor(QBrush color)
     {
         m_draw_enabled = true;
+        delete_tiles();
         m_background = color;
-        delete_pixmaps();
         repaint();
     }
 
@@ -157,15 +163,15 @@ public:
 
     void setArrayElement(uint arrayElementIndex)
     {
+        delete_tiles();
         m_arrayIndex = arrayElementIndex;
-        delete_pixmaps();
         repaint();
     }
 
     void setSliceIndex(uint sliceIndex)
     {
+        delete_tiles();
         m_sliceIndex = sliceIndex;
-        delete_pixmaps();
         repaint();
     }
 
@@ -177,26 +183,70 @@ private:
     double m_zoomFactor;
     bool m_bInvert;
 
-    vogl::map<uint, QPixmap> m_pixmaps;
-    vogl::map<uint, vogl::color_quad_u8 *> m_pixmapData;
-
     const vogl::ktx_texture *m_pKtxTexture;
-    vogl::vector<vogl::image_u8 *> m_image;
     uint m_baseMipLevel;
     uint m_maxMipLevel;
     uint m_arrayIndex;
     uint m_sliceIndex;
 
-    void delete_pixmaps()
+    // format of the texture's images, see setTexture()
+    pxfmt_sized_format m_srcFormat;
+    bool m_bCompressed;
+    uint m_bytesPerPixel;
+    uint m_bytesPerBlock;
+    uint m_blockSize;
+
+    // Describes the tiles of one mip level (or cube face) drawn at 1/(2^shift) of its size.
+    struct tile_grid
     {
-        m_pixmaps.clear();
-        for (vogl::map<uint, vogl::color_quad_u8 *>::iterator iter = m_pixmapData.begin(); iter != m_pixmapData.end(); iter++)
-        {
-            delete[] iter->second;
-            iter->second = NULL;
-        }
-        m_pixmapData.clear();
-    }
+        uint m_mip;
+        uint m_face;
+        uint m_shift;
+        uint m_srcLevel; // the mip level that is read
+        uint m_step;     // distance between the source pixels that are read
+        uint m_width;    // size of the tiled image
+        uint m_height;
+    };
+
+    struct tile_request
+    {
+        tile_grid m_grid;
+        uint m_tileX;
+        uint m_tileY;
+        quint64 m_key;
+        uint m_generation;
+    };
+
+    struct finished_tile
+    {
+        quint64 m_key;
+        uint m_generation;
+        QImage m_image;
+    };
+
+    QCache<quint64, QImage> m_tiles;
+    QSet<quint64> m_pendingTiles;
+    QThreadPool m_tilePool;
+
+    // bumped whenever the tiles are deleted, so tiles that were converted for a previous setting are dropped
+    uint m_generation;
+
+    // handed over from the pool threads, protected by m_finishedMutex
+    QMutex m_finishedMutex;
+    QList<finished_tile> m_finishedTiles;
+
+    tile_grid get_tile_grid(uint mip, uint face, uint shift) const;
+    static quint64 tile_key(const tile_grid &grid, uint tileX, uint tileY);
+    QRectF tile_rect(const tile_grid &grid, const QRectF &faceRect, uint tileX, uint tileY) const;
+    void paint_face(QPainter *painter, const QRectF &visibleRect, const QRectF &faceRect, uint mip, uint face, QSet<quint64> &drawnFallbacks);
+    void request_tile(const tile_grid &grid, uint tileX, uint tileY, int priority);
+
+    // Cancels the tile conversions and deletes all tiles; call this before changing anything that the conversion reads.
+    void delete_tiles();
+
+    friend class QTextureTileJob;
+    QImage convert_tile(const tile_request &request);
+    void tile_finished(const tile_request &request, const QImage &image);
 
     void adjustChannels(ChannelSelectionOption selection, unsigned char &r, unsigned char &g, unsigned char &b, unsigned char &a);
 
@@ -204,9 +254,12 @@ protected:
     void paintEvent(QPaintEvent *event);
 
 signals:
+    // emitted from the pool threads when converted tiles are ready to be published
+    void tilesAvailable();
 
-public
+private
 slots:
+    void publish_tiles();
 };
 
 #endif // VOGLEDITOR_QTEXTUREVIEWER_H
@@ -33,6 +33,10 @@
 #include "vogleditor_frameitem.h"
 #include "vogleditor_groupitem.h"
 
+// width of the cached timeline tiles, and how many of them are kept around
+static const int cTileWidth = 256;
+static const int cMaxCachedTiles = 128;
+
 vogleditor_QTimelineView::vogleditor_QTimelineView(QWidget *parent)
     : QWidget(parent),
       m_roundoff(cVOGL_TIMELINEOFFSET),
@@ -41,7 +45,9 @@ vogleditor_QTimelineView::vogleditor_QTimelineView(QWidget *parent)
       m_zoom(1),
       m_scroll(0),
       m_pModel(NULL),
-      m_pPixmap(NULL)
+      m_modelRevision(0),
+      m_tiles(cMaxCachedTiles),
+      m_tileHeight(0)
 {
     QLinearGradient gradient(QPointF(0, 1), QPointF(0, 0));
     gradient.setCoordinateMode(QGradient::ObjectBoundingMode);
@@ -115,18 +121,10 @@ void vogleditor_QTimelineView::resizeEvent(QResizeEvent *)
 {
     m_scrollBar->setPageStep(width());
 
-    if (m_pPixmap != NULL)
+    // a new width changes the line length, and so the tiles that are used; a new height needs new tiles
+    if (height() != m_tileHeight)
     {
-        int pmHeight = m_pPixmap->height();
-        int pmWidth = m_pPixmap->width();
-        float widthPctDelta = (float)(width() - pmWidth) / (float)pmWidth;
-        float heightPctDelta = (float)(height() - pmHeight) / (float)pmHeight;
-        // If the resize is of a 'signficant' amount, then delete the pixmap so that it will be regenerated at the new size.
-        if (fabs(widthPctDelta) > 0.2 ||
-                fabs(heightPctDelta) > 0.2)
-        {
-            deletePixmap();
-        }
+        deleteTiles();
     }
 }
 
@@ -206,7 +204,6 @@ void vogleditor_QTimelineView::scrollToPx(int scroll)
     m_scroll=qMax(m_scroll, 0);
     m_scroll=qMin(m_scroll, (int)((double)m_zoom*(double)width()-width()));
     emit(scrollPosChanged(m_scroll));    
-    deletePixmap();
     update();
 }
 
@@ -258,38 +255,39 @@ void vogleditor_QTimelineView::paint(QPainter *painter, QPaintEvent *event)
         return;
     }
 
-    if (m_pPixmap == NULL)
+    // the model was refreshed (e.g. more frames were loaded)
+    if (m_modelRevision != m_pModel->get_revision())
     {
-        m_timelineItemPosCache.clear();
-        m_pPixmap = new QPixmap(event->rect().width(), event->rect().height());
-        m_pPixmap->fill(Qt::transparent);
-        QPainter pixmapPainter(m_pPixmap);
-
-        //Apply the scroll translation:
-        pixmapPainter.translate(-m_scroll, 0);
-        // translate drawing to vertical center of rect
-        // everything will have a small gap on the left and right sides
-        pixmapPainter.translate(m_gap, height() / 2);
+        deleteTiles();
+        m_modelRevision = m_pModel->get_revision();
+        m_maxItemDuration = m_pModel->get_root_item()->getMaxChildDuration();
+    }
 
-        m_horizontalScale = (double)m_lineLength / (double)m_pModel->get_root_item()->getDuration();
+    m_horizontalScale = (double)m_lineLength / (double)m_pModel->get_root_item()->getDuration();
+    m_tileHeight = height();
 
-        // we don't want to draw the root item, but all of its children
-        int numChildren = m_pModel->get_root_item()->childCount();
-        int i_height = height() / 2 - 2 * m_gap;
+    // draw the visible tiles, reusing the ones that were drawn before at this zoom level
+    int firstTile = m_scroll / cTileWidth;
+    int lastTile = (m_scroll + width() - 1) / cTileWidth;
+    for (int tile = firstTile; tile <= lastTile; tile++)
+    {
+        QPair<int, int> key(m_lineLength, tile);
+        QPixmap *pTile = m_tiles.object(key);
+        if (pTile == NULL)
+        {
+            pTile = new QPixmap(cTileWidth, m_tileHeight);
+            pTile->fill(Qt::transparent);
 
-        pixmapPainter.setBrush(m_triangleBrushWhite);
-        pixmapPainter.setPen(m_trianglePen);
+            QPainter tilePainter(pTile);
+            tilePainter.translate(-tile * cTileWidth, 0);
+            drawTimelineTile(&tilePainter, tile * cTileWidth, (tile + 1) * cTileWidth);
+            tilePainter.end();
 
-        double minimumOffset = 0;
-        vogleditor_timelineItem *rootItem = m_pModel->get_root_item();
-        for (int c = 0; c < numChildren; c++)
-        {
-            vogleditor_timelineItem *pChild = rootItem->child(c);
-            drawTimelineItem(&pixmapPainter, pChild, i_height, minimumOffset);
+            m_tiles.insert(key, pTile);
         }
-    }
 
-    painter->drawPixmap(event->rect(), *m_pPixmap, m_pPixmap->rect());
+        painter->drawPixmap(tile * cTileWidth - m_scroll, 0, *pTile);
+    }
 
     painter->translate(-m_scroll, 0);
     painter->setBrush(m_triangleBrushWhite);
@@ -351,38 +349,128 @@ double vogleditor_QTimelineView::scalePositionHorizontally(double value)
     return offset;
 }
 
+double vogleditor_QTimelineView::timeAtPosition(double offset)
+{
+    double horizontalShift = m_pModel->get_root_item()->getBeginTime();
+    double horizontalLength = m_pModel->get_root_item()->getDuration();
+
+    return horizontalShift + offset / m_lineLength * horizontalLength;
+}
+
 vogleditor_timelineItem *vogleditor_QTimelineView::itemUnderPos(QPoint pos)
 {
+    if (m_pModel == NULL || m_pModel->get_root_item() == NULL)
+    {
+        return NULL;
+    }
+
     int x=pos.x()+m_scroll-m_gap;
+
+    // look for a span under the position first, then for one within a pixel of it
+    const QVector<vogleditor_timelineItem *> &spans = m_pModel->get_spans();
+    for (int tolerance = 0; tolerance <= 1; tolerance++)
     {
-        QLinkedListIterator<timelineItemPos> i(m_timelineItemPosCache);
-        while (i.hasNext())
+        for (int i = m_pModel->find_first_span(timeAtPosition(x - 1)); i < spans.size(); i++)
         {
-            timelineItemPos itempos = i.next();
-            //See if we have gone beyond the pos
-            if (itempos.leftOffset > x)
+            int leftOffset = scalePositionHorizontally(spans[i]->getBeginTime()) - m_roundoff;
+            if (leftOffset > x + tolerance)
                 break;
-            if (itempos.leftOffset<=x && itempos.rightOffset>=x)
-            {
-                return itempos.pItem;
-            }
+
+            int rightOffset = leftOffset + qMax(scaleDurationHorizontally(spans[i]->getDuration()), 1.0) + m_roundoff;
+            if (rightOffset >= x - tolerance)
+                return spans[i];
         }
     }
+    return NULL;
+}
+
+QBrush vogleditor_QTimelineView::durationBrush(float duration)
+{
+    // color relative to time duration of apicall
+    float durationRatio = duration / m_maxItemDuration;
+    int intensity = std::min(255, (int)(durationRatio * 255.0f));
+    return QBrush(QColor(intensity, 255 - intensity, 0));
+}
+
+void vogleditor_QTimelineView::drawTimelineTile(QPainter *painter, int tileLeft, int tileRight)
+{
+    // translate drawing to vertical center of rect
+    // everything will have a small gap on the left and right sides
+    painter->translate(m_gap, height() / 2);
+    int left = tileLeft - m_gap;
+    int right = tileRight - m_gap;
+
+    int i_height = height() / 2 - 2 * m_gap;
+
+    // frame markers, at most one per pixel
+    painter->setBrush(m_triangleBrushWhite);
+    painter->setPen(m_trianglePen);
+
+    const QVector<vogleditor_timelineItem *> &markers = m_pModel->get_markers();
+    int m = m_pModel->find_first_marker(timeAtPosition(left - 1));
+    while (m < markers.size())
+    {
+        float offset = scalePositionHorizontally(markers[m]->getBeginTime());
+        if (offset > right + 1)
+            break;
+
+        painter->drawLine(QLineF(offset, -i_height, offset, i_height));
+
+        // skip the markers that would be drawn in the same pixel
+        m = qMax(m + 1, m_pModel->find_first_marker(timeAtPosition(floor(offset) + 1)));
+    }
+
+    // When a pixel covers more time than the finest buckets of the model's summary the spans are drawn from the summary,
+    // otherwise only the spans within the tile are drawn.
+    if (timeAtPosition(1) - timeAtPosition(0) > m_pModel->get_bucket_duration())
+    {
+        drawTimelineSummary(painter, left, right, i_height);
+        return;
+    }
+
+    const QVector<vogleditor_timelineItem *> &spans = m_pModel->get_spans();
+    double minimumOffset = left - 1;
+    for (int i = m_pModel->find_first_span(timeAtPosition(left - 1)); i < spans.size(); i++)
     {
-        QLinkedListIterator<timelineItemPos> i(m_timelineItemPosCache);
-        while (i.hasNext())
+        if (scalePositionHorizontally(spans[i]->getBeginTime()) > right + 1)
+            break;
+
+        drawTimelineItem(painter, spans[i], i_height, minimumOffset, left - 1, right + 1);
+    }
+}
+
+void vogleditor_QTimelineView::drawTimelineSummary(QPainter *painter, int left, int right, int height)
+{
+    // don't draw boundary. It can add an extra pixel to rect width
+    painter->setPen(Qt::NoPen);
+
+    // each pixel shows the longest span within it; neighboring pixels that show the same span are drawn together
+    int runStart = left;
+    vogleditor_timelineItem *pRunItem = NULL;
+    for (int x = left; x <= right; x++)
+    {
+        vogleditor_timelineItem *pItem = NULL;
+        if (x < right)
         {
-            timelineItemPos itempos = i.next();
-            if (itempos.leftOffset > x+1)
-                break;
-            if (itempos.leftOffset<= x+1  && itempos.rightOffset>= x-1 )
-                return itempos.pItem;
+            vogleditor_timelineSummary summary = m_pModel->get_summary(timeAtPosition(x), timeAtPosition(x + 1));
+            pItem = summary.pLongestItem;
         }
+
+        if (pItem == pRunItem && x < right)
+            continue;
+
+        if (pRunItem != NULL)
+        {
+            painter->setBrush(pRunItem->getBrush() ? *(pRunItem->getBrush()) : durationBrush(pRunItem->getDuration()));
+            painter->drawRect(QRect(runStart, -height / 2, x - runStart, height));
+        }
+
+        runStart = x;
+        pRunItem = pItem;
     }
-    return NULL;
 }
 
-void vogleditor_QTimelineView::drawTimelineItem(QPainter *painter, vogleditor_timelineItem *pItem, int height, double &minimumOffset)
+void vogleditor_QTimelineView::drawTimelineItem(QPainter *painter, vogleditor_timelineItem *pItem, int height, double &minimumOffset, int left, int right)
 {
     float duration = pItem->getDuration();
     if (duration < 0)
@@ -399,11 +487,11 @@ void vogleditor_QTimelineView::drawTimelineItem(QPainter *painter, vogleditor_ti
     }
     else
     {
-        // only draw if the item will extend beyond the minimum offset and it is on-screen
+        // only draw if the item will extend beyond the minimum offset and it is within the tile
         double leftOffset = scalePositionHorizontally(pItem->getBeginTime());
         double scaledWidth = scaleDurationHorizontally(duration);
         double rightOffset = leftOffset + scaledWidth;
-        if (minimumOffset < rightOffset && rightOffset>m_scroll && leftOffset<m_scroll+width() )
+        if (minimumOffset < rightOffset && rightOffset > left && leftOffset < right)
         {
             // Set brush fill color
             if (pItem->getBrush())
@@ -412,10 +500,7 @@ void vogleditor_QTimelineView::drawTimelineItem(QPainter *painter, vogleditor_ti
             }
             else // create brush with color relative to time duration of apicall
             {
-                float durationRatio = duration / m_maxItemDuration;
-                int intensity = std::min(255, (int)(durationRatio * 255.0f));
-                QColor color(intensity, 255 - intensity, 0);
-                painter->setBrush(QBrush(color));
+                painter->setBrush(durationBrush(duration));
             }
             // don't draw boundary. It can add an extra pixel to rect width
             painter->setPen(Qt::NoPen);
@@ -440,13 +525,6 @@ void vogleditor_QTimelineView::drawTimelineItem(QPainter *painter, vogleditor_ti
             rect.setWidth(durationPx);
             rect.setHeight(height);
             painter->drawRect(rect);
-
-            //Add the position of this item to the timelineItemPosCache for use by itemUnderPos().
-            timelineItemPos itemPos;
-            itemPos.pItem=pItem;
-            itemPos.leftOffset=startTimePx;
-            itemPos.rightOffset=startTimePx+durationPx;
-            m_timelineItemPosCache.append(itemPos);
         }
 
         // If only State/Render groups to display, we're done (if debug groups
@@ -462,7 +540,7 @@ void vogleditor_QTimelineView::drawTimelineItem(QPainter *painter, vogleditor_ti
         int numChildren = pItem->childCount();
         for (int c = 0; c < numChildren; c++)
         {
-            drawTimelineItem(painter, pItem->child(c), height - 1, minimumOffset);
+            drawTimelineItem(painter, pItem->child(c), height - 1, minimumOffset, left, right);
         }
     }
 
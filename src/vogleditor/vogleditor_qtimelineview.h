@@ -35,9 +35,11 @@ class QScrollBar;
 QT_END_NAMESPACE
 
 #include <QBrush>
+#include <QCache>
 #include <QFont>
+#include <QPair>
 #include <QPen>
-#include <QLinkedList>
+#include <QPixmap>
 
 #include "vogleditor_apicalltimelinemodel.h"
 #include "vogleditor_timelineitem.h"
@@ -66,12 +68,10 @@ public:
         m_curApiCallTime=-1;
 
         m_pModel = pModel;        
-        if (m_pModel == NULL)
-        {
-            deletePixmap();
-        }
-        else
+        deleteTiles();
+        if (m_pModel != NULL && m_pModel->get_root_item() != NULL)
         {
+            m_modelRevision = m_pModel->get_revision();
             m_maxItemDuration = m_pModel->get_root_item()->getMaxChildDuration();
             if (m_pModel->get_root_item()->isGroupItem())
                 m_firstCallTime = m_pModel->get_root_item()->getGroupItem()->startTime();
@@ -101,13 +101,9 @@ public:
             m_curApiCallTime=m_pModel->absoluteToRelativeTime(apiCall->startTime());
     }
 
-    void deletePixmap()
+    void deleteTiles()
     {
-        if (m_pPixmap != NULL)
-        {
-            delete m_pPixmap;
-            m_pPixmap = NULL;
-        }
+        m_tiles.clear();
     }
 
 private:
@@ -131,22 +127,23 @@ private:
     int m_gap;
 
     vogleditor_apiCallTimelineModel *m_pModel;
-    QPixmap *m_pPixmap;
+    unsigned int m_modelRevision;
+
+    // The timeline is drawn in tiles of cTileWidth pixels that are kept for each zoom level (line length),
+    // so scrolling only has to draw the tiles that come into view.
+    QCache<QPair<int, int>, QPixmap> m_tiles;
+    int m_tileHeight;
 
     void drawBaseTimeline(QPainter *painter, const QRect &rect, int gap);
-    void drawTimelineItem(QPainter *painter, vogleditor_timelineItem *pItem, int height, double &minimumOffset);
+    void drawTimelineTile(QPainter *painter, int tileLeft, int tileRight);
+    void drawTimelineSummary(QPainter *painter, int left, int right, int height);
+    void drawTimelineItem(QPainter *painter, vogleditor_timelineItem *pItem, int height, double &minimumOffset, int left, int right);
+    QBrush durationBrush(float duration);
 
     double scaleDurationHorizontally(double value);
     double scalePositionHorizontally(double value);
+    double timeAtPosition(double offset);
     vogleditor_timelineItem* itemUnderPos(QPoint pos);
-
-    struct timelineItemPos
-    {
-        vogleditor_timelineItem *pItem;
-        int leftOffset;
-        int rightOffset;
-    };
-    QLinkedList<timelineItemPos> m_timelineItemPosCache;
 public slots:
     void scrollToPx(int scroll);
     void resetZoom();
@@ -37,6 +37,7 @@ GCC_DIAGNOSTIC_POP()
 #include "vogl_gl_state_snapshot.h"
 #include "vogl_vao_state.h"
 
+#include "vogleditor_qvertexarraytablemodel.h"
 #include "vogleditor_qvertexvisualizer.h"
 
 Q_DECLARE_METATYPE(vogl_vao_state *);
@@ -54,10 +55,21 @@ vogleditor_QVertexArrayExplorer::vogleditor_QVertexArrayExplorer(QWidget *parent
       m_currentCallElementBaseVertex(0),
       m_currentCallElementIndices(NULL),
       m_currentCallInstanceCount(0),
-      m_currentCallBaseInstance(0)
+      m_currentCallBaseInstance(0),
+      m_pVertexTableModel(NULL),
+      m_pInstanceTableModel(NULL)
 {
     ui->setupUi(this);
 
+    // rows are formatted on demand, so keep the row heights fixed to avoid measuring every row
+    m_pVertexTableModel = new vogleditor_QVertexArrayTableModel(this);
+    ui->vertexTableView->setModel(m_pVertexTableModel);
+    ui->vertexTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+
+    m_pInstanceTableModel = new vogleditor_QVertexArrayTableModel(this);
+    ui->instancedVertexTableView->setModel(m_pInstanceTableModel);
+    ui->instancedVertexTableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+
     beginUpdate();
     ui->elementTypeComboBox->addItem("GL_UNSIGNED_BYTE");
     ui->elementTypeComboBox->addItem("GL_UNSIGNED_SHORT");
@@ -103,7 +115,11 @@ void vogleditor_QVertexArrayExplorer::clear()
     m_currentCallBaseInstance = 0;
 
     ui->vertexArrayComboBox->clear();
-    ui->vertexTableWidget->clear();
+    m_pVertexTableModel->clear();
+    m_pInstanceTableModel->clear();
+
+    // the buffers belong to the snapshot, which may be deleted after this
+    m_vertexDataCache.release_buffers();
 }
 
 uint vogleditor_QVertexArrayExplorer::set_vertexarray_objects(vogl_context_snapshot *pContext, vogl::vector<vogl_context_snapshot *> sharingContexts)
@@ -114,7 +130,9 @@ uint vogleditor_QVertexArrayExplorer::set_vertexarray_objects(vogl_context_snaps
     m_pVaoElementArray = NULL;
 
     ui->vertexArrayComboBox->clear();
-    ui->vertexTableWidget->clear();
+    m_pVertexTableModel->clear();
+    m_pInstanceTableModel->clear();
+    m_vertexDataCache.release_buffers();
 
     m_sharing_contexts = sharingContexts;
 
@@ -251,290 +269,6 @@ void vogleditor_QVertexArrayExplorer::auto_update_element_count()
     }
 }
 
-QString vogleditor_QVertexArrayExplorer::format_buffer_data_as_string(uint32_t index, const vogl_buffer_state &bufferState, const vogl_vertex_attrib_desc &attribDesc)
-{
-    /*
-    attribDesc.m_size; // number of components
-    attribDesc.m_type; // byte, unsigned byte, short, ushort, int, uint (accepted by VertexAttribPointer and VertexAttribIPointer);
-                       // half_float, float, double, fixed, Int2101010Rev, Uint2101010Rev, & uint10f11f11fRev also accepted by glVertexAttribPointer;
-                       // double is accepted by glVertexAttribLPointer only (no other types are allowed for that call)
-    attribDesc.m_normalized; // indicates that fixed-point data should be normalized when they are accessed (otherwise leave as fixed-point)
-    attribDesc.m_stride; // Specifies the byte offset between consecutive generic vertex attributes. If stride is 0, the generic vertex attributes are understood to be tightly packed in the array.
-    attribDesc.m_pointer; // Specifies a offset of the first component of the first generic vertex attribute in the array in the data store of the buffer currently bound to the GL_ARRAY_BUFFER target.
-
-    attribDesc.m_divisor; // Specify the number of instances that will pass between updates of the generic attribute at slot index.
-                          // glVertexAttribDivisor modifies the rate at which generic vertex attributes advance when rendering multiple instances of primitives in a single draw call. If divisor is zero, the attribute at slot index advances once per vertex. If divisor is non-zero, the attribute advances once per divisor instances of the set(s) of vertices being rendered. An attribute is referred to as instanced if its GL_VERTEX_ATTRIB_ARRAY_DIVISOR value is non-zero.
-    attribDesc.m_integer; // True if glVertexAttribIPointer is used; values should remain as integer when sent to shader.
-*/
-
-    uint32_t bytesPerComponent = vogl_get_gl_type_size(attribDesc.m_type);
-    uint32_t bytesPerAttribute = bytesPerComponent * attribDesc.m_size;
-
-    uint32_t stride = (attribDesc.m_stride != 0) ? attribDesc.m_stride : bytesPerAttribute;
-
-    // account for divisor
-    if (attribDesc.m_divisor != 0)
-    {
-        index /= attribDesc.m_divisor;
-    }
-
-    uint32_t curAttributeDataIndex = stride * index;
-
-    // make sure accessing this attribute's components will not read past the end of the buffer
-    uint32_t bufferSize = bufferState.get_buffer_data().size();
-    if (index > bufferSize ||
-        curAttributeDataIndex > bufferSize ||
-        curAttributeDataIndex + bytesPerAttribute > bufferSize)
-    {
-        return "Out of bounds";
-    }
-
-    // index into the buffer
-    const uint8_t *pCurAttributeData = &(bufferState.get_buffer_data()[curAttributeDataIndex]);
-
-    // print each component
-    dynamic_string attributeValueString;
-    if (attribDesc.m_size > 1)
-        attributeValueString += "{ ";
-
-    for (int i = 0; i < attribDesc.m_size; i++)
-    {
-        // print the data appropriately
-        if (attribDesc.m_type == GL_BYTE)
-        {
-            int8_t *pData = (int8_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-            {
-                attributeValueString.format_append("%hhd", *pData);
-            }
-            else
-            {
-                float normalized = (float)*pData / (float)SCHAR_MAX;
-                attributeValueString.format_append("%.8g", normalized);
-            }
-        }
-        else if (attribDesc.m_type == GL_UNSIGNED_BYTE)
-        {
-            uint8_t *pData = (uint8_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-            {
-                attributeValueString.format_append("%hhu", *pData);
-            }
-            else
-            {
-                float normalized = (float)*pData / (float)UCHAR_MAX;
-                attributeValueString.format_append("%.8g", normalized);
-            }
-        }
-        else if (attribDesc.m_type == GL_SHORT)
-        {
-            int16_t *pData = (int16_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-            {
-                attributeValueString.format_append("%hd", *pData);
-            }
-            else
-            {
-                float normalized = (float)*pData / (float)SHRT_MAX;
-                attributeValueString.format_append("%.8g", normalized);
-            }
-        }
-        else if (attribDesc.m_type == GL_UNSIGNED_SHORT)
-        {
-            uint16_t *pData = (uint16_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-            {
-                attributeValueString.format_append("%hu", *pData);
-            }
-            else
-            {
-                float normalized = (float)*pData / (float)USHRT_MAX;
-                attributeValueString.format_append("%.8g", normalized);
-            }
-        }
-        else if (attribDesc.m_type == GL_INT)
-        {
-            int32_t *pData = (int32_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-            {
-                attributeValueString.format_append("%d", *pData);
-            }
-            else
-            {
-                float normalized = (float)*pData / (float)INT_MAX;
-                attributeValueString.format_append("%.8g", normalized);
-            }
-        }
-        else if (attribDesc.m_type == GL_UNSIGNED_INT)
-        {
-            uint32_t *pData = (uint32_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-            {
-                attributeValueString.format_append("%u", *pData);
-            }
-            else
-            {
-                float normalized = (float)*pData / (float)UINT_MAX;
-                attributeValueString.format_append("%.8g", normalized);
-            }
-        }
-        else if (attribDesc.m_type == GL_FLOAT)
-        {
-            float *pData = (float *)pCurAttributeData;
-            attributeValueString.format_append("%.8g", *pData);
-        }
-        else if (attribDesc.m_type == GL_DOUBLE)
-        {
-            double *pData = (double *)pCurAttributeData;
-            attributeValueString.format_append("%.17g", *pData);
-        }
-        else
-        {
-            // half-float, fixed, int_2_10_10_10_REV, UINT_2_10_10_10_REV, UINT_10F_11F_11F_REV
-            attributeValueString.append("unhandled format");
-        }
-
-        // add comma if needed
-        if (i < attribDesc.m_size - 1)
-            attributeValueString += ", ";
-
-        pCurAttributeData += bytesPerComponent;
-    }
-
-    if (attribDesc.m_size > 1)
-        attributeValueString += " }";
-
-    return attributeValueString.c_str();
-}
-
-QVector3D vogleditor_QVertexArrayExplorer::buffer_data_to_QVector3D(uint32_t index, const vogl_buffer_state &bufferState, const vogl_vertex_attrib_desc &attribDesc)
-{
-    //Works like format_buffer_data_as_string but returns QVector3D
-
-    uint32_t bytesPerComponent = vogl_get_gl_type_size(attribDesc.m_type);
-    uint32_t bytesPerAttribute = bytesPerComponent * attribDesc.m_size;
-
-    uint32_t stride = (attribDesc.m_stride != 0) ? attribDesc.m_stride : bytesPerAttribute;
-
-    // account for divisor
-    if (attribDesc.m_divisor != 0)
-    {
-        index /= attribDesc.m_divisor;
-    }
-
-    uint32_t curAttributeDataIndex = stride * index;
-
-    // make sure accessing this attribute's components will not read past the end of the buffer
-    uint32_t bufferSize = bufferState.get_buffer_data().size();
-    if (index > bufferSize ||
-        curAttributeDataIndex > bufferSize ||
-        curAttributeDataIndex + bytesPerAttribute > bufferSize)
-    {
-        return QVector3D();
-    }
-
-    // index into the buffer
-    const uint8_t *pCurAttributeData = &(bufferState.get_buffer_data()[curAttributeDataIndex]);
-
-    float values[3];
-    for (int i = 0; (i < attribDesc.m_size) && (i < 3); i++)
-    {
-        values[i]=0;
-        // convert the data appropriately
-        if (attribDesc.m_type == GL_BYTE)
-        {
-            int8_t *pData = (int8_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-                values[i]=(float)*pData;
-            else
-            {
-                float normalized = (float)*pData / (float)SCHAR_MAX;
-                values[i]=normalized;
-            }
-        }
-        else if (attribDesc.m_type == GL_UNSIGNED_BYTE)
-        {
-            uint8_t *pData = (uint8_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-                values[i]=(float)*pData;
-            else
-            {
-                float normalized = (float)*pData / (float)UCHAR_MAX;
-                values[i]=normalized;
-            }
-        }
-        else if (attribDesc.m_type == GL_SHORT)
-        {
-            int16_t *pData = (int16_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-                values[i]=(float)*pData;
-            else
-            {
-                float normalized = (float)*pData / (float)SHRT_MAX;
-                values[i]=normalized;
-            }
-        }
-        else if (attribDesc.m_type == GL_UNSIGNED_SHORT)
-        {
-            uint16_t *pData = (uint16_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-                values[i]=(float)*pData;
-            else
-            {
-                float normalized = (float)*pData / (float)USHRT_MAX;
-                values[i]=normalized;
-            }
-        }
-        else if (attribDesc.m_type == GL_INT)
-        {
-            int32_t *pData = (int32_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-                values[i]=(float)*pData;
-            else
-            {
-                float normalized = (float)*pData / (float)INT_MAX;
-                values[i]=normalized;
-            }
-        }
-        else if (attribDesc.m_type == GL_UNSIGNED_INT)
-        {
-            uint32_t *pData = (uint32_t *)pCurAttributeData;
-            if (!attribDesc.m_normalized)
-                values[i]=(float)*pData;
-            else
-            {
-                float normalized = (float)*pData / (float)UINT_MAX;
-                values[i]=normalized;
-            }
-        }
-        else if (attribDesc.m_type == GL_FLOAT)
-        {
-            float *pData = (float *)pCurAttributeData;
-            values[i]=*pData;
-        }
-        else if (attribDesc.m_type == GL_DOUBLE)
-        {
-            double *pData = (double *)pCurAttributeData;
-            values[i]=(float)*pData;
-        }
-//        else
-//        {
-            // half-float, fixed, int_2_10_10_10_REV, UINT_2_10_10_10_REV, UINT_10F_11F_11F_REV
-//        }
-        pCurAttributeData += bytesPerComponent;
-    }
-
-    QVector3D vertex;
-    vertex.setX(values[0]);
-    if (attribDesc.m_size>1)
-        vertex.setY(values[1]);
-    if (attribDesc.m_size>2)
-        vertex.setZ(values[2]);
-    return vertex;
-//    return attributeValueString.c_str();
-
-}
-
 void vogleditor_QVertexArrayExplorer::on_vertexArrayComboBox_currentIndexChanged(int index)
 {
     if (index < 0 || index >= ui->vertexArrayComboBox->count())
@@ -570,68 +304,6 @@ void vogleditor_QVertexArrayExplorer::on_vertexArrayComboBox_currentIndexChanged
     }
 }
 
-bool vogleditor_QVertexArrayExplorer::calculate_element_and_format_as_string(const uint8_vec *pElementArray, uint32_t index, int typeIndex, int byteOffset, int baseVertex, uint32_t &elementValue, QString &elementString)
-{
-    if (pElementArray != NULL)
-    {
-        if (typeIndex == 0)
-        {
-            // GL_UNSIGNED_BYTE
-            if (byteOffset + sizeof(uint8_t) * (index + 1) > pElementArray->size_in_bytes())
-            {
-                elementString = "Out of bounds";
-                return false;
-            }
-            else
-            {
-                elementValue = ((uint8_t *)(pElementArray->get_ptr() + byteOffset))[index];
-            }
-        }
-        else if (typeIndex == 1)
-        {
-            // GL_UNSIGNED_SHORT
-            if (byteOffset + sizeof(uint16_t) * (index + 1) > pElementArray->size_in_bytes())
-            {
-                elementString = "Out of bounds";
-                return false;
-            }
-            else
-            {
-                elementValue = ((uint16_t *)(pElementArray->get_ptr() + byteOffset))[index];
-            }
-        }
-        else if (typeIndex == 2)
-        {
-            // GL_UNSIGNED_INT
-            if (byteOffset + sizeof(uint32_t) * (index + 1) > pElementArray->size_in_bytes())
-            {
-                elementString = "Out of bounds";
-                return false;
-            }
-            else
-            {
-                elementValue = ((uint32_t *)(pElementArray->get_ptr() + byteOffset))[index];
-            }
-        }
-        else
-        {
-            VOGL_ASSERT(!"Invalid type index supplied to calculate_element_and_format_as_string");
-            // invalid option, so bail out
-            return false;
-        }
-    }
-    else
-    {
-        elementValue = index;
-    }
-
-    // add baseVertex to the vertex index
-    elementValue += baseVertex;
-
-    elementString = QString::number(elementValue);
-    return true;
-}
-
 void vogleditor_QVertexArrayExplorer::update_array_table_headers()
 {
     // get all the accessible buffers
@@ -680,49 +352,41 @@ void vogleditor_QVertexArrayExplorer::update_array_table_headers()
         }
     }
 
-    // this will store the column labels
-    QStringList headers;
-    QStringList instancedHeaders;
-
     if (m_pVaoElementArray != NULL)
     {
-        headers << QString("Element Buffer %1").arg(elementArrayBufferHandle);
+        m_pVertexTableModel->set_element_header(QString("Element Buffer %1").arg(elementArrayBufferHandle));
     }
     else if (m_currentCallElementIndices != NULL)
     {
-        headers << QString("Indices (Client Array)");
+        m_pVertexTableModel->set_element_header(QString("Indices (Client Array)"));
     }
     else
     {
-        headers << QString("Implied Indices");
+        m_pVertexTableModel->set_element_header(QString("Implied Indices"));
     }
 
-    instancedHeaders << QString("InstanceId");
+    m_pInstanceTableModel->set_element_header(QString("InstanceId"));
     uint instancedCount = 0;
     for (uint b = 0; b < m_attrib_buffers.size(); b++)
     {
         if (m_attrib_buffers[b] != NULL)
         {
+            const vogl_vertex_attrib_desc &attribDesc = m_pVaoState->get_vertex_attrib_desc(b);
+            QString header = QString("Attrib %1 (Buffer %2)").arg(b).arg(m_attrib_buffers[b]->get_snapshot_handle());
+
             // determine whether this attrib is per-vertex or per-instance
-            if (m_pVaoState->get_vertex_attrib_desc(b).m_divisor == 0)
+            if (attribDesc.m_divisor == 0)
             {
-                headers << QString("Attrib %1 (Buffer %2)").arg(b).arg(m_attrib_buffers[b]->get_snapshot_handle());
+                m_pVertexTableModel->add_attrib_column(header, m_attrib_buffers[b], attribDesc);
             }
             else
             {
-                instancedHeaders << QString("Attrib %1 (Buffer %2)").arg(b).arg(m_attrib_buffers[b]->get_snapshot_handle());
+                m_pInstanceTableModel->add_attrib_column(header, m_attrib_buffers[b], attribDesc);
                 instancedCount++;
             }
         }
     }
 
-    // set column headers
-    ui->vertexTableWidget->setColumnCount(headers.size());
-    ui->vertexTableWidget->setHorizontalHeaderLabels(headers);
-
-    ui->instancedVertexTableWidget->setColumnCount(instancedHeaders.size());
-    ui->instancedVertexTableWidget->setHorizontalHeaderLabels(instancedHeaders);
-
     if (instancedCount == 0)
     {
         // no instanced vertex data, so collapse the view
@@ -757,51 +421,19 @@ void vogleditor_QVertexArrayExplorer::update_vertex_array_table()
         }
     }
 
-    // Populate each row of the table
-    int32_t indexCount = ui->countSpinBox->value();
-    ui->vertexTableWidget->setRowCount(indexCount);
-    for (int i = 0; i < indexCount; i++)
-    {
-        uint32_t elementIndex = i;
-
-        int byteOffset = ui->byteOffsetSpinBox->value();
-        int baseVertex = ui->baseVertexSpinBox->value();
-
-        QString elementString;
-
-        bool bValidElement = calculate_element_and_format_as_string(pElementArray, elementIndex, ui->elementTypeComboBox->currentIndex(), byteOffset, baseVertex, elementIndex, elementString);
+    // Decode the indices once; the table and the visualizations both read them
+    uint32_t indexCount = ui->countSpinBox->value();
+    vogleditor_vertexDataCache::decode_elements(pElementArray, ui->elementTypeComboBox->currentIndex(), ui->byteOffsetSpinBox->value(), ui->baseVertexSpinBox->value(), indexCount, m_elements);
 
-        // populated element index value
-        ui->vertexTableWidget->setItem(i, 0, new QTableWidgetItem(elementString));
-
-        // populate attrib values
-        // column 0 contains element indices, so start at appropriate column
-        uint column = 1;
-        for (uint b = 0; b < m_attrib_buffers.size(); b++)
-        {
-            // make sure buffer is available and that divisor is 0 (which means it is NOT a per-instance attribute)
-            if (m_attrib_buffers[b] != NULL && m_pVaoState->get_vertex_attrib_desc(b).m_divisor == 0)
-            {
-                if (bValidElement)
-                {
-                    ui->vertexTableWidget->setItem(i, column, new QTableWidgetItem(format_buffer_data_as_string(elementIndex, *(m_attrib_buffers[b]), m_pVaoState->get_vertex_attrib_desc(b))));
-                }
-                else
-                {
-                    ui->vertexTableWidget->setItem(i, column, new QTableWidgetItem("Out of bounds"));
-                }
-                column++;
-            }
-        }
-    }
+    m_pVertexTableModel->set_rows(indexCount, m_elements.m_elements);
 
     // resize columns to fit contents, but then reset back to interactive so the user can resize them manually
-    for (int i = 0; i < ui->vertexTableWidget->columnCount(); i++)
+    for (int i = 0; i < m_pVertexTableModel->columnCount(); i++)
     {
-        ui->vertexTableWidget->horizontalHeader()->setSectionResizeMode(i, QHeaderView::ResizeToContents);
-        uint tmpWidth = ui->vertexTableWidget->horizontalHeader()->sectionSize(i);
-        ui->vertexTableWidget->horizontalHeader()->setSectionResizeMode(i, QHeaderView::Interactive);
-        ui->vertexTableWidget->horizontalHeader()->resizeSection(i, tmpWidth);
+        ui->vertexTableView->horizontalHeader()->setSectionResizeMode(i, QHeaderView::ResizeToContents);
+        uint tmpWidth = ui->vertexTableView->horizontalHeader()->sectionSize(i);
+        ui->vertexTableView->horizontalHeader()->setSectionResizeMode(i, QHeaderView::Interactive);
+        ui->vertexTableView->horizontalHeader()->resizeSection(i, tmpWidth);
     }
 
     update_vertex_array_visualizations();
@@ -840,46 +472,33 @@ void vogleditor_QVertexArrayExplorer::update_vertex_array_visualizations()
         }
     }
 
-    // Identify the correct element array to reference
-    const uint8_vec *pElementArray = m_pVaoElementArray;
-    if (pElementArray == NULL)
-    {
-        if (m_currentCallElementIndices != NULL)
-        {
-            pElementArray = m_currentCallElementIndices;
-        }
-        else
-        {
-            // no element array means there will be implied indices (ie, in the case of glDrawArrays)
-            pElementArray = NULL;
-        }
-    }
-
-    int32_t indexCount = ui->countSpinBox->value();
-    int byteOffset = ui->byteOffsetSpinBox->value();
-    int baseVertex = ui->baseVertexSpinBox->value();
-    int elementType = ui->elementTypeComboBox->currentIndex();
-    QString elementString;
+    // the elements were decoded by update_vertex_array_table(); vertices stop at the first element that is out of bounds
+    const QVector<uint32_t> &elements = m_elements.m_elements;
     for (uint b = 0; b < attrib_buffers_to_render.size(); b++)
     {
-        QString label = QString("Attrib %1 (Buffer %2)").arg(b).arg(m_attrib_buffers[attrib_buffers_to_render[b]]->get_snapshot_handle());
+        uint attrib = attrib_buffers_to_render[b];
+        const vogl_vertex_attrib_desc &attribDesc = m_pVaoState->get_vertex_attrib_desc(attrib);
+
+        QString label = QString("Attrib %1 (Buffer %2)").arg(attrib).arg(m_attrib_buffers[attrib]->get_snapshot_handle());
         m_vertexVisualizers.at(b)->setLabel(label);
         m_vertexVisualizers.at(b)->setDrawMode(m_currentCallDrawMode);
+
+        vogleditor_decodedAttrib decoded;
+        m_vertexDataCache.get_attrib(*(m_attrib_buffers[attrib]), attribDesc, decoded);
+
         //Add the vertex values
-        QVector<QVector3D> vertices;
-        for (int i = 0; i < indexCount; i++)
+        QVector<QVector3D> vertices(elements.size());
+        const float *pValues = decoded.m_values.constData();
+        for (int i = 0; i < elements.size(); i++)
         {
-            uint32_t elementIndex = i;
-            //We should not have to format the element as a string in order to work out if it is valid:
-            bool bValidElement = calculate_element_and_format_as_string(pElementArray, elementIndex, elementType, byteOffset, baseVertex, elementIndex, elementString);
-            if (bValidElement)
+            // out of bounds attributes are left at the origin
+            if (elements[i] < decoded.m_vertexCount)
             {
-//                QString vertexstring = format_buffer_data_as_string(elementIndex, *(m_attrib_buffers[attrib_buffers_to_render[b]]), m_pVaoState->get_vertex_attrib_desc(b));
-                QVector3D vertex = buffer_data_to_QVector3D(elementIndex, *(m_attrib_buffers[attrib_buffers_to_render[b]]), m_pVaoState->get_vertex_attrib_desc(b));
-                vertices.push_back(vertex);
+                const float *pVertex = pValues + elements[i] * decoded.m_components;
+                vertices[i] = QVector3D(pVertex[0],
+                                        (decoded.m_components > 1) ? pVertex[1] : 0.0f,
+                                        (decoded.m_components > 2) ? pVertex[2] : 0.0f);
             }
-            else
-                break;
         }
         m_vertexVisualizers.at(b)->setVertices(vertices);
     }
@@ -889,41 +508,20 @@ void vogleditor_QVertexArrayExplorer::update_instance_array_table()
 {
     QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-    // Populate each row of the table
+    // Instance ids are implied, so they never run out of bounds; the divisor is applied per attribute
     uint32_t instanceCount = ui->instanceCountSpinBox->value();
-    ui->instancedVertexTableWidget->setRowCount(instanceCount);
-    for (uint32_t i = 0; i < instanceCount; i++)
-    {
-        int baseInstance = ui->baseInstanceSpinBox->value();
-
-        uint32_t instanceIndex = baseInstance + i;
-
-        QString instanceString = QString::number(instanceIndex);
+    vogleditor_decodedElements instances;
+    vogleditor_vertexDataCache::decode_elements(NULL, 0, 0, ui->baseInstanceSpinBox->value(), instanceCount, instances);
 
-        // populated element index value
-        ui->instancedVertexTableWidget->setItem(i, 0, new QTableWidgetItem(instanceString));
-
-        // populate attrib values
-        // column 0 contains instance Ids, so start at appropriate column
-        uint column = 1;
-        for (uint b = 0; b < m_attrib_buffers.size(); b++)
-        {
-            // make sure buffer is available and that divisor is NON-ZERO (which means it IS a per-instance attribute)
-            if (m_attrib_buffers[b] != NULL && this->m_pVaoState->get_vertex_attrib_desc(b).m_divisor != 0)
-            {
-                ui->instancedVertexTableWidget->setItem(i, column, new QTableWidgetItem(format_buffer_data_as_string(instanceIndex, *(m_attrib_buffers[b]), m_pVaoState->get_vertex_attrib_desc(b))));
-                column++;
-            }
-        }
-    }
+    m_pInstanceTableModel->set_rows(instanceCount, instances.m_elements);
 
     // resize columns to fit contents, but then reset back to interactive so the user can resize them manually
-    for (int i = 0; i < ui->instancedVertexTableWidget->columnCount(); i++)
+    for (int i = 0; i < m_pInstanceTableModel->columnCount(); i++)
     {
-        ui->instancedVertexTableWidget->horizontalHeader()->setSectionResizeMode(i, QHeaderView::ResizeToContents);
-        uint tmpWidth = ui->instancedVertexTableWidget->horizontalHeader()->sectionSize(i);
-        ui->instancedVertexTableWidget->horizontalHeader()->setSectionResizeMode(i, QHeaderView::Interactive);
-        ui->instancedVertexTableWidget->horizontalHeader()->resizeSection(i, tmpWidth);
+        ui->instancedVertexTableView->horizontalHeader()->setSectionResizeMode(i, QHeaderView::ResizeToContents);
+        uint tmpWidth = ui->instancedVertexTableView->horizontalHeader()->sectionSize(i);
+        ui->instancedVertexTableView->horizontalHeader()->setSectionResizeMode(i, QHeaderView::Interactive);
+        ui->instancedVertexTableView->horizontalHeader()->resizeSection(i, tmpWidth);
     }
 
     QApplication::restoreOverrideCursor();
@@ -5,6 +5,7 @@
 #include "vogl_core.h"
 #include "gl_types.h"
 #include "vogleditor_output.h"
+#include "vogleditor_vertexdatacache.h"
 #include <QVector3D>
 
 class vogl_buffer_state;
@@ -15,6 +16,7 @@ typedef vogl::vector<vogl_gl_object_state *> vogl_gl_object_state_ptr_vec;
 struct vogl_vertex_attrib_desc;
 
 class vogleditor_QVertexVisualizer;
+class vogleditor_QVertexArrayTableModel;
 
 namespace Ui
 {
@@ -101,11 +103,14 @@ private:
     void update_instance_array_table();
     void update_vertex_array_visualizations();
 
-    bool calculate_element_and_format_as_string(const vogl::uint8_vec *pElementArray, uint32_t index, int typeIndex, int byteOffset, int baseVertex, uint32_t &elementValue, QString &elementString);
-    QString format_buffer_data_as_string(uint32_t index, const vogl_buffer_state &bufferState, const vogl_vertex_attrib_desc &attribDesc);
-
     vogl::vector<vogleditor_QVertexVisualizer*> m_vertexVisualizers;
-    QVector3D buffer_data_to_QVector3D(uint32_t index, const vogl_buffer_state &bufferState, const vogl_vertex_attrib_desc &attribDesc);
+
+    vogleditor_QVertexArrayTableModel *m_pVertexTableModel;
+    vogleditor_QVertexArrayTableModel *m_pInstanceTableModel;
+
+    // decoded attributes are kept across snapshots, so stepping through draw calls that use the same buffers doesn't decode them again
+    vogleditor_vertexDataCache m_vertexDataCache;
+    vogleditor_decodedElements m_elements;
 };
 
 #endif // VOGLEDITOR_QVERTEXARRAYEXPLORER_H
@@ -0,0 +1,268 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+#include "vogleditor_qvertexarraytablemodel.h"
+
+#include "vogl_gl_object.h"
+#include "vogl_buffer_state.h"
+
+vogleditor_QVertexArrayTableModel::vogleditor_QVertexArrayTableModel(QObject *parent)
+    : QAbstractTableModel(parent),
+      m_rowCount(0)
+{
+}
+
+void vogleditor_QVertexArrayTableModel::clear()
+{
+    beginResetModel();
+    m_headers.clear();
+    m_columns.clear();
+    m_rowCount = 0;
+    m_elements.clear();
+    endResetModel();
+}
+
+void vogleditor_QVertexArrayTableModel::set_element_header(const QString &header)
+{
+    beginResetModel();
+    m_headers.clear();
+    m_headers << header;
+    m_columns.clear();
+    endResetModel();
+}
+
+void vogleditor_QVertexArrayTableModel::add_attrib_column(const QString &header, const vogl_buffer_state *pBufferState, const vogl_vertex_attrib_desc &attribDesc)
+{
+    attrib_column column;
+    column.m_pBufferState = pBufferState;
+    column.m_attribDesc = attribDesc;
+
+    beginInsertColumns(QModelIndex(), m_headers.size(), m_headers.size());
+    m_headers << header;
+    m_columns.append(column);
+    endInsertColumns();
+}
+
+void vogleditor_QVertexArrayTableModel::set_rows(uint32_t rowCount, const QVector<uint32_t> &elements)
+{
+    beginResetModel();
+    m_rowCount = rowCount;
+    m_elements = elements;
+    endResetModel();
+}
+
+int vogleditor_QVertexArrayTableModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_rowCount;
+}
+
+int vogleditor_QVertexArrayTableModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+
+    return m_headers.size();
+}
+
+QVariant vogleditor_QVertexArrayTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    if (index.row() >= m_elements.size())
+        return QString("Out of bounds");
+
+    uint32_t element = m_elements[index.row()];
+    if (index.column() == 0)
+        return QString::number(element);
+
+    const attrib_column &column = m_columns[index.column() - 1];
+    return format_buffer_data_as_string(element, *(column.m_pBufferState), column.m_attribDesc);
+}
+
+QVariant vogleditor_QVertexArrayTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section < m_headers.size())
+        return m_headers[section];
+
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
+
+QString vogleditor_QVertexArrayTableModel::format_buffer_data_as_string(uint32_t index, const vogl_buffer_state &bufferState, const vogl_vertex_attrib_desc &attribDesc)
+{
+    /*
+    attribDesc.m_size; // number of components
+    attribDesc.m_type; // byte, unsigned byte, short, ushort, int, uint (accepted by VertexAttribPointer and VertexAttribIPointer);
+                       // half_float, float, double, fixed, Int2101010Rev, Uint2101010Rev, & uint10f11f11fRev also accepted by glVertexAttribPointer;
+                       // double is accepted by glVertexAttribLPointer only (no other types are allowed for that call)
+    attribDesc.m_normalized; // indicates that fixed-point data should be normalized when they are accessed (otherwise leave as fixed-point)
+    attribDesc.m_stride; // Specifies the byte offset between consecutive generic vertex attributes. If stride is 0, the generic vertex attributes are understood to be tightly packed in the array.
+    attribDesc.m_pointer; // Specifies a offset of the first component of the first generic vertex attribute in the array in the data store of the buffer currently bound to the GL_ARRAY_BUFFER target.
+
+    attribDesc.m_divisor; // Specify the number of instances that will pass between updates of the generic attribute at slot index.
+                          // glVertexAttribDivisor modifies the rate at which generic vertex attributes advance when rendering multiple instances of primitives in a single draw call. If divisor is zero, the attribute at slot index advances once per vertex. If divisor is non-zero, the attribute advances once per divisor instances of the set(s) of vertices being rendered. An attribute is referred to as instanced if its GL_VERTEX_ATTRIB_ARRAY_DIVISOR value is non-zero.
+    attribDesc.m_integer; // True if glVertexAttribIPointer is used; values should remain as integer when sent to shader.
+*/
+
+    uint32_t bytesPerComponent = vogl_get_gl_type_size(attribDesc.m_type);
+    uint32_t bytesPerAttribute = bytesPerComponent * attribDesc.m_size;
+
+    uint32_t stride = (attribDesc.m_stride != 0) ? attribDesc.m_stride : bytesPerAttribute;
+
+    // account for divisor
+    if (attribDesc.m_divisor != 0)
+    {
+        index /= attribDesc.m_divisor;
+    }
+
+    uint64_t curAttributeDataIndex = attribDesc.m_pointer + (uint64_t)stride * index;
+
+    // make sure accessing this attribute's components will not read past the end of the buffer
+    uint32_t bufferSize = bufferState.get_buffer_data().size();
+    if (curAttributeDataIndex + bytesPerAttribute > bufferSize)
+    {
+        return "Out of bounds";
+    }
+
+    // index into the buffer
+    const uint8_t *pCurAttributeData = &(bufferState.get_buffer_data()[curAttributeDataIndex]);
+
+    // print each component
+    dynamic_string attributeValueString;
+    if (attribDesc.m_size > 1)
+        attributeValueString += "{ ";
+
+    for (int i = 0; i < attribDesc.m_size; i++)
+    {
+        // print the data appropriately
+        if (attribDesc.m_type == GL_BYTE)
+        {
+            int8_t *pData = (int8_t *)pCurAttributeData;
+            if (!attribDesc.m_normalized)
+            {
+                attributeValueString.format_append("%hhd", *pData);
+            }
+            else
+            {
+                float normalized = (float)*pData / (float)SCHAR_MAX;
+                attributeValueString.format_append("%.8g", normalized);
+            }
+        }
+        else if (attribDesc.m_type == GL_UNSIGNED_BYTE)
+        {
+            uint8_t *pData = (uint8_t *)pCurAttributeData;
+            if (!attribDesc.m_normalized)
+            {
+                attributeValueString.format_append("%hhu", *pData);
+            }
+            else
+            {
+                float normalized = (float)*pData / (float)UCHAR_MAX;
+                attributeValueString.format_append("%.8g", normalized);
+            }
+        }
+        else if (attribDesc.m_type == GL_SHORT)
+        {
+            int16_t *pData = (int16_t *)pCurAttributeData;
+            if (!attribDesc.m_normalized)
+            {
+                attributeValueString.format_append("%hd", *pData);
+            }
+            else
+            {
+                float normalized = (float)*pData / (float)SHRT_MAX;
+                attributeValueString.format_append("%.8g", normalized);
+            }
+        }
+        else if (attribDesc.m_type == GL_UNSIGNED_SHORT)
+        {
+            uint16_t *pData = (uint16_t *)pCurAttributeData;
+            if (!attribDesc.m_normalized)
+            {
+                attributeValueString.format_append("%hu", *pData);
+            }
+            else
+            {
+                float normalized = (float)*pData / (float)USHRT_MAX;
+                attributeValueString.format_append("%.8g", normalized);
+            }
+        }
+        else if (attribDesc.m_type == GL_INT)
+        {
+            int32_t *pData = (int32_t *)pCurAttributeData;
+            if (!attribDesc.m_normalized)
+            {
+                attributeValueString.format_append("%d", *pData);
+            }
+            else
+            {
+                float normalized = (float)*pData / (float)INT_MAX;
+                attributeValueString.format_append("%.8g", normalized);
+            }
+        }
+        else if (attribDesc.m_type == GL_UNSIGNED_INT)
+        {
+            uint32_t *pData = (uint32_t *)pCurAttributeData;
+            if (!attribDesc.m_normalized)
+            {
+                attributeValueString.format_append("%u", *pData);
+            }
+            else
+            {
+                float normalized = (float)*pData / (float)UINT_MAX;
+                attributeValueString.format_append("%.8g", normalized);
+            }
+        }
+        else if (attribDesc.m_type == GL_FLOAT)
+        {
+            float *pData = (float *)pCurAttributeData;
+            attributeValueString.format_append("%.8g", *pData);
+        }
+        else if (attribDesc.m_type == GL_DOUBLE)
+        {
+            double *pData = (double *)pCurAttributeData;
+            attributeValueString.format_append("%.17g", *pData);
+        }
+        else
+        {
+            // half-float, fixed, int_2_10_10_10_REV, UINT_2_10_10_10_REV, UINT_10F_11F_11F_REV
+            attributeValueString.append("unhandled format");
+        }
+
+        // add comma if needed
+        if (i < attribDesc.m_size - 1)
+            attributeValueString += ", ";
+
+        pCurAttributeData += bytesPerComponent;
+    }
+
+    if (attribDesc.m_size > 1)
+        attributeValueString += " }";
+
+    return attributeValueString.c_str();
+}
@@ -0,0 +1,76 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+#ifndef VOGLEDITOR_QVERTEXARRAYTABLEMODEL_H
+#define VOGLEDITOR_QVERTEXARRAYTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+#include <QVector>
+#include "vogl_core.h"
+#include "vogl_vao_state.h"
+
+class vogl_buffer_state;
+
+// Presents the attributes of a range of vertices (or instances) as a table without creating an item per cell.
+// Column 0 holds the element index of each row, the other columns hold one attribute each.
+// Cells are formatted from the buffer data when the view asks for them, so only visible rows cost anything.
+class vogleditor_QVertexArrayTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    vogleditor_QVertexArrayTableModel(QObject *parent = 0);
+
+    void clear();
+
+    // Sets the header of the element column and clears the attribute columns.
+    void set_element_header(const QString &header);
+    void add_attrib_column(const QString &header, const vogl_buffer_state *pBufferState, const vogl_vertex_attrib_desc &attribDesc);
+
+    // Rows beyond the end of elements are shown as out of bounds.
+    void set_rows(uint32_t rowCount, const QVector<uint32_t> &elements);
+
+    virtual int rowCount(const QModelIndex &parent = QModelIndex()) const;
+    virtual int columnCount(const QModelIndex &parent = QModelIndex()) const;
+    virtual QVariant data(const QModelIndex &index, int role) const;
+    virtual QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+
+    static QString format_buffer_data_as_string(uint32_t index, const vogl_buffer_state &bufferState, const vogl_vertex_attrib_desc &attribDesc);
+
+private:
+    struct attrib_column
+    {
+        const vogl_buffer_state *m_pBufferState;
+        vogl_vertex_attrib_desc m_attribDesc;
+    };
+
+    QStringList m_headers;
+    QVector<attrib_column> m_columns;
+    uint32_t m_rowCount;
+    QVector<uint32_t> m_elements;
+};
+
+#endif // VOGLEDITOR_QVERTEXARRAYTABLEMODEL_H
@@ -0,0 +1,122 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+
+#include "vogleditor_sessionblobmanager.h"
+#include "vogl_file_utils.h"
+
+vogleditor_sessionBlobManager::vogleditor_sessionBlobManager()
+    : m_pTraceBlobManager(NULL),
+      m_pAddedBlobIds(NULL)
+{
+}
+
+vogleditor_sessionBlobManager::~vogleditor_sessionBlobManager()
+{
+    deinit();
+}
+
+bool vogleditor_sessionBlobManager::init(const char *pSessionDataPath, vogl_multi_blob_manager *pTraceBlobManager)
+{
+    deinit();
+
+    if (!vogl_loose_file_blob_manager::init(cBMFReadWrite, pSessionDataPath))
+        return false;
+
+    if (!m_reader.init(cBMFReadable | cBMFOpenExisting))
+    {
+        deinit();
+        return false;
+    }
+
+    m_pTraceBlobManager = pTraceBlobManager;
+
+    // multi blob managers can't be nested (they track the owner of an open stream in its user data),
+    // so the reader gets the trace's blob managers themselves
+    m_reader.add_blob_manager(this);
+    if (m_pTraceBlobManager != NULL)
+    {
+        const vogl_multi_blob_manager::vogl_blob_manager_ptr_vec &traceBlobManagers = m_pTraceBlobManager->get_blob_managers();
+        for (uint32_t i = 0; i < traceBlobManagers.size(); i++)
+        {
+            m_reader.add_blob_manager(traceBlobManagers[i]);
+        }
+    }
+
+    return true;
+}
+
+bool vogleditor_sessionBlobManager::deinit()
+{
+    m_reader.deinit();
+    m_pTraceBlobManager = NULL;
+    m_pAddedBlobIds = NULL;
+    m_sessionBlobIds.clear();
+
+    return vogl_loose_file_blob_manager::deinit();
+}
+
+vogl::dynamic_string vogleditor_sessionBlobManager::add_buf_using_id(const void *pData, uint32_t size, const vogl::dynamic_string &id)
+{
+    if (!id.is_empty() && (m_pTraceBlobManager != NULL) && m_pTraceBlobManager->does_exist(id))
+        return id;
+
+    dynamic_string actualId(vogl_loose_file_blob_manager::add_buf_using_id(pData, size, id));
+    if (!actualId.is_empty())
+    {
+        m_sessionBlobIds.push_back(actualId);
+        if (m_pAddedBlobIds != NULL)
+            m_pAddedBlobIds->push_back(actualId);
+    }
+
+    return actualId;
+}
+
+void vogleditor_sessionBlobManager::add_session_blob_ids(const dynamic_string_array &blobIds)
+{
+    m_sessionBlobIds.append(blobIds);
+}
+
+void vogleditor_sessionBlobManager::delete_unreferenced_blobs(const dynamic_string_array &referencedBlobIds)
+{
+    dynamic_string_array referenced(referencedBlobIds);
+    referenced.sort();
+    referenced.unique();
+
+    m_sessionBlobIds.sort();
+    m_sessionBlobIds.unique();
+
+    for (uint32_t i = 0; i < m_sessionBlobIds.size(); i++)
+    {
+        if (referenced.find_sorted(m_sessionBlobIds[i]) < 0)
+        {
+            dynamic_string filename;
+            file_utils::combine_path(filename, get_path().get_ptr(), m_sessionBlobIds[i].get_ptr());
+            file_utils::delete_file(filename.get_ptr());
+        }
+    }
+
+    m_sessionBlobIds.swap(referenced);
+}
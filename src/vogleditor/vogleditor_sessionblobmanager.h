@@ -0,0 +1,73 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+
+#ifndef VOGLEDITOR_SESSIONBLOBMANAGER_H
+#define VOGLEDITOR_SESSIONBLOBMANAGER_H
+
+#include "vogl_common.h"
+#include "vogl_blob_manager.h"
+
+// Blob storage of a session: blobs are written as loose files into the session data folder, except for
+// the ones that the trace already contains. Since blob ids are content addressed, unmodified snapshot
+// data keeps referring to the trace archive instead of being copied into every session.
+class vogleditor_sessionBlobManager : public vogl_loose_file_blob_manager
+{
+public:
+    vogleditor_sessionBlobManager();
+    virtual ~vogleditor_sessionBlobManager();
+
+    bool init(const char *pSessionDataPath, vogl_multi_blob_manager *pTraceBlobManager);
+
+    virtual bool deinit();
+
+    virtual vogl::dynamic_string add_buf_using_id(const void *pData, uint32_t size, const vogl::dynamic_string &id);
+
+    // Reads blobs from the session data folder, then from the trace
+    const vogl_blob_manager &get_reader() const
+    {
+        return m_reader;
+    }
+
+    // While set, the ids of blobs added to the session data folder are appended to pBlobIds
+    void set_added_blob_ids(dynamic_string_array *pBlobIds)
+    {
+        m_pAddedBlobIds = pBlobIds;
+    }
+
+    // Session blobs listed in a loaded session file
+    void add_session_blob_ids(const dynamic_string_array &blobIds);
+
+    // Deletes the session blobs that were loaded or added since the last call and are not in referencedBlobIds
+    void delete_unreferenced_blobs(const dynamic_string_array &referencedBlobIds);
+
+private:
+    vogl_multi_blob_manager *m_pTraceBlobManager;
+    vogl_multi_blob_manager m_reader;
+    dynamic_string_array *m_pAddedBlobIds;
+    dynamic_string_array m_sessionBlobIds;
+};
+
+#endif // VOGLEDITOR_SESSIONBLOBMANAGER_H
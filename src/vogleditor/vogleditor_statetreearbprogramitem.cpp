@@ -199,7 +199,8 @@ QString vogleditor_stateTreeArbProgramParamItem::getDiffedValue() const
 
 vogleditor_stateTreeArbProgramItem::vogleditor_stateTreeArbProgramItem(QString name, QString value, vogleditor_stateTreeItem *parentNode, vogl_arb_program_state &state)
     : vogleditor_stateTreeItem(name, value, parentNode),
-      m_pState(&state)
+      m_pState(&state),
+      m_pDiffBaseState(NULL)
 {
     QString tmp;
 
@@ -20,6 +20,11 @@ public:
         m_pDiffBaseState = pBaseState;
     }
 
+    void set_state(const vogl_arb_program_state *pState)
+    {
+        m_pState = pState;
+    }
+
     const vogl_arb_program_state *get_current_state() const
     {
         return m_pState;
@@ -164,6 +169,16 @@ public:
         }
     }
 
+    // Shows another ARB program with the same state, e.g. the same program in another snapshot.
+    void set_state(vogl_arb_program_state *pState)
+    {
+        m_pState = pState;
+        for (vogleditor_stateTreeArbProgramDiffableItem **iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
+        {
+            (*iter)->set_state(pState);
+        }
+    }
+
 private:
     vogl_arb_program_state *m_pState;
     const vogl_arb_program_state *m_pDiffBaseState;
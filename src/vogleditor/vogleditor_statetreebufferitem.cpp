@@ -52,6 +52,15 @@ void vogleditor_stateTreeBufferItem::set_diff_base_state(const vogl_buffer_state
 
     for (vogleditor_stateTreeStateVecDiffableItem *const *iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
     {
-        (*iter)->set_diff_base_state(&(pBaseState->get_params()));
+        (*iter)->set_diff_base_state((pBaseState != NULL) ? &(pBaseState->get_params()) : NULL);
+    }
+}
+
+void vogleditor_stateTreeBufferItem::set_state(const vogl_buffer_state *pState)
+{
+    m_pState = pState;
+    for (vogleditor_stateTreeStateVecDiffableItem *const *iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
+    {
+        (*iter)->set_state(&(pState->get_params()));
     }
 }
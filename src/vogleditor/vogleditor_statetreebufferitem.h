@@ -26,6 +26,9 @@ public:
 
     void set_diff_base_state(const vogl_buffer_state *pBaseState);
 
+    // Shows another buffer with the same state, e.g. the same buffer in another snapshot.
+    void set_state(const vogl_buffer_state *pState);
+
 private:
     const vogl_buffer_state *m_pState;
     const vogl_buffer_state *m_pDiffBaseState;
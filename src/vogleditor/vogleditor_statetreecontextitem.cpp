@@ -22,14 +22,6 @@
 #include "vogleditor_statetreecontextinfoitem.h"
 #include "vogleditor_statetreebufferitem.h"
 
-struct vogl_gl_object_state_handle_less_than
-{
-    inline bool operator()(const vogl_gl_object_state *a, const vogl_gl_object_state *b) const
-    {
-        return a->get_snapshot_handle() < b->get_snapshot_handle();
-    }
-};
-
 #define STR_INT(val) tmp.sprintf("%d", val)
 
 vogleditor_stateTreeContextItem::vogleditor_stateTreeContextItem(QString name, QString value, vogleditor_stateTreeItem *parent, vogl_context_snapshot &contextState)
@@ -197,188 +189,6 @@ vogleditor_stateTreeContextItem::vogleditor_stateTreeContextItem(QString name, Q
             m_pTexEnvItem = new vogleditor_stateTreeTexEnvItem("Texture Env", this, texEnvState, info);
             this->appendChild(m_pTexEnvItem);
         }
-
-        // sort all state objects by snapshot handle
-        vogl_gl_object_state_ptr_vec objectState = contextState.get_objects();
-        objectState.sort(vogl_gl_object_state_handle_less_than());
-        vogleditor_stateTreeItem *pObjectsNode = new vogleditor_stateTreeItem("Objects", "", this);
-        this->appendChild(pObjectsNode);
-
-        {
-// Append a node for each of the state object types
-#define DEF(x) vogleditor_stateTreeItem *pNode##x = new vogleditor_stateTreeItem(#x "s", "", pObjectsNode);
-            VOGL_GL_OBJECT_STATE_TYPES
-#undef DEF
-
-            for (vogl_gl_object_state_ptr_vec::iterator iter = objectState.begin(); iter != objectState.end(); iter++)
-            {
-                switch ((*iter)->get_type())
-                {
-                    case cGLSTTexture:
-                    {
-                        vogl_texture_state *pTexState = static_cast<vogl_texture_state *>(*iter);
-                        QString valueStr;
-                        valueStr = valueStr.sprintf("%s (%u x %u x %u) %s", enum_to_string(pTexState->get_target()).toStdString().c_str(), pTexState->get_texture().get_width(), pTexState->get_texture().get_height(), pTexState->get_texture().get_depth(), enum_to_string(pTexState->get_texture().get_ogl_internal_fmt()).toStdString().c_str());
-                        vogleditor_stateTreeTextureItem *pNode = new vogleditor_stateTreeTextureItem(int64_to_string(pTexState->get_snapshot_handle()), valueStr, pNodeTexture, pTexState, info);
-                        m_textureItems.push_back(pNode);
-                        pNodeTexture->appendChild(pNode);
-                        break;
-                    }
-                    case cGLSTBuffer:
-                    {
-                        vogl_buffer_state *pBuffer = static_cast<vogl_buffer_state *>(*iter);
-                        vogleditor_stateTreeBufferItem *pNode = new vogleditor_stateTreeBufferItem(int64_to_string(pBuffer->get_snapshot_handle()), enum_to_string(pBuffer->get_target()), pNodeBuffer, pBuffer);
-                        m_bufferItems.push_back(pNode);
-                        pNodeBuffer->appendChild(pNode);
-
-                        break;
-                    }
-                    case cGLSTSampler:
-                    {
-                        const vogl_sampler_state *pSampler = static_cast<const vogl_sampler_state *>(*iter);
-                        vogleditor_stateTreeSamplerItem *pNode = new vogleditor_stateTreeSamplerItem(int64_to_string(pSampler->get_snapshot_handle()), "", pNodeSampler, pSampler, info);
-                        m_samplerItems.push_back(pNode);
-                        pNodeSampler->appendChild(pNode);
-
-                        break;
-                    }
-                    case cGLSTQuery:
-                    {
-                        vogl_query_state *pQuery = static_cast<vogl_query_state *>(*iter);
-                        vogleditor_stateTreeQueryItem *pNode = new vogleditor_stateTreeQueryItem(int64_to_string(pQuery->get_snapshot_handle()), pQuery->get_snapshot_handle(), pNodeQuery, pQuery);
-                        m_queryItems.push_back(pNode);
-                        pNodeQuery->appendChild(pNode);
-                        break;
-                    }
-                    case cGLSTRenderbuffer:
-                    {
-                        vogl_renderbuffer_state *pRenderbuffer = static_cast<vogl_renderbuffer_state *>(*iter);
-                        vogleditor_stateTreeRenderbufferItem *pNode = new vogleditor_stateTreeRenderbufferItem(int64_to_string(pRenderbuffer->get_snapshot_handle()), pRenderbuffer->get_snapshot_handle(), pNodeRenderbuffer, *pRenderbuffer);
-                        QString valueStr;
-                        int width = 0;
-                        int height = 0;
-                        int format = 0;
-                        pRenderbuffer->get_desc().get_int(GL_RENDERBUFFER_WIDTH, &width);
-                        pRenderbuffer->get_desc().get_int(GL_RENDERBUFFER_HEIGHT, &height);
-                        pRenderbuffer->get_desc().get_int(GL_RENDERBUFFER_INTERNAL_FORMAT, &format);
-                        valueStr = valueStr.sprintf("(%d x %d) %s", width, height, enum_to_string(format).toStdString().c_str());
-                        pNode->setValue(valueStr);
-                        m_renderbufferItems.push_back(pNode);
-                        pNodeRenderbuffer->appendChild(pNode);
-
-                        break;
-                    }
-                    case cGLSTFramebuffer:
-                    {
-                        vogl_framebuffer_state *pFramebuffer = static_cast<vogl_framebuffer_state *>(*iter);
-                        if (!pFramebuffer->is_valid())
-                        {
-                            break;
-                        }
-
-                        vogleditor_stateTreeFramebufferItem *pNode = new vogleditor_stateTreeFramebufferItem(int64_to_string(pFramebuffer->get_snapshot_handle()), "", pFramebuffer->get_snapshot_handle(), pNodeFramebuffer, pFramebuffer);
-                        m_framebufferItems.push_back(pNode);
-                        pNodeFramebuffer->appendChild(pNode);
-
-                        break;
-                    }
-                    case cGLSTVertexArray:
-                    {
-                        vogl_vao_state *pVAO = static_cast<vogl_vao_state *>(*iter);
-                        if (!pVAO->is_valid())
-                        {
-                            break;
-                        }
-
-                        vogleditor_stateTreeVertexArrayItem *pNode = new vogleditor_stateTreeVertexArrayItem(int64_to_string(pVAO->get_snapshot_handle()), tmp.sprintf("[%u]", info.get_max_vertex_attribs()), pVAO->get_snapshot_handle(), pNodeVertexArray, *pVAO, info);
-                        m_vertexArrayItems.push_back(pNode);
-                        pNodeVertexArray->appendChild(pNode);
-
-                        break;
-                    }
-                    case cGLSTShader:
-                    {
-                        vogl_shader_state *pShader = static_cast<vogl_shader_state *>(*iter);
-                        if (!pShader->is_valid())
-                        {
-                            break;
-                        }
-
-                        vogleditor_stateTreeShaderItem *pNode = new vogleditor_stateTreeShaderItem(int64_to_string(pShader->get_snapshot_handle()), enum_to_string(pShader->get_shader_type()), pNodeShader, *pShader);
-                        m_shaderItems.push_back(pNode);
-                        pNodeShader->appendChild(pNode);
-
-                        break;
-                    }
-                    case cGLSTProgram:
-                    {
-                        vogl_program_state *pProgram = static_cast<vogl_program_state *>(*iter);
-                        if (!pProgram->is_valid())
-                        {
-                            break;
-                        }
-
-                        vogleditor_stateTreeProgramItem *pNode = new vogleditor_stateTreeProgramItem(int64_to_string(pProgram->get_snapshot_handle()), "", pNodeProgram, *pProgram, info);
-                        m_programItems.push_back(pNode);
-                        pNodeProgram->appendChild(pNode);
-
-                        break;
-                    }
-                    case cGLSTSync:
-                    {
-                        vogl_sync_state *pSync = static_cast<vogl_sync_state *>(*iter);
-                        vogleditor_stateTreeSyncItem *pNode = new vogleditor_stateTreeSyncItem(int64_to_string(pSync->get_snapshot_handle()), pNodeSync, *pSync);
-                        m_syncItems.push_back(pNode);
-                        pNodeSync->appendChild(pNode);
-                        break;
-                    }
-                    case cGLSTARBProgram:
-                    {
-                        vogl_arb_program_state *pARBProgram = static_cast<vogl_arb_program_state *>(*iter);
-                        if (!pARBProgram->is_valid())
-                        {
-                            break;
-                        }
-                        vogleditor_stateTreeArbProgramItem *pNode = new vogleditor_stateTreeArbProgramItem(int64_to_string(pARBProgram->get_snapshot_handle()), "", pNodeARBProgram, *pARBProgram);
-                        m_arbProgramItems.push_back(pNode);
-                        pNodeARBProgram->appendChild(pNode);
-                        break;
-                    }
-                    case cGLSTProgramPipeline:
-                    {
-                        vogl_sso_state *pSSO = static_cast<vogl_sso_state *>(*iter);
-                        if (!pSSO->is_valid())
-                        {
-                            break;
-                        }
-                        vogleditor_stateTreeProgramPipelineItem *pNode = new vogleditor_stateTreeProgramPipelineItem(int64_to_string(pSSO->get_snapshot_handle()), pSSO->get_snapshot_handle(), pNodeProgramPipeline, *pSSO);
-                        m_programPipelineItems.push_back(pNode);
-                        pNodeProgramPipeline->appendChild(pNode);
-
-                        break;
-                    }
-                    case cGLSTInvalid:
-                    default:
-                    {
-                        // in the Invalid and default case add the object to the invalids
-                        vogleditor_stateTreeItem *pNode = new vogleditor_stateTreeItem(int64_to_string((*iter)->get_snapshot_handle()), get_gl_object_state_type_str((*iter)->get_type()), pNodeARBProgram);
-                        pNodeARBProgram->appendChild(pNode);
-                    }
-                }
-            } // end for
-
-// update the value of the list node to reflect the number of elements in that list
-#define DEF(x) pNode##x->setValue(tmp.sprintf("[%d]", pNode##x->childCount()));
-            VOGL_GL_OBJECT_STATE_TYPES
-#undef DEF
-
-// only append list if there are objects of that type
-#define DEF(x)                      \
-    if (pNode##x->childCount() > 0) \
-        pObjectsNode->appendChild(pNode##x);
-            VOGL_GL_OBJECT_STATE_TYPES
-#undef DEF
-        }
     }
 }
 
@@ -452,223 +262,263 @@ void vogleditor_stateTreeContextItem::set_diff_base_state(const vogl_context_sna
         }
     }
 
-    vogl_gl_object_state_ptr_vec texObjs;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTTexture, texObjs);
-    for (vogleditor_stateTreeTextureItem **iter = m_textureItems.begin(); iter != m_textureItems.end(); iter++)
+    const vogl_light_state &lightState = pBaseState->get_light_state();
+    if (lightState.is_valid())
     {
-        for (vogl_gl_object_state **diffIter = texObjs.begin(); diffIter != texObjs.end(); diffIter++)
+        for (vogleditor_stateTreeLightItem **iter = m_lightItems.begin(); iter != m_lightItems.end(); iter++)
         {
-            const vogl_texture_state *pDiffTex = static_cast<const vogl_texture_state *>(*diffIter);
-            if (pDiffTex->get_snapshot_handle() == (*iter)->get_texture_state()->get_snapshot_handle())
-            {
-                (*iter)->set_diff_base_state(pDiffTex);
-                break;
-            }
+            const vogl_state_vector &lightVec = lightState.get_light((*iter)->get_light_index());
+            (*iter)->set_diff_base_state(&lightVec);
         }
     }
 
-    vogl_gl_object_state_ptr_vec queryObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTQuery, queryObjects);
-    for (vogleditor_stateTreeQueryItem **iter = m_queryItems.begin(); iter != m_queryItems.end(); iter++)
+    const vogl_arb_program_environment_state &progEnvState = pBaseState->get_arb_program_environment_state();
+    if (progEnvState.is_valid())
     {
-        for (vogl_gl_object_state **diffIter = queryObjects.begin(); diffIter != queryObjects.end(); diffIter++)
+        for (vogleditor_stateTreeArbProgramEnvItem **iter = m_arbProgramEnvItems.begin(); iter != m_arbProgramEnvItems.end(); iter++)
         {
-            const vogl_query_state *pDiffState = static_cast<const vogl_query_state *>(*diffIter);
-            if (pDiffState->get_snapshot_handle() == (*iter)->get_handle())
-            {
-                (*iter)->set_diff_base_state(pDiffState);
-                break;
-            }
+            (*iter)->set_diff_base_state(&progEnvState);
         }
     }
 
-    vogl_gl_object_state_ptr_vec renderbufferObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTRenderbuffer, renderbufferObjects);
-    for (vogleditor_stateTreeRenderbufferItem **iter = m_renderbufferItems.begin(); iter != m_renderbufferItems.end(); iter++)
+    const vogl_material_state &materialState = pBaseState->get_material_state();
+    if (materialState.is_valid())
     {
-        for (vogl_gl_object_state **diffIter = renderbufferObjects.begin(); diffIter != renderbufferObjects.end(); diffIter++)
+        for (vogleditor_stateTreeContextMaterialItem **iter = m_materialItems.begin(); iter != m_materialItems.end(); iter++)
         {
-            const vogl_renderbuffer_state *pDiffState = static_cast<const vogl_renderbuffer_state *>(*diffIter);
-            if (pDiffState->get_snapshot_handle() == (*iter)->get_handle())
-            {
-                (*iter)->set_diff_base_state(pDiffState);
-                break;
-            }
+            (*iter)->set_diff_base_state(&materialState);
         }
     }
 
-    vogl_gl_object_state_ptr_vec framebufferObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTFramebuffer, framebufferObjects);
-    for (vogleditor_stateTreeFramebufferItem **iter = m_framebufferItems.begin(); iter != m_framebufferItems.end(); iter++)
+    const vogl_matrix_state &matrixState = pBaseState->get_matrix_state();
+    if (matrixState.is_valid())
     {
-        for (vogl_gl_object_state **diffIter = framebufferObjects.begin(); diffIter != framebufferObjects.end(); diffIter++)
+        for (vogleditor_stateTreeMatrixStackItem **iter = m_matrixStackItems.begin(); iter != m_matrixStackItems.end(); iter++)
         {
-            const vogl_framebuffer_state *pDiffState = static_cast<const vogl_framebuffer_state *>(*diffIter);
-            if (pDiffState->get_snapshot_handle() == (*iter)->get_handle())
+            if (m_pDiffBaseState != NULL)
             {
-                (*iter)->set_diff_base_state(pDiffState);
-                break;
+                (*iter)->set_diff_base_state(&matrixState);
             }
         }
     }
+}
 
-    vogl_gl_object_state_ptr_vec samplerObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTSampler, samplerObjects);
-    for (vogleditor_stateTreeSamplerItem **iter = m_samplerItems.begin(); iter != m_samplerItems.end(); iter++)
+vogl_gl_object_state_type vogleditor_stateTreeContextItem::get_object_category(const vogl_gl_object_state *pObject)
+{
+    vogl_gl_object_state_type type = pObject->get_type();
+    if (type <= cGLSTInvalid || type >= cGLSTTotalTypes)
     {
-        for (vogl_gl_object_state **diffIter = samplerObjects.begin(); diffIter != samplerObjects.end(); diffIter++)
-        {
-            const vogl_sampler_state *pDiffObj = static_cast<const vogl_sampler_state *>(*diffIter);
-            if (pDiffObj->get_snapshot_handle() == (*iter)->get_sampler_state()->get_snapshot_handle())
-            {
-                (*iter)->set_diff_base_state(pDiffObj);
-                break;
-            }
-        }
+        // invalid objects are listed with the ARB programs
+        return cGLSTARBProgram;
     }
 
-    vogl_gl_object_state_ptr_vec bufferObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTBuffer, bufferObjects);
-    for (vogleditor_stateTreeBufferItem **iter = m_bufferItems.begin(); iter != m_bufferItems.end(); iter++)
+    return type;
+}
+
+vogleditor_stateTreeItem *vogleditor_stateTreeContextItem::create_object_item(vogl_gl_object_state *pObject, vogleditor_stateTreeItem *parent, const vogl_context_info &info)
+{
+    QString tmp;
+
+    switch (pObject->get_type())
     {
-        for (vogl_gl_object_state **diffIter = bufferObjects.begin(); diffIter != bufferObjects.end(); diffIter++)
+        case cGLSTTexture:
         {
-            const vogl_buffer_state *pDiffObj = static_cast<const vogl_buffer_state *>(*diffIter);
-            if (pDiffObj->get_snapshot_handle() == (*iter)->get_buffer_state()->get_snapshot_handle())
-            {
-                (*iter)->set_diff_base_state(pDiffObj);
-                break;
-            }
+            vogl_texture_state *pTexState = static_cast<vogl_texture_state *>(pObject);
+            QString valueStr;
+            valueStr = valueStr.sprintf("%s (%u x %u x %u) %s", enum_to_string(pTexState->get_target()).toStdString().c_str(), pTexState->get_texture().get_width(), pTexState->get_texture().get_height(), pTexState->get_texture().get_depth(), enum_to_string(pTexState->get_texture().get_ogl_internal_fmt()).toStdString().c_str());
+            return new vogleditor_stateTreeTextureItem(int64_to_string(pTexState->get_snapshot_handle()), valueStr, parent, pTexState, info);
         }
-    }
-
-    vogl_gl_object_state_ptr_vec vertexArrayObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTVertexArray, vertexArrayObjects);
-    for (vogleditor_stateTreeVertexArrayItem **iter = m_vertexArrayItems.begin(); iter != m_vertexArrayItems.end(); iter++)
-    {
-        for (vogl_gl_object_state **diffIter = vertexArrayObjects.begin(); diffIter != vertexArrayObjects.end(); diffIter++)
+        case cGLSTBuffer:
         {
-            const vogl_vao_state *pDiffObj = static_cast<const vogl_vao_state *>(*diffIter);
-            if (pDiffObj->get_snapshot_handle() == (*iter)->get_handle())
+            vogl_buffer_state *pBuffer = static_cast<vogl_buffer_state *>(pObject);
+            return new vogleditor_stateTreeBufferItem(int64_to_string(pBuffer->get_snapshot_handle()), enum_to_string(pBuffer->get_target()), parent, pBuffer);
+        }
+        case cGLSTSampler:
+        {
+            const vogl_sampler_state *pSampler = static_cast<const vogl_sampler_state *>(pObject);
+            return new vogleditor_stateTreeSamplerItem(int64_to_string(pSampler->get_snapshot_handle()), "", parent, pSampler, info);
+        }
+        case cGLSTQuery:
+        {
+            vogl_query_state *pQuery = static_cast<vogl_query_state *>(pObject);
+            return new vogleditor_stateTreeQueryItem(int64_to_string(pQuery->get_snapshot_handle()), pQuery->get_snapshot_handle(), parent, pQuery);
+        }
+        case cGLSTRenderbuffer:
+        {
+            vogl_renderbuffer_state *pRenderbuffer = static_cast<vogl_renderbuffer_state *>(pObject);
+            vogleditor_stateTreeRenderbufferItem *pNode = new vogleditor_stateTreeRenderbufferItem(int64_to_string(pRenderbuffer->get_snapshot_handle()), pRenderbuffer->get_snapshot_handle(), parent, *pRenderbuffer);
+            QString valueStr;
+            int width = 0;
+            int height = 0;
+            int format = 0;
+            pRenderbuffer->get_desc().get_int(GL_RENDERBUFFER_WIDTH, &width);
+            pRenderbuffer->get_desc().get_int(GL_RENDERBUFFER_HEIGHT, &height);
+            pRenderbuffer->get_desc().get_int(GL_RENDERBUFFER_INTERNAL_FORMAT, &format);
+            valueStr = valueStr.sprintf("(%d x %d) %s", width, height, enum_to_string(format).toStdString().c_str());
+            pNode->setValue(valueStr);
+            return pNode;
+        }
+        case cGLSTFramebuffer:
+        {
+            vogl_framebuffer_state *pFramebuffer = static_cast<vogl_framebuffer_state *>(pObject);
+            if (!pFramebuffer->is_valid())
             {
-                (*iter)->set_diff_base_state(pDiffObj);
-                break;
+                return NULL;
             }
-        }
-    }
 
-    vogl_gl_object_state_ptr_vec shaderObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTShader, shaderObjects);
-    for (vogleditor_stateTreeShaderItem **iter = m_shaderItems.begin(); iter != m_shaderItems.end(); iter++)
-    {
-        for (vogl_gl_object_state **diffIter = shaderObjects.begin(); diffIter != shaderObjects.end(); diffIter++)
+            return new vogleditor_stateTreeFramebufferItem(int64_to_string(pFramebuffer->get_snapshot_handle()), "", pFramebuffer->get_snapshot_handle(), parent, pFramebuffer);
+        }
+        case cGLSTVertexArray:
         {
-            const vogl_shader_state *pDiffObj = static_cast<const vogl_shader_state *>(*diffIter);
-            if (pDiffObj->get_snapshot_handle() == (*iter)->get_current_state()->get_snapshot_handle())
+            vogl_vao_state *pVAO = static_cast<vogl_vao_state *>(pObject);
+            if (!pVAO->is_valid())
             {
-                (*iter)->set_diff_base_state(pDiffObj);
-                break;
+                return NULL;
             }
-        }
-    }
 
-    vogl_gl_object_state_ptr_vec programObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTProgram, programObjects);
-    for (vogleditor_stateTreeProgramItem **iter = m_programItems.begin(); iter != m_programItems.end(); iter++)
-    {
-        for (vogl_gl_object_state **diffIter = programObjects.begin(); diffIter != programObjects.end(); diffIter++)
+            return new vogleditor_stateTreeVertexArrayItem(int64_to_string(pVAO->get_snapshot_handle()), tmp.sprintf("[%u]", info.get_max_vertex_attribs()), pVAO->get_snapshot_handle(), parent, *pVAO, info);
+        }
+        case cGLSTShader:
         {
-            const vogl_program_state *pDiffObj = static_cast<const vogl_program_state *>(*diffIter);
-            if (pDiffObj->get_snapshot_handle() == (*iter)->get_current_state()->get_snapshot_handle())
+            vogl_shader_state *pShader = static_cast<vogl_shader_state *>(pObject);
+            if (!pShader->is_valid())
             {
-                (*iter)->set_diff_base_state(pDiffObj);
-                break;
+                return NULL;
             }
-        }
-    }
 
-    vogl_gl_object_state_ptr_vec syncObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTSync, syncObjects);
-    for (vogleditor_stateTreeSyncItem **iter = m_syncItems.begin(); iter != m_syncItems.end(); iter++)
-    {
-        for (vogl_gl_object_state **diffIter = syncObjects.begin(); diffIter != syncObjects.end(); diffIter++)
+            return new vogleditor_stateTreeShaderItem(int64_to_string(pShader->get_snapshot_handle()), enum_to_string(pShader->get_shader_type()), parent, *pShader);
+        }
+        case cGLSTProgram:
         {
-            vogl_sync_state *pDiffObj = static_cast<vogl_sync_state *>(*diffIter);
-            if (pDiffObj->get_snapshot_handle() == (*iter)->get_current_state()->get_snapshot_handle())
+            vogl_program_state *pProgram = static_cast<vogl_program_state *>(pObject);
+            if (!pProgram->is_valid())
             {
-                (*iter)->set_diff_base_state(pDiffObj);
-                break;
+                return NULL;
             }
-        }
-    }
 
-    vogl_gl_object_state_ptr_vec arbProgramObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTARBProgram, arbProgramObjects);
-    for (vogleditor_stateTreeArbProgramItem **iter = m_arbProgramItems.begin(); iter != m_arbProgramItems.end(); iter++)
-    {
-        for (vogl_gl_object_state **diffIter = arbProgramObjects.begin(); diffIter != arbProgramObjects.end(); diffIter++)
+            return new vogleditor_stateTreeProgramItem(int64_to_string(pProgram->get_snapshot_handle()), "", parent, *pProgram, info);
+        }
+        case cGLSTSync:
+        {
+            vogl_sync_state *pSync = static_cast<vogl_sync_state *>(pObject);
+            return new vogleditor_stateTreeSyncItem(int64_to_string(pSync->get_snapshot_handle()), parent, *pSync);
+        }
+        case cGLSTARBProgram:
         {
-            const vogl_arb_program_state *pDiffObj = static_cast<const vogl_arb_program_state *>(*diffIter);
-            if (pDiffObj->get_snapshot_handle() == (*iter)->get_current_state()->get_snapshot_handle())
+            vogl_arb_program_state *pARBProgram = static_cast<vogl_arb_program_state *>(pObject);
+            if (!pARBProgram->is_valid())
             {
-                (*iter)->set_diff_base_state(pDiffObj);
-                break;
+                return NULL;
             }
-        }
-    }
 
-    vogl_gl_object_state_ptr_vec programPipelineObjects;
-    m_pDiffBaseState->get_all_objects_of_category(cGLSTProgramPipeline, programPipelineObjects);
-    for (vogleditor_stateTreeProgramPipelineItem **iter = m_programPipelineItems.begin(); iter != m_programPipelineItems.end(); iter++)
-    {
-        for (vogl_gl_object_state **diffIter = programPipelineObjects.begin(); diffIter != programPipelineObjects.end(); diffIter++)
+            return new vogleditor_stateTreeArbProgramItem(int64_to_string(pARBProgram->get_snapshot_handle()), "", parent, *pARBProgram);
+        }
+        case cGLSTProgramPipeline:
         {
-            const vogl_sso_state *pDiffObj = static_cast<const vogl_sso_state *>(*diffIter);
-            if (pDiffObj->get_snapshot_handle() == (*iter)->get_handle())
+            vogl_sso_state *pSSO = static_cast<vogl_sso_state *>(pObject);
+            if (!pSSO->is_valid())
             {
-                (*iter)->set_diff_base_state(pDiffObj);
-                break;
+                return NULL;
             }
-        }
-    }
 
-    const vogl_light_state &lightState = pBaseState->get_light_state();
-    if (lightState.is_valid())
-    {
-        for (vogleditor_stateTreeLightItem **iter = m_lightItems.begin(); iter != m_lightItems.end(); iter++)
-        {
-            const vogl_state_vector &lightVec = lightState.get_light((*iter)->get_light_index());
-            (*iter)->set_diff_base_state(&lightVec);
+            return new vogleditor_stateTreeProgramPipelineItem(int64_to_string(pSSO->get_snapshot_handle()), pSSO->get_snapshot_handle(), parent, *pSSO);
         }
-    }
-
-    const vogl_arb_program_environment_state &progEnvState = pBaseState->get_arb_program_environment_state();
-    if (progEnvState.is_valid())
-    {
-        for (vogleditor_stateTreeArbProgramEnvItem **iter = m_arbProgramEnvItems.begin(); iter != m_arbProgramEnvItems.end(); iter++)
+        case cGLSTInvalid:
+        default:
         {
-            (*iter)->set_diff_base_state(&progEnvState);
+            // in the Invalid and default case add the object to the invalids
+            return new vogleditor_stateTreeItem(int64_to_string(pObject->get_snapshot_handle()), get_gl_object_state_type_str(pObject->get_type()), parent);
         }
     }
+}
 
-    const vogl_material_state &materialState = pBaseState->get_material_state();
-    if (materialState.is_valid())
+void vogleditor_stateTreeContextItem::set_object_state(vogleditor_stateTreeItem *pItem, vogl_gl_object_state *pObject)
+{
+    switch (pObject->get_type())
     {
-        for (vogleditor_stateTreeContextMaterialItem **iter = m_materialItems.begin(); iter != m_materialItems.end(); iter++)
-        {
-            (*iter)->set_diff_base_state(&materialState);
-        }
+        case cGLSTTexture:
+            static_cast<vogleditor_stateTreeTextureItem *>(pItem)->set_state(static_cast<vogl_texture_state *>(pObject));
+            break;
+        case cGLSTBuffer:
+            static_cast<vogleditor_stateTreeBufferItem *>(pItem)->set_state(static_cast<const vogl_buffer_state *>(pObject));
+            break;
+        case cGLSTSampler:
+            static_cast<vogleditor_stateTreeSamplerItem *>(pItem)->set_state(static_cast<const vogl_sampler_state *>(pObject));
+            break;
+        case cGLSTQuery:
+            static_cast<vogleditor_stateTreeQueryItem *>(pItem)->set_state(static_cast<const vogl_query_state *>(pObject));
+            break;
+        case cGLSTRenderbuffer:
+            static_cast<vogleditor_stateTreeRenderbufferItem *>(pItem)->set_state(static_cast<const vogl_renderbuffer_state *>(pObject));
+            break;
+        case cGLSTFramebuffer:
+            static_cast<vogleditor_stateTreeFramebufferItem *>(pItem)->set_state(static_cast<vogl_framebuffer_state *>(pObject));
+            break;
+        case cGLSTVertexArray:
+            static_cast<vogleditor_stateTreeVertexArrayItem *>(pItem)->set_state(static_cast<vogl_vao_state *>(pObject));
+            break;
+        case cGLSTShader:
+            static_cast<vogleditor_stateTreeShaderItem *>(pItem)->set_state(static_cast<vogl_shader_state *>(pObject));
+            break;
+        case cGLSTProgram:
+            static_cast<vogleditor_stateTreeProgramItem *>(pItem)->set_state(static_cast<vogl_program_state *>(pObject));
+            break;
+        case cGLSTSync:
+            static_cast<vogleditor_stateTreeSyncItem *>(pItem)->set_state(static_cast<const vogl_sync_state *>(pObject));
+            break;
+        case cGLSTARBProgram:
+            static_cast<vogleditor_stateTreeArbProgramItem *>(pItem)->set_state(static_cast<vogl_arb_program_state *>(pObject));
+            break;
+        case cGLSTProgramPipeline:
+            static_cast<vogleditor_stateTreeProgramPipelineItem *>(pItem)->set_state(static_cast<const vogl_sso_state *>(pObject));
+            break;
+        default:
+            // the items of invalid objects don't refer to the state
+            break;
     }
+}
 
-    const vogl_matrix_state &matrixState = pBaseState->get_matrix_state();
-    if (matrixState.is_valid())
+void vogleditor_stateTreeContextItem::set_object_diff_base_state(vogleditor_stateTreeItem *pItem, const vogl_gl_object_state *pObject, const vogl_gl_object_state *pBaseObject)
+{
+    switch (pObject->get_type())
     {
-        for (vogleditor_stateTreeMatrixStackItem **iter = m_matrixStackItems.begin(); iter != m_matrixStackItems.end(); iter++)
-        {
-            if (m_pDiffBaseState != NULL)
-            {
-                (*iter)->set_diff_base_state(&matrixState);
-            }
-        }
+        case cGLSTTexture:
+            static_cast<vogleditor_stateTreeTextureItem *>(pItem)->set_diff_base_state(static_cast<const vogl_texture_state *>(pBaseObject));
+            break;
+        case cGLSTBuffer:
+            static_cast<vogleditor_stateTreeBufferItem *>(pItem)->set_diff_base_state(static_cast<const vogl_buffer_state *>(pBaseObject));
+            break;
+        case cGLSTSampler:
+            static_cast<vogleditor_stateTreeSamplerItem *>(pItem)->set_diff_base_state(static_cast<const vogl_sampler_state *>(pBaseObject));
+            break;
+        case cGLSTQuery:
+            static_cast<vogleditor_stateTreeQueryItem *>(pItem)->set_diff_base_state(static_cast<const vogl_query_state *>(pBaseObject));
+            break;
+        case cGLSTRenderbuffer:
+            static_cast<vogleditor_stateTreeRenderbufferItem *>(pItem)->set_diff_base_state(static_cast<const vogl_renderbuffer_state *>(pBaseObject));
+            break;
+        case cGLSTFramebuffer:
+            static_cast<vogleditor_stateTreeFramebufferItem *>(pItem)->set_diff_base_state(static_cast<const vogl_framebuffer_state *>(pBaseObject));
+            break;
+        case cGLSTVertexArray:
+            static_cast<vogleditor_stateTreeVertexArrayItem *>(pItem)->set_diff_base_state(static_cast<const vogl_vao_state *>(pBaseObject));
+            break;
+        case cGLSTShader:
+            static_cast<vogleditor_stateTreeShaderItem *>(pItem)->set_diff_base_state(static_cast<const vogl_shader_state *>(pBaseObject));
+            break;
+        case cGLSTProgram:
+            static_cast<vogleditor_stateTreeProgramItem *>(pItem)->set_diff_base_state(static_cast<const vogl_program_state *>(pBaseObject));
+            break;
+        case cGLSTSync:
+            static_cast<vogleditor_stateTreeSyncItem *>(pItem)->set_diff_base_state(static_cast<const vogl_sync_state *>(pBaseObject));
+            break;
+        case cGLSTARBProgram:
+            static_cast<vogleditor_stateTreeArbProgramItem *>(pItem)->set_diff_base_state(static_cast<const vogl_arb_program_state *>(pBaseObject));
+            break;
+        case cGLSTProgramPipeline:
+            static_cast<vogleditor_stateTreeProgramPipelineItem *>(pItem)->set_diff_base_state(static_cast<const vogl_sso_state *>(pBaseObject));
+            break;
+        default:
+            break;
     }
 }
@@ -4,25 +4,13 @@
 #include "vogleditor_statetreeitem.h"
 #include "vogl_gl_state_snapshot.h"
 
-class vogleditor_stateTreeArbProgramItem;
 class vogleditor_stateTreeArbProgramEnvItem;
-class vogleditor_stateTreeBufferItem;
 class vogleditor_stateTreeContextInfoItem;
 class vogleditor_stateTreeContextGeneralItem;
-class vogleditor_stateTreeFramebufferItem;
 class vogleditor_stateTreeLightItem;
 class vogleditor_stateTreePolygonStippleItem;
-class vogleditor_stateTreeProgramItem;
-class vogleditor_stateTreeQueryItem;
-class vogleditor_stateTreeRenderbufferItem;
-class vogleditor_stateTreeSamplerItem;
-class vogleditor_stateTreeShaderItem;
-class vogleditor_stateTreeSyncItem;
-class vogleditor_stateTreeTextureItem;
 class vogleditor_stateTreeMatrixStackItem;
-class vogleditor_stateTreeVertexArrayItem;
 class vogleditor_stateTreeTexEnvItem;
-class vogleditor_stateTreeProgramPipelineItem;
 
 class vogleditor_stateTreeContextAttributesItem : public vogleditor_stateTreeItem
 {
@@ -343,6 +331,20 @@ public:
 
     void set_diff_base_state(const vogl_context_snapshot *pBaseState);
 
+    // The items of the objects are not children of the context item, so that the state tree model can
+    // keep the items of the objects that did not change when it shows another snapshot.
+    // Objects of an invalid type are listed as ARB programs.
+    static vogl_gl_object_state_type get_object_category(const vogl_gl_object_state *pObject);
+
+    // Returns NULL for the objects that are not shown.
+    static vogleditor_stateTreeItem *create_object_item(vogl_gl_object_state *pObject, vogleditor_stateTreeItem *parent, const vogl_context_info &info);
+
+    // Makes an item of create_object_item() show another object with the same state.
+    static void set_object_state(vogleditor_stateTreeItem *pItem, vogl_gl_object_state *pObject);
+
+    // pBaseObject may be NULL.
+    static void set_object_diff_base_state(vogleditor_stateTreeItem *pItem, const vogl_gl_object_state *pObject, const vogl_gl_object_state *pBaseObject);
+
 private:
     vogl_context_snapshot *m_pState;
     const vogl_context_snapshot *m_pDiffBaseState;
@@ -355,22 +357,10 @@ private:
     vogl::vector<vogleditor_stateTreeContextInfoItem *> m_contextInfoItems;
     vogl::vector<vogleditor_stateTreeContextGeneralItem *> m_generalStateItems;
     vogl::vector<vogleditor_stateTreeStateVecDiffableItem *> m_diffableItems;
-    vogl::vector<vogleditor_stateTreeTextureItem *> m_textureItems;
-    vogl::vector<vogleditor_stateTreeSamplerItem *> m_samplerItems;
-    vogl::vector<vogleditor_stateTreeBufferItem *> m_bufferItems;
     vogl::vector<vogleditor_stateTreeLightItem *> m_lightItems;
     vogl::vector<vogleditor_stateTreeContextMaterialItem *> m_materialItems;
     vogl::vector<vogleditor_stateTreeMatrixStackItem *> m_matrixStackItems;
-    vogl::vector<vogleditor_stateTreeQueryItem *> m_queryItems;
-    vogl::vector<vogleditor_stateTreeRenderbufferItem *> m_renderbufferItems;
-    vogl::vector<vogleditor_stateTreeVertexArrayItem *> m_vertexArrayItems;
-    vogl::vector<vogleditor_stateTreeFramebufferItem *> m_framebufferItems;
-    vogl::vector<vogleditor_stateTreeShaderItem *> m_shaderItems;
-    vogl::vector<vogleditor_stateTreeProgramItem *> m_programItems;
-    vogl::vector<vogleditor_stateTreeSyncItem *> m_syncItems;
-    vogl::vector<vogleditor_stateTreeArbProgramItem *> m_arbProgramItems;
     vogl::vector<vogleditor_stateTreeArbProgramEnvItem *> m_arbProgramEnvItems;
-    vogl::vector<vogleditor_stateTreeProgramPipelineItem *> m_programPipelineItems;
 };
 
 #endif // VOGLEDITOR_STATETREECONTEXTITEM_H
@@ -11,6 +11,13 @@ vogleditor_stateTreeFramebufferBoolItem::vogleditor_stateTreeFramebufferBoolItem
     setValue(val != 0);
 }
 
+void vogleditor_stateTreeFramebufferBoolItem::set_state(const vogl_framebuffer_state *pState)
+{
+    const vogl_framebuffer_state::GLenum_to_attachment_map &rAttachments = pState->get_attachments();
+    vogl_framebuffer_state::GLenum_to_attachment_map::const_iterator iter = rAttachments.find(m_attachment);
+    m_pState = (iter != rAttachments.end()) ? &(iter->second) : NULL;
+}
+
 bool vogleditor_stateTreeFramebufferBoolItem::hasChanged() const
 {
     if (m_pDiffBaseState == NULL)
@@ -49,6 +56,13 @@ vogleditor_stateTreeFramebufferIntItem::vogleditor_stateTreeFramebufferIntItem(Q
     setValue(val);
 }
 
+void vogleditor_stateTreeFramebufferIntItem::set_state(const vogl_framebuffer_state *pState)
+{
+    const vogl_framebuffer_state::GLenum_to_attachment_map &rAttachments = pState->get_attachments();
+    vogl_framebuffer_state::GLenum_to_attachment_map::const_iterator iter = rAttachments.find(m_attachment);
+    m_pState = (iter != rAttachments.end()) ? &(iter->second) : NULL;
+}
+
 bool vogleditor_stateTreeFramebufferIntItem::hasChanged() const
 {
     if (m_pDiffBaseState == NULL)
@@ -87,6 +101,13 @@ vogleditor_stateTreeFramebufferEnumItem::vogleditor_stateTreeFramebufferEnumItem
     setValue(enum_to_string(val));
 }
 
+void vogleditor_stateTreeFramebufferEnumItem::set_state(const vogl_framebuffer_state *pState)
+{
+    const vogl_framebuffer_state::GLenum_to_attachment_map &rAttachments = pState->get_attachments();
+    vogl_framebuffer_state::GLenum_to_attachment_map::const_iterator iter = rAttachments.find(m_attachment);
+    m_pState = (iter != rAttachments.end()) ? &(iter->second) : NULL;
+}
+
 bool vogleditor_stateTreeFramebufferEnumItem::hasChanged() const
 {
     if (m_pDiffBaseState == NULL)
@@ -123,6 +144,11 @@ vogleditor_stateTreeFramebufferReadbufferItem::vogleditor_stateTreeFramebufferRe
     setValue(enum_to_string(m_pState->get_read_buffer()));
 }
 
+void vogleditor_stateTreeFramebufferReadbufferItem::set_state(const vogl_framebuffer_state *pState)
+{
+    m_pState = pState;
+}
+
 bool vogleditor_stateTreeFramebufferReadbufferItem::hasChanged() const
 {
     if (m_pDiffBaseState == NULL)
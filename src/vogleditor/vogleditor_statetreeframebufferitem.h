@@ -22,6 +22,8 @@ public:
         m_pDiffBaseState = pBaseState;
     }
 
+    virtual void set_state(const vogl_framebuffer_state *pState) = 0;
+
     GLenum get_attachment() const
     {
         return m_attachment;
@@ -48,6 +50,8 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_framebuffer_state *pState);
+
     virtual bool hasChanged() const;
 
     virtual QString getDiffedValue() const;
@@ -66,6 +70,8 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_framebuffer_state *pState);
+
     virtual bool hasChanged() const;
 
     virtual QString getDiffedValue() const;
@@ -84,6 +90,8 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_framebuffer_state *pState);
+
     virtual bool hasChanged() const;
 
     virtual QString getDiffedValue() const;
@@ -102,6 +110,8 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_framebuffer_state *pState);
+
     virtual bool hasChanged() const;
 
     virtual QString getDiffedValue() const;
@@ -138,6 +148,17 @@ public:
         }
     }
 
+    // Shows another framebuffer with the same state, e.g. the same framebuffer in another snapshot.
+    void set_state(vogl_framebuffer_state *pState)
+    {
+        m_pFramebufferState = pState;
+
+        for (vogleditor_stateTreeFramebufferDiffableItem **iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
+        {
+            (*iter)->set_state(pState);
+        }
+    }
+
     GLuint64 get_handle() const
     {
         return m_handle;
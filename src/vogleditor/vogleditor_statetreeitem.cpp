@@ -34,13 +34,16 @@ vogleditor_stateTreeItem::vogleditor_stateTreeItem(QList<QVariant> columnTitles,
     : m_columnData(columnTitles),
       m_parentItem(NULL),
       m_pModel(pModel),
-      m_bWasEdited(false)
+      m_bWasEdited(false),
+      m_changed(-1)
 {
 }
 
 vogleditor_stateTreeItem::vogleditor_stateTreeItem(QString name, QString value, vogleditor_stateTreeItem *parent)
     : m_parentItem(parent),
-      m_pModel(NULL)
+      m_pModel(NULL),
+      m_bWasEdited(false),
+      m_changed(-1)
 {
     m_columnData << name;
     m_columnData << value;
@@ -211,6 +214,19 @@ void vogleditor_stateTreeItem::appendChild(vogleditor_stateTreeItem *pChild)
     m_childItems.append(pChild);
 }
 
+void vogleditor_stateTreeItem::insertChild(int row, vogleditor_stateTreeItem *pChild)
+{
+    pChild->m_parentItem = this;
+    m_childItems.insert(row, pChild);
+}
+
+vogleditor_stateTreeItem *vogleditor_stateTreeItem::takeChild(int row)
+{
+    vogleditor_stateTreeItem *pChild = m_childItems.takeAt(row);
+    pChild->m_parentItem = NULL;
+    return pChild;
+}
+
 void vogleditor_stateTreeItem::transferChildren(vogleditor_stateTreeItem *pNewParent)
 {
     // transfer the children to the new parent, then clear our list of children
@@ -262,14 +278,14 @@ QVariant vogleditor_stateTreeItem::columnData(int column, int role) const
         return QVariant();
     }
 
-    if (role == Qt::ForegroundRole && parent() != NULL && hasChanged())
+    if (role == Qt::ForegroundRole && parent() != NULL && isChanged())
     {
         return QVariant(QColor(Qt::red));
     }
 
     if (role == Qt::ToolTipRole)
     {
-        if (hasChanged())
+        if (isChanged())
         {
             QString prevValue = getDiffedValue();
             if (prevValue.isEmpty())
@@ -302,7 +318,7 @@ bool vogleditor_stateTreeItem::hasChanged() const
 {
     for (int i = 0; i < m_childItems.size(); i++)
     {
-        if (m_childItems[i]->hasChanged())
+        if (m_childItems[i]->isChanged())
         {
             return true;
         }
@@ -311,6 +327,34 @@ bool vogleditor_stateTreeItem::hasChanged() const
     return false;
 }
 
+bool vogleditor_stateTreeItem::isChanged() const
+{
+    if (m_changed < 0)
+    {
+        m_changed = hasChanged() ? 1 : 0;
+    }
+
+    return m_changed != 0;
+}
+
+void vogleditor_stateTreeItem::clearChangedCache()
+{
+    m_changed = -1;
+
+    for (int i = 0; i < m_childItems.size(); i++)
+    {
+        m_childItems[i]->clearChangedCache();
+    }
+}
+
+void vogleditor_stateTreeItem::clearParentsChangedCache()
+{
+    for (vogleditor_stateTreeItem *pItem = this; pItem != NULL; pItem = pItem->m_parentItem)
+    {
+        pItem->m_changed = -1;
+    }
+}
+
 //=============================================================================
 
 template <typename T>
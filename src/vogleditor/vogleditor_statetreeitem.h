@@ -84,6 +84,10 @@ public:
 
     void appendChild(vogleditor_stateTreeItem *pChild);
 
+    // Inserts an item that may have been taken from another parent. takeChild() removes a child without deleting it.
+    void insertChild(int row, vogleditor_stateTreeItem *pChild);
+    vogleditor_stateTreeItem *takeChild(int row);
+
     void transferChildren(vogleditor_stateTreeItem *pNewParent);
 
     int childCount() const;
@@ -98,6 +102,14 @@ public:
 
     virtual bool hasChanged() const;
 
+    // Cached result of hasChanged(), which may have to compare a whole subtree. The cache has to be cleared
+    // if the state of the item or of its diff base changes.
+    bool isChanged() const;
+    void clearChangedCache();
+
+    // Only clears the cache of this item and its parents, for when some of its children were replaced.
+    void clearParentsChangedCache();
+
     virtual QString getDiffedValue() const
     {
         return "";
@@ -134,6 +146,7 @@ protected:
     vogleditor_stateTreeItem *m_parentItem;
     vogleditor_QStateTreeModel *m_pModel;
     bool m_bWasEdited;
+    mutable int m_changed; // -1 until isChanged() was called
 
     static QString enum_to_string(GLenum id)
     {
@@ -173,6 +186,9 @@ public:
         m_pDiffBaseState = pBaseState;
     }
 
+    // Shows the same state from another state vector, e.g. the one of the same object in another snapshot.
+    virtual void set_state(const vogl_state_vector *pState) = 0;
+
 protected:
     const vogl_state_vector *m_pDiffBaseState;
 };
@@ -187,6 +203,11 @@ public:
         m_pStateVec = NULL;
     }
 
+    virtual void set_state(const vogl_state_vector *pState)
+    {
+        m_pStateVec = pState;
+    }
+
     virtual bool hasChanged() const;
 
     virtual QString getDiffedValue() const;
@@ -265,6 +286,11 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_state_vector *pState)
+    {
+        m_pState = pState;
+    }
+
     virtual bool hasChanged() const;
 
     virtual QString getDiffedValue() const;
@@ -299,6 +325,16 @@ public:
         }
     }
 
+    virtual void set_state(const vogl_state_vector *pState)
+    {
+        m_pState = pState;
+
+        for (vogleditor_stateTreeStateVecMatrixRowItem **iter = m_rowItems.begin(); iter != m_rowItems.end(); iter++)
+        {
+            (*iter)->set_state(pState);
+        }
+    }
+
 private:
     const vogl_state_vector *m_pState;
     vogl::vector<vogleditor_stateTreeStateVecMatrixRowItem *> m_rowItems;
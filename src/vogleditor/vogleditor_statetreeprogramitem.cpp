@@ -212,32 +212,33 @@ QString vogleditor_stateTreeProgramUniformItem::getDiffedValue() const
 
 vogleditor_stateTreeProgramItem::vogleditor_stateTreeProgramItem(QString name, QString value, vogleditor_stateTreeItem *parentNode, vogl_program_state &state, const vogl_context_info &info)
     : vogleditor_stateTreeItem(name, value, parentNode),
-      m_pState(&state)
+      m_pState(&state),
+      m_pDiffBaseState(NULL)
 {
     QString tmp;
 
     // basic info
-    this->appendChild(new vogleditor_stateTreeProgramBoolItem("GL_LINK_STATUS", &vogl_program_state::get_link_status, this, state));
+    add_diffable_child(new vogleditor_stateTreeProgramBoolItem("GL_LINK_STATUS", &vogl_program_state::get_link_status, this, state));
     if (info.supports_extension("GL_ARB_separate_shader_objects"))
-        this->appendChild(new vogleditor_stateTreeProgramBoolItem("GL_PROGRAM_SEPARABLE", &vogl_program_state::get_separable, this, state));
-    this->appendChild(new vogleditor_stateTreeProgramBoolItem("GL_DELETE_STATUS", &vogl_program_state::get_marked_for_deletion, this, state));
-    this->appendChild(new vogleditor_stateTreeProgramBoolItem("GL_VALIDATE_STATUS", &vogl_program_state::get_verify_status, this, state));
+        add_diffable_child(new vogleditor_stateTreeProgramBoolItem("GL_PROGRAM_SEPARABLE", &vogl_program_state::get_separable, this, state));
+    add_diffable_child(new vogleditor_stateTreeProgramBoolItem("GL_DELETE_STATUS", &vogl_program_state::get_marked_for_deletion, this, state));
+    add_diffable_child(new vogleditor_stateTreeProgramBoolItem("GL_VALIDATE_STATUS", &vogl_program_state::get_verify_status, this, state));
     if (info.get_version() >= VOGL_GL_VERSION_3_1)
     {
-        this->appendChild(new vogleditor_stateTreeProgramUIntItem("GL_ACTIVE_UNIFORM_BLOCKS", &vogl_program_state::get_num_active_uniform_blocks, this, state));
+        add_diffable_child(new vogleditor_stateTreeProgramUIntItem("GL_ACTIVE_UNIFORM_BLOCKS", &vogl_program_state::get_num_active_uniform_blocks, this, state));
     }
 
     // program binary
     this->appendChild(new vogleditor_stateTreeItem("GL_PROGRAM_BINARY_RETRIEVABLE_HINT", "TODO", this));
-    this->appendChild(new vogleditor_stateTreeProgramUIntItem("GL_PROGRAM_BINARY_LENGTH", &vogl_program_state::get_program_binary_size, this, state));
-    this->appendChild(new vogleditor_stateTreeProgramEnumItem("GL_PROGRAM_BINARY_FORMAT", &vogl_program_state::get_program_binary_format, this, state));
+    add_diffable_child(new vogleditor_stateTreeProgramUIntItem("GL_PROGRAM_BINARY_LENGTH", &vogl_program_state::get_program_binary_size, this, state));
+    add_diffable_child(new vogleditor_stateTreeProgramEnumItem("GL_PROGRAM_BINARY_FORMAT", &vogl_program_state::get_program_binary_format, this, state));
     if (m_pState->get_program_binary().size() > 0)
     {
         this->appendChild(new vogleditor_stateTreeItem("Program Binary", "TODO: open in a new tab", this));
     }
 
     // info log
-    this->appendChild(new vogleditor_stateTreeProgramLogItem("GL_INFO_LOG_LENGTH", &vogl_program_state::get_info_log, this, state));
+    add_diffable_child(new vogleditor_stateTreeProgramLogItem("GL_INFO_LOG_LENGTH", &vogl_program_state::get_info_log, this, state));
 
     // linked shaders
     const vogl_unique_ptr<vogl_program_state> &linked_program = m_pState->get_link_time_snapshot();
@@ -251,7 +252,9 @@ vogleditor_stateTreeProgramItem::vogleditor_stateTreeProgramItem(QString name, Q
         {
             vogl_shader_state &shader = const_cast<vogl_shader_state &>(linked_program->get_shaders()[i]);
             GLuint64 shaderId = shader.get_snapshot_handle();
-            pLinkedShadersNode->appendChild(new vogleditor_stateTreeShaderItem(tmp.sprintf("%" PRIu64, shaderId), enum_to_string(shader.get_shader_type()), pLinkedShadersNode, shader));
+            vogleditor_stateTreeShaderItem *pItem = new vogleditor_stateTreeShaderItem(tmp.sprintf("%" PRIu64, shaderId), enum_to_string(shader.get_shader_type()), pLinkedShadersNode, shader);
+            m_linkedShaderItems.push_back(pItem);
+            pLinkedShadersNode->appendChild(pItem);
         }
     }
 
@@ -263,7 +266,9 @@ vogleditor_stateTreeProgramItem::vogleditor_stateTreeProgramItem(QString name, Q
     {
         vogl_shader_state &shader = const_cast<vogl_shader_state &>(m_pState->get_shaders()[i]);
         GLuint64 shaderId = shader.get_snapshot_handle();
-        pAttachedShadersNode->appendChild(new vogleditor_stateTreeShaderItem(tmp.sprintf("%" PRIu64, shaderId), enum_to_string(shader.get_shader_type()), pAttachedShadersNode, shader));
+        vogleditor_stateTreeShaderItem *pItem = new vogleditor_stateTreeShaderItem(tmp.sprintf("%" PRIu64, shaderId), enum_to_string(shader.get_shader_type()), pAttachedShadersNode, shader);
+        m_attachedShaderItems.push_back(pItem);
+        pAttachedShadersNode->appendChild(pItem);
     }
 
     // active attribs
@@ -299,3 +304,33 @@ void vogleditor_stateTreeProgramItem::add_diffable_child(vogleditor_stateTreePro
     m_diffableItems.push_back(pItem);
     appendChild(pItem);
 }
+
+void vogleditor_stateTreeProgramItem::set_state(vogl_program_state *pState)
+{
+    m_pState = pState;
+    for (vogleditor_stateTreeProgramDiffableItem **iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
+    {
+        (*iter)->set_state(pState);
+    }
+
+    for (uint i = 0; i < m_attribItems.size(); i++)
+    {
+        m_attribItems[i]->set_state(&(pState->get_attrib_state_vec()[i]));
+    }
+
+    for (uint i = 0; i < m_uniformItems.size(); i++)
+    {
+        m_uniformItems[i]->set_state(&(pState->get_uniform_state_vec()[i]));
+    }
+
+    const vogl_unique_ptr<vogl_program_state> &linked_program = pState->get_link_time_snapshot();
+    for (uint i = 0; i < m_linkedShaderItems.size(); i++)
+    {
+        m_linkedShaderItems[i]->set_state(const_cast<vogl_shader_state *>(&(linked_program->get_shaders()[i])));
+    }
+
+    for (uint i = 0; i < m_attachedShaderItems.size(); i++)
+    {
+        m_attachedShaderItems[i]->set_state(const_cast<vogl_shader_state *>(&(pState->get_shaders()[i])));
+    }
+}
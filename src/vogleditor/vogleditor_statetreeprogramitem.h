@@ -4,6 +4,8 @@
 #include "vogleditor_statetreeitem.h"
 #include "vogl_program_state.h"
 
+class vogleditor_stateTreeShaderItem;
+
 class vogleditor_stateTreeProgramDiffableItem : public vogleditor_stateTreeItem
 {
 public:
@@ -19,6 +21,11 @@ public:
         m_pDiffBaseState = pBaseState;
     }
 
+    void set_state(const vogl_program_state *pState)
+    {
+        m_pState = pState;
+    }
+
     const vogl_program_state *get_current_state() const
     {
         return m_pState;
@@ -130,6 +137,11 @@ public:
         m_pDiffBaseState = pBaseState;
     }
 
+    void set_state(const vogl_program_attrib_state *pState)
+    {
+        m_pState = pState;
+    }
+
     virtual bool hasChanged() const;
     virtual QString getDiffedValue() const;
 
@@ -157,6 +169,11 @@ public:
         m_pDiffBaseState = pBaseState;
     }
 
+    void set_state(const vogl_program_uniform_state *pState)
+    {
+        m_pState = pState;
+    }
+
     virtual bool hasChanged() const;
     virtual QString getDiffedValue() const;
 
@@ -205,20 +222,25 @@ public:
 
         for (vogleditor_stateTreeProgramAttribItem **iter = m_attribItems.begin(); iter != m_attribItems.end(); iter++)
         {
-            (*iter)->set_diff_base_state(&(pBaseState->get_attrib_state_vec()));
+            (*iter)->set_diff_base_state((pBaseState != NULL) ? &(pBaseState->get_attrib_state_vec()) : NULL);
         }
 
         for (vogleditor_stateTreeProgramUniformItem **iter = m_uniformItems.begin(); iter != m_uniformItems.end(); iter++)
         {
-            (*iter)->set_diff_base_state(&(pBaseState->get_uniform_state_vec()));
+            (*iter)->set_diff_base_state((pBaseState != NULL) ? &(pBaseState->get_uniform_state_vec()) : NULL);
         }
     }
 
+    // Shows another program with the same state, e.g. the same program in another snapshot.
+    void set_state(vogl_program_state *pState);
+
 private:
     vogl_program_state *m_pState;
     const vogl_program_state *m_pDiffBaseState;
     vogl::vector<vogleditor_stateTreeProgramDiffableItem *> m_diffableItems;
     vogl::vector<vogleditor_stateTreeProgramAttribItem *> m_attribItems;
     vogl::vector<vogleditor_stateTreeProgramUniformItem *> m_uniformItems;
+    vogl::vector<vogleditor_stateTreeShaderItem *> m_linkedShaderItems;
+    vogl::vector<vogleditor_stateTreeShaderItem *> m_attachedShaderItems;
 };
 #endif // VOGLEDITOR_STATETREEPROGRAMITEM_H
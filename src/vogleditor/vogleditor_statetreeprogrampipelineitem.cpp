@@ -62,13 +62,19 @@ vogleditor_stateTreeProgramPipelineItem::vogleditor_stateTreeProgramPipelineItem
       m_pDiffBaseState(NULL)
 {
     // TODO : Implement this
-    this->appendChild(new vogleditor_stateTreeProgramPipelineUIntItem("GL_ACTIVE_PROGRAM", &vogl_sso_state::get_active_program, this, state));
-    this->appendChild(new vogleditor_stateTreeProgramPipelineUIntItem("GL_INFO_LOG_LENGTH", &vogl_sso_state::get_info_log_length, this, state));
+    add_diffable_child(new vogleditor_stateTreeProgramPipelineUIntItem("GL_ACTIVE_PROGRAM", &vogl_sso_state::get_active_program, this, state));
+    add_diffable_child(new vogleditor_stateTreeProgramPipelineUIntItem("GL_INFO_LOG_LENGTH", &vogl_sso_state::get_info_log_length, this, state));
     // Ideally for Program Objs in state tree display, we could create stateTreeProgramItem objects, but need lots of plumbing to get there.
     // Currently only displaying Programs that have non-zero Prog Obj bound. This saves space and avoids any issue of querying for unsupported shader types on MESA.
     for (uint32_t i = 0; i < m_pState->cNumShaders; i++)
     {
         if (0 != m_pState->get_shader_program(i))
-            this->appendChild(new vogleditor_stateTreeProgramPipelineUIntVecItem(enum_to_string(vogl_sso_state::gl_shader_type_mapping[i]), &vogl_sso_state::get_shader_program, i, this, state));
+            add_diffable_child(new vogleditor_stateTreeProgramPipelineUIntVecItem(enum_to_string(vogl_sso_state::gl_shader_type_mapping[i]), &vogl_sso_state::get_shader_program, i, this, state));
     }
 }
+
+void vogleditor_stateTreeProgramPipelineItem::add_diffable_child(vogleditor_stateTreeProgramPipelineDiffableItem *pItem)
+{
+    m_diffableItems.push_back(pItem);
+    appendChild(pItem);
+}
@@ -18,6 +18,10 @@ public:
     {
         m_pDiffBaseState = pBaseState;
     }
+    void set_state(const vogl_sso_state *pState)
+    {
+        m_pState = pState;
+    }
     const vogl_sso_state *get_current_state() const
     {
         return m_pState;
@@ -86,12 +90,24 @@ public:
         }
     }
 
+    // Shows another pipeline with the same state, e.g. the same pipeline in another snapshot.
+    void set_state(const vogl_sso_state *pState)
+    {
+        m_pState = pState;
+        for (vogleditor_stateTreeProgramPipelineDiffableItem **iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
+        {
+            (*iter)->set_state(pState);
+        }
+    }
+
     GLuint64 get_handle() const
     {
         return m_handle;
     }
 
 private:
+    void add_diffable_child(vogleditor_stateTreeProgramPipelineDiffableItem *pItem);
+
     GLuint64 m_handle;
     const vogl_sso_state *m_pState;
     const vogl_sso_state *m_pDiffBaseState;
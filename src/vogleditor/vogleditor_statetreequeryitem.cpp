@@ -19,6 +19,11 @@ void vogleditor_stateTreeQueryItem::set_diff_base_state(const vogl_query_state *
     m_pDiffBaseState = pBaseState;
 }
 
+void vogleditor_stateTreeQueryItem::set_state(const vogl_query_state *pState)
+{
+    m_pState = pState;
+}
+
 bool vogleditor_stateTreeQueryItem::hasChanged() const
 {
     if (m_pDiffBaseState == NULL)
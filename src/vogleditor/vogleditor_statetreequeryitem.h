@@ -17,6 +17,9 @@ public:
 
     void set_diff_base_state(const vogl_query_state *pBaseState);
 
+    // Shows another query with the same state, e.g. the same query in another snapshot.
+    void set_state(const vogl_query_state *pState);
+
     GLuint64 get_handle() const
     {
         return m_handle;
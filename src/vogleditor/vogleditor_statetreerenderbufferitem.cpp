@@ -3,9 +3,8 @@
 #include "vogl_renderbuffer_state.h"
 
 vogleditor_stateTreeRenderbufferIntItem::vogleditor_stateTreeRenderbufferIntItem(QString name, GLenum enumName, vogleditor_stateTreeItem *parent, const vogl_renderbuffer_state &state)
-    : vogleditor_stateTreeRenderbufferDiffableItem(name, "", parent),
-      m_enum(enumName),
-      m_pState(&state)
+    : vogleditor_stateTreeRenderbufferDiffableItem(name, "", parent, state),
+      m_enum(enumName)
 {
     int val = 0;
     if (m_pState->get_desc().get_int(m_enum, &val))
@@ -52,9 +51,8 @@ QString vogleditor_stateTreeRenderbufferIntItem::getDiffedValue() const
 //=============================================================================
 
 vogleditor_stateTreeRenderbufferEnumItem::vogleditor_stateTreeRenderbufferEnumItem(QString name, GLenum enumName, vogleditor_stateTreeItem *parent, const vogl_renderbuffer_state &state)
-    : vogleditor_stateTreeRenderbufferDiffableItem(name, "", parent),
-      m_enum(enumName),
-      m_pState(&state)
+    : vogleditor_stateTreeRenderbufferDiffableItem(name, "", parent, state),
+      m_enum(enumName)
 {
     int val = 0;
     if (m_pState->get_desc().get_int(m_enum, &val))
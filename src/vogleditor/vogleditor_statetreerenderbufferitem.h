@@ -8,20 +8,32 @@ class vogl_renderbuffer_state;
 class vogleditor_stateTreeRenderbufferDiffableItem : public vogleditor_stateTreeItem
 {
 public:
-    vogleditor_stateTreeRenderbufferDiffableItem(QString name, QString value, vogleditor_stateTreeItem *parent)
+    vogleditor_stateTreeRenderbufferDiffableItem(QString name, QString value, vogleditor_stateTreeItem *parent, const vogl_renderbuffer_state &state)
         : vogleditor_stateTreeItem(name, value, parent),
+          m_pState(&state),
           m_pDiffBaseState(NULL)
     {
     }
+    virtual ~vogleditor_stateTreeRenderbufferDiffableItem()
+    {
+        m_pState = NULL;
+        m_pDiffBaseState = NULL;
+    }
 
     void set_diff_base_state(const vogl_renderbuffer_state *pBaseState)
     {
         m_pDiffBaseState = pBaseState;
     }
 
+    void set_state(const vogl_renderbuffer_state *pState)
+    {
+        m_pState = pState;
+    }
+
     virtual bool hasChanged() const = 0;
 
 protected:
+    const vogl_renderbuffer_state *m_pState;
     const vogl_renderbuffer_state *m_pDiffBaseState;
 };
 
@@ -29,34 +41,22 @@ class vogleditor_stateTreeRenderbufferIntItem : public vogleditor_stateTreeRende
 {
 public:
     vogleditor_stateTreeRenderbufferIntItem(QString name, GLenum enumName, vogleditor_stateTreeItem *parent, const vogl_renderbuffer_state &state);
-    virtual ~vogleditor_stateTreeRenderbufferIntItem()
-    {
-        m_pState = NULL;
-    }
-
     virtual bool hasChanged() const;
     virtual QString getDiffedValue() const;
 
 private:
     GLenum m_enum;
-    const vogl_renderbuffer_state *m_pState;
 };
 
 class vogleditor_stateTreeRenderbufferEnumItem : public vogleditor_stateTreeRenderbufferDiffableItem
 {
 public:
     vogleditor_stateTreeRenderbufferEnumItem(QString name, GLenum enumName, vogleditor_stateTreeItem *parent, const vogl_renderbuffer_state &state);
-    virtual ~vogleditor_stateTreeRenderbufferEnumItem()
-    {
-        m_pState = NULL;
-    }
-
     virtual bool hasChanged() const;
     virtual QString getDiffedValue() const;
 
 private:
     GLenum m_enum;
-    const vogl_renderbuffer_state *m_pState;
 };
 
 class vogleditor_stateTreeRenderbufferItem : public vogleditor_stateTreeItem
@@ -78,6 +78,16 @@ public:
         }
     }
 
+    // Shows another renderbuffer with the same state, e.g. the same renderbuffer in another snapshot.
+    void set_state(const vogl_renderbuffer_state *pState)
+    {
+        m_pState = pState;
+        for (vogleditor_stateTreeRenderbufferDiffableItem **iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
+        {
+            (*iter)->set_state(pState);
+        }
+    }
+
     GLuint64 get_handle() const
     {
         return m_handle;
@@ -22,6 +22,9 @@ public:
 
     void set_diff_base_state(const vogl_sampler_state *pBaseState);
 
+    // Shows another sampler with the same state, e.g. the same sampler in another snapshot.
+    void set_state(const vogl_sampler_state *pState);
+
 private:
     const vogl_sampler_state *m_pState;
     const vogl_sampler_state *m_pDiffBaseState;
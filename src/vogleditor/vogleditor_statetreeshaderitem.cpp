@@ -125,7 +125,8 @@ QString vogleditor_stateTreeShaderStringItem::getDiffedValue() const
 
 vogleditor_stateTreeShaderItem::vogleditor_stateTreeShaderItem(QString name, QString value, vogleditor_stateTreeItem *parentNode, vogl_shader_state &state)
     : vogleditor_stateTreeItem(name, value, parentNode),
-      m_pState(&state)
+      m_pState(&state),
+      m_pDiffBaseState(NULL)
 {
     QString tmp;
 
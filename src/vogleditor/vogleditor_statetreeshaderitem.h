@@ -20,6 +20,11 @@ public:
         m_pDiffBaseState = pBaseState;
     }
 
+    void set_state(const vogl_shader_state *pState)
+    {
+        m_pState = pState;
+    }
+
     const vogl_shader_state *get_current_state() const
     {
         return m_pState;
@@ -134,6 +139,16 @@ public:
         }
     }
 
+    // Shows another shader with the same state, e.g. the same shader in another snapshot.
+    void set_state(vogl_shader_state *pState)
+    {
+        m_pState = pState;
+        for (vogleditor_stateTreeShaderDiffableItem **iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
+        {
+            (*iter)->set_state(pState);
+        }
+    }
+
 private:
     vogl_shader_state *m_pState;
     const vogl_shader_state *m_pDiffBaseState;
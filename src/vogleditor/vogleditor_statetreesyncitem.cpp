@@ -19,6 +19,11 @@ void vogleditor_stateTreeSyncItem::set_diff_base_state(const vogl_sync_state *pB
     m_pDiffBaseState = pBaseState;
 }
 
+void vogleditor_stateTreeSyncItem::set_state(const vogl_sync_state *pState)
+{
+    m_pState = pState;
+}
+
 bool vogleditor_stateTreeSyncItem::hasChanged() const
 {
     if (m_pDiffBaseState == NULL)
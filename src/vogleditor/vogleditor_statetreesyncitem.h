@@ -22,6 +22,9 @@ public:
 
     virtual void set_diff_base_state(const vogl_sync_state *pBaseState);
 
+    // Shows another sync object with the same state, e.g. the same sync object in another snapshot.
+    void set_state(const vogl_sync_state *pState);
+
     virtual bool hasChanged() const;
 
 private:
@@ -21,6 +21,12 @@ public:
         m_pDiffBaseState = pBaseState;
     }
 
+    virtual void set_state(const vogl_state_vector *pState)
+    {
+        VOGL_NOTE_UNUSED(pState);
+        VOGL_ASSERT(!"This version of the function is not supported for vogleditor_stateTreeTexEnvStateVecDiffableItem");
+    }
+
     GLenum get_target() const
     {
         return m_target;
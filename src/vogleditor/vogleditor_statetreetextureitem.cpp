@@ -7,7 +7,21 @@ void vogleditor_stateTreeTextureItem::set_diff_base_state(const vogl_texture_sta
     m_pDiffBaseState = pBaseState;
     for (vogleditor_stateTreeStateVecDiffableItem **iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
     {
-        (*iter)->set_diff_base_state(&(pBaseState->get_params()));
+        (*iter)->set_diff_base_state((pBaseState != NULL) ? &(pBaseState->get_params()) : NULL);
+    }
+}
+
+void vogleditor_stateTreeTextureItem::set_state(vogl_texture_state *pState)
+{
+    m_pTexture = pState;
+    for (vogleditor_stateTreeStateVecDiffableItem **iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
+    {
+        (*iter)->set_state(&(pState->get_params()));
+    }
+
+    for (level_item *iter = m_levelItems.begin(); iter != m_levelItems.end(); iter++)
+    {
+        iter->pItem->set_state(&(pState->get_level_params(iter->face, iter->level)));
     }
 }
 
@@ -124,15 +138,19 @@ vogleditor_stateTreeTextureItem::vogleditor_stateTreeTextureItem(QString name, Q
 // TODO: Check for core vs. compat profiles and not query the old stuff
 #undef GET_INT
 #undef GET_ENUM
-#define GET_INT(name, num)                                                                                                             \
-    if (level_params.get<int>(name, 0, iVals, num))                                                                                    \
-    {                                                                                                                                  \
-        pLevelNode->appendChild(new vogleditor_stateTreeStateVecIntItem(#name, name, 0, level_params, iVals, num, false, pLevelNode)); \
+#define GET_INT(name, num)                                                                                                                                          \
+    if (level_params.get<int>(name, 0, iVals, num))                                                                                                                 \
+    {                                                                                                                                                               \
+        level_item item = { face, static_cast<uint>(level), new vogleditor_stateTreeStateVecIntItem(#name, name, 0, level_params, iVals, num, false, pLevelNode) }; \
+        m_levelItems.push_back(item);                                                                                                                               \
+        pLevelNode->appendChild(item.pItem);                                                                                                                        \
     }
-#define GET_ENUM(name, num)                                                                                                             \
-    if (level_params.get<int>(name, 0, iVals, num))                                                                                     \
-    {                                                                                                                                   \
-        pLevelNode->appendChild(new vogleditor_stateTreeStateVecEnumItem(#name, name, 0, level_params, iVals, num, false, pLevelNode)); \
+#define GET_ENUM(name, num)                                                                                                                                          \
+    if (level_params.get<int>(name, 0, iVals, num))                                                                                                                  \
+    {                                                                                                                                                                \
+        level_item item = { face, static_cast<uint>(level), new vogleditor_stateTreeStateVecEnumItem(#name, name, 0, level_params, iVals, num, false, pLevelNode) }; \
+        m_levelItems.push_back(item);                                                                                                                                \
+        pLevelNode->appendChild(item.pItem);                                                                                                                         \
     }
             GET_INT(GL_TEXTURE_WIDTH, 1);
             GET_INT(GL_TEXTURE_HEIGHT, 1);
@@ -26,9 +26,20 @@ public:
 
     void set_diff_base_state(const vogl_texture_state *pBaseState);
 
+    // Shows another texture with the same state, e.g. the same texture in another snapshot.
+    void set_state(vogl_texture_state *pState);
+
 private:
+    struct level_item
+    {
+        uint face;
+        uint level;
+        vogleditor_stateTreeStateVecDiffableItem *pItem;
+    };
+
     vogl_texture_state *m_pTexture;
     const vogl_texture_state *m_pDiffBaseState;
     vogl::vector<vogleditor_stateTreeStateVecDiffableItem *> m_diffableItems;
+    vogl::vector<level_item> m_levelItems;
 };
 #endif // VOGLEDITOR_STATETREETEXTUREITEM_H
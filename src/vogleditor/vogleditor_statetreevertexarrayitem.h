@@ -19,6 +19,8 @@ public:
         m_pDiffBaseState = pBaseState;
     }
 
+    virtual void set_state(const vogl_vao_state *pState) = 0;
+
     unsigned int get_array_index() const
     {
         return m_arrayIndex;
@@ -41,6 +43,11 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_vao_state *pState)
+    {
+        m_pState = &(pState->get_vertex_attrib_desc(m_arrayIndex));
+    }
+
     virtual bool hasChanged() const;
     virtual QString getDiffedValue() const;
 
@@ -59,6 +66,11 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_vao_state *pState)
+    {
+        m_pState = &(pState->get_vertex_attrib_desc(m_arrayIndex));
+    }
+
     virtual bool hasChanged() const;
     virtual QString getDiffedValue() const;
 
@@ -76,6 +88,11 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_vao_state *pState)
+    {
+        m_pState = &(pState->get_vertex_attrib_desc(m_arrayIndex));
+    }
+
     virtual bool hasChanged() const;
     virtual QString getDiffedValue() const;
 
@@ -93,6 +110,11 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_vao_state *pState)
+    {
+        m_pState = &(pState->get_vertex_attrib_desc(m_arrayIndex));
+    }
+
     virtual bool hasChanged() const;
     virtual QString getDiffedValue() const;
 
@@ -110,6 +132,11 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_vao_state *pState)
+    {
+        m_pState = &(pState->get_vertex_attrib_desc(m_arrayIndex));
+    }
+
     virtual bool hasChanged() const;
     virtual QString getDiffedValue() const;
 
@@ -127,6 +154,11 @@ public:
         m_pState = NULL;
     }
 
+    virtual void set_state(const vogl_vao_state *pState)
+    {
+        m_pState = pState;
+    }
+
     virtual bool hasChanged() const;
     virtual QString getDiffedValue() const;
 
@@ -154,6 +186,16 @@ public:
         }
     }
 
+    // Shows another vertex array with the same state, e.g. the same vertex array in another snapshot.
+    void set_state(vogl_vao_state *pState)
+    {
+        m_pState = pState;
+        for (vogleditor_stateTreeVertexArrayDiffableItem **iter = m_diffableItems.begin(); iter != m_diffableItems.end(); iter++)
+        {
+            (*iter)->set_state(pState);
+        }
+    }
+
     GLuint64 get_handle() const
     {
         return m_handle;
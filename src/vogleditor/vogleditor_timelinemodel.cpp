@@ -23,11 +23,66 @@
  *
  **************************************************************************/
 
+#include <algorithm>
+
 #include "vogleditor_timelinemodel.h"
 #include "vogleditor_timelineitem.h"
 
+// The finest level of the summary has at most this many buckets (and about as many as there are spans).
+static const int cMaxSummaryBuckets = 1 << 17;
+static const int cMinSummaryBuckets = 256;
+
+void vogleditor_timelineSummary::add(const vogleditor_timelineSummary &other)
+{
+    if (other.count == 0)
+    {
+        return;
+    }
+
+    if (count == 0)
+    {
+        *this = other;
+        return;
+    }
+
+    minDuration = std::min(minDuration, other.minDuration);
+    if (other.maxDuration > maxDuration)
+    {
+        maxDuration = other.maxDuration;
+        pLongestItem = other.pLongestItem;
+    }
+    totalDuration += other.totalDuration;
+    count += other.count;
+}
+
+void vogleditor_timelineSummary::add(vogleditor_timelineItem *pItem)
+{
+    vogleditor_timelineSummary item;
+    item.minDuration = item.maxDuration = pItem->getDuration();
+    item.totalDuration = pItem->getDuration();
+    item.count = 1;
+    item.pLongestItem = pItem;
+    add(item);
+}
+
+static bool timeline_item_begins_first(const vogleditor_timelineItem *pItem, const vogleditor_timelineItem *pOther)
+{
+    return pItem->getBeginTime() < pOther->getBeginTime();
+}
+
+static bool timeline_item_begins_before(double time, const vogleditor_timelineItem *pItem)
+{
+    return time < pItem->getBeginTime();
+}
+
+static bool timeline_item_begins_after(const vogleditor_timelineItem *pItem, double time)
+{
+    return pItem->getBeginTime() < time;
+}
+
 vogleditor_timelineModel::vogleditor_timelineModel()
-    : m_rootItem(NULL)
+    : m_rootItem(NULL),
+      m_revision(0)
 {
 }
 
@@ -44,3 +99,129 @@ vogleditor_timelineItem *vogleditor_timelineModel::get_root_item()
 {
     return m_rootItem;
 }
+
+void vogleditor_timelineModel::update_summary()
+{
+    m_revision++;
+    m_spans.clear();
+    m_markers.clear();
+    m_summaryLevels.clear();
+
+    if (m_rootItem == NULL)
+    {
+        return;
+    }
+
+    for (int c = 0; c < m_rootItem->childCount(); c++)
+    {
+        vogleditor_timelineItem *pChild = m_rootItem->child(c);
+        if (pChild->getDuration() < 0)
+        {
+            continue;
+        }
+
+        if (pChild->isMarker())
+            m_markers.append(pChild);
+        else
+            m_spans.append(pChild);
+    }
+
+    std::stable_sort(m_spans.begin(), m_spans.end(), timeline_item_begins_first);
+    std::stable_sort(m_markers.begin(), m_markers.end(), timeline_item_begins_first);
+
+    int numBuckets = cMinSummaryBuckets;
+    while (numBuckets < m_spans.size() && numBuckets < cMaxSummaryBuckets)
+    {
+        numBuckets *= 2;
+    }
+
+    // finest level: every span is added to each bucket it overlaps, with the part of its duration within the bucket
+    m_summaryLevels.append(QVector<vogleditor_timelineSummary>(numBuckets));
+    QVector<vogleditor_timelineSummary> &buckets = m_summaryLevels.last();
+
+    double bucketDuration = get_bucket_duration();
+    double rootBegin = m_rootItem->getBeginTime();
+    for (int i = 0; i < m_spans.size(); i++)
+    {
+        vogleditor_timelineItem *pSpan = m_spans[i];
+        int first = std::max(0, std::min(numBuckets - 1, (int)((pSpan->getBeginTime() - rootBegin) / bucketDuration)));
+        int last = std::max(first, std::min(numBuckets - 1, (int)((pSpan->getEndTime() - rootBegin) / bucketDuration)));
+        for (int b = first; b <= last; b++)
+        {
+            vogleditor_timelineSummary part;
+            part.add(pSpan);
+            if (first != last)
+            {
+                double bucketBegin = rootBegin + b * bucketDuration;
+                part.totalDuration = std::max(0.0, std::min(pSpan->getEndTime(), bucketBegin + bucketDuration) - std::max(pSpan->getBeginTime(), bucketBegin));
+            }
+            buckets[b].add(part);
+        }
+    }
+
+    // coarser levels
+    while (m_summaryLevels.last().size() > 1)
+    {
+        const QVector<vogleditor_timelineSummary> &fine = m_summaryLevels.last();
+        QVector<vogleditor_timelineSummary> coarse(fine.size() / 2);
+        for (int b = 0; b < coarse.size(); b++)
+        {
+            coarse[b] = fine[b * 2];
+            coarse[b].add(fine[b * 2 + 1]);
+        }
+        m_summaryLevels.append(coarse);
+    }
+}
+
+int vogleditor_timelineModel::find_first_span(double time) const
+{
+    // the span that begins last before time is the earliest one that may still be running
+    QVector<vogleditor_timelineItem *>::const_iterator it = std::upper_bound(m_spans.constBegin(), m_spans.constEnd(), time, timeline_item_begins_before);
+    return std::max(0, (int)(it - m_spans.constBegin()) - 1);
+}
+
+int vogleditor_timelineModel::find_first_marker(double time) const
+{
+    QVector<vogleditor_timelineItem *>::const_iterator it = std::lower_bound(m_markers.constBegin(), m_markers.constEnd(), time, timeline_item_begins_after);
+    return (int)(it - m_markers.constBegin());
+}
+
+double vogleditor_timelineModel::get_bucket_duration() const
+{
+    if (m_rootItem == NULL || m_summaryLevels.isEmpty())
+    {
+        return 0;
+    }
+
+    return m_rootItem->getDuration() / m_summaryLevels.first().size();
+}
+
+vogleditor_timelineSummary vogleditor_timelineModel::get_summary(double beginTime, double endTime) const
+{
+    vogleditor_timelineSummary summary;
+
+    double bucketDuration = get_bucket_duration();
+    if (bucketDuration <= 0 || endTime <= beginTime)
+    {
+        return summary;
+    }
+
+    // use the coarsest level whose buckets still fit within the range, so only a few buckets are needed
+    int level = 0;
+    while (level + 1 < m_summaryLevels.size() && bucketDuration * 2 <= endTime - beginTime)
+    {
+        bucketDuration *= 2;
+        level++;
+    }
+
+    const QVector<vogleditor_timelineSummary> &buckets = m_summaryLevels[level];
+    double rootBegin = m_rootItem->getBeginTime();
+    int first = std::max(0, (int)((beginTime - rootBegin) / bucketDuration));
+    int last = std::min(buckets.size() - 1, (int)((endTime - rootBegin) / bucketDuration));
+    for (int b = first; b <= last; b++)
+    {
+        summary.add(buckets[b]);
+    }
+
+    return summary;
+}
@@ -26,8 +26,33 @@
 #ifndef VOGLEDITOR_TIMELINEMODEL_H
 #define VOGLEDITOR_TIMELINEMODEL_H
 
+#include <QVector>
+
 class vogleditor_timelineItem;
 
+// Durations of the top level timeline spans within a range of time. A span that overlaps several
+// buckets of a summary is counted in each, but only with the part of its duration within the bucket.
+struct vogleditor_timelineSummary
+{
+    vogleditor_timelineSummary()
+        : minDuration(0),
+          maxDuration(0),
+          totalDuration(0),
+          count(0),
+          pLongestItem(NULL)
+    {
+    }
+
+    void add(const vogleditor_timelineSummary &other);
+    void add(vogleditor_timelineItem *pItem);
+
+    float minDuration;
+    float maxDuration;
+    double totalDuration;
+    int count;
+    vogleditor_timelineItem *pLongestItem;
+};
+
 class vogleditor_timelineModel
 {
 public:
@@ -36,8 +61,43 @@ public:
 
     vogleditor_timelineItem *get_root_item();
 
+    // Changes whenever the items of the timeline are recreated.
+    unsigned int get_revision() const
+    {
+        return m_revision;
+    }
+
+    // The top level spans and the frame markers of the root, sorted by begin time.
+    const QVector<vogleditor_timelineItem *> &get_spans() const
+    {
+        return m_spans;
+    }
+    const QVector<vogleditor_timelineItem *> &get_markers() const
+    {
+        return m_markers;
+    }
+
+    // Index of the first span that may still be running at time / of the first marker at or after time.
+    int find_first_span(double time) const;
+    int find_first_marker(double time) const;
+
+    // Spans are summarized in a pyramid of buckets: the finest level has buckets of get_bucket_duration(),
+    // every level above has half as many buckets of twice the duration. A summary is exact up to the
+    // duration of the buckets that are used for the range, which is at most as long as the range.
+    double get_bucket_duration() const;
+    vogleditor_timelineSummary get_summary(double beginTime, double endTime) const;
+
 protected:
+    // Must be called after the items below m_rootItem are (re)created.
+    void update_summary();
+
     vogleditor_timelineItem *m_rootItem;
+
+private:
+    unsigned int m_revision;
+    QVector<vogleditor_timelineItem *> m_spans;
+    QVector<vogleditor_timelineItem *> m_markers;
+    QVector<QVector<vogleditor_timelineSummary> > m_summaryLevels;
 };
 
 #endif // VOGLEDITOR_TIMELINEMODEL_H
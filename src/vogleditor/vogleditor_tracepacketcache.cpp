@@ -0,0 +1,191 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+#include "vogleditor_tracepacketcache.h"
+
+#include "vogl_trace_file_reader.h"
+#include "vogl_trace_packet.h"
+#include "vogl_trace_stream_types.h"
+
+vogleditor_tracePacketCache::vogleditor_tracePacketCache(vogl_binary_trace_file_reader *pTraceReader, const vogl_ctypes *pCtypes, uint32_t maxPackets)
+    : m_pTraceReader(pTraceReader),
+      m_pCtypes(pCtypes),
+      m_maxPackets(VOGL_MAX(maxPackets, 1U)),
+      m_head(-1),
+      m_tail(-1),
+      m_hits(0),
+      m_misses(0)
+{
+    m_slots.reserve(m_maxPackets);
+    m_slotMap.reserve(m_maxPackets);
+}
+
+vogleditor_tracePacketCache::~vogleditor_tracePacketCache()
+{
+    for (uint32_t i = 0; i < m_slots.size(); i++)
+    {
+        vogl_delete(m_slots[i].m_pPacket);
+        m_slots[i].m_pPacket = NULL;
+    }
+
+    m_slots.clear();
+    m_slotMap.clear();
+}
+
+bool vogleditor_tracePacketCache::is_supported(vogl_trace_file_reader *pTraceReader)
+{
+    return (pTraceReader != NULL) && (pTraceReader->get_type() == cBINARY_TRACE_FILE_READER);
+}
+
+void vogleditor_tracePacketCache::unlink(uint32_t slotIndex)
+{
+    slot &s = m_slots[slotIndex];
+
+    if (s.m_prev >= 0)
+        m_slots[s.m_prev].m_next = s.m_next;
+    else
+        m_head = s.m_next;
+
+    if (s.m_next >= 0)
+        m_slots[s.m_next].m_prev = s.m_prev;
+    else
+        m_tail = s.m_prev;
+
+    s.m_prev = -1;
+    s.m_next = -1;
+}
+
+void vogleditor_tracePacketCache::link_front(uint32_t slotIndex)
+{
+    slot &s = m_slots[slotIndex];
+
+    s.m_prev = -1;
+    s.m_next = m_head;
+
+    if (m_head >= 0)
+        m_slots[m_head].m_prev = slotIndex;
+    else
+        m_tail = slotIndex;
+
+    m_head = slotIndex;
+}
+
+void vogleditor_tracePacketCache::link_back(uint32_t slotIndex)
+{
+    slot &s = m_slots[slotIndex];
+
+    s.m_prev = m_tail;
+    s.m_next = -1;
+
+    if (m_tail >= 0)
+        m_slots[m_tail].m_next = slotIndex;
+    else
+        m_head = slotIndex;
+
+    m_tail = slotIndex;
+}
+
+uint32_t vogleditor_tracePacketCache::acquire_slot(uint64_t fileOffset)
+{
+    uint32_t slotIndex;
+
+    if (m_slots.size() < m_maxPackets)
+    {
+        slotIndex = m_slots.size();
+
+        slot &s = *m_slots.enlarge(1);
+        s.m_pPacket = vogl_new(vogl_trace_packet, m_pCtypes);
+        s.m_prev = -1;
+        s.m_next = -1;
+    }
+    else
+    {
+        // recycle the least recently used packet
+        slotIndex = m_tail;
+        unlink(slotIndex);
+        m_slotMap.erase(m_slots[slotIndex].m_fileOffset);
+    }
+
+    m_slots[slotIndex].m_fileOffset = fileOffset;
+    m_slotMap.insert(fileOffset, slotIndex);
+    link_front(slotIndex);
+
+    return slotIndex;
+}
+
+vogl_trace_packet *vogleditor_tracePacketCache::insert(uint64_t fileOffset)
+{
+    const uint32_t *pSlotIndex = m_slotMap.find_value(fileOffset);
+    if (pSlotIndex != NULL)
+    {
+        unlink(*pSlotIndex);
+        link_front(*pSlotIndex);
+        return m_slots[*pSlotIndex].m_pPacket;
+    }
+
+    return m_slots[acquire_slot(fileOffset)].m_pPacket;
+}
+
+vogl_trace_packet *vogleditor_tracePacketCache::get(uint64_t fileOffset)
+{
+    const uint32_t *pSlotIndex = m_slotMap.find_value(fileOffset);
+    if (pSlotIndex != NULL)
+    {
+        m_hits++;
+        unlink(*pSlotIndex);
+        link_front(*pSlotIndex);
+        return m_slots[*pSlotIndex].m_pPacket;
+    }
+
+    m_misses++;
+
+    // don't disturb whoever is reading the trace sequentially
+    vogl_scoped_location_saver saver(*m_pTraceReader);
+
+    if (!m_pTraceReader->seek(fileOffset) ||
+        (m_pTraceReader->read_next_packet() != vogl_trace_file_reader::cOK) ||
+        (m_pTraceReader->get_packet_type() != cTSPTGLEntrypoint))
+    {
+        vogl_error_printf("Failed reading GL entrypoint packet at trace file offset %" PRIu64 "\n", fileOffset);
+        return NULL;
+    }
+
+    uint32_t slotIndex = acquire_slot(fileOffset);
+    vogl_trace_packet *pPacket = m_slots[slotIndex].m_pPacket;
+
+    if (!pPacket->deserialize(m_pTraceReader->get_packet_buf().get_ptr(), m_pTraceReader->get_packet_buf().size(), false))
+    {
+        vogl_error_printf("Failed parsing GL entrypoint packet at trace file offset %" PRIu64 "\n", fileOffset);
+
+        // don't leave a half decoded packet behind in the cache, and recycle its slot first
+        m_slotMap.erase(fileOffset);
+        m_slots[slotIndex].m_fileOffset = cUINT64_MAX;
+        unlink(slotIndex);
+        link_back(slotIndex);
+        return NULL;
+    }
+
+    return pPacket;
+}
@@ -0,0 +1,107 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+#ifndef VOGLEDITOR_TRACEPACKETCACHE_H
+#define VOGLEDITOR_TRACEPACKETCACHE_H
+
+#include "vogl_common.h"
+#include "vogl_hash_map.h"
+
+class vogl_ctypes;
+class vogl_trace_packet;
+class vogl_trace_file_reader;
+class vogl_binary_trace_file_reader;
+
+// Keeps a bounded number of decoded GL entrypoint packets, keyed by their offset in the trace file.
+// Packets that fall out of the cache are read and decoded again from the trace when they are next requested,
+// so the API call tree only needs to remember where each call lives in the file.
+class vogleditor_tracePacketCache
+{
+public:
+    enum
+    {
+        cDefaultMaxPackets = 4096
+    };
+
+    vogleditor_tracePacketCache(vogl_binary_trace_file_reader *pTraceReader, const vogl_ctypes *pCtypes, uint32_t maxPackets = cDefaultMaxPackets);
+    ~vogleditor_tracePacketCache();
+
+    // Only binary traces can seek to an individual packet; packets from other traces have to stay resident.
+    static bool is_supported(vogl_trace_file_reader *pTraceReader);
+
+    // Returns a cache-owned packet for the specified file offset that the caller should deserialize into.
+    // Used while the trace is being read sequentially, so the packet doesn't have to be read again.
+    vogl_trace_packet *insert(uint64_t fileOffset);
+
+    // Returns the decoded packet at the specified file offset, reading it from the trace if it isn't cached.
+    // The returned packet remains valid until the cache has handed out maxPackets other packets.
+    // Returns NULL if the packet could not be read.
+    vogl_trace_packet *get(uint64_t fileOffset);
+
+    uint32_t size() const
+    {
+        return m_slots.size();
+    }
+
+    uint64_t hits() const
+    {
+        return m_hits;
+    }
+
+    uint64_t misses() const
+    {
+        return m_misses;
+    }
+
+private:
+    struct slot
+    {
+        uint64_t m_fileOffset;
+        vogl_trace_packet *m_pPacket;
+        int m_prev;
+        int m_next;
+    };
+
+    uint32_t acquire_slot(uint64_t fileOffset);
+    void unlink(uint32_t slotIndex);
+    void link_front(uint32_t slotIndex);
+    void link_back(uint32_t slotIndex);
+
+    vogl_binary_trace_file_reader *m_pTraceReader;
+    const vogl_ctypes *m_pCtypes;
+    uint32_t m_maxPackets;
+
+    vogl::vector<slot> m_slots;
+    vogl::hash_map<uint64_t, uint32_t> m_slotMap;
+
+    // most recently used slot is at the head, the next one to be recycled at the tail
+    int m_head;
+    int m_tail;
+
+    uint64_t m_hits;
+    uint64_t m_misses;
+};
+
+#endif // VOGLEDITOR_TRACEPACKETCACHE_H
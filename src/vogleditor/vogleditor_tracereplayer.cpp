@@ -4,18 +4,49 @@
 #include "vogleditor_frameitem.h"
 #include "vogleditor_tracereplayer.h"
 
+#include "vogl_cfile_stream.h"
 #include "vogl_find_files.h"
 #include "vogl_file_utils.h"
 #include "vogl_gl_replayer.h"
 #include "vogleditor_output.h"
 
+// Remembers every blob it writes, so clear_keyframes() can delete the spilled keyframe blobs again.
+class vogleditor_keyframeBlobManager : public vogl_loose_file_blob_manager
+{
+public:
+    vogleditor_keyframeBlobManager(vogl::hash_map<dynamic_string> &blobIds)
+        : m_blobIds(blobIds)
+    {
+    }
+
+    virtual dynamic_string add_buf_using_id(const void *pData, uint32_t size, const dynamic_string &id)
+    {
+        dynamic_string actual_id(vogl_loose_file_blob_manager::add_buf_using_id(pData, size, id));
+        if (!actual_id.is_empty())
+        {
+            m_blobIds.insert(actual_id);
+        }
+        return actual_id;
+    }
+
+private:
+    vogl::hash_map<dynamic_string> &m_blobIds;
+};
+
 vogleditor_traceReplayer::vogleditor_traceReplayer()
-    : m_pTraceReplayer(vogl_new(vogl_gl_replayer))
+    : m_pTraceReplayer(vogl_new(vogl_gl_replayer)),
+      m_keyframeInterval(0),
+      m_maxKeyframesInMemory(0),
+      m_bTakeKeyframes(false),
+      m_keyframeUseCounter(0),
+      m_pReplayKeyframe(NULL)
 {
 }
 
 vogleditor_traceReplayer::~vogleditor_traceReplayer()
 {
+    clear_keyframes();
+
     if (m_pTraceReplayer != NULL)
     {
         vogl_delete(m_pTraceReplayer);
@@ -33,6 +64,212 @@ void vogleditor_traceReplayer::enable_fs_preprocessor(std::string fs_preprocesso
     m_fs_preprocessor = fs_preprocessor;
 }
 
+void vogleditor_traceReplayer::enable_keyframes(uint frameInterval, uint maxInMemory, const dynamic_string &spillPath)
+{
+    clear_keyframes();
+
+    m_keyframeInterval = frameInterval;
+    m_maxKeyframesInMemory = maxInMemory;
+    m_keyframeSpillPath = spillPath;
+}
+
+void vogleditor_traceReplayer::clear_keyframes()
+{
+    for (uint i = 0; i < m_keyframes.size(); i++)
+    {
+        if (m_keyframes[i].pSnapshot != NULL)
+        {
+            vogl_delete(m_keyframes[i].pSnapshot);
+        }
+
+        if (!m_keyframes[i].filename.is_empty())
+        {
+            remove(m_keyframes[i].filename.get_ptr());
+        }
+    }
+
+    m_keyframes.clear();
+
+    // the blobs are named by their contents and may be shared between keyframes, so they go once all keyframes are gone
+    for (vogl::hash_map<dynamic_string>::const_iterator it = m_spilledBlobIds.begin(); it != m_spilledBlobIds.end(); ++it)
+    {
+        dynamic_string blobFilename;
+        file_utils::combine_path(blobFilename, m_keyframeSpillPath.get_ptr(), it->first.get_ptr());
+        remove(blobFilename.get_ptr());
+    }
+
+    m_spilledBlobIds.clear();
+}
+
+vogleditor_traceReplayer::keyframe *vogleditor_traceReplayer::find_keyframe(uint64_t apiCallNumber)
+{
+    // the last keyframe that starts at or before the call
+    keyframe *pKeyframe = NULL;
+    for (uint i = 0; i < m_keyframes.size() && m_keyframes[i].firstCallIndex <= apiCallNumber; i++)
+    {
+        pKeyframe = &m_keyframes[i];
+    }
+
+    return pKeyframe;
+}
+
+void vogleditor_traceReplayer::take_keyframe_if_needed(vogleditor_apiCallTreeItem *pFrameItem)
+{
+    vogleditor_frameItem *pFrame = pFrameItem->frameItem();
+    if (!m_bTakeKeyframes || pFrame->frameNumber() == 0 || (pFrame->frameNumber() % m_keyframeInterval) != 0 || pFrame->callCount() == 0)
+    {
+        return;
+    }
+
+    // the replayer must be in between calls
+    if (m_pTraceReplayer->has_pending_packets() || m_pTraceReplayer->get_has_pending_window_resize() || m_pTraceReplayer->get_pending_apply_snapshot())
+    {
+        return;
+    }
+
+    uint64_t firstCallIndex = pFrame->call(0)->globalCallIndex();
+
+    uint index = 0;
+    while (index < m_keyframes.size() && m_keyframes[index].firstCallIndex < firstCallIndex)
+    {
+        index++;
+    }
+
+    if (index < m_keyframes.size() && m_keyframes[index].firstCallIndex == firstCallIndex)
+    {
+        // already have it
+        return;
+    }
+
+    vogl_gl_state_snapshot *pSnapshot = m_pTraceReplayer->snapshot_state();
+    if (pSnapshot == NULL)
+    {
+        return;
+    }
+
+    dynamic_string info;
+    vogleditor_output_message(info.format("Took keyframe snapshot at frame %" PRIu64 ".", pFrame->frameNumber()).c_str());
+
+    keyframe kf;
+    kf.frameNumber = pFrame->frameNumber();
+    kf.frameRow = pFrameItem->row();
+    kf.firstCallIndex = firstCallIndex;
+    kf.pSnapshot = pSnapshot;
+    kf.lastUsed = ++m_keyframeUseCounter;
+    m_keyframes.insert(index, kf);
+
+    limit_keyframes_in_memory();
+}
+
+bool vogleditor_traceReplayer::load_keyframe(keyframe &kf)
+{
+    kf.lastUsed = ++m_keyframeUseCounter;
+
+    if (kf.pSnapshot != NULL)
+    {
+        return true;
+    }
+
+    json_document doc;
+    if (!doc.deserialize_file(kf.filename.get_ptr()) || (!doc.get_root()))
+    {
+        dynamic_string info;
+        vogleditor_output_error(info.format("Failed reading keyframe \"%s\".", kf.filename.get_ptr()).c_str());
+        return false;
+    }
+
+    vogl_loose_file_blob_manager blob_manager;
+    blob_manager.init(cBMFReadable, m_keyframeSpillPath.get_ptr());
+
+    vogl_gl_state_snapshot *pSnapshot = vogl_new(vogl_gl_state_snapshot);
+    if (!pSnapshot->deserialize(*doc.get_root(), blob_manager, &m_pTraceReplayer->get_trace_gl_ctypes()))
+    {
+        vogl_delete(pSnapshot);
+        dynamic_string info;
+        vogleditor_output_error(info.format("Failed deserializing keyframe \"%s\".", kf.filename.get_ptr()).c_str());
+        return false;
+    }
+
+    kf.pSnapshot = pSnapshot;
+    return true;
+}
+
+bool vogleditor_traceReplayer::spill_keyframe(keyframe &kf)
+{
+    if (kf.filename.is_empty())
+    {
+        if (m_keyframeSpillPath.is_empty())
+        {
+            return false;
+        }
+
+        file_utils::create_directories(m_keyframeSpillPath, false);
+
+        vogleditor_keyframeBlobManager blob_manager(m_spilledBlobIds);
+        blob_manager.init(cBMFReadWrite, m_keyframeSpillPath.get_ptr());
+
+        dynamic_string filename;
+        filename.format("%s/keyframe_%07" PRIu64 ".json", m_keyframeSpillPath.get_ptr(), kf.frameNumber);
+
+        // Stream the snapshot to disk, huge snapshots don't fit in memory as a single JSON document.
+        cfile_stream snapshot_stream;
+        json_stream_writer writer;
+        if (!snapshot_stream.open(filename.get_ptr(), cDataStreamWritable) ||
+            !writer.open(snapshot_stream) ||
+            !kf.pSnapshot->serialize(writer, blob_manager, &m_pTraceReplayer->get_trace_gl_ctypes()) ||
+            !writer.close() ||
+            !snapshot_stream.close())
+        {
+            dynamic_string info;
+            vogleditor_output_warning(info.format("Failed writing keyframe \"%s\".", filename.get_ptr()).c_str());
+            snapshot_stream.close();
+            remove(filename.get_ptr());
+            return false;
+        }
+
+        kf.filename = filename;
+    }
+
+    vogl_delete(kf.pSnapshot);
+    kf.pSnapshot = NULL;
+    return true;
+}
+
+void vogleditor_traceReplayer::limit_keyframes_in_memory()
+{
+    for (;;)
+    {
+        uint numInMemory = 0;
+        int leastRecentlyUsed = -1;
+        for (uint i = 0; i < m_keyframes.size(); i++)
+        {
+            if (m_keyframes[i].pSnapshot == NULL)
+                continue;
+
+            numInMemory++;
+
+            // the keyframe that is being replayed from may still be needed by the replayer
+            if (m_keyframes[i].pSnapshot != m_pReplayKeyframe &&
+                (leastRecentlyUsed < 0 || m_keyframes[i].lastUsed < m_keyframes[leastRecentlyUsed].lastUsed))
+            {
+                leastRecentlyUsed = i;
+            }
+        }
+
+        if (numInMemory <= m_maxKeyframesInMemory || leastRecentlyUsed < 0)
+        {
+            break;
+        }
+
+        if (!spill_keyframe(m_keyframes[leastRecentlyUsed]))
+        {
+            // can't keep it anywhere
+            vogl_delete(m_keyframes[leastRecentlyUsed].pSnapshot);
+            m_keyframes.erase(leastRecentlyUsed);
+        }
+    }
+}
+
 bool vogleditor_traceReplayer::process_events()
 {
     SDL_Event wnd_event;
@@ -151,6 +388,11 @@ vogleditor_tracereplayer_result vogleditor_traceReplayer::recursive_replay_apica
 {
     vogleditor_tracereplayer_result result = VOGLEDITOR_TRR_SUCCESS;
 
+    if (pItem->frameItem() != NULL)
+    {
+        take_keyframe_if_needed(pItem);
+    }
+
     if (pItem->frameItem() != NULL && m_screenshot_prefix.size() > 0)
     {
         // take screenshot
@@ -162,8 +404,6 @@ vogleditor_tracereplayer_result vogleditor_traceReplayer::recursive_replay_apica
     vogleditor_apiCallItem *pApiCall = pItem->apiCallItem();
     if (pApiCall != NULL)
     {
-        vogl_trace_packet *pTrace_packet = pApiCall->getTracePacket();
-
         vogl_gl_replayer::status_t status = vogl_gl_replayer::cStatusOK;
 
         // See if a window resize or snapshot is pending. If a window resize is pending we must delay a while and pump X events until the window is resized.
@@ -183,6 +423,13 @@ vogleditor_tracereplayer_result vogleditor_traceReplayer::recursive_replay_apica
             }
         }
 
+        // Fetch the packet only after pumping events, repainting the api call tree may cycle the packet cache.
+        vogl_trace_packet *pTrace_packet = pApiCall->getTracePacket();
+        if (pTrace_packet == NULL)
+        {
+            return VOGLEDITOR_TRR_ERROR;
+        }
+
         // process pending trace packets (this could include glXMakeCurrent)
         if (!status_indicates_end(status) && m_pTraceReplayer->has_pending_packets())
         {
@@ -300,6 +547,65 @@ vogleditor_tracereplayer_result vogleditor_traceReplayer::replay(vogl_trace_file
 
     vogleditor_tracereplayer_result result = VOGLEDITOR_TRR_SUCCESS;
 
+    // keyframes are only taken and used when replaying to take a snapshot
+    m_bTakeKeyframes = (m_keyframeInterval > 0) && (ppNewSnapshot != NULL);
+
+    keyframe *pKeyframe = m_bTakeKeyframes ? find_keyframe(apiCallNumber) : NULL;
+    if (pKeyframe != NULL && pKeyframe->frameRow < pRootItem->childCount() && load_keyframe(*pKeyframe))
+    {
+        // pKeyframe is not valid anymore once keyframes are added or removed
+        m_pReplayKeyframe = pKeyframe->pSnapshot;
+        int frameRow = pKeyframe->frameRow;
+
+        dynamic_string info;
+        vogleditor_output_message(info.format("Replaying from keyframe at frame %" PRIu64 ".", pKeyframe->frameNumber).c_str());
+        limit_keyframes_in_memory();
+
+        // Attempt to initialize GL func pointers here so they're available when loading from a snapshot
+        if (load_gl())
+            vogl_init_actual_gl_entrypoints(vogl_get_proc_address_helper);
+
+        if (applying_snapshot_and_process_resize(m_pReplayKeyframe))
+        {
+            // replay the frames after the keyframe
+            for (int i = frameRow; i < pRootItem->childCount(); i++)
+            {
+                result = recursive_replay_apicallTreeItem(pRootItem->child(i), ppNewSnapshot, apiCallNumber);
+
+                if (result != VOGLEDITOR_TRR_SUCCESS)
+                    break;
+
+                if (process_events() == false)
+                {
+                    result = VOGLEDITOR_TRR_USER_EXIT;
+                    break;
+                }
+            }
+
+            if (result == VOGLEDITOR_TRR_ERROR)
+            {
+                QString msg = QString("Replay ending abruptly at global api call %1").arg(m_pTraceReplayer->get_last_processed_call_counter());
+                vogleditor_output_error(msg.toStdString().c_str());
+            }
+
+            m_bTakeKeyframes = false;
+            m_pReplayKeyframe = NULL;
+            m_pTraceReplayer->deinit();
+            m_window.close();
+            return result;
+        }
+
+        // start over without the keyframe
+        m_pReplayKeyframe = NULL;
+        m_pTraceReplayer->deinit();
+        if (!m_pTraceReplayer->init(replayer_flags, &m_window, m_pTraceReader->get_sof_packet(), m_pTraceReader->get_multi_blob_manager()))
+        {
+            vogleditor_output_error("Failed initializing GL replayer!");
+            m_window.close();
+            return VOGLEDITOR_TRR_ERROR;
+        }
+    }
+
     for (;;)
     {
         if (process_events() == false)
@@ -360,6 +666,7 @@ vogleditor_tracereplayer_result vogleditor_traceReplayer::replay(vogl_trace_file
         }
     }
 
+    m_bTakeKeyframes = false;
     m_pTraceReplayer->deinit();
     m_window.close();
     return result;
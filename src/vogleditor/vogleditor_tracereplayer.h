@@ -33,9 +33,34 @@ public:
     void enable_screenshot_capturing(std::string screenshot_prefix);
     void enable_fs_preprocessor(std::string fs_preprocessor);
 
+    // While replaying to take a snapshot, a keyframe snapshot is taken at the start of every frameInterval'th frame.
+    // Later snapshot replays then start at the closest keyframe before the requested call instead of at the
+    // start of the trace. Only maxInMemory keyframes are kept in memory, the least recently used ones are
+    // written to spillPath (if it is not empty). A frameInterval of 0 disables keyframes.
+    void enable_keyframes(uint frameInterval, uint maxInMemory, const dynamic_string &spillPath);
+
+    // Must be called when the keyframes no longer match the replay, ie a snapshot was edited or another trace was opened.
+    void clear_keyframes();
+
 private:
+    struct keyframe
+    {
+        uint64_t frameNumber;
+        int frameRow;                      // row of the frame below the root item
+        uint64_t firstCallIndex;           // the snapshot is the state before this call
+        vogl_gl_state_snapshot *pSnapshot; // NULL while only on disk
+        dynamic_string filename;           // set once the keyframe was written to disk
+        uint64_t lastUsed;
+    };
+
     bool applying_snapshot_and_process_resize(const vogl_gl_state_snapshot *pSnapshot);
 
+    keyframe *find_keyframe(uint64_t apiCallNumber);
+    void take_keyframe_if_needed(vogleditor_apiCallTreeItem *pFrameItem);
+    bool load_keyframe(keyframe &kf);
+    bool spill_keyframe(keyframe &kf);
+    void limit_keyframes_in_memory();
+
     vogleditor_tracereplayer_result take_state_snapshot_if_needed(vogleditor_gl_state_snapshot **ppNewSnapshot, uint32_t apiCallNumber);
     vogleditor_tracereplayer_result recursive_replay_apicallTreeItem(vogleditor_apiCallTreeItem *pItem, vogleditor_gl_state_snapshot **ppNewSnapshot, uint64_t apiCallNumber);
 
@@ -47,6 +72,15 @@ private:
     std::string m_fs_preprocessor;
     std::string m_fs_preprocessor_options;
     std::string m_fs_preprocessor_prefix;
+
+    uint m_keyframeInterval;
+    uint m_maxKeyframesInMemory;
+    dynamic_string m_keyframeSpillPath;
+    bool m_bTakeKeyframes;
+    uint64_t m_keyframeUseCounter;
+    const vogl_gl_state_snapshot *m_pReplayKeyframe; // the keyframe that is being replayed from, if any
+    vogl::vector<keyframe> m_keyframes; // sorted by firstCallIndex
+    vogl::hash_map<dynamic_string> m_spilledBlobIds; // blobs spill_keyframe() wrote to m_keyframeSpillPath
 };
 
 #endif // VOGLEDITOR_TRACEREPLAYER_H
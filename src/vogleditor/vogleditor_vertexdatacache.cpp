@@ -0,0 +1,237 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+#include "vogleditor_vertexdatacache.h"
+
+#include "vogl_gl_object.h"
+#include "vogl_buffer_state.h"
+#include "vogl_vao_state.h"
+
+// Converts the first components of each attribute to float, scaling normalized values into [0,1] or [-1,1].
+// memcpy keeps the unaligned reads legal; the loops are simple enough for the compiler to vectorize.
+template <typename T>
+static void convert_components(const uint8_t *pSrc, uint32_t stride, uint32_t vertexCount, uint32_t components, float scale, float *pDst)
+{
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        T data[4];
+        memcpy(data, pSrc, sizeof(T) * components);
+
+        for (uint32_t c = 0; c < components; c++)
+        {
+            pDst[c] = (float)data[c] / scale;
+        }
+
+        pSrc += stride;
+        pDst += components;
+    }
+}
+
+bool vogleditor_vertexDataCache::attrib_key::operator==(const attrib_key &other) const
+{
+    return (m_handle == other.m_handle) &&
+           (m_contents == other.m_contents) &&
+           (m_type == other.m_type) &&
+           (m_size == other.m_size) &&
+           (m_stride == other.m_stride) &&
+           (m_offset == other.m_offset) &&
+           (m_normalized == other.m_normalized);
+}
+
+uint qHash(const vogleditor_vertexDataCache::attrib_key &key)
+{
+    return (uint)key.m_contents.m_lo ^ vogl::bitmix32c((uint)key.m_handle + key.m_type + (uint)key.m_offset) ^ (key.m_size << 24) ^ (key.m_stride << 8);
+}
+
+vogleditor_vertexDataCache::vogleditor_vertexDataCache(int maxCost)
+    : m_attribs(maxCost)
+{
+}
+
+void vogleditor_vertexDataCache::release_buffers()
+{
+    m_contentHashes.clear();
+}
+
+void vogleditor_vertexDataCache::clear()
+{
+    m_attribs.clear();
+    m_contentHashes.clear();
+}
+
+vogl::hash128_t vogleditor_vertexDataCache::contents_hash(const vogl_buffer_state &bufferState)
+{
+    QHash<const vogl_buffer_state *, vogl::hash128_t>::iterator iter = m_contentHashes.find(&bufferState);
+    if (iter != m_contentHashes.end())
+    {
+        return iter.value();
+    }
+
+    const uint8_vec &bufferData = bufferState.get_buffer_data();
+    vogl::hash128_t hash = vogl::calc_hash128(bufferData.get_ptr(), bufferData.size());
+    m_contentHashes.insert(&bufferState, hash);
+    return hash;
+}
+
+void vogleditor_vertexDataCache::get_attrib(const vogl_buffer_state &bufferState, const vogl_vertex_attrib_desc &attribDesc, vogleditor_decodedAttrib &result)
+{
+    attrib_key key;
+    key.m_handle = bufferState.get_snapshot_handle();
+    key.m_contents = contents_hash(bufferState);
+    key.m_type = attribDesc.m_type;
+    key.m_size = attribDesc.m_size;
+    key.m_stride = attribDesc.m_stride;
+    key.m_offset = attribDesc.m_pointer;
+    key.m_normalized = attribDesc.m_normalized;
+
+    vogleditor_decodedAttrib *pCached = m_attribs.object(key);
+    if (pCached != NULL)
+    {
+        result = *pCached;
+        return;
+    }
+
+    decode_attrib(bufferState.get_buffer_data(), attribDesc, result);
+
+    // the result shares its values with the cached copy, so it stays valid if the cache drops it
+    int cost = (int)((result.m_values.size() * sizeof(float)) / 1024) + 1;
+    // QCache deletes its objects with delete, so they are allocated with new
+    m_attribs.insert(key, new vogleditor_decodedAttrib(result), cost);
+}
+
+void vogleditor_vertexDataCache::decode_attrib(const uint8_vec &bufferData, const vogl_vertex_attrib_desc &attribDesc, vogleditor_decodedAttrib &result)
+{
+    result.m_components = math::clamp<GLint>(attribDesc.m_size, 0, 4);
+    result.m_vertexCount = 0;
+    result.m_values.clear();
+
+    uint32_t bytesPerComponent = vogl_get_gl_type_size(attribDesc.m_type);
+    uint32_t bytesPerAttribute = bytesPerComponent * result.m_components;
+    uint32_t stride = (attribDesc.m_stride != 0) ? attribDesc.m_stride : bytesPerAttribute;
+    uint64_t offset = attribDesc.m_pointer;
+    uint32_t bufferSize = bufferData.size();
+
+    if (bytesPerAttribute == 0 || offset + bytesPerAttribute > bufferSize)
+    {
+        return;
+    }
+
+    // only complete attributes are decoded
+    result.m_vertexCount = (uint32_t)((bufferSize - offset - bytesPerAttribute) / stride) + 1;
+    result.m_values.resize(result.m_vertexCount * result.m_components);
+
+    const uint8_t *pSrc = bufferData.get_ptr() + offset;
+    float *pDst = result.m_values.data();
+    uint32_t count = result.m_vertexCount;
+    uint32_t components = result.m_components;
+    bool normalized = attribDesc.m_normalized;
+
+    switch (attribDesc.m_type)
+    {
+        case GL_BYTE:
+            convert_components<int8_t>(pSrc, stride, count, components, normalized ? (float)SCHAR_MAX : 1.0f, pDst);
+            break;
+        case GL_UNSIGNED_BYTE:
+            convert_components<uint8_t>(pSrc, stride, count, components, normalized ? (float)UCHAR_MAX : 1.0f, pDst);
+            break;
+        case GL_SHORT:
+            convert_components<int16_t>(pSrc, stride, count, components, normalized ? (float)SHRT_MAX : 1.0f, pDst);
+            break;
+        case GL_UNSIGNED_SHORT:
+            convert_components<uint16_t>(pSrc, stride, count, components, normalized ? (float)USHRT_MAX : 1.0f, pDst);
+            break;
+        case GL_INT:
+            convert_components<int32_t>(pSrc, stride, count, components, normalized ? (float)INT_MAX : 1.0f, pDst);
+            break;
+        case GL_UNSIGNED_INT:
+            convert_components<uint32_t>(pSrc, stride, count, components, normalized ? (float)UINT_MAX : 1.0f, pDst);
+            break;
+        case GL_FLOAT:
+            convert_components<float>(pSrc, stride, count, components, 1.0f, pDst);
+            break;
+        case GL_DOUBLE:
+            convert_components<double>(pSrc, stride, count, components, 1.0f, pDst);
+            break;
+        default:
+            // half-float, fixed, int_2_10_10_10_REV, UINT_2_10_10_10_REV, UINT_10F_11F_11F_REV
+            result.m_values.fill(0.0f);
+            break;
+    }
+}
+
+void vogleditor_vertexDataCache::decode_elements(const uint8_vec *pElementArray, int typeIndex, uint32_t byteOffset, int32_t baseVertex, uint32_t count, vogleditor_decodedElements &result)
+{
+    result.m_elements.resize(count);
+    uint32_t *pDst = result.m_elements.data();
+
+    if (pElementArray == NULL)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            pDst[i] = baseVertex + i;
+        }
+        return;
+    }
+
+    // the size of one index for GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT and GL_UNSIGNED_INT
+    uint32_t indexSize = 1U << math::clamp(typeIndex, 0, 2);
+    uint32_t available = (byteOffset < pElementArray->size()) ? (pElementArray->size() - byteOffset) / indexSize : 0;
+    if (typeIndex < 0 || typeIndex > 2)
+    {
+        VOGL_ASSERT(!"Invalid type index supplied to decode_elements");
+        available = 0;
+    }
+
+    count = math::minimum(count, available);
+    result.m_elements.resize(count);
+    pDst = result.m_elements.data();
+
+    const uint8_t *pSrc = pElementArray->get_ptr() + byteOffset;
+    if (typeIndex == 0)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            pDst[i] = pSrc[i] + baseVertex;
+        }
+    }
+    else if (typeIndex == 1)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint16_t index;
+            memcpy(&index, pSrc + i * sizeof(uint16_t), sizeof(uint16_t));
+            pDst[i] = index + baseVertex;
+        }
+    }
+    else if (typeIndex == 2)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            uint32_t index;
+            memcpy(&index, pSrc + i * sizeof(uint32_t), sizeof(uint32_t));
+            pDst[i] = index + baseVertex;
+        }
+    }
+}
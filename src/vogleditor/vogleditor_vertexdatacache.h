@@ -0,0 +1,110 @@
+/**************************************************************************
+ *
+ * Copyright 2013-2014 RAD Game Tools and Valve Software
+ * All Rights Reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ **************************************************************************/
+
+#ifndef VOGLEDITOR_VERTEXDATACACHE_H
+#define VOGLEDITOR_VERTEXDATACACHE_H
+
+#include <QCache>
+#include <QHash>
+#include <QVector>
+#include "vogl_core.h"
+#include "vogl_hash.h"
+#include "gl_types.h"
+
+class vogl_buffer_state;
+struct vogl_vertex_attrib_desc;
+
+// An attribute array converted to floats, m_components values for each of the m_vertexCount
+// complete attributes that fit in the buffer. The values are implicitly shared with the cache.
+struct vogleditor_decodedAttrib
+{
+    vogleditor_decodedAttrib()
+        : m_components(0),
+          m_vertexCount(0)
+    {
+    }
+
+    uint32_t m_components;
+    uint32_t m_vertexCount;
+    QVector<float> m_values;
+};
+
+// Element indices read from an element array, with the base vertex already added.
+// Only the indices that could be read are decoded, so m_elements may be shorter than the requested count.
+struct vogleditor_decodedElements
+{
+    QVector<uint32_t> m_elements;
+};
+
+// Keeps vertex attribute arrays converted to floats, keyed by the buffer handle, a hash of the
+// buffer contents and the attribute format. Snapshots taken at different calls store their own copy of
+// each buffer, but as long as the contents and format are the same the attribute is only decoded once.
+class vogleditor_vertexDataCache
+{
+public:
+    enum
+    {
+        // in KB
+        cDefaultMaxCost = 256 * 1024
+    };
+
+    vogleditor_vertexDataCache(int maxCost = cDefaultMaxCost);
+
+    void get_attrib(const vogl_buffer_state &bufferState, const vogl_vertex_attrib_desc &attribDesc, vogleditor_decodedAttrib &result);
+
+    // typeIndex is 0, 1 or 2 for GL_UNSIGNED_BYTE, GL_UNSIGNED_SHORT and GL_UNSIGNED_INT.
+    // Without an element array the indices are implied: baseVertex, baseVertex + 1, ...
+    static void decode_elements(const vogl::uint8_vec *pElementArray, int typeIndex, uint32_t byteOffset, int32_t baseVertex, uint32_t count, vogleditor_decodedElements &result);
+
+    // Content hashes are remembered per buffer object, so this must be called before the buffers of the
+    // current snapshot are deleted. The decoded attributes are kept.
+    void release_buffers();
+
+    void clear();
+
+private:
+    struct attrib_key
+    {
+        GLuint64 m_handle;
+        vogl::hash128_t m_contents;
+        GLenum m_type;
+        GLint m_size;
+        GLsizei m_stride;
+        uint64_t m_offset;
+        bool m_normalized;
+
+        bool operator==(const attrib_key &other) const;
+    };
+    friend uint qHash(const attrib_key &key);
+
+    vogl::hash128_t contents_hash(const vogl_buffer_state &bufferState);
+
+    static void decode_attrib(const vogl::uint8_vec &bufferData, const vogl_vertex_attrib_desc &attribDesc, vogleditor_decodedAttrib &result);
+
+    QCache<attrib_key, vogleditor_decodedAttrib> m_attribs;
+    QHash<const vogl_buffer_state *, vogl::hash128_t> m_contentHashes;
+};
+
+#endif // VOGLEDITOR_VERTEXDATACACHE_H
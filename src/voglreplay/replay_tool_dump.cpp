@@ -29,6 +29,7 @@
 
 #include "vogl_colorized_console.h"
 #include "vogl_file_utils.h"
+#include "vogl_cfile_stream.h"
 
 #ifdef VOGL_REMOTING
 #include "vogl_remote.h"
@@ -45,6 +46,105 @@ static command_line_param_desc g_command_line_param_descs_dump[] =
     { "debug", 0, false, "Enable verbose debug information" },
 };
 
+//----------------------------------------------------------------------------------------------------------------------
+// json_dump_file
+// One output JSON file. The packets are streamed to disk as they're serialized, so memory use doesn't depend on the
+// number of calls in a frame. "meta" is written last because its "eof" key isn't known until the file is finished.
+//----------------------------------------------------------------------------------------------------------------------
+class json_dump_file
+{
+public:
+    json_dump_file()
+        : m_cur_frame(0),
+          m_has_duplicate_keys(false)
+    {
+    }
+
+    bool is_open() const
+    {
+        return m_writer.is_open();
+    }
+
+    bool begin(const dynamic_string &filename, uint32_t cur_frame, const json_node *pSOF_node)
+    {
+        VOGL_FUNC_TRACER
+
+        m_filename = filename;
+        m_cur_frame = cur_frame;
+        m_has_duplicate_keys = false;
+
+        vogl_message_printf("Writing file: \"%s\"\n", m_filename.get_ptr());
+
+        if (!m_stream.open(m_filename.get_ptr(), cDataStreamWritable))
+        {
+            vogl_error_printf("Failed opening JSON file %s\n", m_filename.get_ptr());
+            return false;
+        }
+
+        m_writer.open(m_stream);
+
+        bool success = m_writer.begin_object();
+        if (pSOF_node)
+            success = success && m_writer.add_node("sof", *pSOF_node);
+        success = success && m_writer.begin_array("packets");
+
+        if (!success)
+            vogl_error_printf("Failed serializing JSON document to file %s\n", m_filename.get_ptr());
+        return success;
+    }
+
+    bool add_packet(const json_node &packet_node)
+    {
+        if ((!m_has_duplicate_keys) && (packet_node.check_for_duplicate_keys()))
+            m_has_duplicate_keys = true;
+
+        if (!m_writer.add_node(NULL, packet_node))
+        {
+            vogl_error_printf("Failed serializing JSON document to file %s\n", m_filename.get_ptr());
+            return false;
+        }
+        return true;
+    }
+
+    // eof is 0 if the trace continues in the next file, 1 if the trace's EOF packet was seen, 2 otherwise.
+    bool end(const vogl_trace_stream_start_of_file_packet &sof_packet, bool write_uuid, int eof)
+    {
+        VOGL_FUNC_TRACER
+
+        json_node meta_node(NULL, true);
+        meta_node.add_key_value("cur_frame", m_cur_frame);
+        if (write_uuid)
+        {
+            json_node &uuid_array = meta_node.add_array("uuid");
+            for (uint32_t i = 0; i < VOGL_ARRAY_SIZE(sof_packet.m_uuid); i++)
+                uuid_array.add_value(sof_packet.m_uuid[i]);
+        }
+        if (eof)
+            meta_node.add_key_value("eof", eof);
+
+        bool success = m_writer.end();
+        success = m_writer.add_node("meta", meta_node) && success;
+        success = m_writer.end() && success;
+        success = m_writer.close() && success;
+        success = m_stream.close() && success;
+
+        if (!success)
+            vogl_error_printf("Failed serializing JSON document to file %s\n", m_filename.get_ptr());
+
+        if (m_has_duplicate_keys)
+            vogl_warning_printf("JSON document %s has nodes with duplicate keys, this document may not be readable by some JSON parsers\n", m_filename.get_ptr());
+
+        return success;
+    }
+
+private:
+    dynamic_string m_filename;
+    cfile_stream m_stream;
+    json_stream_writer m_writer;
+    uint32_t m_cur_frame;
+    bool m_has_duplicate_keys;
+};
+
 //----------------------------------------------------------------------------------------------------------------------
 // tool_dump_mode
 //----------------------------------------------------------------------------------------------------------------------
@@ -131,27 +231,29 @@ bool tool_dump_mode(vogl::vector<command_line_param_desc> *desc)
     uint32_t cur_frame_index = 0;
     uint64_t cur_packet_index = 0;
     VOGL_NOTE_UNUSED(cur_packet_index);
-    json_document cur_doc;
 
-    {
-        json_node &meta_node = cur_doc.get_root()->add_object("meta");
-        meta_node.add_key_value("cur_frame", cur_frame_index);
-
-        json_node &sof_node = cur_doc.get_root()->add_object("sof");
-        sof_node.add_key_value("pointer_sizes", pTrace_reader->get_sof_packet().m_pointer_sizes);
-        sof_node.add_key_value("version", to_hex_string(pTrace_reader->get_sof_packet().m_version));
-        if (!archive_name.is_empty())
-            sof_node.add_key_value("archive_filename", archive_name);
-
-        json_node &uuid_array = sof_node.add_array("uuid");
-        for (uint32_t i = 0; i < VOGL_ARRAY_SIZE(pTrace_reader->get_sof_packet().m_uuid); i++)
-            uuid_array.add_value(pTrace_reader->get_sof_packet().m_uuid[i]);
-    }
+    const vogl_trace_stream_start_of_file_packet &sof_packet = pTrace_reader->get_sof_packet();
+
+    json_node sof_node(NULL, true);
+    sof_node.add_key_value("pointer_sizes", sof_packet.m_pointer_sizes);
+    sof_node.add_key_value("version", to_hex_string(sof_packet.m_version));
+    if (!archive_name.is_empty())
+        sof_node.add_key_value("archive_filename", archive_name);
+
+    json_node &uuid_array = sof_node.add_array("uuid");
+    for (uint32_t i = 0; i < VOGL_ARRAY_SIZE(sof_packet.m_uuid); i++)
+        uuid_array.add_value(sof_packet.m_uuid[i]);
 
     // TODO: Automatically dump binary snapshot file to text?
     // Right now we can't afford to do it at trace time, it takes too much memory.
 
-    json_node *pPacket_array = &cur_doc.get_root()->add_array("packets");
+    json_dump_file cur_file;
+    if (!cur_file.begin(dynamic_string(cVarArg, "%s_%06u.json", output_base_filename.get_ptr(), cur_file_index), cur_frame_index, &sof_node))
+        return false;
+
+    json_node packet_node(NULL, true);
+
+    int eof = 0;
 
     bool flush_current_document = false;
 
@@ -184,9 +286,7 @@ bool tool_dump_mode(vogl::vector<command_line_param_desc> *desc)
                 status = false;
             }
 
-            json_node *pMeta_node = cur_doc.get_root()->find_child_object("meta");
-            if (pMeta_node)
-                pMeta_node->add_key_value("eof", (pTrace_reader->get_packet_type() == cTSPTEOF) ? 1 : 2);
+            eof = (pTrace_reader->get_packet_type() == cTSPTEOF) ? 1 : 2;
 
             break;
         }
@@ -195,33 +295,19 @@ bool tool_dump_mode(vogl::vector<command_line_param_desc> *desc)
         {
             flush_current_document = false;
 
-            dynamic_string output_filename(cVarArg, "%s_%06u.json", output_base_filename.get_ptr(), cur_file_index);
-            vogl_message_printf("Writing file: \"%s\"\n", output_filename.get_ptr());
-
-            if (!cur_doc.serialize_to_file(output_filename.get_ptr(), true))
+            if (!cur_file.end(sof_packet, cur_file_index != 0, 0))
             {
-                vogl_error_printf("Failed serializing JSON document to file %s\n", output_filename.get_ptr());
-
                 status = false;
                 break;
             }
 
-            if (cur_doc.get_root()->check_for_duplicate_keys())
-                vogl_warning_printf("JSON document %s has nodes with duplicate keys, this document may not be readable by some JSON parsers\n", output_filename.get_ptr());
-
             cur_file_index++;
 
-            pPacket_array = NULL;
-            cur_doc.clear();
-
-            json_node &note_node = cur_doc.get_root()->add_object("meta");
-            note_node.add_key_value("cur_frame", cur_frame_index);
-
-            json_node &uuid_array = note_node.add_array("uuid");
-            for (uint32_t i = 0; i < VOGL_ARRAY_SIZE(pTrace_reader->get_sof_packet().m_uuid); i++)
-                uuid_array.add_value(pTrace_reader->get_sof_packet().m_uuid[i]);
-
-            pPacket_array = &cur_doc.get_root()->add_array("packets");
+            if (!cur_file.begin(dynamic_string(cVarArg, "%s_%06u.json", output_base_filename.get_ptr(), cur_file_index), cur_frame_index, NULL))
+            {
+                status = false;
+                break;
+            }
         }
 
         const vogl_trace_gl_entrypoint_packet &gl_packet = pTrace_reader->get_packet<vogl_trace_gl_entrypoint_packet>();
@@ -252,7 +338,9 @@ bool tool_dump_mode(vogl::vector<command_line_param_desc> *desc)
             continue;
         }
 
-        json_node &new_node = pPacket_array->add_object();
+        json_node &new_node = packet_node;
+        new_node.clear();
+        new_node.set_is_object(true);
 
         vogl_trace_packet::json_serialize_params serialize_params;
         serialize_params.m_output_basename = file_utils::get_filename(output_base_filename.get_ptr());
@@ -387,33 +475,17 @@ bool tool_dump_mode(vogl::vector<command_line_param_desc> *desc)
             cur_frame_index++;
         }
 
-        if (cur_doc.get_root()->size() >= 1 * 1000 * 1000)
+        if (!cur_file.add_packet(new_node))
         {
-            // TODO: Support replaying dumps like this, or fix the code to serialize the text as it goes.
-            vogl_error_printf("Haven't encountered a SwapBuffers() call in over 1000000 GL calls, dumping current in-memory JSON document to disk to avoid running out of memory. This JSON dump may not be replayable, but writing it anyway.\n");
-            flush_current_document = true;
+            status = false;
+            break;
         }
     }
 
-    json_node *pMeta_node = cur_doc.get_root()->find_child_object("meta");
-
-    if (pMeta_node)
+    if (cur_file.is_open())
     {
-        if (!pMeta_node->has_key("eof"))
-            pMeta_node->add_key_value("eof", 2);
-
-        dynamic_string output_filename(cVarArg, "%s_%06u.json", output_base_filename.get_ptr(), cur_file_index);
-        vogl_message_printf("Writing file: \"%s\"\n", output_filename.get_ptr());
-
-        if (!cur_doc.serialize_to_file(output_filename.get_ptr(), true))
-        {
-            vogl_error_printf("Failed serializing JSON document to file %s\n", output_filename.get_ptr());
-
+        if (!cur_file.end(sof_packet, cur_file_index != 0, eof ? eof : 2))
             status = false;
-        }
-
-        if (cur_doc.get_root()->check_for_duplicate_keys())
-            vogl_warning_printf("JSON document %s has nodes with duplicate keys, this document may not be readable by some JSON parsers\n", output_filename.get_ptr());
 
         cur_file_index++;
     }
@@ -27,6 +27,52 @@
 #include "vogl_common.h"
 #include "vogl_gl_replayer.h"
 #include "vogl_json.h"
+#include "vogl_cfile_stream.h"
+
+//----------------------------------------------------------------------------------------------------------------------
+// convert_json_file
+// Streams text JSON to UBJ or vice versa, so the whole document is never held in memory.
+//----------------------------------------------------------------------------------------------------------------------
+static bool convert_json_file(const dynamic_string &input_filename, const dynamic_string &output_filename, bool input_is_binary)
+{
+    VOGL_FUNC_TRACER
+
+    cfile_stream input_stream;
+    if (!input_stream.open(input_filename.get_ptr(), cDataStreamReadable))
+    {
+        vogl_error_printf("Unable to open input file \"%s\"!\n", input_filename.get_ptr());
+        return false;
+    }
+
+    cfile_stream output_stream;
+    if (!output_stream.open(output_filename.get_ptr(), cDataStreamWritable))
+    {
+        vogl_error_printf("Unable to open output file \"%s\"!\n", output_filename.get_ptr());
+        return false;
+    }
+
+    json_stream_writer writer;
+    writer.open(output_stream, !input_is_binary);
+
+    json_stream_reader reader;
+    bool success = input_is_binary ? reader.binary_parse(input_stream, writer) : reader.parse(input_stream, writer);
+    if (!success)
+    {
+        vogl_error_printf("Unable to deserialize input file \"%s\"!\n", input_filename.get_ptr());
+        if (reader.get_error_info().m_error_msg.has_content())
+            vogl_error_printf("%s (Line: %u)\n", reader.get_error_info().m_error_msg.get_ptr(), reader.get_error_info().m_error_line);
+        writer.close();
+        return false;
+    }
+
+    if ((!writer.close()) || (!output_stream.close()))
+    {
+        vogl_error_printf("Failed serializing to output file \"%s\"!\n", output_filename.get_ptr());
+        return false;
+    }
+
+    return true;
+}
 
 //----------------------------------------------------------------------------------------------------------------------
 // tool_unpack_json_mode
@@ -55,22 +101,10 @@ bool tool_unpack_json_mode(vogl::vector<command_line_param_desc> *desc)
         return false;
     }
 
-    json_document doc;
     vogl_message_printf("Reading UBJ file \"%s\"\n", input_filename.get_ptr());
 
-    if (!doc.binary_deserialize_file(input_filename.get_ptr()))
-    {
-        vogl_error_printf("Unable to deserialize input file \"%s\"!\n", input_filename.get_ptr());
-        if (doc.get_error_msg().has_content())
-            vogl_error_printf("%s\n", doc.get_error_msg().get_ptr());
+    if (!convert_json_file(input_filename, output_filename, true))
         return false;
-    }
-
-    if (!doc.serialize_to_file(output_filename.get_ptr()))
-    {
-        vogl_error_printf("Failed serializing to output file \"%s\"!\n", output_filename.get_ptr());
-        return false;
-    }
 
     vogl_message_printf("Wrote textual JSON file to \"%s\"\n", output_filename.get_ptr());
 
@@ -104,22 +138,10 @@ bool tool_pack_json_mode(vogl::vector<command_line_param_desc> *desc)
         return false;
     }
 
-    json_document doc;
     vogl_message_printf("Reading JSON text file \"%s\"\n", input_filename.get_ptr());
 
-    if (!doc.deserialize_file(input_filename.get_ptr()))
-    {
-        vogl_error_printf("Unable to deserialize input file \"%s\"!\n", input_filename.get_ptr());
-        if (doc.get_error_msg().has_content())
-            vogl_error_printf("%s (Line: %u)\n", doc.get_error_msg().get_ptr(), doc.get_error_line());
-        return false;
-    }
-
-    if (!doc.binary_serialize_to_file(output_filename.get_ptr()))
-    {
-        vogl_error_printf("Failed serializing to output file \"%s\"!\n", output_filename.get_ptr());
+    if (!convert_json_file(input_filename, output_filename, false))
         return false;
-    }
 
     vogl_message_printf("Wrote binary UBJ file to \"%s\"\n", output_filename.get_ptr());
 
@@ -26,8 +26,10 @@
 // File: vogl_tool_replay.cpp
 #include "vogl_common.h"
 #include "vogl_gl_replayer.h"
+#include "vogl_program_binary_cache.h"
 #include "vogl_file_utils.h"
 #include "vogl_find_files.h"
+#include "vogl_cfile_stream.h"
 
 #include "libtelemetry.h"
 
@@ -46,6 +48,7 @@ static command_line_param_desc g_command_line_param_descs_play[] =
     { "loop_frame", 1, false, "Replay: loop mode's start frame" },
     { "loop_len", 1, false, "Replay: loop mode's loop length" },
     { "loop_count", 1, false, "Replay: loop mode's loop count" },
+    { "loop_predecode", 0, false, "Replay: loop mode decodes the looped frames once and replays them from memory" },
     { "benchmark", 0, false, NULL }, // Always set hidden option.
     { "allow_state_teardown", 0, false, "Benchmark: When in benchmark mode, enables state teardown/restore at frame loop boundaries" },
 };
@@ -65,6 +68,7 @@ static command_line_param_desc g_command_line_param_descs_replay[] =
     { "loop_frame", 1, false, "Replay: loop mode's start frame" },
     { "loop_len", 1, false, "Replay: loop mode's loop length" },
     { "loop_count", 1, false, "Replay: loop mode's loop count" },
+    { "loop_predecode", 0, false, "Replay: loop mode decodes the looped frames once and replays them from memory" },
     { "benchmark", 0, false, "Replay mode: Disable glGetError()'s, divergence checks, state teardown/restore, during replaying" },
     { "allow_state_teardown", 0, false, "Benchmark: When in benchmark mode, enables state teardown/restore at frame loop boundaries" },
 
@@ -106,6 +110,9 @@ static command_line_param_desc g_command_line_param_descs_replay[] =
     { "fs_preprocessor", 1, false, "Replay: Run all FS through specified pre-processor prior to glCreateShader() call and substitute the shader output by the pre-processor into the glCreateShader() call." },
     { "fs_preprocessor_options", 1, false, "Replay: Options to pass to the FS pre-processor.  Must also specify --fs_preprocessor" },
     { "fs_preprocessor_prefix", 1, false, "Replay: Dir/prefix to append to FS input to PP and output from PP.  Must also specify --fs_preprocessor" },
+    { "fs_preprocessor_cache", 1, false, "Replay: Directory to cache FS pre-processor output in, so each distinct FS is only pre-processed once across runs.  Must also specify --fs_preprocessor" },
+    { "fs_preprocessor_worker", 0, false, "Replay: Start the FS pre-processor once and stream all FS through it over stdin/stdout (see vogl_fs_preprocessor.cpp for the protocol).  Must also specify --fs_preprocessor" },
+    { "program_binary_cache", 1, false, "Replay: Directory used to cache linked program binaries across runs (requires GL 4.1 or GL_ARB_get_program_binary)" },
 };
 
 static const struct
@@ -155,6 +162,8 @@ struct replay_data_t
         loop_frame(0),
         loop_len(0),
         loop_count(0),
+        loop_predecode(false),
+        loop_frames_active(false),
         draw_kill_max_thresh(0),
         endless_mode(false)
     {}
@@ -201,6 +210,9 @@ struct replay_data_t
     int loop_frame;
     int loop_len;
     int loop_count;
+    bool loop_predecode;
+    bool loop_frames_active;
+    vogl_predecoded_frames loop_frames;
     int draw_kill_max_thresh;
     bool endless_mode;
     bool benchmark_mode;
@@ -978,6 +990,43 @@ static int do_interactive_mode(replay_data_t &rdata)
     return 0;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+// get_loop_cur_frame
+// Returns the trace frame the replay is currently at. While pre-decoded loop frames are being replayed the trace reader
+// sits at the end of the loop, so the frame comes from their cursor instead.
+//----------------------------------------------------------------------------------------------------------------------
+static int64_t get_loop_cur_frame(replay_data_t &rdata)
+{
+    if (rdata.loop_frames_active)
+        return rdata.snapshot_loop_start_frame + rdata.loop_frames.get_cur_frame();
+
+    return rdata.pTrace_reader->get_cur_frame();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// begin_predecoded_loop
+//----------------------------------------------------------------------------------------------------------------------
+static bool begin_predecoded_loop(replay_data_t &rdata)
+{
+    if (!rdata.loop_predecode)
+        return true;
+
+    double record_start = rdata.tm.get_elapsed_secs();
+
+    if (!rdata.loop_frames.record(*rdata.pTrace_reader, &rdata.replayer.get_trace_gl_ctypes(), rdata.loop_len))
+    {
+        vogl_error_printf("Failed pre-decoding loop frames\n");
+        return false;
+    }
+
+    vogl_printf("Pre-decoded %u frame(s), %u packets in %.3f secs\n", rdata.loop_frames.get_num_frames(), rdata.loop_frames.size(), rdata.tm.get_elapsed_secs() - record_start);
+
+    rdata.loop_frames.rewind();
+    rdata.loop_frames_active = true;
+
+    return true;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 // do_non_interactive_mode
 //----------------------------------------------------------------------------------------------------------------------
@@ -1132,6 +1181,9 @@ static int do_non_interactive_mode(replay_data_t &rdata)
                     }
 
                     vogl_debug_printf("Loop start: %" PRIi64 " Loop end: %" PRIi64 ", Loops remaining: %d\n", rdata.snapshot_loop_start_frame, rdata.snapshot_loop_end_frame, rdata.loop_count);
+
+                    if (!begin_predecoded_loop(rdata))
+                        return -1;
                 }
             }
             else
@@ -1155,6 +1207,9 @@ static int do_non_interactive_mode(replay_data_t &rdata)
                     }
 
                     vogl_debug_printf("Loop start: %" PRIi64 " Loop end: %" PRIi64 "\n", rdata.snapshot_loop_start_frame, rdata.snapshot_loop_end_frame);
+
+                    if (!begin_predecoded_loop(rdata))
+                        return -1;
                 }
                 else
                 {
@@ -1176,6 +1231,10 @@ static int do_non_interactive_mode(replay_data_t &rdata)
             {
                 status = replayer.process_pending_packets();
             }
+            else if (rdata.loop_frames_active)
+            {
+                status = replayer.process_next_packet(rdata.loop_frames);
+            }
             else
             {
                 status = replayer.process_next_packet(*rdata.pTrace_reader);
@@ -1207,15 +1266,22 @@ static int do_non_interactive_mode(replay_data_t &rdata)
                     vogl_null_blob_manager null_blob_manager;
                     null_blob_manager.init(cBMFReadWrite);
 
-                    json_document doc;
                     vogl_blob_manager *pBlob_manager = g_command_line_params().get_value_as_bool("write_snapshot_blobs") ?
                                 static_cast<vogl_blob_manager *>(&rdata.trim_file_blob_manager) :
                                 static_cast<vogl_blob_manager *>(&null_blob_manager);
-                    if (!rdata.pSnapshot->serialize(*doc.get_root(), *pBlob_manager, &replayer.get_trace_gl_ctypes()))
+
+                    // Stream the snapshot to disk, huge snapshots don't fit in memory as a single JSON document.
+                    cfile_stream snapshot_stream;
+                    json_stream_writer writer;
+                    if (!snapshot_stream.open(filename.get_ptr(), cDataStreamWritable))
+                    {
+                        vogl_error_printf("Failed writing state snapshot to file \"%s\"!\n", filename.get_ptr());
+                    }
+                    else if ((!writer.open(snapshot_stream)) || (!rdata.pSnapshot->serialize(writer, *pBlob_manager, &replayer.get_trace_gl_ctypes())))
                     {
                         vogl_error_printf("Failed serializing state snapshot document!\n");
                     }
-                    else if (!doc.serialize_to_file(filename.get_ptr(), true))
+                    else if ((!writer.close()) || (!snapshot_stream.close()))
                     {
                         vogl_error_printf("Failed writing state snapshot to file \"%s\"!\n", filename.get_ptr());
                     }
@@ -1279,7 +1345,7 @@ static int do_non_interactive_mode(replay_data_t &rdata)
     }
 
     // Essentially, this loop is only entered if the code needs to perform more loops
-    if ((replayer.get_at_frame_boundary()) && (rdata.loop_count > 0) && ((rdata.pTrace_reader->get_cur_frame() == rdata.snapshot_loop_end_frame) || (status == vogl_gl_replayer::cStatusAtEOF && rdata.snapshot_loop_end_frame != -1)))
+    if ((replayer.get_at_frame_boundary()) && (rdata.loop_count > 0) && ((get_loop_cur_frame(rdata) == rdata.snapshot_loop_end_frame) || (status == vogl_gl_replayer::cStatusAtEOF && rdata.snapshot_loop_end_frame != -1)))
     {
         // apply the snapshot if one exists
         if (rdata.pSnapshot)
@@ -1297,7 +1363,10 @@ static int do_non_interactive_mode(replay_data_t &rdata)
             }
         }
 
-        rdata.pTrace_reader->seek_to_frame(static_cast<uint32_t>(rdata.snapshot_loop_start_frame));
+        if (rdata.loop_frames_active)
+            rdata.loop_frames.rewind();
+        else
+            rdata.pTrace_reader->seek_to_frame(static_cast<uint32_t>(rdata.snapshot_loop_start_frame));
 
         if (rdata.draw_kill_max_thresh > 0)
         {
@@ -1318,7 +1387,7 @@ static int do_non_interactive_mode(replay_data_t &rdata)
     }
     else
     {
-        if (rdata.pTrace_reader->get_cur_frame() == rdata.snapshot_loop_end_frame)
+        if (get_loop_cur_frame(rdata) == rdata.snapshot_loop_end_frame)
         {
             // just finished looping
             vogl_debug_printf("Looping complete.\n");
@@ -1343,6 +1412,7 @@ static int do_non_interactive_mode(replay_data_t &rdata)
                 double fs_pp_time = rdata.replayer.get_fs_pp_time();
                 vogl_printf("Ran with FS Preprocessor (FSPP) enabled:\n");
                 vogl_printf("FSPP Time: %.3f secs\n", fs_pp_time);
+                vogl_printf("FSPP Cache: %u hits, %u misses\n", rdata.replayer.get_fs_preprocessor()->get_num_cache_hits(), rdata.replayer.get_fs_preprocessor()->get_num_cache_misses());
             }
             unsigned int initial_frames = replayer.get_total_swaps() - loop_frames;
             vogl_printf("Initial: %u total swaps, %.3f secs, %3.3f avg fps\n", initial_frames, time_looping_started, initial_frames / time_looping_started);
@@ -1363,6 +1433,7 @@ static int do_non_interactive_mode(replay_data_t &rdata)
                     double fs_pp_time = rdata.replayer.get_fs_pp_time();
                     vogl_printf("Ran with FS Preprocessor (FSPP) enabled:\n");
                     vogl_printf("FSPP Time: %.3f secs\n", fs_pp_time);
+                    vogl_printf("FSPP Cache: %u hits, %u misses\n", rdata.replayer.get_fs_preprocessor()->get_num_cache_hits(), rdata.replayer.get_fs_preprocessor()->get_num_cache_misses());
                     vogl_printf("Overall Stats:             %u total swaps, %.3f secs, %3.3f avg fps\n", replayer.get_total_swaps(), time_since_start, replayer.get_frame_index() / time_since_start);
                     vogl_printf("Stats Excluding FSPP time: %u total swaps, %.3f secs, %3.3f avg fps\n", replayer.get_total_swaps(), time_since_start-fs_pp_time, replayer.get_frame_index() / (time_since_start-fs_pp_time));
                 }
@@ -1473,6 +1544,14 @@ bool tool_replay_mode(vogl::vector<command_line_param_desc> *desc)
     rdata.replayer.set_fs_preprocessor(g_command_line_params().get_value_as_string("fs_preprocessor", 0, ""));
     rdata.replayer.set_fs_preprocessor_options(g_command_line_params().get_value_as_string("fs_preprocessor_options", 0, ""));
     rdata.replayer.set_fs_preprocessor_prefix(g_command_line_params().get_value_as_string("fs_preprocessor_prefix", 0, ""));
+    rdata.replayer.set_fs_preprocessor_cache_dir(g_command_line_params().get_value_as_string("fs_preprocessor_cache", 0, ""));
+    rdata.replayer.set_fs_preprocessor_use_worker(g_command_line_params().get_value_as_bool("fs_preprocessor_worker"));
+
+    if (g_command_line_params().has_key("program_binary_cache"))
+    {
+        if (!vogl_program_binary_cache::get_instance()->init(g_command_line_params().get_value_as_string_or_empty("program_binary_cache")))
+            vogl_warning_printf("Failed initializing program binary cache, continuing without it\n");
+    }
 
     if (!rdata.keyframe_base_filename.is_empty())
     {
@@ -1516,6 +1595,7 @@ bool tool_replay_mode(vogl::vector<command_line_param_desc> *desc)
     rdata.loop_frame = g_command_line_params().get_value_as_int("loop_frame", 0, -1);
     rdata.loop_len = math::maximum<int>(g_command_line_params().get_value_as_int("loop_len", 0, 1), 1);
     rdata.loop_count = math::maximum<int>(g_command_line_params().get_value_as_int("loop_count", 0, cINT32_MAX), 1);
+    rdata.loop_predecode = g_command_line_params().get_value_as_bool("loop_predecode");
     rdata.draw_kill_max_thresh = g_command_line_params().get_value_as_int("draw_kill_max_thresh", 0, -1);
     rdata.endless_mode = g_command_line_params().get_value_as_bool("endless");
     rdata.benchmark_mode = g_command_line_params().get_value_as_bool("benchmark");
@@ -1779,6 +1859,9 @@ bool tool_replay_mode(vogl::vector<command_line_param_desc> *desc)
         }
     }
 
+    if (vogl_program_binary_cache::get_instance()->is_enabled())
+        vogl_program_binary_cache::get_instance()->print_stats();
+
     return (ret != -1);
 }
 
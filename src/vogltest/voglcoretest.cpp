@@ -33,9 +33,13 @@
 #include "vogl_sparse_vector.h"
 #include "vogl_sort.h"
 #include "vogl_hash_map.h"
+#include "vogl_dense_hash_map.h"
 #include "vogl_map.h"
 #include "vogl_md5.h"
 #include "vogl_rh_hash_map.h"
+#include "vogl_json.h"
+#include "vogl_sample_stats.h"
+#include "vogl_program_binary_cache.h"
 
 //$ TODO?
 //#include "vogl_timer.h"
@@ -53,11 +57,14 @@ struct test_data_t
     const char *name;
     bool (*pfunc1)(void);
     bool (*pfunc2)(uint);
+    // Benchmarks aren't run by --all, only when named.
+    bool benchmark;
 };
 static const struct test_data_t g_tests[] =
 {
-#define DEFTEST(_x) { #_x, _x ## _test, NULL }
-#define DEFTEST2(_x) { #_x, NULL, _x ## _test }
+#define DEFTEST(_x) { #_x, _x ## _test, NULL, false }
+#define DEFTEST2(_x) { #_x, NULL, _x ## _test, false }
+#define DEFBENCH(_x) { #_x "_bench", _x ## _bench, NULL, true }
     DEFTEST(rh_hash_map),
     DEFTEST(object_pool),
     DEFTEST(dynamic_string),
@@ -68,11 +75,19 @@ static const struct test_data_t g_tests[] =
     DEFTEST(strutils),
     DEFTEST(map),
     DEFTEST(hash_map),
+    DEFTEST(dense_hash_map),
     DEFTEST(sort),
+    DEFTEST(json),
+    DEFTEST(hash),
+    DEFTEST(sample_stats),
+    DEFTEST(vogl_program_binary_cache),
     DEFTEST2(sparse_vector),
     DEFTEST2(bigint128),
+    DEFBENCH(hash),
+    DEFBENCH(dense_hash_map),
 #undef DEFTEST
 #undef DEFTEST2
+#undef DEFBENCH
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -105,7 +120,7 @@ static void tool_print_help()
 
     for (size_t i = 0; i < VOGL_ARRAY_SIZE(g_tests); i++)
     {
-        vogl_printf("  % 2d: %s\n", (int)i, g_tests[i].name);
+        vogl_printf("  % 2d: %s%s\n", (int)i, g_tests[i].name, g_tests[i].benchmark ? " (benchmark, not run by --all)" : "");
     }
 }
 
@@ -169,7 +184,7 @@ int run_voglcore_tests(int argc, char *argv[])
     for (size_t i = 0; i < VOGL_ARRAY_SIZE(g_tests); i++)
     {
         // If --all was passed or the name of this test, then run it.
-        bool run_test = arg_all || check_for_command_line_param(g_tests[i].name);
+        bool run_test = (arg_all && !g_tests[i].benchmark) || check_for_command_line_param(g_tests[i].name);
 
         if (run_test)
         {